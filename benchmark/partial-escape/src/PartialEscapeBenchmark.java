@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class PartialEscapeBenchmark {
+    public static Object sink;
+    public static String string1 = "s1";
+    public static int rareMask = 1023;
+
+    static class Range {
+        int start;
+        int end;
+    }
+
+    static class Builder {
+        Builder(int capacity) {
+            this.capacity = capacity;
+        }
+
+        Builder add(int value) {
+            sum += value;
+            ++count;
+            return this;
+        }
+
+        final int capacity;
+        int sum;
+        int count;
+    }
+
+    public void timeRangeRareEscape(int count) {
+        int mask = rareMask;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            Range range = new Range();
+            range.start = i;
+            range.end = i + 10;
+            sum += range.end - range.start;
+            if ((i & mask) == mask) {
+                sink = range;
+            }
+        }
+        if (sum != count * 10) {
+            throw new AssertionError();
+        }
+    }
+
+    public void timeBuilderRareEscape(int count) {
+        int mask = rareMask;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            Builder builder = new Builder(16).add(i).add(1);
+            sum += builder.sum - i + builder.count;
+            if ((i & mask) == mask) {
+                sink = builder;
+            }
+        }
+        if (sum != count * 3) {
+            throw new AssertionError();
+        }
+    }
+
+    public void timeStringBuilderRareEscape(int count) {
+        String s1 = string1;
+        int mask = rareMask;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            StringBuilder sb = new StringBuilder();
+            sb.append(s1);
+            if ((i & mask) == mask) {
+                sink = sb;
+            }
+            sum += sb.length();
+        }
+        if (sum != count * s1.length()) {
+            throw new AssertionError();
+        }
+    }
+
+    public void timeIntegerValueOfRareEscape(int count) {
+        int mask = rareMask;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            // Use values outside of the `Integer` cache so that boxing allocates.
+            Integer boxed = Integer.valueOf(i + 1024);
+            sum += boxed.intValue() - i;
+            if ((i & mask) == mask) {
+                sink = boxed;
+            }
+        }
+        if (sum != count * 1024) {
+            throw new AssertionError();
+        }
+    }
+}
@@ -58,6 +58,13 @@ enum class ProfileMethodsCheck : uint8_t {
   kAbort,
 };
 
+// Enum for GetRegisterAllocationStrategy. Outside CompilerOptions so it can be forward-declared.
+enum class RegisterAllocationStrategy : uint8_t {
+  kDefault,     // Graph coloring for methods that are hot in the profile, linear scan otherwise.
+  kLinearScan,
+  kGraphColor,
+};
+
 class CompilerOptions final {
  public:
   // Default values for parameters set via flags.
@@ -354,6 +361,10 @@ class CompilerOptions final {
     return check_profiled_methods_;
   }
 
+  RegisterAllocationStrategy GetRegisterAllocationStrategy() const {
+    return register_allocation_strategy_;
+  }
+
   uint32_t MaxImageBlockSize() const {
     return max_image_block_size_;
   }
@@ -469,6 +480,9 @@ class CompilerOptions final {
   // up compiled and are not punted.
   ProfileMethodsCheck check_profiled_methods_;
 
+  // The register allocator used by the optimizing compiler.
+  RegisterAllocationStrategy register_allocation_strategy_;
+
   // Maximum solid block size in the generated image.
   uint32_t max_image_block_size_;
 
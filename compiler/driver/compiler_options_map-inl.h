@@ -91,6 +91,7 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
   if (map.Exists(Base::CheckProfiledMethods)) {
     options->check_profiled_methods_ = *map.Get(Base::CheckProfiledMethods);
   }
+  map.AssignIfExists(Base::RegisterAllocationStrategy, &options->register_allocation_strategy_);
   map.AssignIfExists(Base::MaxImageBlockSize, &options->max_image_block_size_);
 
   if (map.Exists(Base::DumpTimings)) {
@@ -170,6 +171,15 @@ NO_INLINE void AddCompilerOptionsArgumentParserOptions(Builder& b) {
                          {"abort", ProfileMethodsCheck::kAbort}})
           .IntoKey(Map::CheckProfiledMethods)
 
+      .Define("--register-allocation-strategy=_")
+          .template WithType<RegisterAllocationStrategy>()
+          .WithValueMap({{"linear-scan", RegisterAllocationStrategy::kLinearScan},
+                         {"graph-color", RegisterAllocationStrategy::kGraphColor}})
+          .WithHelp("Select the register allocator of the optimizing compiler.\n"
+                    "Default: graph-color for methods that are hot in the profile,\n"
+                    "linear-scan otherwise.")
+          .IntoKey(Map::RegisterAllocationStrategy)
+
       .Define({"--dump-timings"})
           .WithHelp("Display a breakdown of where time was spent.")
           .IntoKey(Map::DumpTimings)
@@ -242,8 +252,7 @@ NO_INLINE void AddCompilerOptionsArgumentParserOptions(Builder& b) {
       .Ignore({
         "--num-dex-methods=_",
         "--top-k-profile-threshold=_",
-        "--large-method-max=_",
-        "--register-allocation-strategy=_"
+        "--large-method-max=_"
       });
   // clang-format on
 }
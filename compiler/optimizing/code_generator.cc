@@ -51,6 +51,8 @@
 #include "gc/space/image_space.h"
 #include "intern_table.h"
 #include "intrinsics.h"
+#include "jit/jit.h"
+#include "jit/jit_code_cache.h"
 #include "mirror/array-inl.h"
 #include "mirror/object_array-inl.h"
 #include "mirror/object_reference.h"
@@ -209,6 +211,15 @@ uint64_t CodeGenerator::GetJitClassRootIndex(TypeReference type_reference) {
   return code_generation_data_->GetJitClassRootIndex(type_reference);
 }
 
+uint64_t CodeGenerator::GetJitEntryPointSlotAddress(HInvokeStaticOrDirect* invoke) {
+  DCHECK(GetCompilerOptions().IsJitCompiler());
+  DCHECK_EQ(invoke->GetMethodLoadKind(), MethodLoadKind::kJitDirectAddress);
+  ScopedObjectAccess soa(Thread::Current());
+  jit::JitCodeCache* code_cache = Runtime::Current()->GetJit()->GetCodeCache();
+  return reinterpret_cast<uint64_t>(
+      code_cache->GetEntryPointSlot(soa.Self(), invoke->GetResolvedMethod()));
+}
+
 void CodeGenerator::EmitJitRootPatches([[maybe_unused]] uint8_t* code,
                                        [[maybe_unused]] const uint8_t* roots_data) {
   DCHECK(code_generation_data_ != nullptr);
@@ -391,13 +402,87 @@ void CodeGenerator::EmitThunkCode([[maybe_unused]] const linker::LinkerPatch& pa
   LOG(FATAL) << "Unexpected call to EmitThunkCode().";
 }
 
+// Return whether the profile found that the branch from `predecessor` to `block`
+// was never taken, while the other side was.
+static bool IsColdEdge(HBasicBlock* predecessor, HBasicBlock* block) {
+  HInstruction* last = predecessor->GetLastInstruction();
+  if (!last->IsIf()) {
+    return false;
+  }
+  HIf* if_instr = last->AsIf();
+  if (if_instr->IfTrueSuccessor() == if_instr->IfFalseSuccessor()) {
+    return false;
+  }
+  bool is_true_successor = if_instr->IfTrueSuccessor() == block;
+  uint16_t count = is_true_successor ? if_instr->GetTrueCount() : if_instr->GetFalseCount();
+  uint16_t other_count = is_true_successor ? if_instr->GetFalseCount() : if_instr->GetTrueCount();
+  return count == 0u && other_count != 0u;
+}
+
+// Move the blocks that are unlikely to execute after the other blocks, so that the
+// hot code of the method is contiguous. Slow paths are already emitted after all blocks.
+// A block is cold if it is a catch block, if it ends with a throw, or if it can only be
+// reached from cold blocks or through branches the profile never saw taken. Every block
+// starts and ends with the same frame, so the layout does not affect CFI, and stack maps
+// are recorded in emission order.
+const ArenaVector<HBasicBlock*>* CodeGenerator::ComputeCodeLayout(
+    const ArenaVector<HBasicBlock*>& block_order) {
+  if (GetGraph()->IsCompilingBaseline() || GetGraph()->IsDebuggable()) {
+    return &block_order;
+  }
+  ArenaAllocator* allocator = GetGraph()->GetAllocator();
+  ArenaBitVector cold_blocks(
+      allocator, GetGraph()->GetBlocks().size(), /* expandable= */ false, kArenaAllocCodeGenerator);
+  size_t number_of_cold_blocks = 0u;
+  for (HBasicBlock* block : block_order) {
+    bool is_cold;
+    if (block->IsEntryBlock() || block->IsExitBlock()) {
+      is_cold = false;
+    } else if (block->IsCatchBlock() || block->GetLastInstruction()->IsThrow()) {
+      is_cold = true;
+    } else {
+      // Back edges come from blocks not visited yet, and keep loop headers hot.
+      is_cold = !block->GetPredecessors().empty() &&
+          std::all_of(block->GetPredecessors().begin(),
+                      block->GetPredecessors().end(),
+                      [&](HBasicBlock* predecessor) {
+                        return cold_blocks.IsBitSet(predecessor->GetBlockId()) ||
+                               IsColdEdge(predecessor, block);
+                      });
+    }
+    if (is_cold) {
+      cold_blocks.SetBit(block->GetBlockId());
+      ++number_of_cold_blocks;
+    }
+  }
+  if (number_of_cold_blocks == 0u) {
+    return &block_order;
+  }
+
+  ArenaVector<HBasicBlock*>* layout =
+      new (allocator) ArenaVector<HBasicBlock*>(allocator->Adapter(kArenaAllocCodeGenerator));
+  layout->reserve(block_order.size());
+  for (HBasicBlock* block : block_order) {
+    if (!cold_blocks.IsBitSet(block->GetBlockId())) {
+      layout->push_back(block);
+    }
+  }
+  for (HBasicBlock* block : block_order) {
+    if (cold_blocks.IsBitSet(block->GetBlockId())) {
+      layout->push_back(block);
+    }
+  }
+  return layout;
+}
+
 void CodeGenerator::InitializeCodeGeneration(size_t number_of_spill_slots,
                                              size_t maximum_safepoint_spill_size,
                                              size_t number_of_out_slots,
                                              const ArenaVector<HBasicBlock*>& block_order) {
-  block_order_ = &block_order;
   DCHECK(!block_order.empty());
   DCHECK(block_order[0] == GetGraph()->GetEntryBlock());
+  block_order_ = ComputeCodeLayout(block_order);
+  DCHECK_EQ(block_order_->size(), block_order.size());
   ComputeSpillMask();
   first_register_slot_in_slow_path_ = RoundUp(
       (number_of_out_slots + number_of_spill_slots) * kVRegSize, GetPreferredSlotsAlignment());
@@ -1826,7 +1911,19 @@ void CodeGenerator::EmitJitRoots(uint8_t* code,
   EmitJitRootPatches(code, roots_data);
 }
 
+QuickEntrypointEnum CodeGenerator::GetNewInstanceEntrypoint(HNewInstance* new_instance) {
+  if (new_instance->IsPretenured()) {
+    // The pretenured entrypoint does all the checks of kQuickAllocObjectWithChecks.
+    DCHECK(!new_instance->IsStringAlloc());
+    return kQuickAllocObjectPretenured;
+  }
+  return new_instance->GetEntrypoint();
+}
+
 QuickEntrypointEnum CodeGenerator::GetArrayAllocationEntrypoint(HNewArray* new_array) {
+  if (new_array->IsPretenured()) {
+    return kQuickAllocArrayPretenured;
+  }
   switch (new_array->GetComponentSizeShift()) {
     case 0: return kQuickAllocArrayResolved8;
     case 1: return kQuickAllocArrayResolved16;
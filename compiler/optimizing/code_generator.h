@@ -379,6 +379,7 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
   void RecordCatchBlockInfo();
 
   const CompilerOptions& GetCompilerOptions() const { return compiler_options_; }
+  OptimizingCompilerStats* GetCompilationStats() const { return stats_; }
   bool EmitReadBarrier() const;
   bool EmitBakerReadBarrier() const;
   bool EmitNonBakerReadBarrier() const;
@@ -726,6 +727,7 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
 
   virtual void GenerateNop() = 0;
 
+  static QuickEntrypointEnum GetNewInstanceEntrypoint(HNewInstance* new_instance);
   static QuickEntrypointEnum GetArrayAllocationEntrypoint(HNewArray* new_array);
   static ScaleFactor ScaleFactorForType(DataType::Type type);
 
@@ -835,6 +837,10 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
   void ReserveJitClassRoot(TypeReference type_reference, Handle<mirror::Class> klass);
   uint64_t GetJitClassRootIndex(TypeReference type_reference);
 
+  // Return the address of the slot of the callee of `invoke` in the JIT entry point table
+  // of its dex file. Only applies to `CodePtrLocation::kCallEntryPointTable`.
+  uint64_t GetJitEntryPointSlotAddress(HInvokeStaticOrDirect* invoke);
+
   // Emit the patches assocatied with JIT roots. Only applies to JIT compiled code.
   virtual void EmitJitRootPatches(uint8_t* code, const uint8_t* roots_data);
 
@@ -858,13 +864,15 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
   const uint32_t core_callee_save_mask_;
   const uint32_t fpu_callee_save_mask_;
 
-  // The order to use for code generation.
+  // The order to use for code generation. This is the linear order of the
+  // register allocator, with cold blocks moved after the hot ones.
   const ArenaVector<HBasicBlock*>* block_order_;
 
   DisassemblyInformation* disasm_info_;
 
  private:
   void InitializeCodeGenerationData();
+  const ArenaVector<HBasicBlock*>* ComputeCodeLayout(const ArenaVector<HBasicBlock*>& block_order);
   size_t GetStackOffsetOfSavedRegister(size_t index);
   void GenerateSlowPaths();
   void BlockIfInRegister(Location location, bool is_out = false) const;
@@ -917,6 +925,7 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
   // Which intrinsics we don't have handcrafted code for.
   art::ArrayRef<const bool> unimplemented_intrinsics_;
 
+  friend class CodegenTest;
   friend class OptimizingCFITest;
   ART_FRIEND_TEST(CodegenTest, ARM64FrameSizeSIMD);
   ART_FRIEND_TEST(CodegenTest, ARM64FrameSizeNoSIMD);
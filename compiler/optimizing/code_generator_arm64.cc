@@ -4719,12 +4719,18 @@ void CodeGeneratorARM64::MaybeGenerateInlineCacheCheck(HInstruction* instruction
         info, GetCompilerOptions(), instruction->AsInvoke());
     if (cache != nullptr) {
       uint64_t address = reinterpret_cast64<uint64_t>(cache);
-      vixl::aarch64::Label done;
+      vixl::aarch64::Label done, update;
       __ Mov(x8, address);
       __ Ldr(w9, MemOperand(x8, InlineCache::ClassesOffset().Int32Value()));
-      // Fast path for a monomorphic cache.
+      // Fast path for a monomorphic cache. The receiver count is approximate, so we
+      // don't need an atomic increment.
       __ Cmp(klass.W(), w9);
-      __ B(eq, &done);
+      __ B(ne, &update);
+      __ Ldr(w9, MemOperand(x8, InlineCache::CountsOffset().Int32Value()));
+      __ Add(w9, w9, 1);
+      __ Str(w9, MemOperand(x8, InlineCache::CountsOffset().Int32Value()));
+      __ B(&done);
+      __ Bind(&update);
       InvokeRuntime(kQuickUpdateInlineCache, instruction, instruction->GetDexPc());
       __ Bind(&done);
     } else {
@@ -5023,6 +5029,19 @@ void CodeGeneratorARM64::GenerateStaticOrDirectCall(
       call_lr();
       break;
     }
+    case CodePtrLocation::kCallEntryPointTable: {
+      // LR = *entry_point_slot, or callee_method->entry_point_from_quick_compiled_code_ if null.
+      vixl::aarch64::Label call;
+      __ Ldr(lr, jit_patches_.DeduplicateUint64Literal(GetJitEntryPointSlotAddress(invoke)));
+      __ Ldr(lr, MemOperand(lr));
+      __ Cbnz(lr, &call);
+      MemberOffset offset = ArtMethod::EntryPointFromQuickCompiledCodeOffset(kArm64PointerSize);
+      __ Ldr(lr, MemOperand(XRegisterFrom(callee_method), offset.Int32Value()));
+      __ Bind(&call);
+      // lr()
+      call_lr();
+      break;
+    }
   }
 
   DCHECK(!IsLeafMethod());
@@ -5997,7 +6016,8 @@ void LocationsBuilderARM64::VisitNewInstance(HNewInstance* instruction) {
 }
 
 void InstructionCodeGeneratorARM64::VisitNewInstance(HNewInstance* instruction) {
-  codegen_->InvokeRuntime(instruction->GetEntrypoint(), instruction, instruction->GetDexPc());
+  QuickEntrypointEnum entrypoint = CodeGenerator::GetNewInstanceEntrypoint(instruction);
+  codegen_->InvokeRuntime(entrypoint, instruction, instruction->GetDexPc());
   CheckEntrypointTypes<kQuickAllocObjectWithChecks, void*, mirror::Class*>();
   codegen_->MaybeGenerateMarkingRegisterCheck(/* code= */ __LINE__);
 }
@@ -5666,7 +5666,8 @@ void LocationsBuilderARMVIXL::VisitNewInstance(HNewInstance* instruction) {
 }
 
 void InstructionCodeGeneratorARMVIXL::VisitNewInstance(HNewInstance* instruction) {
-  codegen_->InvokeRuntime(instruction->GetEntrypoint(), instruction, instruction->GetDexPc());
+  QuickEntrypointEnum entrypoint = CodeGenerator::GetNewInstanceEntrypoint(instruction);
+  codegen_->InvokeRuntime(entrypoint, instruction, instruction->GetDexPc());
   CheckEntrypointTypes<kQuickAllocObjectWithChecks, void*, mirror::Class*>();
   codegen_->MaybeGenerateMarkingRegisterCheck(/* code= */ 12);
 }
@@ -9616,6 +9617,10 @@ void CodeGeneratorARMVIXL::GenerateStaticOrDirectCall(
     case CodePtrLocation::kCallArtMethod:
       call_code_pointer_member(ArtMethod::EntryPointFromQuickCompiledCodeOffset(kArmPointerSize));
       break;
+    case CodePtrLocation::kCallEntryPointTable:
+      // Only selected by `Jit::CanCallThroughEntryPointTable()` on arm64 and x86-64.
+      LOG(FATAL) << "Unsupported code pointer location: kCallEntryPointTable";
+      UNREACHABLE();
   }
 
   DCHECK(!IsLeafMethod());
@@ -4759,7 +4759,8 @@ void LocationsBuilderRISCV64::VisitNewInstance(HNewInstance* instruction) {
 }
 
 void InstructionCodeGeneratorRISCV64::VisitNewInstance(HNewInstance* instruction) {
-  codegen_->InvokeRuntime(instruction->GetEntrypoint(), instruction, instruction->GetDexPc());
+  QuickEntrypointEnum entrypoint = CodeGenerator::GetNewInstanceEntrypoint(instruction);
+  codegen_->InvokeRuntime(entrypoint, instruction, instruction->GetDexPc());
   CheckEntrypointTypes<kQuickAllocObjectWithChecks, void*, mirror::Class*>();
 }
 
@@ -6898,6 +6899,10 @@ void CodeGeneratorRISCV64::GenerateStaticOrDirectCall(HInvokeStaticOrDirect* inv
       __ Jalr(RA);
       RecordPcInfo(invoke, invoke->GetDexPc(), slow_path);
       break;
+    case CodePtrLocation::kCallEntryPointTable:
+      // Only selected by `Jit::CanCallThroughEntryPointTable()` on arm64 and x86-64.
+      LOG(FATAL) << "Unsupported code pointer location: kCallEntryPointTable";
+      UNREACHABLE();
     case CodePtrLocation::kCallCriticalNative: {
       size_t out_frame_size =
           PrepareCriticalNativeCall<CriticalNativeCallingConventionVisitorRiscv64,
@@ -25,6 +25,12 @@ namespace x86_64 {
 // NOLINT on __ macro to suppress wrong warning/fix (misc-macro-parentheses) from clang-tidy.
 #define __ down_cast<X86_64Assembler*>(GetAssembler())->  // NOLINT
 
+// Returns whether `instruction` operates on the full 256-bit YMM registers, which are
+// used for all vectors when AVX2 is available.
+static bool IsYmmVector(HVecOperation* instruction) {
+  return instruction->GetVectorNumberOfBytes() == 4 * kX86_64WordSize;
+}
+
 void LocationsBuilderX86_64::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
   LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
   HInstruction* input = instruction->InputAt(0);
@@ -59,12 +65,48 @@ void InstructionCodeGeneratorX86_64::VisitVecReplicateScalar(HVecReplicateScalar
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
 
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
-  // Shorthand for any type of zero.
+  // Shorthand for any type of zero. The VEX encoded form also clears the upper half.
   if (IsZeroBitPattern(instruction->InputAt(0))) {
     cpu_has_avx ? __ vxorps(dst, dst, dst) : __ xorps(dst, dst);
     return;
   }
 
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
+        __ vpbroadcastb(ymm_dst, dst);
+        return;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
+        __ vpbroadcastw(ymm_dst, dst);
+        return;
+      case DataType::Type::kInt32:
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
+        __ vpbroadcastd(ymm_dst, dst);
+        return;
+      case DataType::Type::kInt64:
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ true);
+        __ vpbroadcastq(ymm_dst, dst);
+        return;
+      case DataType::Type::kFloat32:
+        DCHECK(locations->InAt(0).Equals(locations->Out()));
+        __ vbroadcastss(ymm_dst, dst);
+        return;
+      case DataType::Type::kFloat64:
+        DCHECK(locations->InAt(0).Equals(locations->Out()));
+        __ vbroadcastsd(ymm_dst, dst);
+        return;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+  }
+
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -144,17 +186,17 @@ void InstructionCodeGeneratorX86_64::VisitVecExtractScalar(HVecExtractScalar* in
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
       UNREACHABLE();
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(IsYmmVector(instruction) ? 8u : 4u, instruction->GetVectorLength());
       __ movd(locations->Out().AsRegister<CpuRegister>(), src, /*64-bit*/ false);
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(IsYmmVector(instruction) ? 4u : 2u, instruction->GetVectorLength());
       __ movd(locations->Out().AsRegister<CpuRegister>(), src, /*64-bit*/ true);
       break;
     case DataType::Type::kFloat32:
     case DataType::Type::kFloat64:
       DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 4u);
+      DCHECK_LE(instruction->GetVectorLength(), 8u);
       DCHECK(locations->InAt(0).Equals(locations->Out()));  // no code required
       break;
     default:
@@ -187,8 +229,9 @@ static void CreateVecUnOpLocations(ArenaAllocator* allocator, HVecUnaryOperation
 
 void LocationsBuilderX86_64::VisitVecReduce(HVecReduce* instruction) {
   CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
-  // Long reduction or min/max require a temporary.
+  // Long reduction, 256-bit reduction or min/max require a temporary.
   if (instruction->GetPackedType() == DataType::Type::kInt64 ||
+      IsYmmVector(instruction) ||
       instruction->GetReductionKind() == HVecReduce::kMin ||
       instruction->GetReductionKind() == HVecReduce::kMax) {
     instruction->GetLocations()->AddTemp(Location::RequiresFpuRegister());
@@ -201,10 +244,17 @@ void InstructionCodeGeneratorX86_64::VisitVecReduce(HVecReduce* instruction) {
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(IsYmmVector(instruction) ? 8u : 4u, instruction->GetVectorLength());
       switch (instruction->GetReductionKind()) {
         case HVecReduce::kSum:
-          __ movaps(dst, src);
+          if (IsYmmVector(instruction)) {
+            // Add the upper half to the lower half first.
+            XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+            __ vextracti128(tmp, YmmRegister(src), Immediate(1));
+            __ vpaddd(dst, src, tmp);
+          } else {
+            __ movaps(dst, src);
+          }
           __ phaddd(dst, dst);
           __ phaddd(dst, dst);
           break;
@@ -216,12 +266,18 @@ void InstructionCodeGeneratorX86_64::VisitVecReduce(HVecReduce* instruction) {
       }
       break;
     case DataType::Type::kInt64: {
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(IsYmmVector(instruction) ? 4u : 2u, instruction->GetVectorLength());
       XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
       switch (instruction->GetReductionKind()) {
         case HVecReduce::kSum:
-          __ movaps(tmp, src);
-          __ movaps(dst, src);
+          if (IsYmmVector(instruction)) {
+            // Add the upper half to the lower half first.
+            __ vextracti128(tmp, YmmRegister(src), Immediate(1));
+            __ vpaddq(dst, src, tmp);
+          } else {
+            __ movaps(dst, src);
+          }
+          __ movaps(tmp, dst);
           __ punpckhqdq(tmp, tmp);
           __ paddq(dst, tmp);
           break;
@@ -247,7 +303,11 @@ void InstructionCodeGeneratorX86_64::VisitVecCnv(HVecCnv* instruction) {
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DataType::Type from = instruction->GetInputType();
   DataType::Type to = instruction->GetResultType();
-  if (from == DataType::Type::kInt32 && to == DataType::Type::kFloat32) {
+  if (from == DataType::Type::kInt32 && to == DataType::Type::kFloat32 &&
+      IsYmmVector(instruction)) {
+    DCHECK_EQ(8u, instruction->GetVectorLength());
+    __ vcvtdq2ps(YmmRegister(dst), YmmRegister(src));
+  } else if (from == DataType::Type::kInt32 && to == DataType::Type::kFloat32) {
     DCHECK_EQ(4u, instruction->GetVectorLength());
     __ cvtdq2ps(dst, src);
   } else {
@@ -263,6 +323,41 @@ void InstructionCodeGeneratorX86_64::VisitVecNeg(HVecNeg* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_src(src);
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        __ vpxor(ymm_dst, ymm_dst, ymm_dst);
+        __ vpsubb(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpxor(ymm_dst, ymm_dst, ymm_dst);
+        __ vpsubw(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kInt32:
+        __ vpxor(ymm_dst, ymm_dst, ymm_dst);
+        __ vpsubd(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kInt64:
+        __ vpxor(ymm_dst, ymm_dst, ymm_dst);
+        __ vpsubq(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kFloat32:
+        __ vxorps(ymm_dst, ymm_dst, ymm_dst);
+        __ vsubps(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kFloat64:
+        __ vxorpd(ymm_dst, ymm_dst, ymm_dst);
+        __ vsubpd(ymm_dst, ymm_dst, ymm_src);
+        return;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
@@ -314,6 +409,28 @@ void InstructionCodeGeneratorX86_64::VisitVecAbs(HVecAbs* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_src(src);
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kInt32:
+        __ vpabsd(ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kFloat32:
+        __ vpcmpeqb(ymm_dst, ymm_dst, ymm_dst);  // all ones
+        __ vpsrld(ymm_dst, ymm_dst, Immediate(1));
+        __ vandps(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kFloat64:
+        __ vpcmpeqb(ymm_dst, ymm_dst, ymm_dst);  // all ones
+        __ vpsrlq(ymm_dst, ymm_dst, Immediate(1));
+        __ vandpd(ymm_dst, ymm_dst, ymm_src);
+        return;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt32: {
       DCHECK_EQ(4u, instruction->GetVectorLength());
@@ -355,6 +472,40 @@ void InstructionCodeGeneratorX86_64::VisitVecNot(HVecNot* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_src(src);
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool: {  // special case boolean-not
+        YmmRegister ymm_tmp(locations->GetTemp(0).AsFpuRegister<XmmRegister>());
+        __ vpxor(ymm_dst, ymm_dst, ymm_dst);
+        __ vpcmpeqb(ymm_tmp, ymm_tmp, ymm_tmp);  // all ones
+        __ vpsubb(ymm_dst, ymm_dst, ymm_tmp);  // 32 x one
+        __ vpxor(ymm_dst, ymm_dst, ymm_src);
+        return;
+      }
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vpcmpeqb(ymm_dst, ymm_dst, ymm_dst);  // all ones
+        __ vpxor(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kFloat32:
+        __ vpcmpeqb(ymm_dst, ymm_dst, ymm_dst);  // all ones
+        __ vxorps(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kFloat64:
+        __ vpcmpeqb(ymm_dst, ymm_dst, ymm_dst);  // all ones
+        __ vxorpd(ymm_dst, ymm_dst, ymm_src);
+        return;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool: {  // special case boolean-not
       DCHECK_EQ(16u, instruction->GetVectorLength());
@@ -452,6 +603,36 @@ void InstructionCodeGeneratorX86_64::VisitVecAdd(HVecAdd* instruction) {
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_src(src);
+    YmmRegister ymm_other_src(other_src);
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        __ vpaddb(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpaddw(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      case DataType::Type::kInt32:
+        __ vpaddd(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      case DataType::Type::kInt64:
+        __ vpaddq(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      case DataType::Type::kFloat32:
+        __ vaddps(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      case DataType::Type::kFloat64:
+        __ vaddpd(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
@@ -494,6 +675,27 @@ void InstructionCodeGeneratorX86_64::VisitVecSaturationAdd(HVecSaturationAdd* in
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_src(src);
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+        __ vpaddusb(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kInt8:
+        __ vpaddsb(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kUint16:
+        __ vpaddusw(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kInt16:
+        __ vpaddsw(ymm_dst, ymm_dst, ymm_src);
+        return;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
       DCHECK_EQ(16u, instruction->GetVectorLength());
@@ -529,6 +731,22 @@ void InstructionCodeGeneratorX86_64::VisitVecHalvingAdd(HVecHalvingAdd* instruct
 
   DCHECK(instruction->IsRounded());
 
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_src(src);
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+        __ vpavgb(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kUint16:
+        __ vpavgw(ymm_dst, ymm_dst, ymm_src);
+        return;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+  }
+
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
       DCHECK_EQ(16u, instruction->GetVectorLength());
@@ -559,6 +777,36 @@ void InstructionCodeGeneratorX86_64::VisitVecSub(HVecSub* instruction) {
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_src(src);
+    YmmRegister ymm_other_src(other_src);
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        __ vpsubb(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpsubw(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      case DataType::Type::kInt32:
+        __ vpsubd(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      case DataType::Type::kInt64:
+        __ vpsubq(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      case DataType::Type::kFloat32:
+        __ vsubps(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      case DataType::Type::kFloat64:
+        __ vsubpd(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
@@ -601,6 +849,27 @@ void InstructionCodeGeneratorX86_64::VisitVecSaturationSub(HVecSaturationSub* in
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_src(src);
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+        __ vpsubusb(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kInt8:
+        __ vpsubsb(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kUint16:
+        __ vpsubusw(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kInt16:
+        __ vpsubsw(ymm_dst, ymm_dst, ymm_src);
+        return;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
       DCHECK_EQ(16u, instruction->GetVectorLength());
@@ -639,6 +908,29 @@ void InstructionCodeGeneratorX86_64::VisitVecMul(HVecMul* instruction) {
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_src(src);
+    YmmRegister ymm_other_src(other_src);
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpmullw(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      case DataType::Type::kInt32:
+        __ vpmulld(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      case DataType::Type::kFloat32:
+        __ vmulps(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      case DataType::Type::kFloat64:
+        __ vmulpd(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
@@ -678,6 +970,22 @@ void InstructionCodeGeneratorX86_64::VisitVecDiv(HVecDiv* instruction) {
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_src(src);
+    YmmRegister ymm_other_src(other_src);
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kFloat32:
+        __ vdivps(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      case DataType::Type::kFloat64:
+        __ vdivpd(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kFloat32:
       DCHECK_EQ(4u, instruction->GetVectorLength());
@@ -702,6 +1010,40 @@ void InstructionCodeGeneratorX86_64::VisitVecMin(HVecMin* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_src(src);
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+        __ vpminub(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kInt8:
+        __ vpminsb(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kUint16:
+        __ vpminuw(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kInt16:
+        __ vpminsw(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kUint32:
+        __ vpminud(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kInt32:
+        __ vpminsd(ymm_dst, ymm_dst, ymm_src);
+        return;
+      // Next cases are sloppy wrt 0.0 vs -0.0.
+      case DataType::Type::kFloat32:
+        __ vminps(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kFloat64:
+        __ vminpd(ymm_dst, ymm_dst, ymm_src);
+        return;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
       DCHECK_EQ(16u, instruction->GetVectorLength());
@@ -751,6 +1093,40 @@ void InstructionCodeGeneratorX86_64::VisitVecMax(HVecMax* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_src(src);
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+        __ vpmaxub(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kInt8:
+        __ vpmaxsb(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kUint16:
+        __ vpmaxuw(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kInt16:
+        __ vpmaxsw(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kUint32:
+        __ vpmaxud(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kInt32:
+        __ vpmaxsd(ymm_dst, ymm_dst, ymm_src);
+        return;
+      // Next cases are sloppy wrt 0.0 vs -0.0.
+      case DataType::Type::kFloat32:
+        __ vmaxps(ymm_dst, ymm_dst, ymm_src);
+        return;
+      case DataType::Type::kFloat64:
+        __ vmaxpd(ymm_dst, ymm_dst, ymm_src);
+        return;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
       DCHECK_EQ(16u, instruction->GetVectorLength());
@@ -806,6 +1182,31 @@ void InstructionCodeGeneratorX86_64::VisitVecAnd(HVecAnd* instruction) {
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_src(src);
+    YmmRegister ymm_other_src(other_src);
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vpand(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      case DataType::Type::kFloat32:
+        __ vandps(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      case DataType::Type::kFloat64:
+        __ vandpd(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -847,6 +1248,31 @@ void InstructionCodeGeneratorX86_64::VisitVecAndNot(HVecAndNot* instruction) {
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_src(src);
+    YmmRegister ymm_other_src(other_src);
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vpandn(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      case DataType::Type::kFloat32:
+        __ vandnps(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      case DataType::Type::kFloat64:
+        __ vandnpd(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -888,6 +1314,31 @@ void InstructionCodeGeneratorX86_64::VisitVecOr(HVecOr* instruction) {
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_src(src);
+    YmmRegister ymm_other_src(other_src);
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vpor(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      case DataType::Type::kFloat32:
+        __ vorps(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      case DataType::Type::kFloat64:
+        __ vorpd(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -929,6 +1380,31 @@ void InstructionCodeGeneratorX86_64::VisitVecXor(HVecXor* instruction) {
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_src(src);
+    YmmRegister ymm_other_src(other_src);
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vpxor(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      case DataType::Type::kFloat32:
+        __ vxorps(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      case DataType::Type::kFloat64:
+        __ vxorpd(ymm_dst, ymm_other_src, ymm_src);
+        return;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -982,6 +1458,24 @@ void InstructionCodeGeneratorX86_64::VisitVecShl(HVecShl* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpsllw(ymm_dst, ymm_dst, Immediate(static_cast<int8_t>(value)));
+        return;
+      case DataType::Type::kInt32:
+        __ vpslld(ymm_dst, ymm_dst, Immediate(static_cast<int8_t>(value)));
+        return;
+      case DataType::Type::kInt64:
+        __ vpsllq(ymm_dst, ymm_dst, Immediate(static_cast<int8_t>(value)));
+        return;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
@@ -1011,6 +1505,21 @@ void InstructionCodeGeneratorX86_64::VisitVecShr(HVecShr* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpsraw(ymm_dst, ymm_dst, Immediate(static_cast<int8_t>(value)));
+        return;
+      case DataType::Type::kInt32:
+        __ vpsrad(ymm_dst, ymm_dst, Immediate(static_cast<int8_t>(value)));
+        return;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
@@ -1036,6 +1545,24 @@ void InstructionCodeGeneratorX86_64::VisitVecUShr(HVecUShr* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsYmmVector(instruction)) {
+    YmmRegister ymm_dst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpsrlw(ymm_dst, ymm_dst, Immediate(static_cast<int8_t>(value)));
+        return;
+      case DataType::Type::kInt32:
+        __ vpsrld(ymm_dst, ymm_dst, Immediate(static_cast<int8_t>(value)));
+        return;
+      case DataType::Type::kInt64:
+        __ vpsrlq(ymm_dst, ymm_dst, Immediate(static_cast<int8_t>(value)));
+        return;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
@@ -1094,7 +1621,7 @@ void InstructionCodeGeneratorX86_64::VisitVecSetScalars(HVecSetScalars* instruct
 
   DCHECK_EQ(1u, instruction->InputCount());  // only one input currently implemented
 
-  // Zero out all other elements first.
+  // Zero out all other elements first. The VEX encoded form also clears the upper half.
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
   cpu_has_avx ? __ vxorps(dst, dst, dst) : __ xorps(dst, dst);
 
@@ -1113,19 +1640,19 @@ void InstructionCodeGeneratorX86_64::VisitVecSetScalars(HVecSetScalars* instruct
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
       UNREACHABLE();
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(IsYmmVector(instruction) ? 8u : 4u, instruction->GetVectorLength());
       __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>());
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(IsYmmVector(instruction) ? 4u : 2u, instruction->GetVectorLength());
       __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>());  // is 64-bit
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(IsYmmVector(instruction) ? 8u : 4u, instruction->GetVectorLength());
       __ movss(dst, locations->InAt(0).AsFpuRegister<XmmRegister>());
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(IsYmmVector(instruction) ? 4u : 2u, instruction->GetVectorLength());
       __ movsd(dst, locations->InAt(0).AsFpuRegister<XmmRegister>());
       break;
     default:
@@ -1190,8 +1717,14 @@ void InstructionCodeGeneratorX86_64::VisitVecDotProd(HVecDotProd* instruction) {
   XmmRegister right = locations->InAt(2).AsFpuRegister<XmmRegister>();
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt32: {
-      DCHECK_EQ(4u, instruction->GetVectorLength());
       XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+      if (IsYmmVector(instruction)) {
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpmaddwd(YmmRegister(tmp), YmmRegister(left), YmmRegister(right));
+        __ vpaddd(YmmRegister(acc), YmmRegister(acc), YmmRegister(tmp));
+        break;
+      }
+      DCHECK_EQ(4u, instruction->GetVectorLength());
       if (!cpu_has_avx) {
         __ movaps(tmp, right);
         __ pmaddwd(tmp, left);
@@ -1268,6 +1801,29 @@ void InstructionCodeGeneratorX86_64::VisitVecLoad(HVecLoad* instruction) {
   size_t size = DataType::Size(instruction->GetPackedType());
   Address address = VecAddress(locations, size, instruction->IsStringCharAt());
   XmmRegister reg = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsYmmVector(instruction)) {
+    DCHECK(!instruction->IsStringCharAt());
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vmovdqu(YmmRegister(reg), address);
+        return;
+      case DataType::Type::kFloat32:
+        __ vmovups(YmmRegister(reg), address);
+        return;
+      case DataType::Type::kFloat64:
+        __ vmovupd(YmmRegister(reg), address);
+        return;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+  }
   bool is_aligned16 = instruction->GetAlignment().IsAlignedAt(16);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt16:  // (short) s.charAt(.) can yield HVecLoad/Int16/StringCharAt.
@@ -1327,6 +1883,28 @@ void InstructionCodeGeneratorX86_64::VisitVecStore(HVecStore* instruction) {
   size_t size = DataType::Size(instruction->GetPackedType());
   Address address = VecAddress(locations, size, /*is_string_char_at*/ false);
   XmmRegister reg = locations->InAt(2).AsFpuRegister<XmmRegister>();
+  if (IsYmmVector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vmovdqu(address, YmmRegister(reg));
+        return;
+      case DataType::Type::kFloat32:
+        __ vmovups(address, YmmRegister(reg));
+        return;
+      case DataType::Type::kFloat64:
+        __ vmovupd(address, YmmRegister(reg));
+        return;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+  }
   bool is_aligned16 = instruction->GetAlignment().IsAlignedAt(16);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
@@ -5173,7 +5173,8 @@ void LocationsBuilderX86::VisitNewInstance(HNewInstance* instruction) {
 }
 
 void InstructionCodeGeneratorX86::VisitNewInstance(HNewInstance* instruction) {
-  codegen_->InvokeRuntime(instruction->GetEntrypoint(), instruction, instruction->GetDexPc());
+  QuickEntrypointEnum entrypoint = CodeGenerator::GetNewInstanceEntrypoint(instruction);
+  codegen_->InvokeRuntime(entrypoint, instruction, instruction->GetDexPc());
   CheckEntrypointTypes<kQuickAllocObjectWithChecks, void*, mirror::Class*>();
   DCHECK(!codegen_->IsLeafMethod());
 }
@@ -5627,6 +5628,10 @@ void CodeGeneratorX86::GenerateStaticOrDirectCall(
                           kX86PointerSize).Int32Value()));
       RecordPcInfo(invoke, invoke->GetDexPc(), slow_path);
       break;
+    case CodePtrLocation::kCallEntryPointTable:
+      // Only selected by `Jit::CanCallThroughEntryPointTable()` on arm64 and x86-64.
+      LOG(FATAL) << "Unsupported code pointer location: kCallEntryPointTable";
+      UNREACHABLE();
   }
 
   DCHECK(!IsLeafMethod());
@@ -1198,6 +1198,7 @@ void CodeGeneratorX86_64::GenerateStaticOrDirectCall(
     }
   }
 
+  MaybeEmitVzeroupper();
   switch (invoke->GetCodePtrLocation()) {
     case CodePtrLocation::kCallSelf:
       DCHECK(!GetGraph()->HasShouldDeoptimizeFlag());
@@ -1255,6 +1256,23 @@ void CodeGeneratorX86_64::GenerateStaticOrDirectCall(
                           kX86_64PointerSize).SizeValue()));
       RecordPcInfo(invoke, invoke->GetDexPc(), slow_path);
       break;
+    case CodePtrLocation::kCallEntryPointTable: {
+      // TMP = *entry_point_slot, or callee_method->entry_point_from_quick_compiled_code_ if null.
+      NearLabel call;
+      Load64BitValue(CpuRegister(TMP), static_cast<int64_t>(GetJitEntryPointSlotAddress(invoke)));
+      __ movq(CpuRegister(TMP), Address(CpuRegister(TMP), 0));
+      __ testq(CpuRegister(TMP), CpuRegister(TMP));
+      __ j(kNotEqual, &call);
+      __ movq(CpuRegister(TMP),
+              Address(callee_method.AsRegister<CpuRegister>(),
+                      ArtMethod::EntryPointFromQuickCompiledCodeOffset(
+                          kX86_64PointerSize).SizeValue()));
+      __ Bind(&call);
+      // TMP()
+      __ call(CpuRegister(TMP));
+      RecordPcInfo(invoke, invoke->GetDexPc(), slow_path);
+      break;
+    }
   }
 
   DCHECK(!IsLeafMethod());
@@ -1290,6 +1308,7 @@ void CodeGeneratorX86_64::GenerateVirtualCall(
 
   // temp = temp->GetMethodAt(method_offset);
   __ movq(temp, Address(temp, method_offset));
+  MaybeEmitVzeroupper();
   // call temp->GetEntryPoint();
   __ call(Address(temp, ArtMethod::EntryPointFromQuickCompiledCodeOffset(
       kX86_64PointerSize).SizeValue()));
@@ -1515,6 +1534,21 @@ const X86_64InstructionSetFeatures& CodeGeneratorX86_64::GetInstructionSetFeatur
   return *GetCompilerOptions().GetInstructionSetFeatures()->AsX86_64InstructionSetFeatures();
 }
 
+size_t CodeGeneratorX86_64::GetSIMDRegisterWidth() const {
+  // Vectorize with the 256-bit YMM registers when AVX2 is available.
+  return GetInstructionSetFeatures().HasAVX2() ? 4 * kX86_64WordSize : 2 * kX86_64WordSize;
+}
+
+bool CodeGeneratorX86_64::UsesYmmForSIMD() const {
+  return GetGraph()->HasSIMD() && GetSIMDRegisterWidth() == 4 * kX86_64WordSize;
+}
+
+void CodeGeneratorX86_64::MaybeEmitVzeroupper() {
+  if (UsesYmmForSIMD()) {
+    __ vzeroupper();
+  }
+}
+
 size_t CodeGeneratorX86_64::SaveCoreRegister(size_t stack_index, uint32_t reg_id) {
   __ movq(Address(CpuRegister(RSP), stack_index), CpuRegister(reg_id));
   return kX86_64WordSize;
@@ -1526,7 +1560,9 @@ size_t CodeGeneratorX86_64::RestoreCoreRegister(size_t stack_index, uint32_t reg
 }
 
 size_t CodeGeneratorX86_64::SaveFloatingPointRegister(size_t stack_index, uint32_t reg_id) {
-  if (GetGraph()->HasSIMD()) {
+  if (UsesYmmForSIMD()) {
+    __ vmovups(Address(CpuRegister(RSP), stack_index), YmmRegister(reg_id));
+  } else if (GetGraph()->HasSIMD()) {
     __ movups(Address(CpuRegister(RSP), stack_index), XmmRegister(reg_id));
   } else {
     __ movsd(Address(CpuRegister(RSP), stack_index), XmmRegister(reg_id));
@@ -1535,7 +1571,9 @@ size_t CodeGeneratorX86_64::SaveFloatingPointRegister(size_t stack_index, uint32
 }
 
 size_t CodeGeneratorX86_64::RestoreFloatingPointRegister(size_t stack_index, uint32_t reg_id) {
-  if (GetGraph()->HasSIMD()) {
+  if (UsesYmmForSIMD()) {
+    __ vmovups(YmmRegister(reg_id), Address(CpuRegister(RSP), stack_index));
+  } else if (GetGraph()->HasSIMD()) {
     __ movups(XmmRegister(reg_id), Address(CpuRegister(RSP), stack_index));
   } else {
     __ movsd(XmmRegister(reg_id), Address(CpuRegister(RSP), stack_index));
@@ -1562,6 +1600,7 @@ void CodeGeneratorX86_64::InvokeRuntimeWithoutRecordingPcInfo(int32_t entry_poin
 }
 
 void CodeGeneratorX86_64::GenerateInvokeRuntime(int32_t entry_point_offset) {
+  MaybeEmitVzeroupper();
   __ gs()->call(Address::Absolute(entry_point_offset, /* no_rip= */ true));
 }
 
@@ -1945,6 +1984,7 @@ void CodeGeneratorX86_64::GenerateFrameExit() {
       }
     }
   }
+  MaybeEmitVzeroupper();
   __ ret();
   __ cfi().RestoreState();
   __ cfi().DefCFAOffset(GetFrameSize());
@@ -3169,11 +3209,15 @@ void CodeGeneratorX86_64::MaybeGenerateInlineCacheCheck(HInstruction* instructio
         info, GetCompilerOptions(), instruction->AsInvoke());
     if (cache != nullptr) {
       uint64_t address = reinterpret_cast64<uint64_t>(cache);
-      NearLabel done;
+      NearLabel done, update;
       __ movq(CpuRegister(TMP), Immediate(address));
-      // Fast path for a monomorphic cache.
+      // Fast path for a monomorphic cache. The receiver count is approximate, so we
+      // don't need an atomic increment.
       __ cmpl(Address(CpuRegister(TMP), InlineCache::ClassesOffset().Int32Value()), klass);
-      __ j(kEqual, &done);
+      __ j(kNotEqual, &update);
+      __ addl(Address(CpuRegister(TMP), InlineCache::CountsOffset().Int32Value()), Immediate(1));
+      __ jmp(&done);
+      __ Bind(&update);
       GenerateInvokeRuntime(
           GetThreadOffset<kX86_64PointerSize>(kQuickUpdateInlineCache).Int32Value());
       __ Bind(&done);
@@ -3237,6 +3281,7 @@ void InstructionCodeGeneratorX86_64::VisitInvokeInterface(HInvokeInterface* invo
     Location hidden_reg = locations->GetTemp(1);
     __ movq(hidden_reg.AsRegister<CpuRegister>(), temp);
   }
+  codegen_->MaybeEmitVzeroupper();
   // call temp->GetEntryPoint();
   __ call(Address(
       temp, ArtMethod::EntryPointFromQuickCompiledCodeOffset(kX86_64PointerSize).SizeValue()));
@@ -5107,7 +5152,8 @@ void LocationsBuilderX86_64::VisitNewInstance(HNewInstance* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitNewInstance(HNewInstance* instruction) {
-  codegen_->InvokeRuntime(instruction->GetEntrypoint(), instruction, instruction->GetDexPc());
+  QuickEntrypointEnum entrypoint = CodeGenerator::GetNewInstanceEntrypoint(instruction);
+  codegen_->InvokeRuntime(entrypoint, instruction, instruction->GetDexPc());
   CheckEntrypointTypes<kQuickAllocObjectWithChecks, void*, mirror::Class*>();
   DCHECK(!codegen_->IsLeafMethod());
 }
@@ -6399,16 +6445,20 @@ void ParallelMoveResolverX86_64::EmitMove(size_t index) {
       __ movq(Address(CpuRegister(RSP), destination.GetStackIndex()), CpuRegister(TMP));
     }
   } else if (source.IsSIMDStackSlot()) {
-    if (destination.IsFpuRegister()) {
+    if (destination.IsFpuRegister() && codegen_->UsesYmmForSIMD()) {
+      __ vmovups(YmmRegister(destination.AsFpuRegister<XmmRegister>()),
+                 Address(CpuRegister(RSP), source.GetStackIndex()));
+    } else if (destination.IsFpuRegister()) {
       __ movups(destination.AsFpuRegister<XmmRegister>(),
                 Address(CpuRegister(RSP), source.GetStackIndex()));
     } else {
       DCHECK(destination.IsSIMDStackSlot());
-      size_t high = kX86_64WordSize;
-      __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex()));
-      __ movq(Address(CpuRegister(RSP), destination.GetStackIndex()), CpuRegister(TMP));
-      __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex() + high));
-      __ movq(Address(CpuRegister(RSP), destination.GetStackIndex() + high), CpuRegister(TMP));
+      for (size_t offset = 0, e = codegen_->GetSIMDRegisterWidth();
+           offset < e;
+           offset += kX86_64WordSize) {
+        __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex() + offset));
+        __ movq(Address(CpuRegister(RSP), destination.GetStackIndex() + offset), CpuRegister(TMP));
+      }
     }
   } else if (source.IsConstant()) {
     HConstant* constant = source.GetConstant();
@@ -6455,7 +6505,10 @@ void ParallelMoveResolverX86_64::EmitMove(size_t index) {
       }
     }
   } else if (source.IsFpuRegister()) {
-    if (destination.IsFpuRegister()) {
+    if (destination.IsFpuRegister() && codegen_->UsesYmmForSIMD()) {
+      __ vmovaps(YmmRegister(destination.AsFpuRegister<XmmRegister>()),
+                 YmmRegister(source.AsFpuRegister<XmmRegister>()));
+    } else if (destination.IsFpuRegister()) {
       __ movaps(destination.AsFpuRegister<XmmRegister>(), source.AsFpuRegister<XmmRegister>());
     } else if (destination.IsStackSlot()) {
       __ movss(Address(CpuRegister(RSP), destination.GetStackIndex()),
@@ -6463,6 +6516,10 @@ void ParallelMoveResolverX86_64::EmitMove(size_t index) {
     } else if (destination.IsDoubleStackSlot()) {
       __ movsd(Address(CpuRegister(RSP), destination.GetStackIndex()),
                source.AsFpuRegister<XmmRegister>());
+    } else if (codegen_->UsesYmmForSIMD()) {
+      DCHECK(destination.IsSIMDStackSlot());
+      __ vmovups(Address(CpuRegister(RSP), destination.GetStackIndex()),
+                 YmmRegister(source.AsFpuRegister<XmmRegister>()));
     } else {
        DCHECK(destination.IsSIMDStackSlot());
       __ movups(Address(CpuRegister(RSP), destination.GetStackIndex()),
@@ -6510,6 +6567,15 @@ void ParallelMoveResolverX86_64::Exchange128(XmmRegister reg, int mem) {
   __ addq(CpuRegister(RSP), Immediate(extra_slot));
 }
 
+void ParallelMoveResolverX86_64::Exchange256(XmmRegister reg, int mem) {
+  size_t extra_slot = 4 * kX86_64WordSize;
+  __ subq(CpuRegister(RSP), Immediate(extra_slot));
+  __ vmovups(Address(CpuRegister(RSP), 0), YmmRegister(reg));
+  ExchangeMemory64(0, mem + extra_slot, 4);
+  __ vmovups(YmmRegister(reg), Address(CpuRegister(RSP), 0));
+  __ addq(CpuRegister(RSP), Immediate(extra_slot));
+}
+
 void ParallelMoveResolverX86_64::ExchangeMemory32(int mem1, int mem2) {
   ScratchRegisterScope ensure_scratch(
       this, TMP, RAX, codegen_->GetNumberOfCoreRegisters());
@@ -6562,6 +6628,14 @@ void ParallelMoveResolverX86_64::EmitSwap(size_t index) {
     Exchange64(destination.AsRegister<CpuRegister>(), source.GetStackIndex());
   } else if (source.IsDoubleStackSlot() && destination.IsDoubleStackSlot()) {
     ExchangeMemory64(destination.GetStackIndex(), source.GetStackIndex(), 1);
+  } else if (source.IsFpuRegister() && destination.IsFpuRegister() &&
+             codegen_->UsesYmmForSIMD()) {
+    // Swap the full YMM registers, which may hold vectors.
+    YmmRegister first(source.AsFpuRegister<XmmRegister>());
+    YmmRegister second(destination.AsFpuRegister<XmmRegister>());
+    __ vxorps(first, first, second);
+    __ vxorps(second, second, first);
+    __ vxorps(first, first, second);
   } else if (source.IsFpuRegister() && destination.IsFpuRegister()) {
     __ movd(CpuRegister(TMP), source.AsFpuRegister<XmmRegister>());
     __ movaps(source.AsFpuRegister<XmmRegister>(), destination.AsFpuRegister<XmmRegister>());
@@ -6575,11 +6649,21 @@ void ParallelMoveResolverX86_64::EmitSwap(size_t index) {
   } else if (source.IsDoubleStackSlot() && destination.IsFpuRegister()) {
     Exchange64(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
   } else if (source.IsSIMDStackSlot() && destination.IsSIMDStackSlot()) {
-    ExchangeMemory64(destination.GetStackIndex(), source.GetStackIndex(), 2);
+    ExchangeMemory64(destination.GetStackIndex(),
+                     source.GetStackIndex(),
+                     static_cast<int>(codegen_->GetSIMDRegisterWidth() / kX86_64WordSize));
   } else if (source.IsFpuRegister() && destination.IsSIMDStackSlot()) {
-    Exchange128(source.AsFpuRegister<XmmRegister>(), destination.GetStackIndex());
+    if (codegen_->UsesYmmForSIMD()) {
+      Exchange256(source.AsFpuRegister<XmmRegister>(), destination.GetStackIndex());
+    } else {
+      Exchange128(source.AsFpuRegister<XmmRegister>(), destination.GetStackIndex());
+    }
   } else if (destination.IsFpuRegister() && source.IsSIMDStackSlot()) {
-    Exchange128(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
+    if (codegen_->UsesYmmForSIMD()) {
+      Exchange256(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
+    } else {
+      Exchange128(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
+    }
   } else {
     LOG(FATAL) << "Unimplemented swap between " << source << " and " << destination;
   }
@@ -207,6 +207,7 @@ class ParallelMoveResolverX86_64 : public ParallelMoveResolverWithSwap {
   void Exchange64(CpuRegister reg, int mem);
   void Exchange64(XmmRegister reg, int mem);
   void Exchange128(XmmRegister reg, int mem);
+  void Exchange256(XmmRegister reg, int mem);
   void ExchangeMemory32(int mem1, int mem2);
   void ExchangeMemory64(int mem1, int mem2, int num_of_qwords);
 
@@ -430,9 +431,16 @@ class CodeGeneratorX86_64 : public CodeGenerator {
     return 1 * kX86_64WordSize;
   }
 
-  size_t GetSIMDRegisterWidth() const override {
-    return 2 * kX86_64WordSize;
-  }
+  size_t GetSIMDRegisterWidth() const override;
+
+  // Whether the SIMD values of the graph use the full 256-bit YMM registers.
+  bool UsesYmmForSIMD() const;
+
+  // Clears the upper halves of the YMM registers before leaving code which uses them, so that
+  // the SSE code of the callee or caller does not pay for the AVX-SSE state transition. All
+  // live 256-bit values have been saved at this point, as no FP register keeps more than its
+  // low 64 bits across a call.
+  void MaybeEmitVzeroupper();
 
   HGraphVisitor* GetLocationBuilder() override {
     return &location_builder_;
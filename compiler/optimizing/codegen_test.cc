@@ -73,6 +73,15 @@ class CodegenTest : public CommonCompilerTest, public OptimizingUnitTestHelper {
                       int64_t j,
                       DataType::Type type,
                       const CodegenTargetConfig target_config);
+
+  static const ArenaVector<HBasicBlock*>& ComputeCodeLayout(
+      CodeGenerator* codegen, const ArenaVector<HBasicBlock*>& block_order) {
+    return *codegen->ComputeCodeLayout(block_order);
+  }
+
+  static const ArenaVector<HBasicBlock*>& GetCodeLayout(CodeGenerator* codegen) {
+    return *codegen->block_order_;
+  }
 };
 
 void CodegenTest::TestCode(const std::vector<uint16_t>& data, bool has_result, int32_t expected) {
@@ -715,6 +724,177 @@ TEST_F(CodegenTest, ComparisonsLong) {
   }
 }
 
+// Catch blocks, throwing blocks and blocks only reached through branches the profile
+// never saw taken are emitted after the other blocks, in their original order.
+TEST_F(CodegenTest, CodeLayoutMovesColdBlocksLast) {
+  for (CodegenTargetConfig target_config : GetTargetConfigs()) {
+    ResetPoolAndAllocator();
+    HGraph* graph = CreateGraph();
+    auto add_block = [&]() {
+      HBasicBlock* block = new (GetAllocator()) HBasicBlock(graph);
+      graph->AddBlock(block);
+      return block;
+    };
+
+    HBasicBlock* entry = add_block();
+    HBasicBlock* try_entry = add_block();
+    HBasicBlock* first = add_block();
+    HBasicBlock* throw_block = add_block();
+    HBasicBlock* second = add_block();
+    HBasicBlock* cold_block = add_block();
+    HBasicBlock* cold_successor = add_block();
+    HBasicBlock* hot_block = add_block();
+    HBasicBlock* catch_block = add_block();
+    HBasicBlock* return_block = add_block();
+    HBasicBlock* exit = add_block();
+    graph->SetEntryBlock(entry);
+    graph->SetExitBlock(exit);
+
+    HParameterValue* value = new (GetAllocator()) HParameterValue(
+        graph->GetDexFile(), dex::TypeIndex(0), 0, DataType::Type::kInt32);
+    HParameterValue* exception = new (GetAllocator()) HParameterValue(
+        graph->GetDexFile(), dex::TypeIndex(1), 1, DataType::Type::kReference);
+    entry->AddInstruction(value);
+    entry->AddInstruction(exception);
+    entry->AddInstruction(new (GetAllocator()) HGoto());
+    HIntConstant* constant0 = graph->GetIntConstant(0);
+    HIntConstant* constant1 = graph->GetIntConstant(1);
+
+    try_entry->AddInstruction(
+        new (GetAllocator()) HTryBoundary(HTryBoundary::BoundaryKind::kEntry));
+    catch_block->SetTryCatchInformation(
+        new (GetAllocator()) TryCatchInformation(dex::TypeIndex::Invalid(), graph->GetDexFile()));
+    catch_block->AddInstruction(new (GetAllocator()) HReturn(constant1));
+
+    HEqual* is_zero = new (GetAllocator()) HEqual(value, constant0);
+    first->AddInstruction(is_zero);
+    first->AddInstruction(new (GetAllocator()) HIf(is_zero));
+    throw_block->AddInstruction(new (GetAllocator()) HThrow(exception, 0u));
+
+    HEqual* is_one = new (GetAllocator()) HEqual(value, constant1);
+    second->AddInstruction(is_one);
+    HIf* profiled_if = new (GetAllocator()) HIf(is_one);
+    profiled_if->SetTrueCount(0u);
+    profiled_if->SetFalseCount(100u);
+    second->AddInstruction(profiled_if);
+    cold_block->AddInstruction(new (GetAllocator()) HGoto());
+    cold_successor->AddInstruction(new (GetAllocator()) HGoto());
+    hot_block->AddInstruction(new (GetAllocator()) HGoto());
+    return_block->AddInstruction(new (GetAllocator()) HReturn(constant0));
+    exit->AddInstruction(new (GetAllocator()) HExit());
+
+    entry->AddSuccessor(try_entry);
+    try_entry->AddSuccessor(first);
+    try_entry->AddSuccessor(catch_block);
+    first->AddSuccessor(throw_block);
+    first->AddSuccessor(second);
+    throw_block->AddSuccessor(exit);
+    second->AddSuccessor(cold_block);
+    second->AddSuccessor(hot_block);
+    cold_block->AddSuccessor(cold_successor);
+    cold_successor->AddSuccessor(return_block);
+    hot_block->AddSuccessor(return_block);
+    catch_block->AddSuccessor(exit);
+    return_block->AddSuccessor(exit);
+
+    ArenaVector<HBasicBlock*> block_order(GetAllocator()->Adapter());
+    block_order.assign({entry,
+                        try_entry,
+                        first,
+                        throw_block,
+                        second,
+                        cold_block,
+                        cold_successor,
+                        hot_block,
+                        catch_block,
+                        return_block,
+                        exit});
+
+    std::unique_ptr<CompilerOptions> compiler_options =
+        CommonCompilerTest::CreateCompilerOptions(target_config.GetInstructionSet(), "default");
+    std::unique_ptr<CodeGenerator> codegen(
+        target_config.CreateCodeGenerator(graph, *compiler_options));
+    const ArenaVector<HBasicBlock*>& layout = ComputeCodeLayout(codegen.get(), block_order);
+    std::vector<HBasicBlock*> expected = {entry,
+                                          try_entry,
+                                          first,
+                                          second,
+                                          hot_block,
+                                          return_block,
+                                          exit,
+                                          throw_block,
+                                          cold_block,
+                                          cold_successor,
+                                          catch_block};
+    EXPECT_EQ(std::vector<HBasicBlock*>(layout.begin(), layout.end()), expected);
+  }
+}
+
+// Generated code which goes through a cold block, or jumps over it, still computes
+// the right value, whichever side of the branch the profile marks as cold.
+TEST_F(CodegenTest, CodeLayoutFallThrough) {
+  for (CodegenTargetConfig target_config : GetTargetConfigs()) {
+    for (bool true_side_is_cold : { false, true }) {
+      ResetPoolAndAllocator();
+      HGraph* graph = CreateGraph();
+
+      HBasicBlock* entry = new (GetAllocator()) HBasicBlock(graph);
+      graph->AddBlock(entry);
+      graph->SetEntryBlock(entry);
+      entry->AddInstruction(new (GetAllocator()) HGoto());
+
+      HBasicBlock* first_block = new (GetAllocator()) HBasicBlock(graph);
+      graph->AddBlock(first_block);
+      entry->AddSuccessor(first_block);
+      HIntConstant* constant0 = graph->GetIntConstant(0);
+      HIntConstant* constant2 = graph->GetIntConstant(2);
+      HIntConstant* constant3 = graph->GetIntConstant(3);
+      HEqual* equal = new (GetAllocator()) HEqual(constant0, constant0);
+      first_block->AddInstruction(equal);
+      HIf* if_instruction = new (GetAllocator()) HIf(equal);
+      if_instruction->SetTrueCount(true_side_is_cold ? 0u : 100u);
+      if_instruction->SetFalseCount(true_side_is_cold ? 100u : 0u);
+      first_block->AddInstruction(if_instruction);
+
+      HBasicBlock* then_block = new (GetAllocator()) HBasicBlock(graph);
+      HBasicBlock* else_block = new (GetAllocator()) HBasicBlock(graph);
+      HBasicBlock* merge_block = new (GetAllocator()) HBasicBlock(graph);
+      HBasicBlock* exit_block = new (GetAllocator()) HBasicBlock(graph);
+      graph->SetExitBlock(exit_block);
+
+      graph->AddBlock(then_block);
+      graph->AddBlock(else_block);
+      graph->AddBlock(merge_block);
+      graph->AddBlock(exit_block);
+      first_block->AddSuccessor(then_block);
+      first_block->AddSuccessor(else_block);
+      then_block->AddSuccessor(merge_block);
+      else_block->AddSuccessor(merge_block);
+      merge_block->AddSuccessor(exit_block);
+
+      then_block->AddInstruction(new (GetAllocator()) HGoto());
+      else_block->AddInstruction(new (GetAllocator()) HGoto());
+      HPhi* phi = new (GetAllocator()) HPhi(GetAllocator(), 0, 0, DataType::Type::kInt32);
+      merge_block->AddPhi(phi);
+      phi->AddInput(constant2);
+      phi->AddInput(constant3);
+      merge_block->AddInstruction(new (GetAllocator()) HReturn(phi));
+      exit_block->AddInstruction(new (GetAllocator()) HExit());
+
+      graph->BuildDominatorTree();
+      std::unique_ptr<CompilerOptions> compiler_options =
+          CommonCompilerTest::CreateCompilerOptions(target_config.GetInstructionSet(), "default");
+      std::unique_ptr<CodeGenerator> codegen(
+          target_config.CreateCodeGenerator(graph, *compiler_options));
+      // The condition is true, so the code goes through `then_block`.
+      RunCode(codegen.get(), graph, [](HGraph*) {}, true, 2);
+
+      const ArenaVector<HBasicBlock*>& layout = GetCodeLayout(codegen.get());
+      EXPECT_EQ(layout.back(), true_side_is_cold ? then_block : else_block);
+    }
+  }
+}
+
 #ifdef ART_ENABLE_CODEGEN_arm
 TEST_F(CodegenTest, ARMVIXLParallelMoveResolver) {
   std::unique_ptr<CompilerOptions> compiler_options =
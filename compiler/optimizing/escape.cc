@@ -16,6 +16,7 @@
 
 #include "escape.h"
 
+#include "base/bit_vector-inl.h"
 #include "nodes.h"
 
 namespace art HIDDEN {
@@ -150,4 +151,146 @@ bool DoesNotEscape(HInstruction* reference, NoEscapeCheck& no_escape) {
   return is_singleton_and_not_returned;
 }
 
+bool IsFieldAccessOf(HInstruction* user, HInstruction* reference) {
+  if (user->IsInstanceFieldGet()) {
+    return user->InputAt(0) == reference;
+  } else if (user->IsInstanceFieldSet()) {
+    return user->InputAt(0) == reference && user->InputAt(1) != reference;
+  }
+  return false;
+}
+
+// Maximum number of blocks where an allocation can be materialized. More copies of the
+// allocation and of its fields are unlikely to pay off.
+static constexpr size_t kMaxPartialEscapeBlocks = 4;
+
+static bool IsBackEdge(HBasicBlock* block, HBasicBlock* successor) {
+  return successor->IsLoopHeader() && successor->GetLoopInformation()->IsBackEdge(*block);
+}
+
+bool CalculatePartialEscape(HInstruction* reference,
+                            ScopedArenaAllocator* allocator,
+                            /*out*/ ScopedArenaVector<HBasicBlock*>* escape_blocks) {
+  DCHECK(escape_blocks->empty());
+  if (!reference->IsNewInstance() ||
+      reference->AsNewInstance()->IsFinalizable() ||
+      reference->AsNewInstance()->NeedsChecks()) {
+    return false;
+  }
+  HBasicBlock* allocation_block = reference->GetBlock();
+  HGraph* graph = allocation_block->GetGraph();
+  if (allocation_block->IsTryBlock() || graph->HasIrreducibleLoops()) {
+    // Even singletons are observable inside a try. Irreducible loops have no back edges
+    // telling one iteration from the next.
+    return false;
+  }
+  size_t number_of_blocks = graph->GetBlocks().size();
+  ArenaBitVector access_blocks(
+      allocator, number_of_blocks, /*expandable=*/ false, kArenaAllocMisc);
+  ArenaBitVector is_escape_block(
+      allocator, number_of_blocks, /*expandable=*/ false, kArenaAllocMisc);
+
+  for (const HUseListNode<HInstruction*>& use : reference->GetUses()) {
+    HInstruction* user = use.GetUser();
+    HBasicBlock* block = user->GetBlock();
+    if (IsFieldAccessOf(user, reference)) {
+      access_blocks.SetBit(block->GetBlockId());
+    } else if (user->IsConstructorFence()) {
+      // Fences of a singleton are removed, the materialized object gets its own.
+      continue;
+    } else if (user->IsPhi() ||
+               block == allocation_block ||
+               block->IsTryBlock() ||
+               block->IsCatchBlock() ||
+               block->GetLoopInformation() != allocation_block->GetLoopInformation()) {
+      // The object cannot be materialized in front of this escape, or the materialization
+      // could run more than once per allocation.
+      return false;
+    } else if (!is_escape_block.IsBitSet(block->GetBlockId())) {
+      is_escape_block.SetBit(block->GetBlockId());
+      escape_blocks->push_back(block);
+    }
+  }
+  if (escape_blocks->empty() || escape_blocks->size() > kMaxPartialEscapeBlocks) {
+    return false;
+  }
+  for (const HUseListNode<HEnvironment*>& use : reference->GetEnvUses()) {
+    if (use.GetUser()->GetHolder()->IsDeoptimize()) {
+      // The interpreter would see the original object instead of the materialized one.
+      return false;
+    }
+  }
+
+  // Within an escape block, fields must only be accessed before the escape.
+  for (HBasicBlock* block : *escape_blocks) {
+    if (!access_blocks.IsBitSet(block->GetBlockId())) {
+      continue;
+    }
+    bool escaped = false;
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (IsFieldAccessOf(instruction, reference)) {
+        if (escaped) {
+          return false;
+        }
+      } else if (!instruction->IsConstructorFence() &&
+                 ContainsElement(instruction->GetInputs(), reference)) {
+        escaped = true;
+      }
+    }
+  }
+
+  // Blocks reachable from an escape block must neither access fields nor escape again. A path
+  // going through a back edge of a loop containing the allocation allocates a new object, so
+  // only forward edges are followed.
+  ArenaBitVector visited(allocator, number_of_blocks, /*expandable=*/ false, kArenaAllocMisc);
+  ScopedArenaVector<HBasicBlock*> worklist(allocator->Adapter(kArenaAllocMisc));
+  for (HBasicBlock* escape_block : *escape_blocks) {
+    visited.ClearAllBits();
+    worklist.push_back(escape_block);
+    while (!worklist.empty()) {
+      HBasicBlock* block = worklist.back();
+      worklist.pop_back();
+      for (HBasicBlock* successor : block->GetSuccessors()) {
+        uint32_t successor_id = successor->GetBlockId();
+        if (IsBackEdge(block, successor) || visited.IsBitSet(successor_id)) {
+          continue;
+        }
+        if (access_blocks.IsBitSet(successor_id) || is_escape_block.IsBitSet(successor_id)) {
+          return false;
+        }
+        visited.SetBit(successor_id);
+        worklist.push_back(successor);
+      }
+    }
+  }
+
+  // Look for a path from the allocation which does not escape. Without one, materializing
+  // only moves the allocation.
+  visited.ClearAllBits();
+  worklist.push_back(allocation_block);
+  while (!worklist.empty()) {
+    HBasicBlock* block = worklist.back();
+    worklist.pop_back();
+    for (HBasicBlock* successor : block->GetSuccessors()) {
+      uint32_t successor_id = successor->GetBlockId();
+      if (IsBackEdge(block, successor)) {
+        if (successor->GetLoopInformation()->Contains(*allocation_block)) {
+          // The next iteration allocates a new object.
+          return true;
+        }
+        continue;
+      }
+      if (successor->IsExitBlock()) {
+        return true;
+      }
+      if (!visited.IsBitSet(successor_id) && !is_escape_block.IsBitSet(successor_id)) {
+        visited.SetBit(successor_id);
+        worklist.push_back(successor);
+      }
+    }
+  }
+  return false;
+}
+
 }  // namespace art
@@ -18,9 +18,11 @@
 #define ART_COMPILER_OPTIMIZING_ESCAPE_H_
 
 #include "base/macros.h"
+#include "base/scoped_arena_containers.h"
 
 namespace art HIDDEN {
 
+class HBasicBlock;
 class HInstruction;
 
 /*
@@ -146,6 +148,26 @@ inline bool DoesNotEscape(HInstruction* reference,
   return DoesNotEscape(reference, esc);
 }
 
+/*
+ * Returns whether 'user' only reads or writes a field of 'reference', which partial escape
+ * analysis does not count as an escape.
+ */
+bool IsFieldAccessOf(HInstruction* user, HInstruction* reference);
+
+/*
+ * Performs partial escape analysis on the given instruction, an allocation which escapes on
+ * some paths only. Returns true and collects the blocks where the reference escapes into
+ * 'escape_blocks' if a copy of the object can be materialized at the first escape of each of
+ * these blocks instead, leaving the original allocation as a singleton. This holds if:
+ *  - the reference is not merged into a phi and not visible to an HDeoptimize,
+ *  - each escape block runs at most once per allocation and cannot reach another one,
+ *  - no field of the reference is accessed after an escape on any path,
+ *  - some path from the allocation does not escape at all.
+ */
+bool CalculatePartialEscape(HInstruction* reference,
+                            ScopedArenaAllocator* allocator,
+                            /*out*/ ScopedArenaVector<HBasicBlock*>* escape_blocks);
+
 }  // namespace art
 
 #endif  // ART_COMPILER_OPTIMIZING_ESCAPE_H_
@@ -20,6 +20,7 @@
 #include "base/macros.h"
 #include "builder.h"
 #include "induction_var_analysis.h"
+#include "induction_var_strength_reduction.h"
 #include "nodes.h"
 #include "optimizing_unit_test.h"
 
@@ -200,6 +201,12 @@ class InductionVarAnalysisTest : public OptimizingUnitTest {
     iva_->Run();
   }
 
+  // Performs InductionVarStrengthReduction (after InductionVarAnalysis).
+  bool PerformInductionVarStrengthReduction() {
+    HInductionVarStrengthReduction reduction(graph_, iva_, /*stats=*/ nullptr);
+    return reduction.Run();
+  }
+
   // General building fields.
   HGraph* graph_;
   HInductionVarAnalysis* iva_;
@@ -1363,4 +1370,104 @@ TEST_F(InductionVarAnalysisTest, CharLoopControl2) {
   EXPECT_STREQ("", GetTripCount(0).c_str());
 }
 
+TEST_F(InductionVarAnalysisTest, StrengthReduceMul) {
+  // Setup:
+  // for (int i = 0; i < 100; i++) {
+  //   a[i * 7] = 0;
+  // }
+  BuildLoopNest(1);
+  HInstruction* mul = InsertInstruction(
+      new (GetAllocator()) HMul(DataType::Type::kInt32, basic_[0], constant7_), 0);
+  HInstruction* store = InsertArrayStore(mul, 0);
+  PerformInductionVarAnalysis();
+  EXPECT_TRUE(PerformInductionVarStrengthReduction());
+
+  // Subscript is a new loop-phi k = 0, 7, 14, ...
+  HInstruction* phi = store->InputAt(1);
+  ASSERT_TRUE(phi->IsPhi());
+  EXPECT_EQ(loop_header_[0], phi->GetBlock());
+  EXPECT_EQ(constant0_, phi->InputAt(0));
+  ASSERT_TRUE(phi->InputAt(1)->IsAdd());
+  EXPECT_EQ(phi, phi->InputAt(1)->InputAt(0));
+  EXPECT_EQ(constant7_, phi->InputAt(1)->InputAt(1));
+  EXPECT_FALSE(mul->IsInBlock());
+
+  // Loop test is replaced by k != 700, which removes i.
+  HInstruction* condition = loop_header_[0]->GetLastInstruction()->InputAt(0);
+  ASSERT_TRUE(condition->IsNotEqual());
+  EXPECT_EQ(phi, condition->InputAt(0));
+  ASSERT_TRUE(condition->InputAt(1)->IsIntConstant());
+  EXPECT_EQ(700, condition->InputAt(1)->AsIntConstant()->GetValue());
+  EXPECT_FALSE(basic_[0]->IsInBlock());
+  EXPECT_FALSE(increment_[0]->IsInBlock());
+}
+
+TEST_F(InductionVarAnalysisTest, StrengthReduceShlAndAdd) {
+  // Setup:
+  // for (int i = 0; i < 100; i++) {
+  //   a[(i << 1) + 7] = 0;
+  // }
+  BuildLoopNest(1);
+  HInstruction* shl = InsertInstruction(
+      new (GetAllocator()) HShl(DataType::Type::kInt32, basic_[0], constant1_), 0);
+  HInstruction* add = InsertInstruction(
+      new (GetAllocator()) HAdd(DataType::Type::kInt32, shl, constant7_), 0);
+  HInstruction* store = InsertArrayStore(add, 0);
+  PerformInductionVarAnalysis();
+  EXPECT_TRUE(PerformInductionVarStrengthReduction());
+
+  // Subscript is a new loop-phi k = 7, 9, 11, ...
+  HInstruction* phi = store->InputAt(1);
+  ASSERT_TRUE(phi->IsPhi());
+  EXPECT_EQ(constant7_, phi->InputAt(0));
+  ASSERT_TRUE(phi->InputAt(1)->IsAdd());
+  EXPECT_EQ(constant2_, phi->InputAt(1)->InputAt(1));
+  EXPECT_FALSE(shl->IsInBlock());
+  EXPECT_FALSE(add->IsInBlock());
+
+  // Loop test is replaced by k != 207.
+  HInstruction* condition = loop_header_[0]->GetLastInstruction()->InputAt(0);
+  ASSERT_TRUE(condition->IsNotEqual());
+  EXPECT_EQ(207, condition->InputAt(1)->AsIntConstant()->GetValue());
+  EXPECT_FALSE(basic_[0]->IsInBlock());
+}
+
+TEST_F(InductionVarAnalysisTest, NoStrengthReduceSingleShl) {
+  // Setup:
+  // for (int i = 0; i < 100; i++) {
+  //   a[i << 1] = 0;
+  // }
+  BuildLoopNest(1);
+  HInstruction* shl = InsertInstruction(
+      new (GetAllocator()) HShl(DataType::Type::kInt32, basic_[0], constant1_), 0);
+  HInstruction* store = InsertArrayStore(shl, 0);
+  PerformInductionVarAnalysis();
+
+  // A single shift is not more expensive than the addition of a new loop-phi.
+  EXPECT_FALSE(PerformInductionVarStrengthReduction());
+  EXPECT_EQ(shl, store->InputAt(1));
+  EXPECT_TRUE(basic_[0]->IsInBlock());
+}
+
+TEST_F(InductionVarAnalysisTest, StrengthReduceKeepsUsedBasicInduction) {
+  // Setup:
+  // for (int i = 0; i < 100; i++) {
+  //   a[i * 7] = 0;
+  //   a[i] = 0;
+  // }
+  BuildLoopNest(1);
+  HInstruction* mul = InsertInstruction(
+      new (GetAllocator()) HMul(DataType::Type::kInt32, basic_[0], constant7_), 0);
+  HInstruction* store1 = InsertArrayStore(mul, 0);
+  HInstruction* store2 = InsertArrayStore(basic_[0], 0);
+  PerformInductionVarAnalysis();
+  EXPECT_TRUE(PerformInductionVarStrengthReduction());
+
+  // Multiplication is reduced, but i remains in use, and so does the loop test.
+  EXPECT_TRUE(store1->InputAt(1)->IsPhi());
+  EXPECT_NE(basic_[0], store1->InputAt(1));
+  EXPECT_EQ(basic_[0], store2->InputAt(1));
+  EXPECT_TRUE(loop_header_[0]->GetLastInstruction()->InputAt(0)->IsLessThan());
+}
+
 }  // namespace art
@@ -156,6 +156,33 @@ static HInstruction* GetLoopControl(const HLoopInformation* loop) {
   return loop->GetHeader()->GetLastInstruction();
 }
 
+/**
+ * Determines whether the invariant only consists of operations that can be evaluated
+ * anywhere before the loop, in the given type. Divisions are excluded since their
+ * divisor is only checked for zero inside the loop.
+ */
+static bool IsArithmeticInvariant(HInductionVarAnalysis::InductionInfo* info,
+                                  DataType::Type type) {
+  if (info == nullptr) {
+    return true;  // absent operand of negation
+  } else if (info->induction_class != HInductionVarAnalysis::kInvariant ||
+             DataType::Kind(info->type) != type) {
+    return false;
+  }
+  switch (info->operation) {
+    case HInductionVarAnalysis::kAdd:
+    case HInductionVarAnalysis::kSub:
+    case HInductionVarAnalysis::kNeg:
+    case HInductionVarAnalysis::kMul:
+    case HInductionVarAnalysis::kXor:
+      return IsArithmeticInvariant(info->op_a, type) && IsArithmeticInvariant(info->op_b, type);
+    case HInductionVarAnalysis::kFetch:
+      return true;
+    default:
+      return false;
+  }
+}
+
 /** Determines whether the `context` is in the body of the `loop`. */
 static bool IsContextInBody(const HBasicBlock* context, const HLoopInformation* loop) {
   DCHECK(loop != nullptr);
@@ -454,6 +481,36 @@ HInstruction* InductionVarRange::GenerateTripCount(const HLoopInformation* loop,
   return nullptr;
 }
 
+bool InductionVarRange::HasExactTripCount(const HLoopInformation* loop,
+                                          /*out*/ int64_t* trip_count) const {
+  HInstruction* loop_control = GetLoopControl(loop);
+  HInductionVarAnalysis::InductionInfo *trip = induction_analysis_->LookupInfo(loop, loop_control);
+  // Only a trip count that needs neither a taken-test nor a finite-test is exact. The trip
+  // count is an unsigned entity, so only positive values are taken as is.
+  return trip != nullptr &&
+         trip->operation == HInductionVarAnalysis::kTripCountInLoop &&
+         IsConstant(loop_control->GetBlock(), loop, trip->op_a, kExact, trip_count) &&
+         *trip_count > 0;
+}
+
+bool InductionVarRange::CanGenerateLinear(HInstruction* instruction) {
+  return GenerateLinearOrCheck(instruction,
+                               /*graph=*/ nullptr,
+                               /*block=*/ nullptr,
+                               /*initial=*/ nullptr,
+                               /*stride=*/ nullptr);
+}
+
+void InductionVarRange::GenerateLinear(HInstruction* instruction,
+                                       HGraph* graph,
+                                       HBasicBlock* block,
+                                       /*out*/ HInstruction** initial,
+                                       /*out*/ HInstruction** stride) {
+  if (!GenerateLinearOrCheck(instruction, graph, block, initial, stride)) {
+    LOG(FATAL) << "Failed precondition: CanGenerateLinear()";
+  }
+}
+
 //
 // Private class methods.
 //
@@ -1126,6 +1183,48 @@ bool InductionVarRange::GenerateRangeOrLastValue(const HBasicBlock* context,
       GenerateCode(context, loop, info, trip, graph, block, /*is_min=*/ false, upper);
 }
 
+bool InductionVarRange::GenerateLinearOrCheck(HInstruction* instruction,
+                                              HGraph* graph,
+                                              HBasicBlock* block,
+                                              /*out*/ HInstruction** initial,
+                                              /*out*/ HInstruction** stride) const {
+  const HBasicBlock* context = instruction->GetBlock();
+  const HLoopInformation* loop = nullptr;
+  HInductionVarAnalysis::InductionInfo* info = nullptr;
+  HInductionVarAnalysis::InductionInfo* trip = nullptr;
+  if (!HasInductionInfo(context, instruction, &loop, &info, &trip) ||
+      info->induction_class != HInductionVarAnalysis::kLinear ||
+      HInductionVarAnalysis::IsNarrowingLinear(info) ||
+      info->type != instruction->GetType()) {
+    return false;
+  }
+  // Both the stride and the initial value must be invariants that are safe to evaluate
+  // in the preheader, in the type of the linear induction.
+  HInductionVarAnalysis::InductionInfo* parts[] = { info->op_b, info->op_a };
+  HInstruction** results[] = { initial, stride };
+  for (size_t i = 0; i < arraysize(parts); ++i) {
+    if (!IsArithmeticInvariant(parts[i], info->type)) {
+      return false;
+    }
+    if (graph != nullptr) {
+      int64_t value = 0;
+      if (IsConstant(context, loop, parts[i], kExact, &value)) {
+        *results[i] = graph->GetConstant(info->type, value);
+      } else if (!GenerateCode(context,
+                               loop,
+                               parts[i],
+                               /*trip=*/ nullptr,
+                               graph,
+                               block,
+                               /*is_min=*/ false,
+                               results[i])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 bool InductionVarRange::GenerateLastValueLinear(const HBasicBlock* context,
                                                 const HLoopInformation* loop,
                                                 HInductionVarAnalysis::InductionInfo* info,
@@ -190,6 +190,33 @@ class InductionVarRange {
    */
   HInstruction* GenerateTripCount(const HLoopInformation* loop, HGraph* graph, HBasicBlock* block);
 
+  /**
+   * Checks if the loop is always taken and finite, and its trip count is a known positive
+   * constant. If so, sets 'trip_count' to its value, which is exactly the number of times
+   * the loop control stays in the loop, unless the loop is left earlier elsewhere.
+   */
+  bool HasExactTripCount(const HLoopInformation* loop, /*out*/ int64_t* trip_count) const;
+
+  /**
+   * Returns true if the given instruction is a linear induction a * i + b inside its closest
+   * enveloping loop, for which induction analysis is able to generate code for the initial
+   * value b and the stride a as loop invariants of the type of the instruction.
+   */
+  bool CanGenerateLinear(HInstruction* instruction);
+
+  /**
+   * Generates the initial value and the stride of the linear induction of the given
+   * instruction. Code is generated in given block and graph, which should be the preheader
+   * of the loop. Known constants are generated as such.
+   *
+   * Precondition: CanGenerateLinear() returns true.
+   */
+  void GenerateLinear(HInstruction* instruction,
+                      HGraph* graph,
+                      HBasicBlock* block,
+                      /*out*/ HInstruction** initial,
+                      /*out*/ HInstruction** stride);
+
  private:
   /*
    * Enum used in IsConstant() request.
@@ -318,6 +345,17 @@ class InductionVarRange {
                                 /*out*/ bool* needs_finite_test,
                                 /*out*/ bool* needs_taken_test) const;
 
+  /**
+   * Generates code for the initial value and the stride of a linear induction in the HIR.
+   * Returns true on success. With graph nullptr, the method can be used to determine if code
+   * generation would be successful without generating actual code yet.
+   */
+  bool GenerateLinearOrCheck(HInstruction* instruction,
+                             HGraph* graph,
+                             HBasicBlock* block,
+                             /*out*/ HInstruction** initial,
+                             /*out*/ HInstruction** stride) const;
+
   bool GenerateLastValueLinear(const HBasicBlock* context,
                                const HLoopInformation* loop,
                                HInductionVarAnalysis::InductionInfo* info,
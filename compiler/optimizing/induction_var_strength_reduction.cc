@@ -0,0 +1,300 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "induction_var_strength_reduction.h"
+
+#include "base/bit_utils.h"
+#include "base/stl_util.h"
+#include "optimizing_compiler_stats.h"
+
+namespace art HIDDEN {
+
+// Removes the candidate `instruction`, and then the candidates that were only computed for it.
+static void RemoveWithDeadInputs(HInstruction* instruction,
+                                 const ScopedArenaVector<HInstruction*>& candidates) {
+  DCHECK(!instruction->HasUses());
+  // All candidates are binary operations.
+  HInstruction* left = instruction->InputAt(0);
+  HInstruction* right = instruction->InputAt(1);
+  instruction->GetBlock()->RemoveInstruction(instruction);
+  for (HInstruction* input : {left, right}) {
+    if (input->IsInBlock() && !input->HasUses() && ContainsElement(candidates, input)) {
+      RemoveWithDeadInputs(input, candidates);
+    }
+  }
+}
+
+// Returns whether all uses of `instruction` are inside `loop`.
+static bool IsOnlyUsedInLoop(HInstruction* instruction, HLoopInformation* loop) {
+  for (const HUseListNode<HInstruction*>& use : instruction->GetUses()) {
+    if (!loop->Contains(*use.GetUser()->GetBlock())) {
+      return false;
+    }
+  }
+  for (const HUseListNode<HEnvironment*>& use : instruction->GetEnvUses()) {
+    if (!loop->Contains(*use.GetUser()->GetHolder()->GetBlock())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+HInductionVarStrengthReduction::HInductionVarStrengthReduction(
+    HGraph* graph,
+    HInductionVarAnalysis* induction_analysis,
+    OptimizingCompilerStats* stats,
+    const char* name)
+    : HOptimization(graph, name, stats),
+      induction_range_(induction_analysis) {}
+
+bool HInductionVarStrengthReduction::Run() {
+  if (!graph_->HasLoops()) {
+    return false;
+  }
+  bool did_reduce = false;
+  // Post order visit to visit inner loops before outer loops. Irreducible loops, which
+  // include all loops of an OSR compilation, have no induction information.
+  for (HBasicBlock* block : graph_->GetPostOrder()) {
+    if (block->IsLoopHeader() && !block->GetLoopInformation()->IsIrreducible()) {
+      did_reduce |= TryReduceLoop(block->GetLoopInformation());
+    }
+  }
+  return did_reduce;
+}
+
+bool HInductionVarStrengthReduction::TryReduceLoop(HLoopInformation* loop) {
+  // The update of a new loop-phi goes at the end of the single back edge.
+  if (loop->NumberOfBackEdges() != 1 ||
+      !loop->GetBackEdges()[0]->GetLastInstruction()->IsGoto()) {
+    return false;
+  }
+
+  // Collect the candidates in a deterministic order.
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<HInstruction*> candidates(
+      allocator.Adapter(kArenaAllocInductionVarAnalysis));
+  for (HBlocksInLoopReversePostOrderIterator it_loop(*loop); !it_loop.Done(); it_loop.Advance()) {
+    HBasicBlock* block = it_loop.Current();
+    if (block->GetLoopInformation() != loop) {
+      continue;  // inner loop
+    }
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      if (IsCandidate(loop, it.Current())) {
+        candidates.push_back(it.Current());
+      }
+    }
+  }
+  if (candidates.empty()) {
+    return false;
+  }
+
+  // Decide on the roots to reduce before changing the graph. A root is a candidate that is not
+  // absorbed into another one, so that the operations computed for it all go away with it.
+  // Uses after the loop would see the value of the last iteration, rather than the value of
+  // the loop-phi on exit, so such candidates are kept.
+  ScopedArenaVector<HInstruction*> roots(allocator.Adapter(kArenaAllocInductionVarAnalysis));
+  for (HInstruction* candidate : candidates) {
+    if (!IsAbsorbed(candidate, candidates) &&
+        IsOnlyUsedInLoop(candidate, loop) &&
+        IsProfitable(candidate, candidates)) {
+      roots.push_back(candidate);
+    }
+  }
+  if (roots.empty()) {
+    return false;
+  }
+
+  ScopedArenaVector<HPhi*> phis(allocator.Adapter(kArenaAllocInductionVarAnalysis));
+  for (HInstruction* root : roots) {
+    // A root may have died along with the operations of an earlier root.
+    if (root->IsInBlock()) {
+      phis.push_back(Reduce(loop, root, candidates));
+      MaybeRecordStat(stats_, MethodCompilationStat::kInductionVarStrengthReduced);
+    }
+  }
+
+  // Try to remove the basic induction now that the reduced operations no longer use it.
+  for (HPhi* phi : phis) {
+    if (TryReplaceLoopTest(loop, phi)) {
+      MaybeRecordStat(stats_, MethodCompilationStat::kLinearFunctionTestReplaced);
+      break;
+    }
+  }
+  return true;
+}
+
+bool HInductionVarStrengthReduction::IsCandidate(HLoopInformation* loop,
+                                                 HInstruction* instruction) {
+  return (instruction->IsAdd() ||
+          instruction->IsSub() ||
+          instruction->IsMul() ||
+          instruction->IsShl()) &&
+         (instruction->GetType() == DataType::Type::kInt32 ||
+          instruction->GetType() == DataType::Type::kInt64) &&
+         instruction->GetBlock()->GetLoopInformation() == loop &&
+         induction_range_.CanGenerateLinear(instruction);
+}
+
+bool HInductionVarStrengthReduction::IsAbsorbed(
+    HInstruction* instruction, const ScopedArenaVector<HInstruction*>& candidates) {
+  return !instruction->HasEnvironmentUses() &&
+         instruction->HasOnlyOneNonEnvironmentUse() &&
+         ContainsElement(candidates, instruction->GetUses().front().GetUser());
+}
+
+bool HInductionVarStrengthReduction::IsProfitable(
+    HInstruction* root, const ScopedArenaVector<HInstruction*>& candidates) {
+  // The new loop-phi costs one addition per iteration. Since every absorbed candidate
+  // has a single user, no operation is visited twice.
+  size_t number_of_operations = 0;
+  bool has_mul = false;
+  ScopedArenaVector<HInstruction*> worklist(candidates.get_allocator());
+  worklist.push_back(root);
+  while (!worklist.empty()) {
+    HInstruction* instruction = worklist.back();
+    worklist.pop_back();
+    ++number_of_operations;
+    has_mul |= instruction->IsMul();
+    for (HInstruction* input : instruction->GetInputs()) {
+      if (ContainsElement(candidates, input) && IsAbsorbed(input, candidates)) {
+        worklist.push_back(input);
+      }
+    }
+  }
+  return has_mul || number_of_operations > 1u;
+}
+
+HPhi* HInductionVarStrengthReduction::Reduce(HLoopInformation* loop,
+                                             HInstruction* root,
+                                             const ScopedArenaVector<HInstruction*>& candidates) {
+  HBasicBlock* header = loop->GetHeader();
+  HBasicBlock* preheader = loop->GetPreHeader();
+  HBasicBlock* back_edge = loop->GetBackEdges()[0];
+  DCHECK_EQ(header->GetPredecessors()[0], preheader);
+  DataType::Type type = root->GetType();
+  HInstruction* initial = nullptr;
+  HInstruction* stride = nullptr;
+  induction_range_.GenerateLinear(root, graph_, preheader, &initial, &stride);
+
+  ArenaAllocator* allocator = graph_->GetAllocator();
+  HPhi* phi = new (allocator) HPhi(allocator, kNoRegNumber, 0, type);
+  header->AddPhi(phi);
+  HInstruction* update = new (allocator) HAdd(type, phi, stride);
+  back_edge->InsertInstructionBefore(update, back_edge->GetLastInstruction());
+  phi->AddInput(initial);
+  phi->AddInput(update);
+
+  root->ReplaceWith(phi);
+  RemoveWithDeadInputs(root, candidates);
+  return phi;
+}
+
+bool HInductionVarStrengthReduction::TryReplaceLoopTest(HLoopInformation* loop, HPhi* phi) {
+  HBasicBlock* header = loop->GetHeader();
+  HInstruction* control = header->GetLastInstruction();
+  HInstruction* initial = phi->InputAt(0);
+  HInstruction* stride = phi->InputAt(1)->InputAt(1);
+  int64_t trip_count = 0;
+  if (!control->IsIf() ||
+      !initial->IsConstant() ||
+      !stride->IsConstant() ||
+      !induction_range_.HasExactTripCount(loop, &trip_count)) {
+    return false;
+  }
+  HInstruction* condition = control->InputAt(0);
+  if (!condition->IsCondition() ||
+      condition->GetBlock() != header ||
+      condition->HasEnvironmentUses() ||
+      !condition->HasOnlyOneNonEnvironmentUse()) {
+    return false;
+  }
+
+  // The loop control evaluates the test on iterations 0 to trip count, and stays in the loop
+  // on all but the last one. The loop-phi takes its final value on the last one only if no
+  // value on the way wraps around, which holds when neither end of the range does.
+  int64_t initial_value = Int64FromConstant(initial->AsConstant());
+  int64_t stride_value = Int64FromConstant(stride->AsConstant());
+  if (stride_value == 0 ||
+      !IsInt<32>(initial_value) ||
+      !IsInt<32>(stride_value) ||
+      !IsInt<32>(trip_count)) {
+    return false;
+  }
+  int64_t final_value = initial_value + stride_value * trip_count;
+  if (phi->GetType() == DataType::Type::kInt32 && !IsInt<32>(final_value)) {
+    return false;
+  }
+
+  // Find the basic induction that only the test keeps alive.
+  HPhi* basic = nullptr;
+  for (HInstruction* input : condition->GetInputs()) {
+    if (input->IsPhi() &&
+        input->GetBlock() == header &&
+        IsOnlyUsedByLoopTest(input->AsPhi(), condition)) {
+      basic = input->AsPhi();
+      break;
+    }
+  }
+  if (basic == nullptr) {
+    return false;
+  }
+
+  // Replace the test, and remove the old one along with the basic induction.
+  ArenaAllocator* allocator = graph_->GetAllocator();
+  HInstruction* final_phi_value = graph_->GetConstant(phi->GetType(), final_value);
+  HCondition* new_condition = nullptr;
+  if (loop->Contains(*control->AsIf()->IfTrueSuccessor())) {
+    new_condition = new (allocator) HNotEqual(phi, final_phi_value);
+  } else {
+    new_condition = new (allocator) HEqual(phi, final_phi_value);
+  }
+  header->InsertInstructionBefore(new_condition, control);
+  control->ReplaceInput(new_condition, 0);
+  header->RemoveInstruction(condition);
+  for (HInstruction* instruction : *induction_range_.LookupCycle(basic)) {
+    if (instruction->IsInBlock()) {
+      RemoveFromCycle(instruction);
+    }
+  }
+  return true;
+}
+
+bool HInductionVarStrengthReduction::IsOnlyUsedByLoopTest(HPhi* phi,
+                                                          HInstruction* condition) const {
+  ArenaSet<HInstruction*>* cycle = induction_range_.LookupCycle(phi);
+  if (cycle == nullptr) {
+    return false;
+  }
+  for (HInstruction* instruction : *cycle) {
+    if (!instruction->IsInBlock()) {
+      continue;
+    } else if (!instruction->IsRemovable()) {
+      return false;
+    }
+    for (const HUseListNode<HInstruction*>& use : instruction->GetUses()) {
+      HInstruction* user = use.GetUser();
+      if (user != condition && cycle->find(user) == cycle->end()) {
+        return false;
+      }
+    }
+    if (!CanRemoveEnvironmentUses(instruction)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace art
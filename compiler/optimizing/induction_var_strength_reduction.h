@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_INDUCTION_VAR_STRENGTH_REDUCTION_H_
+#define ART_COMPILER_OPTIMIZING_INDUCTION_VAR_STRENGTH_REDUCTION_H_
+
+#include "base/macros.h"
+#include "base/scoped_arena_containers.h"
+#include "induction_var_range.h"
+#include "nodes.h"
+#include "optimization.h"
+
+namespace art HIDDEN {
+
+/**
+ * Strength reduction of induction variables, based on induction variable analysis.
+ *
+ * Arithmetic in a loop that computes a linear induction a * i + b, such as the index
+ * i * stride + offset of an array access, is replaced by a new loop-phi that starts at b
+ * and is incremented by a on the back edge. The multiplications, shifts and additions that
+ * only served that computation are removed from the loop body.
+ *
+ * When the basic induction of the loop is then only used by the loop test and the loop has
+ * a known trip count, the test is rewritten as a test on the new loop-phi against its final
+ * value (linear function test replacement), and the basic induction is removed.
+ */
+class HInductionVarStrengthReduction : public HOptimization {
+ public:
+  HInductionVarStrengthReduction(HGraph* graph,
+                                 HInductionVarAnalysis* induction_analysis,
+                                 OptimizingCompilerStats* stats,
+                                 const char* name = kInductionVarStrengthReductionPassName);
+
+  bool Run() override;
+
+  static constexpr const char* kInductionVarStrengthReductionPassName =
+      "induction_var_strength_reduction";
+
+ private:
+  // Reduces the profitable linear inductions of `loop`. Returns whether the graph changed.
+  bool TryReduceLoop(HLoopInformation* loop);
+
+  // Returns whether `instruction` is an arithmetic operation directly in `loop` that computes
+  // a linear induction which a new loop-phi can replace.
+  bool IsCandidate(HLoopInformation* loop, HInstruction* instruction);
+
+  // Returns whether the candidate `instruction` is only computed for a single other candidate,
+  // and is therefore reduced or kept along with that one.
+  static bool IsAbsorbed(HInstruction* instruction,
+                         const ScopedArenaVector<HInstruction*>& candidates);
+
+  // Returns whether replacing the candidate `root`, and the candidates absorbed into it,
+  // by a loop-phi removes a multiplication or more than one operation from the loop.
+  static bool IsProfitable(HInstruction* root, const ScopedArenaVector<HInstruction*>& candidates);
+
+  // Replaces `root` by a new loop-phi of `loop`, removes the candidates that were only
+  // computed for it, and returns the loop-phi.
+  HPhi* Reduce(HLoopInformation* loop,
+               HInstruction* root,
+               const ScopedArenaVector<HInstruction*>& candidates);
+
+  // Rewrites the test of the loop control as a test on the new loop-phi `phi` when that removes
+  // the basic induction of the loop. Returns whether the graph changed.
+  bool TryReplaceLoopTest(HLoopInformation* loop, HPhi* phi);
+
+  // Returns whether the cycle of the loop-phi `phi` is only used by the loop test `condition`,
+  // and can be removed once the test is rewritten.
+  bool IsOnlyUsedByLoopTest(HPhi* phi, HInstruction* condition) const;
+
+  // Range information based on prior induction variable analysis.
+  InductionVarRange induction_range_;
+
+  DISALLOW_COPY_AND_ASSIGN(HInductionVarStrengthReduction);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_INDUCTION_VAR_STRENGTH_REDUCTION_H_
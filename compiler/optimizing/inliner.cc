@@ -621,7 +621,13 @@ bool HInliner::UseOnlyPolymorphicInliningWithNoDeopt() {
   //
   // For OSR:
   //     We may come from the interpreter and it may have seen different receiver types.
-  return Runtime::Current()->IsAotCompiler() || outermost_graph_->IsCompilingOsr();
+  //
+  // For JIT:
+  //     If previous compilations of the method kept deoptimizing on type guards, the
+  //     inline caches do not describe the receivers well enough to speculate on them.
+  return Runtime::Current()->IsAotCompiler() ||
+         outermost_graph_->IsCompilingOsr() ||
+         !outermost_graph_->AllowsSpeculation(DeoptimizationKind::kJitInlineCache);
 }
 bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
     REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -630,12 +636,13 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
   }
 
   StackHandleScope<InlineCache::kIndividualCacheSize> classes(Thread::Current());
+  StackHandleScope<InlineCache::kIndividualCacheSize> hot_classes(Thread::Current());
   // The Zygote JIT compiles based on a profile, so we shouldn't use runtime inline caches
   // for it.
   InlineCacheType inline_cache_type =
       (Runtime::Current()->IsAotCompiler() || Runtime::Current()->IsZygote())
-          ? GetInlineCacheAOT(invoke_instruction, &classes)
-          : GetInlineCacheJIT(invoke_instruction, &classes);
+          ? GetInlineCacheAOT(invoke_instruction, &classes, &hot_classes)
+          : GetInlineCacheJIT(invoke_instruction, &classes, &hot_classes);
 
   switch (inline_cache_type) {
     case kInlineCacheNoData: {
@@ -656,7 +663,7 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
     case kInlineCacheMonomorphic: {
       MaybeRecordStat(stats_, MethodCompilationStat::kMonomorphicCall);
       if (UseOnlyPolymorphicInliningWithNoDeopt()) {
-        return TryInlinePolymorphicCall(invoke_instruction, classes);
+        return TryInlinePolymorphicCall(invoke_instruction, classes, /* is_megamorphic= */ false);
       } else {
         return TryInlineMonomorphicCall(invoke_instruction, classes);
       }
@@ -664,16 +671,19 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
 
     case kInlineCachePolymorphic: {
       MaybeRecordStat(stats_, MethodCompilationStat::kPolymorphicCall);
-      return TryInlinePolymorphicCall(invoke_instruction, classes);
+      return TryInlinePolymorphicCall(invoke_instruction, classes, /* is_megamorphic= */ false);
     }
 
     case kInlineCacheMegamorphic: {
-      LOG_FAIL_NO_STAT()
-          << "Interface or virtual call to "
-          << invoke_instruction->GetMethodReference().PrettyMethod()
-          << " is megamorphic and not inlined";
       MaybeRecordStat(stats_, MethodCompilationStat::kMegamorphicCall);
-      return false;
+      if (hot_classes.Size() == 0u) {
+        LOG_FAIL_NO_STAT()
+            << "Interface or virtual call to "
+            << invoke_instruction->GetMethodReference().PrettyMethod()
+            << " is megamorphic and not inlined";
+        return false;
+      }
+      return TryInlinePolymorphicCall(invoke_instruction, hot_classes, /* is_megamorphic= */ true);
     }
 
     case kInlineCacheMissingTypes: {
@@ -688,7 +698,8 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
 
 HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
     HInvoke* invoke_instruction,
-    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes) {
+    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* hot_classes) {
   DCHECK(codegen_->GetCompilerOptions().IsJitCompiler());
 
   ArtMethod* caller = graph_->GetArtMethod();
@@ -726,13 +737,19 @@ HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
     // Bail for now.
     return kInlineCacheNoData;
   }
-  Runtime::Current()->GetJit()->GetCodeCache()->CopyInlineCacheInto(*cache, classes);
-  return GetInlineCacheType(*classes);
+  jit::JitCodeCache* code_cache = Runtime::Current()->GetJit()->GetCodeCache();
+  code_cache->CopyInlineCacheInto(*cache, classes);
+  InlineCacheType inline_cache_type = GetInlineCacheType(*classes);
+  if (inline_cache_type == kInlineCacheMegamorphic) {
+    code_cache->CopyHotReceiversInto(*cache, hot_classes);
+  }
+  return inline_cache_type;
 }
 
 HInliner::InlineCacheType HInliner::GetInlineCacheAOT(
     HInvoke* invoke_instruction,
-    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes) {
+    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* hot_classes) {
   DCHECK_EQ(classes->Capacity(), InlineCache::kIndividualCacheSize);
   DCHECK_EQ(classes->Size(), 0u);
 
@@ -764,17 +781,41 @@ HInliner::InlineCacheType HInliner::GetInlineCacheAOT(
   if (dex_pc_data.is_missing_types) {
     return kInlineCacheMissingTypes;
   }
+  ClassLinker* class_linker = caller_compilation_unit_.GetClassLinker();
+  Thread* self = Thread::Current();
+  const DexFile* dex_file = caller_compilation_unit_.GetDexFile();
   if (dex_pc_data.is_megamorphic) {
+    DCHECK_LE(dex_pc_data.hot_classes.size(), InlineCache::kIndividualCacheSize);
+    DCHECK_EQ(hot_classes->Size(), 0u);
+    // Look up the most frequent receivers. If one of them cannot be found, we
+    // only record the megamorphic call: inlining the others is still correct,
+    // but the profile is then unlikely to match this execution.
+    ObjPtr<mirror::Class> hot[InlineCache::kIndividualCacheSize];
+    size_t number_of_hot_classes = 0u;
+    for (const dex::TypeIndex& type_index : dex_pc_data.hot_classes) {
+      const char* descriptor = pci->GetTypeDescriptor(dex_file, type_index);
+      ObjPtr<mirror::Class> clazz =
+          class_linker->FindClass(self, descriptor, caller_compilation_unit_.GetClassLoader());
+      if (clazz == nullptr) {
+        self->ClearException();  // Clean up the exception left by type resolution.
+        VLOG(compiler) << "Could not find hot receiver in AOT mode "
+            << invoke_instruction->GetMethodReference().PrettyMethod()
+            << " : "
+            << descriptor;
+        return kInlineCacheMegamorphic;
+      }
+      hot[number_of_hot_classes++] = clazz;
+    }
+    for (size_t i = 0; i != number_of_hot_classes; ++i) {
+      hot_classes->NewHandle(hot[i]);
+    }
     return kInlineCacheMegamorphic;
   }
   DCHECK_LE(dex_pc_data.classes.size(), InlineCache::kIndividualCacheSize);
 
   // Walk over the class descriptors and look up the actual classes.
   // If we cannot find a type we return kInlineCacheMissingTypes.
-  ClassLinker* class_linker = caller_compilation_unit_.GetClassLinker();
-  Thread* self = Thread::Current();
   for (const dex::TypeIndex& type_index : dex_pc_data.classes) {
-    const DexFile* dex_file = caller_compilation_unit_.GetDexFile();
     const char* descriptor = pci->GetTypeDescriptor(dex_file, type_index);
     ObjPtr<mirror::Class> clazz =
         class_linker->FindClass(self, descriptor, caller_compilation_unit_.GetClassLoader());
@@ -1021,11 +1062,14 @@ static void MaybeReplaceAndRemove(HInstruction* new_instruction, HInstruction* o
 
 bool HInliner::TryInlinePolymorphicCall(
     HInvoke* invoke_instruction,
-    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes) {
+    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes,
+    bool is_megamorphic) {
   DCHECK(invoke_instruction->IsInvokeVirtual() || invoke_instruction->IsInvokeInterface())
       << invoke_instruction->DebugName();
 
-  if (TryInlinePolymorphicCallToSameTarget(invoke_instruction, classes)) {
+  // Inlining a single target for all the receivers deoptimizes when another target shows
+  // up, which is expected for a megamorphic call.
+  if (!is_megamorphic && TryInlinePolymorphicCallToSameTarget(invoke_instruction, classes)) {
     return true;
   }
 
@@ -1058,7 +1102,7 @@ bool HInliner::TryInlinePolymorphicCall(
 
     // In monomorphic cases when UseOnlyPolymorphicInliningWithNoDeopt() is true, we call
     // `TryInlinePolymorphicCall` even though we are monomorphic.
-    const bool actually_monomorphic = number_of_types == 1;
+    const bool actually_monomorphic = number_of_types == 1 && !is_megamorphic;
     DCHECK_IMPLIES(actually_monomorphic, UseOnlyPolymorphicInliningWithNoDeopt());
 
     // We only want to limit recursive polymorphic cases, not monomorphic ones.
@@ -1089,8 +1133,10 @@ bool HInliner::TryInlinePolymorphicCall(
                     << " has inlined " << ArtMethod::PrettyMethod(method);
 
       // If we have inlined all targets before, and this receiver is the last seen,
-      // we deoptimize instead of keeping the original invoke instruction.
+      // we deoptimize instead of keeping the original invoke instruction. A megamorphic
+      // call keeps it for the receivers that were not inlined.
       bool deoptimize = !UseOnlyPolymorphicInliningWithNoDeopt() &&
+          !is_megamorphic &&
           all_targets_inlined &&
           (i + 1 == number_of_types);
 
@@ -1117,7 +1163,9 @@ bool HInliner::TryInlinePolymorphicCall(
     return false;
   }
 
-  MaybeRecordStat(stats_, MethodCompilationStat::kInlinedPolymorphicCall);
+  MaybeRecordStat(stats_,
+                  is_megamorphic ? MethodCompilationStat::kInlinedMegamorphicCall
+                                 : MethodCompilationStat::kInlinedPolymorphicCall);
 
   // Lazily run type propagation to get the guards typed.
   run_extra_type_propagation_ = true;
@@ -1293,7 +1341,8 @@ bool HInliner::TryInlinePolymorphicCallToSameTarget(
   bb_cursor->InsertInstructionAfter(class_table_get, receiver_class);
   bb_cursor->InsertInstructionAfter(compare, class_table_get);
 
-  if (outermost_graph_->IsCompilingOsr()) {
+  if (outermost_graph_->IsCompilingOsr() ||
+      !outermost_graph_->AllowsSpeculation(DeoptimizationKind::kJitSameTarget)) {
     CreateDiamondPatternForPolymorphicInline(compare, return_replacement, invoke_instruction);
   } else {
     HDeoptimize* deoptimize = new (graph_->GetAllocator()) HDeoptimize(
@@ -2220,6 +2269,7 @@ bool HInliner::TryBuildAndInlineHelper(HInvoke* invoke_instruction,
       graph_->GetCompilationKind(),
       /* start_instruction_id= */ caller_instruction_counter);
   callee_graph->SetArtMethod(resolved_method);
+  callee_graph->SetDisallowedSpeculations(graph_->GetDisallowedSpeculations());
 
   ScopedProfilingInfoUse spiu(Runtime::Current()->GetJit(), resolved_method, Thread::Current());
   if (Runtime::Current()->GetJit() != nullptr) {
@@ -194,17 +194,21 @@ class HInliner : public HOptimization {
   // Try getting the inline cache from JIT code cache.
   // Return true if the inline cache was successfully allocated and the
   // invoke info was found in the profile info.
+  // For a megamorphic call, `hot_classes` gets the most frequent receivers.
   InlineCacheType GetInlineCacheJIT(
       HInvoke* invoke_instruction,
-      /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes)
+      /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+      /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* hot_classes)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Try getting the inline cache from AOT offline profile.
   // Return true if the inline cache was successfully allocated and the
   // invoke info was found in the profile info.
+  // For a megamorphic call, `hot_classes` gets the most frequent receivers.
   InlineCacheType GetInlineCacheAOT(
       HInvoke* invoke_instruction,
-      /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes)
+      /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes,
+      /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* hot_classes)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Compute the inline cache type.
@@ -220,9 +224,12 @@ class HInliner : public HOptimization {
                                 const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Try to inline targets of a polymorphic call.
+  // Try to inline targets of a polymorphic call. For a megamorphic call,
+  // `classes` are the most frequent receivers, and the call is kept for the
+  // other receivers.
   bool TryInlinePolymorphicCall(HInvoke* invoke_instruction,
-                                const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
+                                const StackHandleScope<InlineCache::kIndividualCacheSize>& classes,
+                                bool is_megamorphic)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   bool TryInlinePolymorphicCallToSameTarget(
@@ -37,6 +37,7 @@
 #include "mirror/dex_cache.h"
 #include "oat/oat_file.h"
 #include "optimizing_compiler_stats.h"
+#include "profile/profile_compilation_info.h"
 #include "reflective_handle_scope-inl.h"
 #include "scoped_thread_state_change-inl.h"
 #include "sharpening.h"
@@ -676,15 +677,33 @@ void HInstructionBuilder::If_21_22t(const Instruction& instruction, uint32_t dex
     comparison = new (allocator_) T(value, second, dex_pc);
   }
   AppendInstruction(comparison);
-  HIf* if_instr = new (allocator_) HIf(comparison, dex_pc);
 
+  BranchCache* cache = nullptr;
   ProfilingInfo* info = graph_->GetProfilingInfo();
   if (info != nullptr && !graph_->IsCompilingBaseline()) {
-    BranchCache* cache = info->GetBranchCache(dex_pc);
-    if (cache != nullptr) {
-      if_instr->SetTrueCount(cache->GetTrue());
-      if_instr->SetFalseCount(cache->GetFalse());
+    cache = info->GetBranchCache(dex_pc);
+  }
+
+  HInstruction* if_input = comparison;
+  if (cache != nullptr && cache->IsSpeculative() && CanSpeculateOnBranch()) {
+    // Only compile the side of the branch that was taken, and deoptimize if the
+    // other side is taken. Dead code elimination removes the other side.
+    bool always_true = cache->GetTrue() != 0u;
+    HInstruction* deoptimize_condition = comparison;
+    if (always_true) {
+      deoptimize_condition = new (allocator_) HBooleanNot(comparison, dex_pc);
+      AppendInstruction(deoptimize_condition);
     }
+    AppendInstruction(new (allocator_) HDeoptimize(
+        allocator_, deoptimize_condition, DeoptimizationKind::kBranchSpeculation, dex_pc));
+    if_input = graph_->GetIntConstant(always_true ? 1 : 0, dex_pc);
+    MaybeRecordStat(compilation_stats_, MethodCompilationStat::kSpeculatedBranch);
+  }
+
+  HIf* if_instr = new (allocator_) HIf(if_input, dex_pc);
+  if (cache != nullptr) {
+    if_instr->SetTrueCount(cache->GetTrue());
+    if_instr->SetFalseCount(cache->GetFalse());
   }
 
   // Append after setting true/false count, so that the builder knows if the
@@ -1456,11 +1475,46 @@ HNewInstance* HInstructionBuilder::BuildNewInstance(dex::TypeIndex type_index, u
       *dex_compilation_unit_->GetDexFile(),
       finalizable,
       entrypoint);
+  if (entrypoint != kQuickAllocStringObject && IsPretenuredAllocationSite(dex_pc)) {
+    new_instance->SetPretenured();
+  }
   AppendInstruction(new_instance);
 
   return new_instance;
 }
 
+bool HInstructionBuilder::CanSpeculateOnBranch() const {
+  // Deoptimizing does not mix with catch blocks, see `HInliner::TryBuildAndInline`, and
+  // OSR code can be entered with states that the branch profile did not see.
+  return !graph_->IsDebuggable() &&
+         !graph_->IsCompilingOsr() &&
+         !current_block_->IsTryBlock() &&
+         graph_->AllowsSpeculation(DeoptimizationKind::kBranchSpeculation);
+}
+
+bool HInstructionBuilder::IsPretenuredAllocationSite(uint32_t dex_pc) const {
+  ProfilingInfo* info = graph_->GetProfilingInfo();
+  if (info != nullptr) {
+    // Baseline code keeps allocating in the young generation, as it is what
+    // samples the survival of the site.
+    if (graph_->IsCompilingBaseline()) {
+      return false;
+    }
+    AllocationSiteCache* cache = info->GetAllocationSiteCache(dex_pc);
+    return cache != nullptr && cache->ShouldPretenure();
+  }
+  if (code_generator_ == nullptr) {
+    return false;
+  }
+  const ProfileCompilationInfo* pci =
+      code_generator_->GetCompilerOptions().GetProfileCompilationInfo();
+  if (pci == nullptr) {
+    return false;
+  }
+  return pci->IsPretenuredAllocationSite(
+      MethodReference(dex_file_, dex_compilation_unit_->GetDexMethodIndex()), dex_pc);
+}
+
 void HInstructionBuilder::BuildConstructorFenceForAllocation(HInstruction* allocation) {
   DCHECK(allocation != nullptr &&
              (allocation->IsNewInstance() ||
@@ -2427,6 +2481,9 @@ HNewArray* HInstructionBuilder::BuildNewArray(uint32_t dex_pc,
   size_t component_type_shift = Primitive::ComponentSizeShift(Primitive::GetType(descriptor[1]));
 
   HNewArray* new_array = new (allocator_) HNewArray(cls, length, dex_pc, component_type_shift);
+  if (IsPretenuredAllocationSite(dex_pc)) {
+    new_array->SetPretenured();
+  }
   AppendInstruction(new_array);
   return new_array;
 }
@@ -286,6 +286,14 @@ class HInstructionBuilder : public ValueObject {
   bool IsInitialized(ObjPtr<mirror::Class> cls) const
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Return whether the branch that ends the current block can be replaced by a
+  // deoptimization on the side the JIT profiling info never saw taken.
+  bool CanSpeculateOnBranch() const;
+
+  // Return whether the JIT profiling info or the AOT profile found that the
+  // objects allocated at `dex_pc` are long-lived.
+  bool IsPretenuredAllocationSite(uint32_t dex_pc) const;
+
   // Try to resolve a field using the class linker. Return null if it could not
   // be found.
   ArtField* ResolveField(uint16_t field_idx, bool is_static, bool is_put);
@@ -249,6 +249,29 @@ namespace art HIDDEN {
 
 class HeapRefHolder;
 
+// The value of a field of the given type in a new object.
+static HInstruction* GetDefaultValue(HGraph* graph, DataType::Type type) {
+  switch (type) {
+    case DataType::Type::kReference:
+      return graph->GetNullConstant();
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+      return graph->GetIntConstant(0);
+    case DataType::Type::kInt64:
+      return graph->GetLongConstant(0);
+    case DataType::Type::kFloat32:
+      return graph->GetFloatConstant(0);
+    case DataType::Type::kFloat64:
+      return graph->GetDoubleConstant(0);
+    default:
+      UNREACHABLE();
+  }
+}
+
 // Use HGraphDelegateVisitor for which all VisitInvokeXXX() delegate to VisitInvoke().
 class LSEVisitor final : private HGraphDelegateVisitor {
  public:
@@ -718,25 +741,7 @@ class LSEVisitor final : private HGraphDelegateVisitor {
   }
 
   HInstruction* GetDefaultValue(DataType::Type type) {
-    switch (type) {
-      case DataType::Type::kReference:
-        return GetGraph()->GetNullConstant();
-      case DataType::Type::kBool:
-      case DataType::Type::kUint8:
-      case DataType::Type::kInt8:
-      case DataType::Type::kUint16:
-      case DataType::Type::kInt16:
-      case DataType::Type::kInt32:
-        return GetGraph()->GetIntConstant(0);
-      case DataType::Type::kInt64:
-        return GetGraph()->GetLongConstant(0);
-      case DataType::Type::kFloat32:
-        return GetGraph()->GetFloatConstant(0);
-      case DataType::Type::kFloat64:
-        return GetGraph()->GetDoubleConstant(0);
-      default:
-        UNREACHABLE();
-    }
+    return ::art::GetDefaultValue(GetGraph(), type);
   }
 
   bool CanValueBeKeptIfSameAsNew(Value value,
@@ -2901,31 +2906,244 @@ class LSEVisitorWrapper : public DeletableArenaObject<kArenaAllocLSE> {
   LSEVisitor lse_visitor_;
 };
 
+// An allocation copied in front of one of its escapes by `MaterializePartialEscapes()`.
+struct LoadStoreElimination::PartialMaterialization {
+  HNewInstance* allocation;
+  HNewInstance* materialization;
+  // The stores copying the fields of `allocation` into `materialization`.
+  ArrayRef<HInstanceFieldSet*> field_copies;
+};
+
+// Return the environment of an allocation materialized in front of `escape`: the one of
+// `escape`, or else the one of the closest instruction dominating it that has one, as returns
+// and field stores have none. Escape blocks are never in a try block, so instructions of try
+// blocks are skipped: an exception thrown by the allocation must not reach their handlers. The
+// original allocation dominates `escape` and is not in a try block either, which bounds the
+// search.
+static HEnvironment* FindMaterializationEnvironment(HInstruction* escape) {
+  HBasicBlock* escape_block = escape->GetBlock();
+  DCHECK(!escape_block->IsTryBlock());
+  for (HBasicBlock* block = escape_block; block != nullptr; block = block->GetDominator()) {
+    if (block->IsTryBlock()) {
+      continue;
+    }
+    HInstruction* instruction = (block == escape_block) ? escape : block->GetLastInstruction();
+    for (; instruction != nullptr; instruction = instruction->GetPrevious()) {
+      if (instruction->HasEnvironment()) {
+        return instruction->GetEnvironment();
+      }
+    }
+  }
+  LOG(FATAL) << "No environment dominates " << escape->DebugName();
+  UNREACHABLE();
+}
+
+void LoadStoreElimination::MaterializePartialEscapes(
+    /*out*/ ArenaVector<PartialMaterialization>* materializations) {
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<HNewInstance*> new_instances(allocator.Adapter(kArenaAllocLSE));
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      if (it.Current()->IsNewInstance()) {
+        new_instances.push_back(it.Current()->AsNewInstance());
+      }
+    }
+  }
+
+  ArenaAllocator* graph_allocator = graph_->GetAllocator();
+  ScopedArenaVector<HBasicBlock*> escape_blocks(allocator.Adapter(kArenaAllocLSE));
+  ScopedArenaVector<HInstanceFieldSet*> field_stores(allocator.Adapter(kArenaAllocLSE));
+  ScopedArenaVector<HInstruction*> field_values(allocator.Adapter(kArenaAllocLSE));
+  for (HNewInstance* new_instance : new_instances) {
+    escape_blocks.clear();
+    if (!CalculatePartialEscape(new_instance, &allocator, &escape_blocks)) {
+      continue;
+    }
+    // Collect one store per written field. Other fields keep their default value in the
+    // materialized object.
+    field_stores.clear();
+    bool needs_constructor_fence = false;
+    for (const HUseListNode<HInstruction*>& use : new_instance->GetUses()) {
+      HInstruction* user = use.GetUser();
+      if (user->IsInstanceFieldSet() && IsFieldAccessOf(user, new_instance)) {
+        MemberOffset offset = user->AsInstanceFieldSet()->GetFieldOffset();
+        if (std::none_of(field_stores.begin(),
+                         field_stores.end(),
+                         [offset](HInstanceFieldSet* store) {
+                           return store->GetFieldOffset() == offset;
+                         })) {
+          field_stores.push_back(user->AsInstanceFieldSet());
+        }
+      } else if (user->IsConstructorFence()) {
+        needs_constructor_fence = true;
+      }
+    }
+
+    for (HBasicBlock* block : escape_blocks) {
+      HInstruction* escape = nullptr;
+      for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+        HInstruction* instruction = it.Current();
+        if (!IsFieldAccessOf(instruction, new_instance) &&
+            !instruction->IsConstructorFence() &&
+            ContainsElement(instruction->GetInputs(), new_instance)) {
+          escape = instruction;
+          break;
+        }
+      }
+      DCHECK(escape != nullptr);
+      uint32_t dex_pc = escape->GetDexPc();
+
+      // Read the current field values before the materialization. These loads of the
+      // singleton are then replaced by the values known on each path.
+      field_values.clear();
+      for (HInstanceFieldSet* store : field_stores) {
+        const FieldInfo& info = store->GetFieldInfo();
+        HInstanceFieldGet* load = new (graph_allocator) HInstanceFieldGet(
+            new_instance,
+            info.GetField(),
+            info.GetFieldType(),
+            info.GetFieldOffset(),
+            info.IsVolatile(),
+            info.GetFieldIndex(),
+            info.GetDeclaringClassDefIndex(),
+            info.GetDexFile(),
+            dex_pc);
+        block->InsertInstructionBefore(load, escape);
+        field_values.push_back(load);
+      }
+
+      HNewInstance* materialization = new (graph_allocator) HNewInstance(
+          new_instance->InputAt(0),
+          dex_pc,
+          new_instance->GetTypeIndex(),
+          new_instance->GetDexFile(),
+          /*finalizable=*/ false,
+          new_instance->GetEntrypoint());
+      materialization->SetPartialMaterialization();
+      if (new_instance->IsPretenured()) {
+        materialization->SetPretenured();
+      }
+      materialization->SetReferenceTypeInfoIfValid(new_instance->GetReferenceTypeInfo());
+      block->InsertInstructionBefore(materialization, escape);
+      materialization->CopyEnvironmentFrom(FindMaterializationEnvironment(escape));
+
+      ArrayRef<HInstanceFieldSet*> field_copies(
+          graph_allocator->AllocArray<HInstanceFieldSet*>(field_stores.size(), kArenaAllocLSE),
+          field_stores.size());
+      for (size_t i = 0, size = field_stores.size(); i != size; ++i) {
+        const FieldInfo& info = field_stores[i]->GetFieldInfo();
+        HInstanceFieldSet* store = new (graph_allocator) HInstanceFieldSet(
+            materialization,
+            field_values[i],
+            info.GetField(),
+            info.GetFieldType(),
+            info.GetFieldOffset(),
+            info.IsVolatile(),
+            info.GetFieldIndex(),
+            info.GetDeclaringClassDefIndex(),
+            info.GetDexFile(),
+            dex_pc);
+        block->InsertInstructionBefore(store, escape);
+        field_copies[i] = store;
+      }
+      if (needs_constructor_fence) {
+        HConstructorFence* fence =
+            new (graph_allocator) HConstructorFence(materialization, dex_pc, graph_allocator);
+        block->InsertInstructionBefore(fence, escape);
+      }
+
+      // The escape and everything it reaches now use the materialized object.
+      new_instance->ReplaceUsesDominatedBy(materialization, materialization);
+      new_instance->ReplaceEnvUsesDominatedBy(materialization, materialization);
+      materializations->push_back({new_instance, materialization, field_copies});
+    }
+  }
+}
+
+void LoadStoreElimination::RollBackPartialEscapes(
+    const ArenaVector<PartialMaterialization>& materializations, bool after_elimination) {
+  for (const PartialMaterialization& entry : materializations) {
+    HNewInstance* allocation = entry.allocation;
+    HNewInstance* materialization = entry.materialization;
+    if (allocation->GetBlock() == nullptr) {
+      // The allocation is gone, only the escaping paths allocate.
+      DCHECK(after_elimination);
+      MaybeRecordStat(stats_, MethodCompilationStat::kPartialAllocationMoved);
+      continue;
+    }
+    // Keep the original allocation and let it escape again, so that the escaping paths do
+    // not allocate twice.
+    HBasicBlock* block = materialization->GetBlock();
+    for (HInstanceFieldSet* store : entry.field_copies) {
+      if (!after_elimination) {
+        // The graph is as it was before the copy, except for the copy itself.
+        HInstruction* load = store->InputAt(1);
+        block->RemoveInstruction(store);
+        DCHECK(load->IsInstanceFieldGet());
+        DCHECK(!load->HasUses());
+        block->RemoveInstruction(load);
+      } else if (store->GetBlock() == nullptr) {
+        // Load-store elimination removed this store of the default value into the new
+        // object, but it may also have removed the stores to the original allocation, which
+        // now needs the value for the escape.
+        const FieldInfo& info = store->GetFieldInfo();
+        HInstanceFieldSet* default_store = new (graph_->GetAllocator()) HInstanceFieldSet(
+            materialization,
+            GetDefaultValue(graph_, info.GetFieldType()),
+            info.GetField(),
+            info.GetFieldType(),
+            info.GetFieldOffset(),
+            info.IsVolatile(),
+            info.GetFieldIndex(),
+            info.GetDeclaringClassDefIndex(),
+            info.GetDexFile(),
+            store->GetDexPc());
+        block->InsertInstructionAfter(default_store, materialization);
+      }
+      // Other stores of the copy now write the original allocation. Their values are those
+      // of its fields at the escape, which load-store elimination may have stopped storing.
+    }
+    if (!after_elimination) {
+      HConstructorFence::RemoveConstructorFences(materialization);
+    }
+    materialization->ReplaceWith(allocation);
+    block->RemoveInstruction(materialization);
+  }
+}
+
 bool LoadStoreElimination::Run() {
   if (graph_->IsDebuggable()) {
     // Debugger may set heap values or trigger deoptimization of callers.
     // Skip this optimization.
     return false;
   }
+  // Currently load_store analysis can't handle predicated load/stores; specifically pairs of
+  // memory operations with different predicates.
+  // TODO: support predicated SIMD.
+  if (graph_->HasPredicatedSIMD()) {
+    return false;
+  }
+
+  // The copies are only worth it if the original allocations are removed, which is known
+  // after load-store elimination. Other allocations are restored as they were.
+  ArenaVector<PartialMaterialization> materializations(
+      graph_->GetAllocator()->Adapter(kArenaAllocLSE));
+  MaterializePartialEscapes(&materializations);
+
   ScopedArenaAllocator allocator(graph_->GetArenaStack());
   LoadStoreAnalysis lsa(graph_, stats_, &allocator);
   lsa.Run();
   const HeapLocationCollector& heap_location_collector = lsa.GetHeapLocationCollector();
   if (heap_location_collector.GetNumberOfHeapLocations() == 0) {
     // No HeapLocation information from LSA, skip this optimization.
-    return false;
-  }
-
-  // Currently load_store analysis can't handle predicated load/stores; specifically pairs of
-  // memory operations with different predicates.
-  // TODO: support predicated SIMD.
-  if (graph_->HasPredicatedSIMD()) {
+    RollBackPartialEscapes(materializations, /*after_elimination=*/ false);
     return false;
   }
 
   std::unique_ptr<LSEVisitorWrapper> lse_visitor(
       new (&allocator) LSEVisitorWrapper(graph_, heap_location_collector, stats_));
   lse_visitor->Run();
+  RollBackPartialEscapes(materializations, /*after_elimination=*/ true);
   return true;
 }
 
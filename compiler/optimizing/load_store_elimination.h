@@ -17,6 +17,7 @@
 #ifndef ART_COMPILER_OPTIMIZING_LOAD_STORE_ELIMINATION_H_
 #define ART_COMPILER_OPTIMIZING_LOAD_STORE_ELIMINATION_H_
 
+#include "base/arena_containers.h"
 #include "base/macros.h"
 #include "optimization.h"
 
@@ -39,6 +40,18 @@ class LoadStoreElimination : public HOptimization {
   static constexpr const char* kLoadStoreEliminationPassName = "load_store_elimination";
 
  private:
+  struct PartialMaterialization;
+
+  // Materializes allocations which escape on some paths only at their escapes, so that the
+  // allocations become singletons which are removed on the other paths.
+  void MaterializePartialEscapes(/*out*/ ArenaVector<PartialMaterialization>* materializations);
+
+  // Undoes the materializations of allocations which are still in the graph, either because
+  // load-store elimination bailed out before changing the graph or because it did not remove
+  // them.
+  void RollBackPartialEscapes(const ArenaVector<PartialMaterialization>& materializations,
+                              bool after_elimination);
+
   DISALLOW_COPY_AND_ASSIGN(LoadStoreElimination);
 };
 
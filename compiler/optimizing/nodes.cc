@@ -147,6 +147,29 @@ void ResetEnvironmentInputRecords(HInstruction* instruction) {
   }
 }
 
+void RemoveFromCycle(HInstruction* instruction) {
+  instruction->RemoveAsUserOfAllInputs();
+  instruction->RemoveEnvironmentUsers();
+  instruction->GetBlock()->RemoveInstructionOrPhi(instruction, /*ensure_safety=*/ false);
+  RemoveEnvironmentUses(instruction);
+  ResetEnvironmentInputRecords(instruction);
+}
+
+bool CanRemoveEnvironmentUses(HInstruction* instruction) {
+  // We can never remove instructions that have environment
+  // uses when we compile 'debuggable'.
+  if (instruction->HasEnvironmentUses() && instruction->GetBlock()->GetGraph()->IsDebuggable()) {
+    return false;
+  }
+  // A deoptimization should never have an environment input removed.
+  for (const HUseListNode<HEnvironment*>& use : instruction->GetEnvUses()) {
+    if (use.GetUser()->GetHolder()->IsDeoptimize()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 static void RemoveAsUser(HInstruction* instruction) {
   instruction->RemoveAsUserOfAllInputs();
   RemoveEnvironmentUses(instruction);
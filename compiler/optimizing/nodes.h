@@ -428,6 +428,7 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
         art_method_(nullptr),
         compilation_kind_(compilation_kind),
         useful_optimizing_(false),
+        disallowed_speculations_(0u),
         cha_single_implementation_list_(allocator->Adapter(kArenaAllocCHA)) {
     blocks_.reserve(kDefaultNumberOfBlocks);
   }
@@ -748,6 +749,17 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   void SetUsefulOptimizing() { useful_optimizing_ = true; }
   bool IsUsefulOptimizing() const { return useful_optimizing_; }
 
+  // Speculations that deoptimized too often in previous compilations of the
+  // outermost method. Inlined graphs share the set of the outermost graph.
+  void DisallowSpeculation(DeoptimizationKind kind) {
+    disallowed_speculations_ |= 1u << static_cast<uint32_t>(kind);
+  }
+  bool AllowsSpeculation(DeoptimizationKind kind) const {
+    return (disallowed_speculations_ & (1u << static_cast<uint32_t>(kind))) == 0u;
+  }
+  uint32_t GetDisallowedSpeculations() const { return disallowed_speculations_; }
+  void SetDisallowedSpeculations(uint32_t value) { disallowed_speculations_ = value; }
+
  private:
   void RemoveDeadBlocksInstructionsAsUsersAndDisconnect(const ArenaBitVector& visited) const;
   void RemoveDeadBlocks(const ArenaBitVector& visited);
@@ -907,6 +919,9 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   // method.
   bool useful_optimizing_;
 
+  // Bit vector of the `DeoptimizationKind`s the compiler should not speculate on.
+  uint32_t disallowed_speculations_;
+
   // List of methods that are assumed to have single implementation.
   ArenaSet<ArtMethod*> cha_single_implementation_list_;
 
@@ -4609,6 +4624,7 @@ class HNewInstance final : public HExpression<1> {
         entrypoint_(entrypoint) {
     SetPackedFlag<kFlagFinalizable>(finalizable);
     SetPackedFlag<kFlagPartialMaterialization>(false);
+    SetPackedFlag<kFlagPretenured>(false);
     SetRawInputAt(0, cls);
   }
 
@@ -4642,6 +4658,11 @@ class HNewInstance final : public HExpression<1> {
     return GetPackedFlag<kFlagPartialMaterialization>();
   }
 
+  // Whether the profile found that objects allocated here are long-lived, and
+  // should be allocated in the non-moving space.
+  bool IsPretenured() const { return GetPackedFlag<kFlagPretenured>(); }
+  void SetPretenured() { SetPackedFlag<kFlagPretenured>(true); }
+
   QuickEntrypointEnum GetEntrypoint() const { return entrypoint_; }
 
   void SetEntrypoint(QuickEntrypointEnum entrypoint) {
@@ -4667,7 +4688,8 @@ class HNewInstance final : public HExpression<1> {
  private:
   static constexpr size_t kFlagFinalizable = kNumberOfGenericPackedBits;
   static constexpr size_t kFlagPartialMaterialization = kFlagFinalizable + 1;
-  static constexpr size_t kNumberOfNewInstancePackedBits = kFlagPartialMaterialization + 1;
+  static constexpr size_t kFlagPretenured = kFlagPartialMaterialization + 1;
+  static constexpr size_t kNumberOfNewInstancePackedBits = kFlagPretenured + 1;
   static_assert(kNumberOfNewInstancePackedBits <= kMaxNumberOfPackedBits,
                 "Too many packed fields.");
 
@@ -4736,6 +4758,11 @@ enum class CodePtrLocation {
   // Used when we don't know the target code. This is also the last-resort-kind used when
   // other kinds are unimplemented or impractical (i.e. slow) on a particular architecture.
   kCallArtMethod,
+
+  // Use code pointer from the slot of the method in the JIT entry point table of its dex file,
+  // or from the ArtMethod* when the slot is null.
+  // Used for JIT with -Xjitentrypointtable.
+  kCallEntryPointTable,
 };
 
 static inline bool IsPcRelativeMethodLoadKind(MethodLoadKind load_kind) {
@@ -5373,6 +5400,7 @@ class HNewArray final : public HExpression<2> {
     SetRawInputAt(0, cls);
     SetRawInputAt(1, length);
     SetPackedField<ComponentSizeShiftField>(component_size_shift);
+    SetPackedFlag<kFlagPretenured>(false);
   }
 
   bool IsClonable() const override { return true; }
@@ -5398,6 +5426,10 @@ class HNewArray final : public HExpression<2> {
     return GetPackedField<ComponentSizeShiftField>();
   }
 
+  // See HNewInstance::IsPretenured.
+  bool IsPretenured() const { return GetPackedFlag<kFlagPretenured>(); }
+  void SetPretenured() { SetPackedFlag<kFlagPretenured>(true); }
+
   DECLARE_INSTRUCTION(NewArray);
 
  protected:
@@ -5406,8 +5438,8 @@ class HNewArray final : public HExpression<2> {
  private:
   static constexpr size_t kFieldComponentSizeShift = kNumberOfGenericPackedBits;
   static constexpr size_t kFieldComponentSizeShiftSize = MinimumBitsToStore(3u);
-  static constexpr size_t kNumberOfNewArrayPackedBits =
-      kFieldComponentSizeShift + kFieldComponentSizeShiftSize;
+  static constexpr size_t kFlagPretenured = kFieldComponentSizeShift + kFieldComponentSizeShiftSize;
+  static constexpr size_t kNumberOfNewArrayPackedBits = kFlagPretenured + 1;
   static_assert(kNumberOfNewArrayPackedBits <= kMaxNumberOfPackedBits, "Too many packed fields.");
   using ComponentSizeShiftField =
       BitField<size_t, kFieldComponentSizeShift, kFieldComponentSizeShiftSize>;
@@ -8800,6 +8832,13 @@ void RemoveEnvironmentUses(HInstruction* instruction);
 bool HasEnvironmentUsedByOthers(HInstruction* instruction);
 void ResetEnvironmentInputRecords(HInstruction* instruction);
 
+// Remove the instruction from the graph. A bit more elaborate than the usual
+// instruction removal, since there may be a cycle in the use structure.
+void RemoveFromCycle(HInstruction* instruction);
+
+// Return whether the instruction can be removed from the environments that use it.
+bool CanRemoveEnvironmentUses(HInstruction* instruction);
+
 // Detects an instruction that is >= 0. As long as the value is carried by
 // a single instruction, arithmetic wrap-around cannot occur.
 bool IsGEZero(HInstruction* instruction);
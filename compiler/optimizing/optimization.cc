@@ -49,6 +49,7 @@
 #include "driver/dex_compilation_unit.h"
 #include "gvn.h"
 #include "induction_var_analysis.h"
+#include "induction_var_strength_reduction.h"
 #include "inliner.h"
 #include "instruction_simplifier.h"
 #include "intrinsics.h"
@@ -71,6 +72,8 @@ const char* OptimizationPassName(OptimizationPass pass) {
       return SideEffectsAnalysis::kSideEffectsAnalysisPassName;
     case OptimizationPass::kInductionVarAnalysis:
       return HInductionVarAnalysis::kInductionPassName;
+    case OptimizationPass::kInductionVarStrengthReduction:
+      return HInductionVarStrengthReduction::kInductionVarStrengthReductionPassName;
     case OptimizationPass::kGlobalValueNumbering:
       return GVNOptimization::kGlobalValueNumberingPassName;
     case OptimizationPass::kInvariantCodeMotion:
@@ -149,6 +152,7 @@ OptimizationPass OptimizationPassByName(const std::string& pass_name) {
   X(OptimizationPass::kDeadCodeElimination);
   X(OptimizationPass::kGlobalValueNumbering);
   X(OptimizationPass::kInductionVarAnalysis);
+  X(OptimizationPass::kInductionVarStrengthReduction);
   X(OptimizationPass::kInliner);
   X(OptimizationPass::kInstructionSimplifier);
   X(OptimizationPass::kInvariantCodeMotion);
@@ -235,6 +239,11 @@ ArenaVector<HOptimization*> ConstructOptimizations(
         opt = new (allocator) BoundsCheckElimination(
             graph, *most_recent_side_effects, most_recent_induction, pass_name);
         break;
+      case OptimizationPass::kInductionVarStrengthReduction:
+        CHECK(most_recent_induction != nullptr);
+        opt = new (allocator) HInductionVarStrengthReduction(
+            graph, most_recent_induction, stats, pass_name);
+        break;
       //
       // Regular passes.
       //
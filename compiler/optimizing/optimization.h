@@ -76,6 +76,7 @@ enum class OptimizationPass {
   kDeadCodeElimination,
   kGlobalValueNumbering,
   kInductionVarAnalysis,
+  kInductionVarStrengthReduction,
   kInliner,
   kInstructionSimplifier,
   kInvariantCodeMotion,
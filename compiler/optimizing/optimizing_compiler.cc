@@ -54,6 +54,7 @@
 #include "oat/oat_quick_method_header.h"
 #include "optimizing/write_barrier_elimination.h"
 #include "prepare_for_register_allocation.h"
+#include "profile/profile_compilation_info.h"
 #include "profiling_info_builder.h"
 #include "reference_type_propagation.h"
 #include "register_allocator_linear_scan.h"
@@ -539,7 +540,8 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
           OptDef(OptimizationPass::kInstructionSimplifierRiscv64),
           OptDef(OptimizationPass::kSideEffectsAnalysis),
           OptDef(OptimizationPass::kGlobalValueNumbering, "GVN$after_arch"),
-          OptDef(OptimizationPass::kCriticalNativeAbiFixupRiscv64)
+          OptDef(OptimizationPass::kCriticalNativeAbiFixupRiscv64),
+          OptDef(OptimizationPass::kScheduling)
       };
       return RunOptimizations(graph,
                               codegen,
@@ -570,6 +572,9 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
           OptDef(OptimizationPass::kInstructionSimplifierX86_64),
           OptDef(OptimizationPass::kSideEffectsAnalysis),
           OptDef(OptimizationPass::kGlobalValueNumbering, "GVN$after_arch"),
+          // Schedule before the memory operand generation, which needs an array length
+          // folded into its bounds check to stay right before it.
+          OptDef(OptimizationPass::kScheduling),
           OptDef(OptimizationPass::kX86MemoryOperandGeneration)
       };
       return RunOptimizations(graph,
@@ -587,11 +592,39 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
   }
 }
 
+// Returns the register allocator to use for the method of `dex_compilation_unit`.
+static RegisterAllocator::Strategy GetRegisterAllocatorStrategy(
+    const CompilerOptions& compiler_options,
+    const DexCompilationUnit& dex_compilation_unit,
+    CompilationKind compilation_kind) {
+  switch (compiler_options.GetRegisterAllocationStrategy()) {
+    case RegisterAllocationStrategy::kLinearScan:
+      return RegisterAllocator::kRegisterAllocatorLinearScan;
+    case RegisterAllocationStrategy::kGraphColor:
+      return RegisterAllocator::kRegisterAllocatorGraphColor;
+    case RegisterAllocationStrategy::kDefault:
+      break;
+  }
+  // Spend the extra compilation time of graph coloring on the methods the profile
+  // marks as hot.
+  const ProfileCompilationInfo* pci = compiler_options.GetProfileCompilationInfo();
+  if (pci != nullptr && compilation_kind == CompilationKind::kOptimized) {
+    ProfileCompilationInfo::MethodHotness hotness = pci->GetMethodHotness(MethodReference(
+        dex_compilation_unit.GetDexFile(), dex_compilation_unit.GetDexMethodIndex()));
+    if (hotness.IsHot()) {
+      return RegisterAllocator::kRegisterAllocatorGraphColor;
+    }
+  }
+  return RegisterAllocator::kRegisterAllocatorDefault;
+}
+
 NO_INLINE  // Avoid increasing caller's frame size by large stack-allocated objects.
 static void AllocateRegisters(HGraph* graph,
                               CodeGenerator* codegen,
                               PassObserver* pass_observer,
-                              OptimizingCompilerStats* stats) {
+                              OptimizingCompilerStats* stats,
+                              RegisterAllocator::Strategy strategy =
+                                  RegisterAllocator::kRegisterAllocatorDefault) {
   {
     PassScope scope(PrepareForRegisterAllocation::kPrepareForRegisterAllocationPassName,
                     pass_observer);
@@ -608,7 +641,7 @@ static void AllocateRegisters(HGraph* graph,
   {
     PassScope scope(RegisterAllocator::kRegisterAllocatorPassName, pass_observer);
     std::unique_ptr<RegisterAllocator> register_allocator =
-        RegisterAllocator::Create(&local_allocator, codegen, liveness);
+        RegisterAllocator::Create(&local_allocator, codegen, liveness, strategy);
     register_allocator->AllocateRegisters();
   }
 }
@@ -687,6 +720,10 @@ void OptimizingCompiler::RunOptimizations(HGraph* graph,
              "instruction_simplifier$after_loop_opt"),
       OptDef(OptimizationPass::kDeadCodeElimination,
              "dead_code_elimination$after_loop_opt"),
+      // Loop optimization leaves the induction information stale.
+      OptDef(OptimizationPass::kInductionVarAnalysis,
+             "induction_var_analysis$before_strength_reduction"),
+      OptDef(OptimizationPass::kInductionVarStrengthReduction),
       // Other high-level optimizations.
       OptDef(OptimizationPass::kLoadStoreElimination),
       OptDef(OptimizationPass::kCHAGuardOptimization),
@@ -840,6 +877,14 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
   if (jit != nullptr) {
     ProfilingInfo* info = jit->GetCodeCache()->GetProfilingInfo(method, Thread::Current());
     graph->SetProfilingInfo(info);
+    if (info != nullptr) {
+      for (size_t i = 0; i <= static_cast<size_t>(DeoptimizationKind::kLast); ++i) {
+        DeoptimizationKind kind = static_cast<DeoptimizationKind>(i);
+        if (!info->AllowsSpeculation(kind)) {
+          graph->DisallowSpeculation(kind);
+        }
+      }
+    }
   }
 
   std::unique_ptr<CodeGenerator> codegen(
@@ -940,7 +985,9 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
   AllocateRegisters(graph,
                     codegen.get(),
                     &pass_observer,
-                    compilation_stats_.get());
+                    compilation_stats_.get(),
+                    GetRegisterAllocatorStrategy(
+                        compiler_options, dex_compilation_unit, compilation_kind));
 
   if (UNLIKELY(codegen->GetFrameSize() > codegen->GetMaximumFrameSize())) {
     SCOPED_TRACE << "Not compiling because of stack frame too large";
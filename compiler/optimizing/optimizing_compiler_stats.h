@@ -71,6 +71,8 @@ enum class MethodCompilationStat {
   kNotCompiledFrameTooBig,
   kInlinedMonomorphicCall,
   kInlinedPolymorphicCall,
+  kInlinedMegamorphicCall,
+  kSpeculatedBranch,
   kMonomorphicCall,
   kPolymorphicCall,
   kMegamorphicCall,
@@ -136,6 +138,10 @@ enum class MethodCompilationStat {
   kPartialStoreRemoved,
   kPartialAllocationMoved,
   kDevirtualized,
+  kRegisterSpillInserted,
+  kRegisterReloadInserted,
+  kInductionVarStrengthReduced,
+  kLinearFunctionTestReplaced,
   kLastStat
 };
 std::ostream& operator<<(std::ostream& os, MethodCompilationStat rhs);
@@ -505,11 +505,21 @@ static bool IsValidDestination(Location destination) {
       || destination.IsSIMDStackSlot();
 }
 
+static bool IsStackLocation(Location location) {
+  return location.IsStackSlot() || location.IsDoubleStackSlot() || location.IsSIMDStackSlot();
+}
+
 void RegisterAllocationResolver::AddMove(HParallelMove* move,
                                          Location source,
                                          Location destination,
                                          HInstruction* instruction,
                                          DataType::Type type) const {
+  if (source.IsRegisterKind() && IsStackLocation(destination)) {
+    MaybeRecordStat(codegen_->GetCompilationStats(), MethodCompilationStat::kRegisterSpillInserted);
+  } else if (IsStackLocation(source) && destination.IsRegisterKind()) {
+    MaybeRecordStat(codegen_->GetCompilationStats(),
+                    MethodCompilationStat::kRegisterReloadInserted);
+  }
   if (type == DataType::Type::kInt64
       && codegen_->ShouldSplitLongMoves()
       // The parallel move resolver knows how to deal with long constants.
@@ -0,0 +1,579 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "register_allocator_graph_color.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "base/bit_utils.h"
+#include "base/bit_utils_iterator.h"
+#include "base/scoped_arena_allocator.h"
+#include "code_generator.h"
+#include "ssa_liveness_analysis.h"
+
+namespace art HIDDEN {
+
+static constexpr size_t kMaxLifetimePosition = -1;
+
+// Spill cost factor of a use for each loop it is nested in.
+static constexpr float kLoopSpillCostFactor = 8.0f;
+
+// Loop depth after which uses do not get more expensive to spill.
+static constexpr size_t kMaxLoopDepthForSpillCost = 6;
+
+// Spill cost of intervals that cannot be spilled.
+static constexpr float kInfiniteSpillCost = std::numeric_limits<float>::max();
+
+/**
+ * A node of the interference graph, for one live interval.
+ */
+class RegisterAllocatorGraphColor::InterferenceNode {
+ public:
+  InterferenceNode(LiveInterval* interval, ScopedArenaAllocator* allocator)
+      : interval_(interval),
+        adjacent_nodes_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        colored_conflicts_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        forbidden_registers_(0u),
+        degree_(0u),
+        spill_cost_(0.0f),
+        is_minimal_(RegisterAllocatorGraphColor::IsMinimal(interval)),
+        is_removed_(false) {}
+
+  LiveInterval* GetInterval() const { return interval_; }
+
+  // Nodes of the same round that cannot share a register with this node.
+  const ScopedArenaVector<InterferenceNode*>& GetAdjacentNodes() const { return adjacent_nodes_; }
+  void AddInterference(InterferenceNode* other) {
+    adjacent_nodes_.push_back(other);
+    other->adjacent_nodes_.push_back(this);
+  }
+
+  // Intervals colored in previous rounds that cannot share a register with this node.
+  const ScopedArenaVector<LiveInterval*>& GetColoredConflicts() const { return colored_conflicts_; }
+  void AddColoredConflict(LiveInterval* interval) { colored_conflicts_.push_back(interval); }
+
+  // Registers held by fixed or precolored intervals that intersect this node.
+  uint32_t GetForbiddenRegisters() const { return forbidden_registers_; }
+  void AddForbiddenRegisters(uint32_t mask) { forbidden_registers_ |= mask; }
+
+  // Number of adjacent nodes that are not removed from the graph yet.
+  size_t GetDegree() const { return degree_; }
+  void SetDegree(size_t degree) { degree_ = degree; }
+  void DecrementDegree() {
+    DCHECK_NE(degree_, 0u);
+    --degree_;
+  }
+
+  float GetSpillCost() const { return spill_cost_; }
+  void SetSpillCost(float cost) { spill_cost_ = cost; }
+
+  bool IsMinimal() const { return is_minimal_; }
+
+  bool IsRemoved() const { return is_removed_; }
+  void SetRemoved() { is_removed_ = true; }
+
+ private:
+  LiveInterval* const interval_;
+  ScopedArenaVector<InterferenceNode*> adjacent_nodes_;
+  ScopedArenaVector<LiveInterval*> colored_conflicts_;
+  uint32_t forbidden_registers_;
+  size_t degree_;
+  float spill_cost_;
+  const bool is_minimal_;
+  bool is_removed_;
+};
+
+RegisterAllocatorGraphColor::RegisterAllocatorGraphColor(ScopedArenaAllocator* allocator,
+                                                         CodeGenerator* codegen,
+                                                         const SsaLivenessAnalysis& liveness)
+    : RegisterAllocatorLinearScan(allocator, codegen, liveness),
+      precolored_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+      colored_(allocator->Adapter(kArenaAllocRegisterAllocator)) {}
+
+RegisterAllocatorGraphColor::~RegisterAllocatorGraphColor() {}
+
+void RegisterAllocatorGraphColor::AssignRegisters() {
+  for (LiveInterval* interval : *unhandled_) {
+    if (interval->IsLowInterval() || interval->IsHighInterval()) {
+      // Pairs need two adjacent registers, which the coloring does not model.
+      LinearScan();
+      return;
+    }
+  }
+
+  precolored_.clear();
+  colored_.clear();
+  ScopedArenaVector<LiveInterval*> worklist(allocator_->Adapter(kArenaAllocRegisterAllocator));
+  worklist.reserve(unhandled_->size());
+  for (LiveInterval* interval : *unhandled_) {
+    if (interval->HasRegister()) {
+      // The location summary of the definition requires that register. Keep it
+      // for the definition only, and color the rest of the interval like any other.
+      precolored_.push_back(interval);
+      size_t position = interval->GetStart() + 1u;
+      if (!interval->IsDeadAt(position)) {
+        worklist.push_back(Split(interval, position));
+      }
+    } else {
+      worklist.push_back(interval);
+    }
+  }
+  unhandled_->clear();
+
+  ScopedArenaVector<LiveInterval*> spilled(allocator_->Adapter(kArenaAllocRegisterAllocator));
+  while (!worklist.empty()) {
+    ColorIntervals(ArrayRef<LiveInterval* const>(worklist));
+
+    // Intervals of previous rounds may have been evicted by an interval that needs
+    // their register at a specific position.
+    spilled.clear();
+    auto colored_kept_end = std::remove_if(
+        colored_.begin(),
+        colored_.end(),
+        [&spilled](LiveInterval* interval) {
+          if (interval->HasRegister()) {
+            return false;
+          }
+          spilled.push_back(interval);
+          return true;
+        });
+    colored_.erase(colored_kept_end, colored_.end());
+    for (LiveInterval* interval : worklist) {
+      if (interval->HasRegister()) {
+        colored_.push_back(interval);
+      } else {
+        spilled.push_back(interval);
+      }
+    }
+
+    worklist.clear();
+    for (LiveInterval* interval : spilled) {
+      SplitSpilledInterval(interval, &worklist);
+    }
+  }
+
+  for (const ScopedArenaVector<LiveInterval*>* intervals : { &precolored_, &colored_ }) {
+    for (LiveInterval* interval : *intervals) {
+      codegen_->AddAllocatedRegister((current_register_type_ == RegisterType::kCoreRegister)
+          ? Location::RegisterLocation(interval->GetRegister())
+          : Location::FpuRegisterLocation(interval->GetRegister()));
+    }
+  }
+}
+
+void RegisterAllocatorGraphColor::ColorIntervals(ArrayRef<LiveInterval* const> intervals) {
+  // Note: Nothing may be allocated with `allocator_` while `allocator` is live.
+  ScopedArenaAllocator allocator(allocator_->GetArenaStack());
+
+  uint32_t allowed_registers = 0u;
+  for (size_t reg = 0; reg != number_of_registers_; ++reg) {
+    if (!IsBlocked(reg)) {
+      allowed_registers |= 1u << reg;
+    }
+  }
+
+  ScopedArenaVector<InterferenceNode> nodes(allocator.Adapter(kArenaAllocRegisterAllocator));
+  nodes.reserve(intervals.size());
+  ScopedArenaVector<InterferenceNode*> sorted_nodes(
+      allocator.Adapter(kArenaAllocRegisterAllocator));
+  sorted_nodes.reserve(intervals.size());
+  for (LiveInterval* interval : intervals) {
+    nodes.emplace_back(interval, &allocator);
+    nodes.back().SetSpillCost(ComputeSpillCost(interval));
+    sorted_nodes.push_back(&nodes.back());
+  }
+  auto starts_before = [](InterferenceNode* lhs, InterferenceNode* rhs) {
+    return lhs->GetInterval()->GetStart() < rhs->GetInterval()->GetStart();
+  };
+  std::sort(sorted_nodes.begin(), sorted_nodes.end(), starts_before);
+
+  // Intervals that already have a register, with whether that register is required
+  // by the location summary (and thus cannot be evicted).
+  ScopedArenaVector<std::pair<LiveInterval*, bool>> colored(
+      allocator.Adapter(kArenaAllocRegisterAllocator));
+  colored.reserve(precolored_.size() + colored_.size());
+  for (LiveInterval* interval : precolored_) {
+    colored.emplace_back(interval, /* is_precolored= */ true);
+  }
+  for (LiveInterval* interval : colored_) {
+    colored.emplace_back(interval, /* is_precolored= */ false);
+  }
+  std::sort(colored.begin(),
+            colored.end(),
+            [](const std::pair<LiveInterval*, bool>& lhs,
+               const std::pair<LiveInterval*, bool>& rhs) {
+              return lhs.first->GetStart() < rhs.first->GetStart();
+            });
+  for (LiveInterval* fixed : inactive_) {
+    DCHECK(fixed->IsFixed());
+    fixed->ResetSearchCache();
+  }
+
+  // (1) Build the interference graph by sweeping over the intervals in order of
+  //     start position. An interval can only intersect the ones that started
+  //     before it and are not dead yet.
+  ScopedArenaVector<InterferenceNode*> active_nodes(
+      allocator.Adapter(kArenaAllocRegisterAllocator));
+  ScopedArenaVector<std::pair<LiveInterval*, bool>> active_colored(
+      allocator.Adapter(kArenaAllocRegisterAllocator));
+  auto remove_dead = [&active_nodes, &active_colored](size_t position) {
+    active_nodes.erase(
+        std::remove_if(active_nodes.begin(),
+                       active_nodes.end(),
+                       [position](InterferenceNode* node) {
+                         return node->GetInterval()->IsDeadAt(position);
+                       }),
+        active_nodes.end());
+    active_colored.erase(
+        std::remove_if(active_colored.begin(),
+                       active_colored.end(),
+                       [position](const std::pair<LiveInterval*, bool>& entry) {
+                         return entry.first->IsDeadAt(position);
+                       }),
+        active_colored.end());
+  };
+  auto add_colored_conflict = [](InterferenceNode* node,
+                                 const std::pair<LiveInterval*, bool>& entry) {
+    if (entry.second) {
+      node->AddForbiddenRegisters(1u << entry.first->GetRegister());
+    } else {
+      node->AddColoredConflict(entry.first);
+    }
+  };
+  auto add_colored = [&](const std::pair<LiveInterval*, bool>& entry) {
+    remove_dead(entry.first->GetStart());
+    for (InterferenceNode* node : active_nodes) {
+      if (Interferes(node->GetInterval(), entry.first)) {
+        add_colored_conflict(node, entry);
+      }
+    }
+    active_colored.push_back(entry);
+  };
+  size_t next_colored = 0u;
+  for (InterferenceNode* node : sorted_nodes) {
+    LiveInterval* interval = node->GetInterval();
+    size_t start = interval->GetStart();
+    for (; next_colored != colored.size() && colored[next_colored].first->GetStart() <= start;
+         ++next_colored) {
+      add_colored(colored[next_colored]);
+    }
+    remove_dead(start);
+    for (InterferenceNode* active : active_nodes) {
+      if (Interferes(active->GetInterval(), interval)) {
+        node->AddInterference(active);
+      }
+    }
+    for (const std::pair<LiveInterval*, bool>& entry : active_colored) {
+      if (Interferes(entry.first, interval)) {
+        add_colored_conflict(node, entry);
+      }
+    }
+    for (LiveInterval* fixed : inactive_) {
+      // Advance the search cache, the nodes are visited in order of start position.
+      fixed->Covers(start);
+      if (fixed->FirstIntersectionWith(interval) != kNoLifetime) {
+        node->AddForbiddenRegisters(GetRegisterMask(fixed, current_register_type_));
+      }
+    }
+    active_nodes.push_back(node);
+  }
+  for (; next_colored != colored.size(); ++next_colored) {
+    add_colored(colored[next_colored]);
+  }
+
+  // (2) Remove the nodes from the graph. Nodes with fewer neighbors than available
+  //     registers are guaranteed a register. When none is left, optimistically
+  //     remove the node that is the cheapest to spill per neighbor.
+  auto available_count = [allowed_registers](InterferenceNode* node) {
+    return static_cast<size_t>(POPCOUNT(allowed_registers & ~node->GetForbiddenRegisters()));
+  };
+  ScopedArenaVector<InterferenceNode*> low_degree_nodes(
+      allocator.Adapter(kArenaAllocRegisterAllocator));
+  ScopedArenaVector<InterferenceNode*> spill_candidates(
+      allocator.Adapter(kArenaAllocRegisterAllocator));
+  for (InterferenceNode& node : nodes) {
+    node.SetDegree(node.GetAdjacentNodes().size());
+    if (node.GetDegree() < available_count(&node)) {
+      low_degree_nodes.push_back(&node);
+    } else {
+      spill_candidates.push_back(&node);
+    }
+  }
+  std::sort(spill_candidates.begin(),
+            spill_candidates.end(),
+            [](InterferenceNode* lhs, InterferenceNode* rhs) {
+              return lhs->GetSpillCost() / (lhs->GetDegree() + 1u) <
+                     rhs->GetSpillCost() / (rhs->GetDegree() + 1u);
+            });
+
+  ScopedArenaVector<InterferenceNode*> stack(allocator.Adapter(kArenaAllocRegisterAllocator));
+  stack.reserve(nodes.size());
+  auto remove_node = [&](InterferenceNode* node) {
+    node->SetRemoved();
+    stack.push_back(node);
+    for (InterferenceNode* adjacent : node->GetAdjacentNodes()) {
+      if (!adjacent->IsRemoved()) {
+        adjacent->DecrementDegree();
+        if (adjacent->GetDegree() + 1u == available_count(adjacent)) {
+          low_degree_nodes.push_back(adjacent);
+        }
+      }
+    }
+  };
+  size_t next_spill_candidate = 0u;
+  while (stack.size() != nodes.size()) {
+    if (!low_degree_nodes.empty()) {
+      InterferenceNode* node = low_degree_nodes.back();
+      low_degree_nodes.pop_back();
+      if (!node->IsRemoved()) {
+        remove_node(node);
+      }
+    } else {
+      while (spill_candidates[next_spill_candidate]->IsRemoved()) {
+        ++next_spill_candidate;
+      }
+      remove_node(spill_candidates[next_spill_candidate]);
+    }
+  }
+
+  // (3) Color the nodes in reverse removal order.
+  for (auto it = stack.rbegin(), end = stack.rend(); it != end; ++it) {
+    InterferenceNode* node = *it;
+    LiveInterval* interval = node->GetInterval();
+    uint32_t used_registers = node->GetForbiddenRegisters();
+    for (InterferenceNode* adjacent : node->GetAdjacentNodes()) {
+      if (adjacent->GetInterval()->HasRegister()) {
+        used_registers |= 1u << adjacent->GetInterval()->GetRegister();
+      }
+    }
+    for (LiveInterval* conflict : node->GetColoredConflicts()) {
+      if (conflict->HasRegister()) {
+        used_registers |= 1u << conflict->GetRegister();
+      }
+    }
+    uint32_t available_registers = allowed_registers & ~used_registers;
+    if (available_registers != 0u) {
+      interval->SetRegister(SelectRegister(interval, available_registers));
+      continue;
+    }
+    if (!node->IsMinimal()) {
+      // The interval is split and the parts are colored in the next round.
+      continue;
+    }
+
+    // The interval needs a register at this position. Take one from intervals that
+    // can still be split, which are colored again in the next round.
+    int reg = kNoRegister;
+    for (uint32_t candidate : LowToHighBits(allowed_registers & ~node->GetForbiddenRegisters())) {
+      bool has_minimal_holder =
+          std::any_of(node->GetAdjacentNodes().begin(),
+                      node->GetAdjacentNodes().end(),
+                      [candidate](InterferenceNode* adjacent) {
+                        return adjacent->GetInterval()->GetRegister() ==
+                                   static_cast<int>(candidate) &&
+                               adjacent->IsMinimal();
+                      }) ||
+          std::any_of(node->GetColoredConflicts().begin(),
+                      node->GetColoredConflicts().end(),
+                      [candidate](LiveInterval* conflict) {
+                        return conflict->GetRegister() == static_cast<int>(candidate) &&
+                               IsMinimal(conflict);
+                      });
+      if (!has_minimal_holder) {
+        reg = static_cast<int>(candidate);
+        break;
+      }
+    }
+    // This situation has the potential to infinite loop, so we make it a non-debug CHECK.
+    CHECK_NE(reg, kNoRegister) << "There is not enough registers available at "
+                               << interval->GetStart();
+    for (InterferenceNode* adjacent : node->GetAdjacentNodes()) {
+      if (adjacent->GetInterval()->GetRegister() == reg) {
+        adjacent->GetInterval()->ClearRegister();
+      }
+    }
+    for (LiveInterval* conflict : node->GetColoredConflicts()) {
+      if (conflict->GetRegister() == reg) {
+        conflict->ClearRegister();
+      }
+    }
+    interval->SetRegister(reg);
+  }
+}
+
+void RegisterAllocatorGraphColor::SplitSpilledInterval(
+    LiveInterval* interval, ScopedArenaVector<LiveInterval*>* worklist) {
+  DCHECK(!interval->HasRegister());
+  DCHECK(!IsMinimal(interval));
+  size_t first_register_use = interval->FirstRegisterUse();
+  if (first_register_use == kNoLifetime) {
+    AllocateSpillSlotFor(interval);
+    return;
+  }
+
+  size_t start = interval->GetStart();
+  if (start + 1u < first_register_use) {
+    // Spill the interval until just before its first register use.
+    LiveInterval* split = SplitBetween(interval, start, first_register_use - 1u);
+    DCHECK_NE(split, interval);
+    AllocateSpillSlotFor(interval);
+    worklist->push_back(split);
+  } else {
+    // The interval starts at its first register use. Color that use and the
+    // rest of the interval separately.
+    LiveInterval* split = Split(interval, std::max(first_register_use, start + 1u));
+    DCHECK_NE(split, interval);
+    DCHECK(IsMinimal(interval));
+    worklist->push_back(interval);
+    worklist->push_back(split);
+  }
+}
+
+int RegisterAllocatorGraphColor::SelectRegister(LiveInterval* interval,
+                                                uint32_t available) const {
+  DCHECK_NE(available, 0u);
+  // Prefer the register of an adjacent sibling, which avoids a move between them.
+  for (LiveInterval* sibling = interval->GetParent();
+       sibling != nullptr;
+       sibling = sibling->GetNextSibling()) {
+    if (sibling != interval &&
+        sibling->HasRegister() &&
+        (available & (1u << sibling->GetRegister())) != 0u &&
+        (sibling->GetEnd() == interval->GetStart() || sibling->GetStart() == interval->GetEnd())) {
+      return sibling->GetRegister();
+    }
+  }
+
+  // Then the register of a phi input or output, or of an input the output can reuse.
+  size_t* free_until = registers_array_;
+  for (size_t reg = 0; reg != number_of_registers_; ++reg) {
+    free_until[reg] = ((available & (1u << reg)) != 0u) ? kMaxLifetimePosition : 0u;
+  }
+  int hint = interval->FindFirstRegisterHint(free_until, liveness_);
+  if (hint != kNoRegister) {
+    DCHECK_NE(available & (1u << hint), 0u);
+    return hint;
+  }
+
+  // We special case intervals that do not span a safepoint to try to find a caller-save
+  // register if one is available, as the linear scan does.
+  uint32_t caller_save_registers = (current_register_type_ == RegisterType::kCoreRegister)
+      ? core_registers_blocked_for_call_
+      : fp_registers_blocked_for_call_;
+  if (!interval->HasWillCallSafepoint() && (available & caller_save_registers) != 0u) {
+    available &= caller_save_registers;
+  }
+  return CTZ(available);
+}
+
+bool RegisterAllocatorGraphColor::IsMinimal(LiveInterval* interval) {
+  if (interval->IsTemp()) {
+    return true;
+  }
+  size_t first_register_use = interval->FirstRegisterUse();
+  if (first_register_use == kNoLifetime) {
+    return false;
+  }
+  size_t start = interval->GetStart();
+  return start + 1u >= first_register_use &&
+         interval->IsDeadAt(std::max(first_register_use, start + 1u));
+}
+
+static size_t FirstIntersection(LiveInterval* first, LiveInterval* second) {
+  LiveRange* first_range = first->GetFirstRange();
+  LiveRange* second_range = second->GetFirstRange();
+  while (first_range != nullptr && second_range != nullptr) {
+    if (first_range->IsBefore(*second_range)) {
+      first_range = first_range->GetNext();
+    } else if (second_range->IsBefore(*first_range)) {
+      second_range = second_range->GetNext();
+    } else {
+      return std::max(first_range->GetStart(), second_range->GetStart());
+    }
+  }
+  return kNoLifetime;
+}
+
+bool RegisterAllocatorGraphColor::Interferes(LiveInterval* first, LiveInterval* second) {
+  size_t position = FirstIntersection(first, second);
+  if (position == kNoLifetime) {
+    return false;
+  }
+  // An input that dies at the definition of an output only intersects it at that
+  // position, where the location summary may allow them to share a register.
+  return !CanReuseInputRegister(first, second, position) &&
+         !CanReuseInputRegister(second, first, position);
+}
+
+bool RegisterAllocatorGraphColor::CanReuseInputRegister(LiveInterval* input,
+                                                        LiveInterval* output,
+                                                        size_t position) {
+  HInstruction* defined_by = output->GetDefinedBy();
+  if (defined_by == nullptr ||
+      output->IsSplit() ||
+      input->IsTemp() ||
+      position != output->GetStart() ||
+      !input->IsDeadAt(position + 1u)) {
+    return false;
+  }
+  LocationSummary* locations = defined_by->GetLocations();
+  if (locations->OutputCanOverlapWithInputs() || !locations->Out().IsUnallocated()) {
+    return false;
+  }
+  HInputsRef inputs = defined_by->GetInputs();
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    if (locations->InAt(i).IsValid() && inputs[i]->GetLiveInterval() == input->GetParent()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+float RegisterAllocatorGraphColor::ComputeSpillCost(LiveInterval* interval) const {
+  if (IsMinimal(interval)) {
+    return kInfiniteSpillCost;
+  }
+  auto use_cost = [](HBasicBlock* block) {
+    float cost = 1.0f;
+    size_t depth = 0u;
+    for (HLoopInformationOutwardIterator it(*block);
+         !it.Done() && depth != kMaxLoopDepthForSpillCost;
+         it.Advance(), ++depth) {
+      cost *= kLoopSpillCostFactor;
+    }
+    return cost;
+  };
+  float cost = 0.0f;
+  if (interval->IsParent() && interval->GetDefinedBy() != nullptr) {
+    cost += use_cost(interval->GetDefinedBy()->GetBlock());
+  }
+  size_t start = interval->GetStart();
+  size_t end = interval->GetEnd();
+  for (const UsePosition& use : interval->GetUses()) {
+    size_t use_position = use.GetPosition();
+    if (use_position > end) {
+      break;
+    }
+    if (use_position >= start && !use.IsSynthesized()) {
+      cost += use_cost(use.GetUser()->GetBlock());
+    }
+  }
+  return cost;
+}
+
+}  // namespace art
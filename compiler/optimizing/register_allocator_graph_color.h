@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_REGISTER_ALLOCATOR_GRAPH_COLOR_H_
+#define ART_COMPILER_OPTIMIZING_REGISTER_ALLOCATOR_GRAPH_COLOR_H_
+
+#include "base/array_ref.h"
+#include "base/macros.h"
+#include "base/scoped_arena_containers.h"
+#include "register_allocator_linear_scan.h"
+
+namespace art HIDDEN {
+
+class CodeGenerator;
+class LiveInterval;
+class SsaLivenessAnalysis;
+
+/**
+ * A graph coloring register allocator on an `HGraph` with SSA form.
+ *
+ * The allocator shares the construction of live intervals, the spill slot
+ * assignment and the resolution with `RegisterAllocatorLinearScan`, and replaces
+ * the linear scan by an optimistic coloring of the interference graph of each
+ * register kind:
+ *
+ * - Nodes that have fewer neighbors than available registers are removed first,
+ *   then the node with the lowest spill cost per neighbor, until the graph is empty.
+ * - Nodes are then colored in reverse removal order. The color of a split sibling,
+ *   phi input or reusable input is preferred when available, which coalesces the
+ *   moves between them.
+ * - Nodes that could not be colored are split before their next register use,
+ *   with the part before it spilled, and the remaining parts are colored again.
+ *   Reloads therefore happen next to the uses that need them, and never inside
+ *   a loop when the value is not needed in a register there.
+ *
+ * Register pairs are not handled: a register kind with pair intervals falls back
+ * to the linear scan.
+ */
+class RegisterAllocatorGraphColor : public RegisterAllocatorLinearScan {
+ public:
+  RegisterAllocatorGraphColor(ScopedArenaAllocator* allocator,
+                              CodeGenerator* codegen,
+                              const SsaLivenessAnalysis& analysis);
+  ~RegisterAllocatorGraphColor() override;
+
+ protected:
+  void AssignRegisters() override;
+
+ private:
+  class InterferenceNode;
+
+  // Colors the interference graph of `intervals`, given the intervals colored in
+  // previous rounds. Intervals left without a register must be split or spilled.
+  void ColorIntervals(ArrayRef<LiveInterval* const> intervals);
+
+  // Spills the part of `interval` before its next register use, or isolates that
+  // use. Parts that still need a register are added to `worklist`.
+  void SplitSpilledInterval(LiveInterval* interval, ScopedArenaVector<LiveInterval*>* worklist);
+
+  // Returns the register to use for `interval` among the `available` ones.
+  int SelectRegister(LiveInterval* interval, uint32_t available) const;
+
+  // Returns whether `interval` only covers its first register use, and therefore
+  // cannot be made shorter to free its register.
+  static bool IsMinimal(LiveInterval* interval);
+
+  // Returns whether `first` and `second` cannot be in the same register.
+  static bool Interferes(LiveInterval* first, LiveInterval* second);
+
+  // Returns whether `output` may be in the same register as `input` at its definition.
+  static bool CanReuseInputRegister(LiveInterval* input, LiveInterval* output, size_t position);
+
+  // Estimated cost of spilling `interval`, weighted by the loop depth of its uses.
+  float ComputeSpillCost(LiveInterval* interval) const;
+
+  // Intervals whose register comes from the location summary of their definition.
+  ScopedArenaVector<LiveInterval*> precolored_;
+
+  // Intervals that were assigned a register in a previous coloring round.
+  ScopedArenaVector<LiveInterval*> colored_;
+
+  ART_FRIEND_TEST(RegisterAllocatorTest, GraphColorEviction);
+
+  DISALLOW_COPY_AND_ASSIGN(RegisterAllocatorGraphColor);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_REGISTER_ALLOCATOR_GRAPH_COLOR_H_
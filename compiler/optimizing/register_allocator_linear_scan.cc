@@ -204,7 +204,7 @@ void RegisterAllocatorLinearScan::AllocateRegistersInternal() {
       inactive_.push_back(fixed);
     }
   }
-  LinearScan();
+  AssignRegisters();
 
   inactive_.clear();
   active_.clear();
@@ -233,7 +233,7 @@ void RegisterAllocatorLinearScan::AllocateRegistersInternal() {
       inactive_.push_back(fixed);
     }
   }
-  LinearScan();
+  AssignRegisters();
 }
 
 void RegisterAllocatorLinearScan::ProcessInstruction(HInstruction* instruction) {
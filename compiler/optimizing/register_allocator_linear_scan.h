@@ -63,7 +63,12 @@ class RegisterAllocatorLinearScan : public RegisterAllocator {
         + catch_phi_spill_slots_;
   }
 
- private:
+ protected:
+  // Assigns registers of `current_register_type_` to the intervals in `unhandled_`,
+  // with the fixed intervals of that register type in `inactive_`. Subclasses that
+  // reuse the interval construction and resolution of this allocator override it.
+  virtual void AssignRegisters() { LinearScan(); }
+
   // Main methods of the allocator.
   void LinearScan();
   bool TryAllocateFreeReg(LiveInterval* interval);
@@ -28,6 +28,7 @@
 #include "driver/compiler_options.h"
 #include "nodes.h"
 #include "optimizing_unit_test.h"
+#include "register_allocator_graph_color.h"
 #include "register_allocator_linear_scan.h"
 #include "ssa_liveness_analysis.h"
 #include "ssa_phi_elimination.h"
@@ -46,11 +47,17 @@ class RegisterAllocatorTest : public CommonCompilerTest, public OptimizingUnitTe
   }
 
   // Helper functions that make use of the OptimizingUnitTest's members.
-  bool Check(const std::vector<uint16_t>& data);
+  bool Check(const std::vector<uint16_t>& data,
+             RegisterAllocator::Strategy strategy = RegisterAllocator::kRegisterAllocatorDefault);
   HGraph* BuildIfElseWithPhi(HPhi** phi, HInstruction** input1, HInstruction** input2);
   HGraph* BuildFieldReturn(HInstruction** field, HInstruction** ret);
   HGraph* BuildTwoSubs(HInstruction** first_sub, HInstruction** second_sub);
   HGraph* BuildDiv(HInstruction** div);
+  HGraph* BuildValuesLiveAcrossLoop(size_t number_of_values,
+                                    std::vector<HInstruction*>* values,
+                                    HBasicBlock** loop_header,
+                                    HBasicBlock** loop_body);
+  void CheckGraphColorSplitsAroundLoop(InstructionSet isa, size_t number_of_values);
 
   bool ValidateIntervals(const ScopedArenaVector<LiveInterval*>& intervals,
                          const CodeGenerator& codegen) {
@@ -66,13 +73,14 @@ class RegisterAllocatorTest : public CommonCompilerTest, public OptimizingUnitTe
   std::unique_ptr<CompilerOptions> compiler_options_;
 };
 
-bool RegisterAllocatorTest::Check(const std::vector<uint16_t>& data) {
+bool RegisterAllocatorTest::Check(const std::vector<uint16_t>& data,
+                                  RegisterAllocator::Strategy strategy) {
   HGraph* graph = CreateCFG(data);
   x86::CodeGeneratorX86 codegen(graph, *compiler_options_);
   SsaLivenessAnalysis liveness(graph, &codegen, GetScopedAllocator());
   liveness.Analyze();
   std::unique_ptr<RegisterAllocator> register_allocator =
-      RegisterAllocator::Create(GetScopedAllocator(), &codegen, liveness);
+      RegisterAllocator::Create(GetScopedAllocator(), &codegen, liveness, strategy);
   register_allocator->AllocateRegisters();
   return register_allocator->Validate(false);
 }
@@ -173,6 +181,7 @@ TEST_F(RegisterAllocatorTest, CFG1) {
     Instruction::RETURN);
 
   ASSERT_TRUE(Check(data));
+  ASSERT_TRUE(Check(data, RegisterAllocator::kRegisterAllocatorGraphColor));
 }
 
 TEST_F(RegisterAllocatorTest, Loop1) {
@@ -212,6 +221,7 @@ TEST_F(RegisterAllocatorTest, Loop1) {
     Instruction::RETURN | 1 << 8);
 
   ASSERT_TRUE(Check(data));
+  ASSERT_TRUE(Check(data, RegisterAllocator::kRegisterAllocatorGraphColor));
 }
 
 TEST_F(RegisterAllocatorTest, Loop2) {
@@ -261,6 +271,7 @@ TEST_F(RegisterAllocatorTest, Loop2) {
     Instruction::RETURN | 1 << 8);
 
   ASSERT_TRUE(Check(data));
+  ASSERT_TRUE(Check(data, RegisterAllocator::kRegisterAllocatorGraphColor));
 }
 
 TEST_F(RegisterAllocatorTest, Loop3) {
@@ -886,4 +897,190 @@ TEST_F(RegisterAllocatorTest, SpillInactive) {
   ASSERT_TRUE(ValidateIntervals(intervals, codegen));
 }
 
+HGraph* RegisterAllocatorTest::BuildValuesLiveAcrossLoop(size_t number_of_values,
+                                                         std::vector<HInstruction*>* values,
+                                                         HBasicBlock** loop_header,
+                                                         HBasicBlock** loop_body) {
+  /*
+   * Test the following snippet:
+   *  int v0 = p + 0; ...; int vN = p + N;
+   *  for (int i = 0; i < p; ++i) {}
+   *  return v0 + ... + vN;
+   *
+   * Which keeps all values live across a loop which does not use them.
+   */
+  HGraph* graph = CreateGraph();
+  HBasicBlock* entry = new (GetAllocator()) HBasicBlock(graph);
+  graph->AddBlock(entry);
+  graph->SetEntryBlock(entry);
+  HInstruction* parameter = new (GetAllocator()) HParameterValue(
+      graph->GetDexFile(), dex::TypeIndex(0), 0, DataType::Type::kInt32);
+  entry->AddInstruction(parameter);
+  entry->AddInstruction(new (GetAllocator()) HGoto());
+
+  HBasicBlock* pre_header = new (GetAllocator()) HBasicBlock(graph);
+  graph->AddBlock(pre_header);
+  entry->AddSuccessor(pre_header);
+  for (size_t i = 0; i != number_of_values; ++i) {
+    HInstruction* value = new (GetAllocator()) HAdd(
+        DataType::Type::kInt32, parameter, graph->GetIntConstant(static_cast<int32_t>(i)));
+    pre_header->AddInstruction(value);
+    values->push_back(value);
+  }
+  pre_header->AddInstruction(new (GetAllocator()) HGoto());
+
+  *loop_header = new (GetAllocator()) HBasicBlock(graph);
+  *loop_body = new (GetAllocator()) HBasicBlock(graph);
+  HBasicBlock* return_block = new (GetAllocator()) HBasicBlock(graph);
+  HBasicBlock* exit = new (GetAllocator()) HBasicBlock(graph);
+  graph->AddBlock(*loop_header);
+  graph->AddBlock(*loop_body);
+  graph->AddBlock(return_block);
+  graph->AddBlock(exit);
+  graph->SetExitBlock(exit);
+  pre_header->AddSuccessor(*loop_header);
+  (*loop_header)->AddSuccessor(return_block);
+  (*loop_header)->AddSuccessor(*loop_body);
+  (*loop_body)->AddSuccessor(*loop_header);
+  return_block->AddSuccessor(exit);
+
+  HPhi* phi = new (GetAllocator()) HPhi(GetAllocator(), 0, 0, DataType::Type::kInt32);
+  (*loop_header)->AddPhi(phi);
+  HInstruction* condition = new (GetAllocator()) HGreaterThanOrEqual(phi, parameter);
+  (*loop_header)->AddInstruction(condition);
+  (*loop_header)->AddInstruction(new (GetAllocator()) HIf(condition));
+  HInstruction* increment =
+      new (GetAllocator()) HAdd(DataType::Type::kInt32, phi, graph->GetIntConstant(1));
+  (*loop_body)->AddInstruction(increment);
+  (*loop_body)->AddInstruction(new (GetAllocator()) HGoto());
+  phi->AddInput(graph->GetIntConstant(0));
+  phi->AddInput(increment);
+
+  HInstruction* sum = (*values)[0];
+  for (size_t i = 1; i != number_of_values; ++i) {
+    sum = new (GetAllocator()) HAdd(DataType::Type::kInt32, sum, (*values)[i]);
+    return_block->AddInstruction(sum);
+  }
+  return_block->AddInstruction(new (GetAllocator()) HReturn(sum));
+  exit->AddInstruction(new (GetAllocator()) HExit());
+
+  graph->BuildDominatorTree();
+  return graph;
+}
+
+void RegisterAllocatorTest::CheckGraphColorSplitsAroundLoop(InstructionSet isa,
+                                                            size_t number_of_values) {
+  std::vector<HInstruction*> values;
+  HBasicBlock* loop_header;
+  HBasicBlock* loop_body;
+  HGraph* graph = BuildValuesLiveAcrossLoop(number_of_values, &values, &loop_header, &loop_body);
+  std::unique_ptr<CompilerOptions> compiler_options =
+      CommonCompilerTest::CreateCompilerOptions(isa, "default");
+  std::unique_ptr<CodeGenerator> codegen = CodeGenerator::Create(graph, *compiler_options);
+  SsaLivenessAnalysis liveness(graph, codegen.get(), GetScopedAllocator());
+  liveness.Analyze();
+
+  std::unique_ptr<RegisterAllocator> register_allocator =
+      RegisterAllocator::Create(GetScopedAllocator(),
+                                codegen.get(),
+                                liveness,
+                                RegisterAllocator::kRegisterAllocatorGraphColor);
+  register_allocator->AllocateRegisters();
+  ASSERT_TRUE(register_allocator->Validate(false));
+
+  // There are more values than registers, so some of them are spilled. They are only
+  // reloaded for their use after the loop, not inside the loop.
+  size_t loop_start = loop_header->GetLifetimeStart();
+  size_t loop_end = loop_body->GetLifetimeEnd();
+  size_t number_of_spilled_values = 0u;
+  for (HInstruction* value : values) {
+    LiveInterval* interval = value->GetLiveInterval();
+    bool is_spilled = false;
+    for (LiveInterval* sibling = interval;
+         sibling != nullptr;
+         sibling = sibling->GetNextSibling()) {
+      if (!sibling->HasRegister()) {
+        is_spilled = true;
+      } else if (sibling != interval) {
+        EXPECT_FALSE(sibling->GetStart() >= loop_start && sibling->GetStart() < loop_end)
+            << "Value " << value->GetId() << " is moved to a register at " << sibling->GetStart();
+      }
+    }
+    if (is_spilled) {
+      ++number_of_spilled_values;
+      ASSERT_TRUE(interval->HasSpillSlot());
+    }
+  }
+  EXPECT_NE(number_of_spilled_values, 0u);
+}
+
+TEST_F(RegisterAllocatorTest, GraphColorSplitsAroundLoop) {
+  CheckGraphColorSplitsAroundLoop(InstructionSet::kX86, /*number_of_values=*/ 16u);
+}
+
+#ifdef ART_ENABLE_CODEGEN_arm64
+TEST_F(RegisterAllocatorTest, ARM64GraphColorSplitsAroundLoop) {
+  CheckGraphColorSplitsAroundLoop(InstructionSet::kArm64, /*number_of_values=*/ 40u);
+}
+#endif
+
+// Test that an interval which needs a register at its only position takes it from an
+// interval colored in a previous round, which can be split and colored again.
+TEST_F(RegisterAllocatorTest, GraphColorEviction) {
+  HGraph* graph = CreateGraph();
+  HBasicBlock* entry = new (GetAllocator()) HBasicBlock(graph);
+  graph->AddBlock(entry);
+  graph->SetEntryBlock(entry);
+  HInstruction* one = new (GetAllocator()) HParameterValue(
+      graph->GetDexFile(), dex::TypeIndex(0), 0, DataType::Type::kInt32);
+  HInstruction* two = new (GetAllocator()) HParameterValue(
+      graph->GetDexFile(), dex::TypeIndex(0), 0, DataType::Type::kInt32);
+  entry->AddInstruction(one);
+  entry->AddInstruction(two);
+
+  // An interval which is live long after its definition, and can therefore be split.
+  static constexpr size_t ranges1[][2] = {{0, 20}};
+  LiveInterval* first = BuildInterval(ranges1, arraysize(ranges1), GetScopedAllocator(), -1, one);
+  LocationSummary* locations =
+      new (GetAllocator()) LocationSummary(first->GetDefinedBy(), LocationSummary::kNoCall);
+  locations->SetOut(Location::RequiresRegister());
+
+  // An interval which only covers its definition, and cannot be spilled.
+  static constexpr size_t ranges2[][2] = {{8, 9}};
+  LiveInterval* second = BuildInterval(ranges2, arraysize(ranges2), GetScopedAllocator(), -1, two);
+  locations =
+      new (GetAllocator()) LocationSummary(second->GetDefinedBy(), LocationSummary::kNoCall);
+  locations->SetOut(Location::RequiresRegister());
+
+  x86::CodeGeneratorX86 codegen(graph, *compiler_options_);
+  SsaLivenessAnalysis liveness(graph, &codegen, GetScopedAllocator());
+  RegisterAllocatorGraphColor register_allocator(GetScopedAllocator(), &codegen, liveness);
+
+  // Set just one register available, held by the first interval after a previous round.
+  register_allocator.number_of_registers_ = 1;
+  register_allocator.registers_array_ = GetAllocator()->AllocArray<size_t>(1);
+  register_allocator.current_register_type_ = RegisterAllocator::RegisterType::kCoreRegister;
+  first->SetRegister(0);
+  register_allocator.colored_.push_back(first);
+
+  LiveInterval* const worklist[] = { second };
+  register_allocator.ColorIntervals(ArrayRef<LiveInterval* const>(worklist));
+
+  ASSERT_EQ(second->GetRegister(), 0);
+  ASSERT_FALSE(first->HasRegister());
+
+  // The evicted interval is split before its next register use and colored again.
+  ScopedArenaVector<LiveInterval*> next_worklist(GetScopedAllocator()->Adapter());
+  register_allocator.SplitSpilledInterval(first, &next_worklist);
+  ASSERT_FALSE(next_worklist.empty());
+  ASSERT_NE(first->GetNextSibling(), nullptr);
+  register_allocator.colored_.push_back(second);
+  register_allocator.ColorIntervals(ArrayRef<LiveInterval* const>(next_worklist));
+
+  ScopedArenaVector<LiveInterval*> intervals(GetScopedAllocator()->Adapter());
+  intervals.push_back(first);
+  intervals.push_back(second);
+  ASSERT_TRUE(ValidateIntervals(intervals, codegen));
+}
+
 }  // namespace art
@@ -120,7 +120,10 @@ HInvokeStaticOrDirect::DispatchInfo HSharpening::SharpenLoadMethod(
             compiler_options.IsJitCompilerForSharedCode())) {
       method_load_kind = MethodLoadKind::kJitDirectAddress;
       method_load_data = reinterpret_cast<uintptr_t>(callee);
-      code_ptr_location = CodePtrLocation::kCallArtMethod;
+      code_ptr_location = Runtime::Current()->GetJit()->CanCallThroughEntryPointTable(
+                              callee, compiler_options.IsJitCompilerForSharedCode())
+          ? CodePtrLocation::kCallEntryPointTable
+          : CodePtrLocation::kCallArtMethod;
     } else {
       // Do not sharpen.
       method_load_kind = MethodLoadKind::kRuntimeCall;
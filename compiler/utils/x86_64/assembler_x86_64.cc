@@ -32,6 +32,10 @@ std::ostream& operator<<(std::ostream& os, const XmmRegister& reg) {
   return os << reg.AsFloatRegister();
 }
 
+std::ostream& operator<<(std::ostream& os, const YmmRegister& reg) {
+  return os << "ymm" << static_cast<int>(reg.AsFloatRegister());
+}
+
 std::ostream& operator<<(std::ostream& os, const X87Register& reg) {
   return os << "ST" << static_cast<int>(reg);
 }
@@ -3766,6 +3770,493 @@ void X86_64Assembler::psrldq(XmmRegister reg, const Immediate& shift_count) {
   EmitUint8(shift_count.value());
 }
 
+/** VEX.256.0F.WIG 28 /r VMOVAPS ymm1, ymm2 */
+void X86_64Assembler::vmovaps(YmmRegister dst, YmmRegister src) {
+  if (src.NeedsRex() && !dst.NeedsRex()) {
+    // Use the store form VEX.256.0F.WIG 29 /r, which fits in the 2-byte VEX prefix.
+    EmitVex256(0x29,
+               SET_VEX_M_0F,
+               SET_VEX_PP_NONE,
+               src.AsFloatRegister(),
+               ManagedRegister::NoRegister().AsX86_64(),
+               dst.AsFloatRegister());
+    return;
+  }
+  EmitVex256(0x28,
+             SET_VEX_M_0F,
+             SET_VEX_PP_NONE,
+             dst.AsFloatRegister(),
+             ManagedRegister::NoRegister().AsX86_64(),
+             src.AsFloatRegister());
+}
+
+/** VEX.256.0F.WIG 10 /r VMOVUPS ymm1, m256 */
+void X86_64Assembler::vmovups(YmmRegister dst, const Address& src) {
+  EmitVex256(0x10, SET_VEX_M_0F, SET_VEX_PP_NONE, dst.AsFloatRegister(), src);
+}
+
+/** VEX.256.0F.WIG 11 /r VMOVUPS m256, ymm1 */
+void X86_64Assembler::vmovups(const Address& dst, YmmRegister src) {
+  EmitVex256(0x11, SET_VEX_M_0F, SET_VEX_PP_NONE, src.AsFloatRegister(), dst);
+}
+
+/** VEX.256.66.0F.WIG 10 /r VMOVUPD ymm1, m256 */
+void X86_64Assembler::vmovupd(YmmRegister dst, const Address& src) {
+  EmitVex256(0x10, SET_VEX_M_0F, SET_VEX_PP_66, dst.AsFloatRegister(), src);
+}
+
+/** VEX.256.66.0F.WIG 11 /r VMOVUPD m256, ymm1 */
+void X86_64Assembler::vmovupd(const Address& dst, YmmRegister src) {
+  EmitVex256(0x11, SET_VEX_M_0F, SET_VEX_PP_66, src.AsFloatRegister(), dst);
+}
+
+/** VEX.256.F3.0F.WIG 6F /r VMOVDQU ymm1, m256 */
+void X86_64Assembler::vmovdqu(YmmRegister dst, const Address& src) {
+  EmitVex256(0x6F, SET_VEX_M_0F, SET_VEX_PP_F3, dst.AsFloatRegister(), src);
+}
+
+/** VEX.256.F3.0F.WIG 7F /r VMOVDQU m256, ymm1 */
+void X86_64Assembler::vmovdqu(const Address& dst, YmmRegister src) {
+  EmitVex256(0x7F, SET_VEX_M_0F, SET_VEX_PP_F3, src.AsFloatRegister(), dst);
+}
+
+/** VEX.256.66.0F38.W0 78 /r VPBROADCASTB ymm1, xmm2 */
+void X86_64Assembler::vpbroadcastb(YmmRegister dst, XmmRegister src) {
+  EmitVex256(0x78,
+             SET_VEX_M_0F_38,
+             SET_VEX_PP_66,
+             dst.AsFloatRegister(),
+             ManagedRegister::NoRegister().AsX86_64(),
+             src.AsFloatRegister());
+}
+
+/** VEX.256.66.0F38.W0 79 /r VPBROADCASTW ymm1, xmm2 */
+void X86_64Assembler::vpbroadcastw(YmmRegister dst, XmmRegister src) {
+  EmitVex256(0x79,
+             SET_VEX_M_0F_38,
+             SET_VEX_PP_66,
+             dst.AsFloatRegister(),
+             ManagedRegister::NoRegister().AsX86_64(),
+             src.AsFloatRegister());
+}
+
+/** VEX.256.66.0F38.W0 58 /r VPBROADCASTD ymm1, xmm2 */
+void X86_64Assembler::vpbroadcastd(YmmRegister dst, XmmRegister src) {
+  EmitVex256(0x58,
+             SET_VEX_M_0F_38,
+             SET_VEX_PP_66,
+             dst.AsFloatRegister(),
+             ManagedRegister::NoRegister().AsX86_64(),
+             src.AsFloatRegister());
+}
+
+/** VEX.256.66.0F38.W0 59 /r VPBROADCASTQ ymm1, xmm2 */
+void X86_64Assembler::vpbroadcastq(YmmRegister dst, XmmRegister src) {
+  EmitVex256(0x59,
+             SET_VEX_M_0F_38,
+             SET_VEX_PP_66,
+             dst.AsFloatRegister(),
+             ManagedRegister::NoRegister().AsX86_64(),
+             src.AsFloatRegister());
+}
+
+/** VEX.256.66.0F38.W0 18 /r VBROADCASTSS ymm1, xmm2 */
+void X86_64Assembler::vbroadcastss(YmmRegister dst, XmmRegister src) {
+  EmitVex256(0x18,
+             SET_VEX_M_0F_38,
+             SET_VEX_PP_66,
+             dst.AsFloatRegister(),
+             ManagedRegister::NoRegister().AsX86_64(),
+             src.AsFloatRegister());
+}
+
+/** VEX.256.66.0F38.W0 19 /r VBROADCASTSD ymm1, xmm2 */
+void X86_64Assembler::vbroadcastsd(YmmRegister dst, XmmRegister src) {
+  EmitVex256(0x19,
+             SET_VEX_M_0F_38,
+             SET_VEX_PP_66,
+             dst.AsFloatRegister(),
+             ManagedRegister::NoRegister().AsX86_64(),
+             src.AsFloatRegister());
+}
+
+/** VEX.256.66.0F3A.W0 39 /r ib VEXTRACTI128 xmm1, ymm2, imm8 */
+void X86_64Assembler::vextracti128(XmmRegister dst, YmmRegister src, const Immediate& imm) {
+  DCHECK(imm.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Prefix(src.NeedsRex(),
+                   /*X=*/ false,
+                   dst.NeedsRex(),
+                   ManagedRegister::NoRegister().AsX86_64(),
+                   SET_VEX_M_0F_3A,
+                   SET_VEX_PP_66);
+  EmitUint8(0x39);
+  EmitRegisterOperand(src.LowBits(), dst.LowBits());
+  EmitUint8(imm.value());
+}
+
+/** VEX.256.66.0F.WIG FC /r VPADDB ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpaddb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xFC, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG FD /r VPADDW ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpaddw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xFD, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG FE /r VPADDD ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpaddd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xFE, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG D4 /r VPADDQ ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpaddq(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xD4, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG F8 /r VPSUBB ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpsubb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xF8, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG F9 /r VPSUBW ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpsubw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xF9, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG FA /r VPSUBD ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpsubd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xFA, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG FB /r VPSUBQ ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpsubq(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xFB, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG D5 /r VPMULLW ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpmullw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xD5, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F38.WIG 40 /r VPMULLD ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpmulld(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x40, SET_VEX_M_0F_38, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG F5 /r VPMADDWD ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpmaddwd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xF5, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG DC /r VPADDUSB ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpaddusb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xDC, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG EC /r VPADDSB ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpaddsb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xEC, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG DD /r VPADDUSW ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpaddusw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xDD, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG ED /r VPADDSW ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpaddsw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xED, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG D8 /r VPSUBUSB ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpsubusb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xD8, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG E8 /r VPSUBSB ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpsubsb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xE8, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG D9 /r VPSUBUSW ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpsubusw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xD9, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG E9 /r VPSUBSW ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpsubsw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xE9, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG E0 /r VPAVGB ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpavgb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xE0, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG E3 /r VPAVGW ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpavgw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xE3, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F38.WIG 38 /r VPMINSB ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpminsb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x38, SET_VEX_M_0F_38, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F38.WIG 3C /r VPMAXSB ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpmaxsb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x3C, SET_VEX_M_0F_38, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG EA /r VPMINSW ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpminsw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xEA, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG EE /r VPMAXSW ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpmaxsw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xEE, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F38.WIG 39 /r VPMINSD ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpminsd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x39, SET_VEX_M_0F_38, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F38.WIG 3D /r VPMAXSD ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpmaxsd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x3D, SET_VEX_M_0F_38, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG DA /r VPMINUB ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpminub(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xDA, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG DE /r VPMAXUB ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpmaxub(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xDE, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F38.WIG 3A /r VPMINUW ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpminuw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x3A, SET_VEX_M_0F_38, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F38.WIG 3E /r VPMAXUW ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpmaxuw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x3E, SET_VEX_M_0F_38, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F38.WIG 3B /r VPMINUD ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpminud(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x3B, SET_VEX_M_0F_38, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F38.WIG 3F /r VPMAXUD ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpmaxud(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x3F, SET_VEX_M_0F_38, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG DB /r VPAND ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpand(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xDB, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG DF /r VPANDN ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpandn(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xDF, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG EB /r VPOR ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpor(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xEB, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG EF /r VPXOR ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpxor(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0xEF, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG 74 /r VPCMPEQB ymm1, ymm2, ymm3 */
+void X86_64Assembler::vpcmpeqb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x74, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.0F.WIG 58 /r VADDPS ymm1, ymm2, ymm3 */
+void X86_64Assembler::vaddps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x58, SET_VEX_M_0F, SET_VEX_PP_NONE, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG 58 /r VADDPD ymm1, ymm2, ymm3 */
+void X86_64Assembler::vaddpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x58, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.0F.WIG 5C /r VSUBPS ymm1, ymm2, ymm3 */
+void X86_64Assembler::vsubps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x5C, SET_VEX_M_0F, SET_VEX_PP_NONE, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG 5C /r VSUBPD ymm1, ymm2, ymm3 */
+void X86_64Assembler::vsubpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x5C, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.0F.WIG 59 /r VMULPS ymm1, ymm2, ymm3 */
+void X86_64Assembler::vmulps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x59, SET_VEX_M_0F, SET_VEX_PP_NONE, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG 59 /r VMULPD ymm1, ymm2, ymm3 */
+void X86_64Assembler::vmulpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x59, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.0F.WIG 5E /r VDIVPS ymm1, ymm2, ymm3 */
+void X86_64Assembler::vdivps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x5E, SET_VEX_M_0F, SET_VEX_PP_NONE, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG 5E /r VDIVPD ymm1, ymm2, ymm3 */
+void X86_64Assembler::vdivpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x5E, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.0F.WIG 5D /r VMINPS ymm1, ymm2, ymm3 */
+void X86_64Assembler::vminps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x5D, SET_VEX_M_0F, SET_VEX_PP_NONE, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG 5D /r VMINPD ymm1, ymm2, ymm3 */
+void X86_64Assembler::vminpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x5D, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.0F.WIG 5F /r VMAXPS ymm1, ymm2, ymm3 */
+void X86_64Assembler::vmaxps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x5F, SET_VEX_M_0F, SET_VEX_PP_NONE, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG 5F /r VMAXPD ymm1, ymm2, ymm3 */
+void X86_64Assembler::vmaxpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x5F, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.0F.WIG 54 /r VANDPS ymm1, ymm2, ymm3 */
+void X86_64Assembler::vandps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x54, SET_VEX_M_0F, SET_VEX_PP_NONE, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG 54 /r VANDPD ymm1, ymm2, ymm3 */
+void X86_64Assembler::vandpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x54, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.0F.WIG 55 /r VANDNPS ymm1, ymm2, ymm3 */
+void X86_64Assembler::vandnps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x55, SET_VEX_M_0F, SET_VEX_PP_NONE, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG 55 /r VANDNPD ymm1, ymm2, ymm3 */
+void X86_64Assembler::vandnpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x55, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.0F.WIG 56 /r VORPS ymm1, ymm2, ymm3 */
+void X86_64Assembler::vorps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x56, SET_VEX_M_0F, SET_VEX_PP_NONE, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG 56 /r VORPD ymm1, ymm2, ymm3 */
+void X86_64Assembler::vorpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x56, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.0F.WIG 57 /r VXORPS ymm1, ymm2, ymm3 */
+void X86_64Assembler::vxorps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x57, SET_VEX_M_0F, SET_VEX_PP_NONE, dst, src1, src2);
+}
+
+/** VEX.256.66.0F.WIG 57 /r VXORPD ymm1, ymm2, ymm3 */
+void X86_64Assembler::vxorpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  EmitVex256(0x57, SET_VEX_M_0F, SET_VEX_PP_66, dst, src1, src2);
+}
+
+/** VEX.256.66.0F38.WIG 1E /r VPABSD ymm1, ymm2 */
+void X86_64Assembler::vpabsd(YmmRegister dst, YmmRegister src) {
+  EmitVex256(0x1E,
+             SET_VEX_M_0F_38,
+             SET_VEX_PP_66,
+             dst.AsFloatRegister(),
+             ManagedRegister::NoRegister().AsX86_64(),
+             src.AsFloatRegister());
+}
+
+/** VEX.256.0F.WIG 5B /r VCVTDQ2PS ymm1, ymm2 */
+void X86_64Assembler::vcvtdq2ps(YmmRegister dst, YmmRegister src) {
+  EmitVex256(0x5B,
+             SET_VEX_M_0F,
+             SET_VEX_PP_NONE,
+             dst.AsFloatRegister(),
+             ManagedRegister::NoRegister().AsX86_64(),
+             src.AsFloatRegister());
+}
+
+/** VEX.256.66.0F.WIG 71 /6 ib VPSLLW ymm1, ymm2, imm8 */
+void X86_64Assembler::vpsllw(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  EmitVex256Shift(0x71, 6, dst, src, shift_count);
+}
+
+/** VEX.256.66.0F.WIG 72 /6 ib VPSLLD ymm1, ymm2, imm8 */
+void X86_64Assembler::vpslld(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  EmitVex256Shift(0x72, 6, dst, src, shift_count);
+}
+
+/** VEX.256.66.0F.WIG 73 /6 ib VPSLLQ ymm1, ymm2, imm8 */
+void X86_64Assembler::vpsllq(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  EmitVex256Shift(0x73, 6, dst, src, shift_count);
+}
+
+/** VEX.256.66.0F.WIG 71 /4 ib VPSRAW ymm1, ymm2, imm8 */
+void X86_64Assembler::vpsraw(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  EmitVex256Shift(0x71, 4, dst, src, shift_count);
+}
+
+/** VEX.256.66.0F.WIG 72 /4 ib VPSRAD ymm1, ymm2, imm8 */
+void X86_64Assembler::vpsrad(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  EmitVex256Shift(0x72, 4, dst, src, shift_count);
+}
+
+/** VEX.256.66.0F.WIG 71 /2 ib VPSRLW ymm1, ymm2, imm8 */
+void X86_64Assembler::vpsrlw(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  EmitVex256Shift(0x71, 2, dst, src, shift_count);
+}
+
+/** VEX.256.66.0F.WIG 72 /2 ib VPSRLD ymm1, ymm2, imm8 */
+void X86_64Assembler::vpsrld(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  EmitVex256Shift(0x72, 2, dst, src, shift_count);
+}
+
+/** VEX.256.66.0F.WIG 73 /2 ib VPSRLQ ymm1, ymm2, imm8 */
+void X86_64Assembler::vpsrlq(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  EmitVex256Shift(0x73, 2, dst, src, shift_count);
+}
+
+/** VEX.128.0F.WIG 77 VZEROUPPER */
+void X86_64Assembler::vzeroupper() {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(EmitVexPrefixByteZero(/*is_twobyte_form=*/ true));
+  EmitUint8(EmitVexPrefixByteOne(/*R=*/ false,
+                                 ManagedRegister::NoRegister().AsX86_64(),
+                                 SET_VEX_L_128,
+                                 SET_VEX_PP_NONE));
+  EmitUint8(0x77);
+}
+
 
 void X86_64Assembler::fldl(const Address& src) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
@@ -5846,5 +6337,86 @@ uint8_t X86_64Assembler::EmitVexPrefixByteTwo(bool W,
   return vex_prefix;
 }
 
+
+void X86_64Assembler::EmitVex256Prefix(bool R,
+                                       bool X,
+                                       bool B,
+                                       X86_64ManagedRegister vvvv,
+                                       int SET_VEX_M,
+                                       int SET_VEX_PP) {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  // The 2-byte form only encodes the R bit and the 0F opcode map.
+  bool is_twobyte_form = (SET_VEX_M == SET_VEX_M_0F) && !X && !B;
+  EmitUint8(EmitVexPrefixByteZero(is_twobyte_form));
+  if (is_twobyte_form) {
+    EmitUint8(EmitVexPrefixByteOne(R, vvvv, SET_VEX_L_256, SET_VEX_PP));
+  } else {
+    EmitUint8(EmitVexPrefixByteOne(R, X, B, SET_VEX_M));
+    EmitUint8(vvvv.IsNoRegister()
+        ? EmitVexPrefixByteTwo(/*W=*/ false, SET_VEX_L_256, SET_VEX_PP)
+        : EmitVexPrefixByteTwo(/*W=*/ false, vvvv, SET_VEX_L_256, SET_VEX_PP));
+  }
+}
+
+void X86_64Assembler::EmitVex256(uint8_t opcode,
+                                 int SET_VEX_M,
+                                 int SET_VEX_PP,
+                                 int reg,
+                                 X86_64ManagedRegister vvvv,
+                                 FloatRegister rm) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Prefix(reg > 7, /*X=*/ false, rm > 7, vvvv, SET_VEX_M, SET_VEX_PP);
+  EmitUint8(opcode);
+  EmitRegisterOperand(reg & 7, rm & 7);
+}
+
+void X86_64Assembler::EmitVex256(uint8_t opcode,
+                                 int SET_VEX_M,
+                                 int SET_VEX_PP,
+                                 int reg,
+                                 const Address& address) {
+  uint8_t rex = address.rex();
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Prefix(reg > 7,
+                   rex & GET_REX_X,
+                   rex & GET_REX_B,
+                   ManagedRegister::NoRegister().AsX86_64(),
+                   SET_VEX_M,
+                   SET_VEX_PP);
+  EmitUint8(opcode);
+  EmitOperand(reg & 7, address);
+}
+
+void X86_64Assembler::EmitVex256(uint8_t opcode,
+                                 int SET_VEX_M,
+                                 int SET_VEX_PP,
+                                 YmmRegister dst,
+                                 YmmRegister src1,
+                                 YmmRegister src2) {
+  EmitVex256(opcode,
+             SET_VEX_M,
+             SET_VEX_PP,
+             dst.AsFloatRegister(),
+             X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister()),
+             src2.AsFloatRegister());
+}
+
+void X86_64Assembler::EmitVex256Shift(uint8_t opcode,
+                                      int opcode_extension,
+                                      YmmRegister dst,
+                                      YmmRegister src,
+                                      const Immediate& shift_count) {
+  DCHECK(shift_count.is_uint8());
+  // The destination is encoded in VEX.vvvv and the shift kind in ModRM.reg.
+  EmitVex256(opcode,
+             SET_VEX_M_0F,
+             SET_VEX_PP_66,
+             opcode_extension,
+             X86_64ManagedRegister::FromXmmRegister(dst.AsFloatRegister()),
+             src.AsFloatRegister());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(shift_count.value());
+}
+
 }  // namespace x86_64
 }  // namespace art
@@ -345,7 +345,155 @@ class AssemblerX86_64AVXTest : public AssemblerX86_64Test {
   x86_64::X86_64Assembler* CreateAssembler(ArenaAllocator* allocator) override {
     return new (allocator) x86_64::X86_64Assembler(allocator, instruction_set_features_.get());
   }
+
+  // Repeat drivers for the VEX.256 instructions. The YMM registers are those with the numbers
+  // of the XMM registers from `GetFPRegisters()`.
+  std::string RepeatYY(void (x86_64::X86_64Assembler::*f)(x86_64::YmmRegister, x86_64::YmmRegister),
+                       const std::string& fmt) {
+    return RepeatVecRegisters<x86_64::YmmRegister, x86_64::YmmRegister>(f, fmt);
+  }
+
+  std::string RepeatYF(void (x86_64::X86_64Assembler::*f)(x86_64::YmmRegister, x86_64::XmmRegister),
+                       const std::string& fmt) {
+    return RepeatVecRegisters<x86_64::YmmRegister, x86_64::XmmRegister>(f, fmt);
+  }
+
+  std::string RepeatYYY(void (x86_64::X86_64Assembler::*f)(x86_64::YmmRegister,
+                                                           x86_64::YmmRegister,
+                                                           x86_64::YmmRegister),
+                        const std::string& fmt) {
+    std::string str;
+    for (x86_64::XmmRegister xmm1 : GetFPRegisters()) {
+      for (x86_64::XmmRegister xmm2 : GetFPRegisters()) {
+        for (x86_64::XmmRegister xmm3 : GetFPRegisters()) {
+          x86_64::YmmRegister reg1(xmm1);
+          x86_64::YmmRegister reg2(xmm2);
+          x86_64::YmmRegister reg3(xmm3);
+          (GetAssembler()->*f)(reg1, reg2, reg3);
+          std::string base = fmt;
+
+          ReplaceReg(REG1_TOKEN, GetAVXRegName(reg1), &base);
+          ReplaceReg(REG2_TOKEN, GetAVXRegName(reg2), &base);
+          ReplaceReg(REG3_TOKEN, GetAVXRegName(reg3), &base);
+
+          str += base;
+          str += "\n";
+        }
+      }
+    }
+    return str;
+  }
+
+  std::string RepeatYYI(void (x86_64::X86_64Assembler::*f)(x86_64::YmmRegister,
+                                                           x86_64::YmmRegister,
+                                                           const x86_64::Immediate&),
+                        const std::string& fmt) {
+    return RepeatVecRegistersImm<x86_64::YmmRegister, x86_64::YmmRegister>(f, fmt);
+  }
+
+  std::string RepeatFYI(void (x86_64::X86_64Assembler::*f)(x86_64::XmmRegister,
+                                                           x86_64::YmmRegister,
+                                                           const x86_64::Immediate&),
+                        const std::string& fmt) {
+    return RepeatVecRegistersImm<x86_64::XmmRegister, x86_64::YmmRegister>(f, fmt);
+  }
+
+  std::string RepeatYA(void (x86_64::X86_64Assembler::*f)(x86_64::YmmRegister,
+                                                          const x86_64::Address&),
+                       const std::string& fmt) {
+    std::string str;
+    for (x86_64::XmmRegister xmm : GetFPRegisters()) {
+      for (const x86_64::Address& addr : GetAddresses()) {
+        x86_64::YmmRegister reg(xmm);
+        (GetAssembler()->*f)(reg, addr);
+        std::string base = fmt;
+
+        ReplaceReg(REG_TOKEN, GetAVXRegName(reg), &base);
+        ReplaceAddr(GetAddrName(addr), &base);
+
+        str += base;
+        str += "\n";
+      }
+    }
+    return str;
+  }
+
+  std::string RepeatAY(void (x86_64::X86_64Assembler::*f)(const x86_64::Address&,
+                                                          x86_64::YmmRegister),
+                       const std::string& fmt) {
+    std::string str;
+    for (const x86_64::Address& addr : GetAddresses()) {
+      for (x86_64::XmmRegister xmm : GetFPRegisters()) {
+        x86_64::YmmRegister reg(xmm);
+        (GetAssembler()->*f)(addr, reg);
+        std::string base = fmt;
+
+        ReplaceReg(REG_TOKEN, GetAVXRegName(reg), &base);
+        ReplaceAddr(GetAddrName(addr), &base);
+
+        str += base;
+        str += "\n";
+      }
+    }
+    return str;
+  }
+
  private:
+  template <typename Reg>
+  static std::string GetAVXRegName(const Reg& reg) {
+    std::ostringstream sreg;
+    sreg << reg;
+    return sreg.str();
+  }
+
+  template <typename Reg1, typename Reg2>
+  std::string RepeatVecRegisters(void (x86_64::X86_64Assembler::*f)(Reg1, Reg2),
+                                 const std::string& fmt) {
+    std::string str;
+    for (x86_64::XmmRegister xmm1 : GetFPRegisters()) {
+      for (x86_64::XmmRegister xmm2 : GetFPRegisters()) {
+        Reg1 reg1(xmm1);
+        Reg2 reg2(xmm2);
+        (GetAssembler()->*f)(reg1, reg2);
+        std::string base = fmt;
+
+        ReplaceReg(REG1_TOKEN, GetAVXRegName(reg1), &base);
+        ReplaceReg(REG2_TOKEN, GetAVXRegName(reg2), &base);
+
+        str += base;
+        str += "\n";
+      }
+    }
+    return str;
+  }
+
+  // Immediates are unsigned bytes, as for the shift counts and lane selectors.
+  template <typename Reg1, typename Reg2>
+  std::string RepeatVecRegistersImm(
+      void (x86_64::X86_64Assembler::*f)(Reg1, Reg2, const x86_64::Immediate&),
+      const std::string& fmt) {
+    std::vector<int64_t> imms = CreateImmediateValues(/*imm_bytes=*/ 1u, /*as_uint=*/ true);
+    std::string str;
+    for (x86_64::XmmRegister xmm1 : GetFPRegisters()) {
+      for (x86_64::XmmRegister xmm2 : GetFPRegisters()) {
+        for (int64_t imm : imms) {
+          Reg1 reg1(xmm1);
+          Reg2 reg2(xmm2);
+          (GetAssembler()->*f)(reg1, reg2, CreateImmediate(imm));
+          std::string base = fmt;
+
+          ReplaceReg(REG1_TOKEN, GetAVXRegName(reg1), &base);
+          ReplaceReg(REG2_TOKEN, GetAVXRegName(reg2), &base);
+          ReplaceImm(imm, /*bias=*/ 0, /*multiplier=*/ 1, &base);
+
+          str += base;
+          str += "\n";
+        }
+      }
+    }
+    return str;
+  }
+
   std::unique_ptr<const X86_64InstructionSetFeatures> instruction_set_features_;
 };
 
@@ -1901,6 +2049,413 @@ TEST_F(AssemblerX86_64AVXTest, VFmadd213sd) {
                       "vfmadd213sd %{reg3}, %{reg2}, %{reg1}"), "vfmadd213sd");
 }
 
+TEST_F(AssemblerX86_64AVXTest, VMovapsYmm) {
+  DriverStr(RepeatYY(&x86_64::X86_64Assembler::vmovaps, "vmovaps %{reg2}, %{reg1}"), "vmovaps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VMovupsLoadYmm) {
+  DriverStr(RepeatYA(&x86_64::X86_64Assembler::vmovups, "vmovups {mem}, %{reg}"), "vmovups_l_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VMovupsStoreYmm) {
+  DriverStr(RepeatAY(&x86_64::X86_64Assembler::vmovups, "vmovups %{reg}, {mem}"), "vmovups_s_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VMovupdLoadYmm) {
+  DriverStr(RepeatYA(&x86_64::X86_64Assembler::vmovupd, "vmovupd {mem}, %{reg}"), "vmovupd_l_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VMovupdStoreYmm) {
+  DriverStr(RepeatAY(&x86_64::X86_64Assembler::vmovupd, "vmovupd %{reg}, {mem}"), "vmovupd_s_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VMovdquLoadYmm) {
+  DriverStr(RepeatYA(&x86_64::X86_64Assembler::vmovdqu, "vmovdqu {mem}, %{reg}"), "vmovdqu_l_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VMovdquStoreYmm) {
+  DriverStr(RepeatAY(&x86_64::X86_64Assembler::vmovdqu, "vmovdqu %{reg}, {mem}"), "vmovdqu_s_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPbroadcastbYmm) {
+  DriverStr(RepeatYF(&x86_64::X86_64Assembler::vpbroadcastb,
+                     "vpbroadcastb %{reg2}, %{reg1}"), "vpbroadcastb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPbroadcastwYmm) {
+  DriverStr(RepeatYF(&x86_64::X86_64Assembler::vpbroadcastw,
+                     "vpbroadcastw %{reg2}, %{reg1}"), "vpbroadcastw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPbroadcastdYmm) {
+  DriverStr(RepeatYF(&x86_64::X86_64Assembler::vpbroadcastd,
+                     "vpbroadcastd %{reg2}, %{reg1}"), "vpbroadcastd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPbroadcastqYmm) {
+  DriverStr(RepeatYF(&x86_64::X86_64Assembler::vpbroadcastq,
+                     "vpbroadcastq %{reg2}, %{reg1}"), "vpbroadcastq_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VBroadcastssYmm) {
+  DriverStr(RepeatYF(&x86_64::X86_64Assembler::vbroadcastss,
+                     "vbroadcastss %{reg2}, %{reg1}"), "vbroadcastss_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VBroadcastsdYmm) {
+  DriverStr(RepeatYF(&x86_64::X86_64Assembler::vbroadcastsd,
+                     "vbroadcastsd %{reg2}, %{reg1}"), "vbroadcastsd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VExtracti128) {
+  DriverStr(RepeatFYI(&x86_64::X86_64Assembler::vextracti128,
+                      "vextracti128 ${imm}, %{reg2}, %{reg1}"), "vextracti128");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPaddbYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpaddb,
+                      "vpaddb %{reg3}, %{reg2}, %{reg1}"), "vpaddb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPaddwYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpaddw,
+                      "vpaddw %{reg3}, %{reg2}, %{reg1}"), "vpaddw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPadddYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpaddd,
+                      "vpaddd %{reg3}, %{reg2}, %{reg1}"), "vpaddd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPaddqYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpaddq,
+                      "vpaddq %{reg3}, %{reg2}, %{reg1}"), "vpaddq_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPsubbYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpsubb,
+                      "vpsubb %{reg3}, %{reg2}, %{reg1}"), "vpsubb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPsubwYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpsubw,
+                      "vpsubw %{reg3}, %{reg2}, %{reg1}"), "vpsubw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPsubdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpsubd,
+                      "vpsubd %{reg3}, %{reg2}, %{reg1}"), "vpsubd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPsubqYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpsubq,
+                      "vpsubq %{reg3}, %{reg2}, %{reg1}"), "vpsubq_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPmullwYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpmullw,
+                      "vpmullw %{reg3}, %{reg2}, %{reg1}"), "vpmullw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPmulldYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpmulld,
+                      "vpmulld %{reg3}, %{reg2}, %{reg1}"), "vpmulld_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPmaddwdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpmaddwd,
+                      "vpmaddwd %{reg3}, %{reg2}, %{reg1}"), "vpmaddwd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPaddusbYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpaddusb,
+                      "vpaddusb %{reg3}, %{reg2}, %{reg1}"), "vpaddusb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPaddsbYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpaddsb,
+                      "vpaddsb %{reg3}, %{reg2}, %{reg1}"), "vpaddsb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPadduswYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpaddusw,
+                      "vpaddusw %{reg3}, %{reg2}, %{reg1}"), "vpaddusw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPaddswYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpaddsw,
+                      "vpaddsw %{reg3}, %{reg2}, %{reg1}"), "vpaddsw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPsubusbYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpsubusb,
+                      "vpsubusb %{reg3}, %{reg2}, %{reg1}"), "vpsubusb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPsubsbYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpsubsb,
+                      "vpsubsb %{reg3}, %{reg2}, %{reg1}"), "vpsubsb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPsubuswYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpsubusw,
+                      "vpsubusw %{reg3}, %{reg2}, %{reg1}"), "vpsubusw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPsubswYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpsubsw,
+                      "vpsubsw %{reg3}, %{reg2}, %{reg1}"), "vpsubsw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPavgbYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpavgb,
+                      "vpavgb %{reg3}, %{reg2}, %{reg1}"), "vpavgb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPavgwYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpavgw,
+                      "vpavgw %{reg3}, %{reg2}, %{reg1}"), "vpavgw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPminsbYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpminsb,
+                      "vpminsb %{reg3}, %{reg2}, %{reg1}"), "vpminsb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPmaxsbYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpmaxsb,
+                      "vpmaxsb %{reg3}, %{reg2}, %{reg1}"), "vpmaxsb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPminswYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpminsw,
+                      "vpminsw %{reg3}, %{reg2}, %{reg1}"), "vpminsw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPmaxswYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpmaxsw,
+                      "vpmaxsw %{reg3}, %{reg2}, %{reg1}"), "vpmaxsw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPminsdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpminsd,
+                      "vpminsd %{reg3}, %{reg2}, %{reg1}"), "vpminsd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPmaxsdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpmaxsd,
+                      "vpmaxsd %{reg3}, %{reg2}, %{reg1}"), "vpmaxsd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPminubYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpminub,
+                      "vpminub %{reg3}, %{reg2}, %{reg1}"), "vpminub_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPmaxubYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpmaxub,
+                      "vpmaxub %{reg3}, %{reg2}, %{reg1}"), "vpmaxub_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPminuwYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpminuw,
+                      "vpminuw %{reg3}, %{reg2}, %{reg1}"), "vpminuw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPmaxuwYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpmaxuw,
+                      "vpmaxuw %{reg3}, %{reg2}, %{reg1}"), "vpmaxuw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPminudYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpminud,
+                      "vpminud %{reg3}, %{reg2}, %{reg1}"), "vpminud_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPmaxudYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpmaxud,
+                      "vpmaxud %{reg3}, %{reg2}, %{reg1}"), "vpmaxud_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPabsdYmm) {
+  DriverStr(RepeatYY(&x86_64::X86_64Assembler::vpabsd, "vpabsd %{reg2}, %{reg1}"), "vpabsd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPandYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpand,
+                      "vpand %{reg3}, %{reg2}, %{reg1}"), "vpand_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPandnYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpandn,
+                      "vpandn %{reg3}, %{reg2}, %{reg1}"), "vpandn_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPorYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpor,
+                      "vpor %{reg3}, %{reg2}, %{reg1}"), "vpor_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPxorYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpxor,
+                      "vpxor %{reg3}, %{reg2}, %{reg1}"), "vpxor_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPcmpeqbYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vpcmpeqb,
+                      "vpcmpeqb %{reg3}, %{reg2}, %{reg1}"), "vpcmpeqb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPsllwYmm) {
+  DriverStr(RepeatYYI(&x86_64::X86_64Assembler::vpsllw,
+                      "vpsllw ${imm}, %{reg2}, %{reg1}"), "vpsllw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPslldYmm) {
+  DriverStr(RepeatYYI(&x86_64::X86_64Assembler::vpslld,
+                      "vpslld ${imm}, %{reg2}, %{reg1}"), "vpslld_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPsllqYmm) {
+  DriverStr(RepeatYYI(&x86_64::X86_64Assembler::vpsllq,
+                      "vpsllq ${imm}, %{reg2}, %{reg1}"), "vpsllq_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPsrawYmm) {
+  DriverStr(RepeatYYI(&x86_64::X86_64Assembler::vpsraw,
+                      "vpsraw ${imm}, %{reg2}, %{reg1}"), "vpsraw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPsradYmm) {
+  DriverStr(RepeatYYI(&x86_64::X86_64Assembler::vpsrad,
+                      "vpsrad ${imm}, %{reg2}, %{reg1}"), "vpsrad_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPsrlwYmm) {
+  DriverStr(RepeatYYI(&x86_64::X86_64Assembler::vpsrlw,
+                      "vpsrlw ${imm}, %{reg2}, %{reg1}"), "vpsrlw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPsrldYmm) {
+  DriverStr(RepeatYYI(&x86_64::X86_64Assembler::vpsrld,
+                      "vpsrld ${imm}, %{reg2}, %{reg1}"), "vpsrld_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPsrlqYmm) {
+  DriverStr(RepeatYYI(&x86_64::X86_64Assembler::vpsrlq,
+                      "vpsrlq ${imm}, %{reg2}, %{reg1}"), "vpsrlq_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VAddpsYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vaddps,
+                      "vaddps %{reg3}, %{reg2}, %{reg1}"), "vaddps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VAddpdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vaddpd,
+                      "vaddpd %{reg3}, %{reg2}, %{reg1}"), "vaddpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VSubpsYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vsubps,
+                      "vsubps %{reg3}, %{reg2}, %{reg1}"), "vsubps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VSubpdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vsubpd,
+                      "vsubpd %{reg3}, %{reg2}, %{reg1}"), "vsubpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VMulpsYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vmulps,
+                      "vmulps %{reg3}, %{reg2}, %{reg1}"), "vmulps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VMulpdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vmulpd,
+                      "vmulpd %{reg3}, %{reg2}, %{reg1}"), "vmulpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VDivpsYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vdivps,
+                      "vdivps %{reg3}, %{reg2}, %{reg1}"), "vdivps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VDivpdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vdivpd,
+                      "vdivpd %{reg3}, %{reg2}, %{reg1}"), "vdivpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VMinpsYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vminps,
+                      "vminps %{reg3}, %{reg2}, %{reg1}"), "vminps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VMinpdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vminpd,
+                      "vminpd %{reg3}, %{reg2}, %{reg1}"), "vminpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VMaxpsYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vmaxps,
+                      "vmaxps %{reg3}, %{reg2}, %{reg1}"), "vmaxps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VMaxpdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vmaxpd,
+                      "vmaxpd %{reg3}, %{reg2}, %{reg1}"), "vmaxpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VAndpsYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vandps,
+                      "vandps %{reg3}, %{reg2}, %{reg1}"), "vandps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VAndpdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vandpd,
+                      "vandpd %{reg3}, %{reg2}, %{reg1}"), "vandpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VAndnpsYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vandnps,
+                      "vandnps %{reg3}, %{reg2}, %{reg1}"), "vandnps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VAndnpdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vandnpd,
+                      "vandnpd %{reg3}, %{reg2}, %{reg1}"), "vandnpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VOrpsYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vorps,
+                      "vorps %{reg3}, %{reg2}, %{reg1}"), "vorps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VOrpdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vorpd,
+                      "vorpd %{reg3}, %{reg2}, %{reg1}"), "vorpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VXorpsYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vxorps,
+                      "vxorps %{reg3}, %{reg2}, %{reg1}"), "vxorps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VXorpdYmm) {
+  DriverStr(RepeatYYY(&x86_64::X86_64Assembler::vxorpd,
+                      "vxorpd %{reg3}, %{reg2}, %{reg1}"), "vxorpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VCvtdq2psYmm) {
+  DriverStr(RepeatYY(&x86_64::X86_64Assembler::vcvtdq2ps,
+                     "vcvtdq2ps %{reg2}, %{reg1}"), "vcvtdq2ps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VZeroupper) {
+  GetAssembler()->vzeroupper();
+  DriverStr("vzeroupper\n", "vzeroupper");
+}
+
 TEST_F(AssemblerX86_64Test, Phaddw) {
   DriverStr(RepeatFF(&x86_64::X86_64Assembler::phaddw, "phaddw %{reg2}, %{reg1}"), "phaddw");
 }
@@ -70,6 +70,29 @@ class XmmRegister {
 };
 std::ostream& operator<<(std::ostream& os, const XmmRegister& reg);
 
+// The 256-bit AVX register whose low 128 bits are the XMM register of the same number.
+class YmmRegister {
+ public:
+  explicit constexpr YmmRegister(FloatRegister r) : reg_(r) {}
+  explicit constexpr YmmRegister(int r) : reg_(FloatRegister(r)) {}
+  explicit constexpr YmmRegister(XmmRegister r) : reg_(r.AsFloatRegister()) {}
+  constexpr FloatRegister AsFloatRegister() const {
+    return reg_;
+  }
+  constexpr uint8_t LowBits() const {
+    return reg_ & 7;
+  }
+  constexpr bool NeedsRex() const {
+    return reg_ > 7;
+  }
+  bool operator==(const YmmRegister& other) const {
+    return reg_ == other.reg_;
+  }
+ private:
+  const FloatRegister reg_;
+};
+std::ostream& operator<<(std::ostream& os, const YmmRegister& reg);
+
 enum X87Register {
   ST0 = 0,
   ST1 = 1,
@@ -54,6 +54,14 @@
   METRIC(FullGcTracingThroughputAvg, MetricsAverage)                \
   METRIC(JitMethodCompileTotalTime, MetricsCounter)                 \
   METRIC(JitMethodCompileCount, MetricsCounter)                     \
+  METRIC(JitOsrQueueLatency, MetricsHistogram, 15, 0, 10'000)       \
+  METRIC(JitBaselineQueueLatency, MetricsHistogram, 15, 0, 10'000)  \
+  METRIC(JitOptimizedQueueLatency, MetricsHistogram, 15, 0, 10'000) \
+  METRIC(JitCodeCacheAllocationHits, MetricsCounter)                \
+  METRIC(JitCodeCacheAllocationMisses, MetricsCounter)              \
+  METRIC(JitCodeCacheEvictions, MetricsCounter)                     \
+  METRIC(JitCodeCacheEvictionRecompilations, MetricsCounter)        \
+  METRIC(JitCommitBatchSizeAvg, MetricsAverage)                     \
   METRIC(YoungGcCollectionTime, MetricsHistogram, 15, 0, 60'000)    \
   METRIC(FullGcCollectionTime, MetricsHistogram, 15, 0, 60'000)     \
   METRIC(YoungGcThroughput, MetricsHistogram, 15, 0, 10'000)        \
@@ -67,7 +75,15 @@
   METRIC(YoungGcDuration, MetricsCounter)                           \
   METRIC(FullGcScannedBytes, MetricsCounter)                        \
   METRIC(FullGcFreedBytes, MetricsCounter)                          \
-  METRIC(FullGcDuration, MetricsCounter)
+  METRIC(FullGcDuration, MetricsCounter)                            \
+  METRIC(GcSoftReferenceCount, MetricsCounter)                      \
+  METRIC(GcSoftReferenceProcessingTime, MetricsCounter)             \
+  METRIC(GcWeakReferenceCount, MetricsCounter)                      \
+  METRIC(GcWeakReferenceProcessingTime, MetricsCounter)             \
+  METRIC(GcFinalizerReferenceCount, MetricsCounter)                 \
+  METRIC(GcFinalizerReferenceProcessingTime, MetricsCounter)        \
+  METRIC(GcPhantomReferenceCount, MetricsCounter)                   \
+  METRIC(GcPhantomReferenceProcessingTime, MetricsCounter)
 
 // Increasing counter metrics, reported as Value Metrics in delta increments.
 #define ART_VALUE_METRICS(METRIC)                              \
@@ -235,8 +235,14 @@ enum class ProfileCompilationInfo::FileSectionType : uint32_t {
   // an optional reserved section not implemented on client yet.
   kAggregationCounts = 4,
 
+  // Allocation sites whose objects are long-lived and should be pretenured.
+  kAllocationSites = 5,
+
+  // The most frequent receivers of megamorphic inline caches.
+  kHotReceivers = 6,
+
   // The number of known sections.
-  kNumberOfSections = 5
+  kNumberOfSections = 7
 };
 
 class ProfileCompilationInfo::FileSectionInfo {
@@ -700,6 +706,18 @@ dex::TypeIndex ProfileCompilationInfo::FindOrCreateTypeIndex(const DexFile& dex_
   return FindOrCreateTypeIndex(dex_file, descriptor);
 }
 
+dex::TypeIndex ProfileCompilationInfo::FindTypeIndex(const DexFile& dex_file,
+                                                     TypeReference class_ref) {
+  DCHECK(class_ref.dex_file != nullptr);
+  DCHECK_LT(class_ref.TypeIndex().index_, class_ref.dex_file->NumTypeIds());
+  if (class_ref.dex_file == &dex_file) {
+    return class_ref.TypeIndex();
+  }
+  std::string_view descriptor = class_ref.dex_file->GetTypeDescriptorView(class_ref.TypeIndex());
+  const dex::TypeId* type_id = dex_file.FindTypeId(descriptor);
+  return (type_id != nullptr) ? dex_file.GetIndexForTypeId(*type_id) : dex::TypeIndex();
+}
+
 dex::TypeIndex ProfileCompilationInfo::FindOrCreateTypeIndex(const DexFile& dex_file,
                                                              std::string_view descriptor) {
   const dex::TypeId* type_id = dex_file.FindTypeId(descriptor);
@@ -1019,6 +1037,8 @@ bool ProfileCompilationInfo::Save(int fd) {
   uint64_t dex_files_section_size = sizeof(ProfileIndexType);  // Number of dex files.
   uint64_t classes_section_size = 0u;
   uint64_t methods_section_size = 0u;
+  uint64_t allocation_sites_section_size = 0u;
+  uint64_t hot_receivers_section_size = 0u;
   DCHECK_LE(info_.size(), MaxProfileIndex());
   for (const std::unique_ptr<DexFileData>& dex_data : info_) {
     if (dex_data->profile_key.size() > kMaxDexFileKeyLength) {
@@ -1031,13 +1051,17 @@ bool ProfileCompilationInfo::Save(int fd) {
         sizeof(uint16_t) + dex_data->profile_key.size();
     classes_section_size += dex_data->ClassesDataSize();
     methods_section_size += dex_data->MethodsDataSize();
+    allocation_sites_section_size += dex_data->AllocationSitesDataSize();
+    hot_receivers_section_size += dex_data->HotReceiversDataSize();
   }
 
   const uint32_t file_section_count =
       /* dex files */ 1u +
       /* extra descriptors */ (extra_descriptors_section_size != 0u ? 1u : 0u) +
       /* classes */ (classes_section_size != 0u ? 1u : 0u) +
-      /* methods */ (methods_section_size != 0u ? 1u : 0u);
+      /* methods */ (methods_section_size != 0u ? 1u : 0u) +
+      /* allocation sites */ (allocation_sites_section_size != 0u ? 1u : 0u) +
+      /* hot receivers */ (hot_receivers_section_size != 0u ? 1u : 0u);
   uint64_t header_and_infos_size =
       sizeof(FileHeader) + file_section_count * sizeof(FileSectionInfo);
 
@@ -1048,7 +1072,9 @@ bool ProfileCompilationInfo::Save(int fd) {
       dex_files_section_size +
       extra_descriptors_section_size +
       classes_section_size +
-      methods_section_size;
+      methods_section_size +
+      allocation_sites_section_size +
+      hot_receivers_section_size;
   VLOG(profiler) << "Required capacity: " << total_uncompressed_size << " bytes.";
   if (total_uncompressed_size > GetSizeErrorThresholdBytes()) {
     LOG(WARNING) << "Profile data size exceeds "
@@ -1147,6 +1173,37 @@ bool ProfileCompilationInfo::Save(int fd) {
     add_section_info(FileSectionType::kMethods, buffer.Size(), methods_section_size);
   }
 
+  // Write the allocation sites section.
+  if (allocation_sites_section_size != 0u) {
+    SafeBuffer buffer(allocation_sites_section_size);
+    for (const std::unique_ptr<DexFileData>& dex_data : info_) {
+      dex_data->WriteAllocationSites(buffer);
+    }
+    if (!buffer.Deflate()) {
+      return false;
+    }
+    if (!WriteBuffer(fd, buffer.Get(), buffer.Size())) {
+      return false;
+    }
+    add_section_info(
+        FileSectionType::kAllocationSites, buffer.Size(), allocation_sites_section_size);
+  }
+
+  // Write the hot receivers section.
+  if (hot_receivers_section_size != 0u) {
+    SafeBuffer buffer(hot_receivers_section_size);
+    for (const std::unique_ptr<DexFileData>& dex_data : info_) {
+      dex_data->WriteHotReceivers(buffer);
+    }
+    if (!buffer.Deflate()) {
+      return false;
+    }
+    if (!WriteBuffer(fd, buffer.Get(), buffer.Size())) {
+      return false;
+    }
+    add_section_info(FileSectionType::kHotReceivers, buffer.Size(), hot_receivers_section_size);
+  }
+
   if (file_offset > GetSizeWarningThresholdBytes()) {
     LOG(WARNING) << "Profile data size exceeds "
         << GetSizeWarningThresholdBytes()
@@ -1355,6 +1412,16 @@ bool ProfileCompilationInfo::AddMethod(const ProfileMethodInfo& pmi,
     dex_pc_max = accessor.InsnsSizeInCodeUnits();
   }
 
+  for (uint32_t dex_pc : pmi.pretenured_allocation_sites) {
+    // Like for inline caches, discard entries that don't fit the encoding or
+    // the code item.
+    if (dex_pc < std::numeric_limits<uint16_t>::max() && dex_pc < dex_pc_max) {
+      data->pretenured_allocation_sites.insert(
+          AllocationSite(dchecked_integral_cast<uint16_t>(pmi.ref.index),
+                         dchecked_integral_cast<uint16_t>(dex_pc)));
+    }
+  }
+
   for (const ProfileMethodInfo::ProfileInlineCache& cache : pmi.inline_caches) {
     if (cache.dex_pc >= std::numeric_limits<uint16_t>::max()) {
       // Discard entries that don't fit the encoding. This should only apply to
@@ -1372,7 +1439,6 @@ bool ProfileCompilationInfo::AddMethod(const ProfileMethodInfo& pmi,
     }
     if  (cache.is_megamorphic) {
       FindOrAddDexPc(inline_cache, cache.dex_pc)->SetIsMegamorphic();
-      continue;
     }
     for (const TypeReference& class_ref : cache.classes) {
       DexPcData* dex_pc_data = FindOrAddDexPc(inline_cache, cache.dex_pc);
@@ -1388,6 +1454,19 @@ bool ProfileCompilationInfo::AddMethod(const ProfileMethodInfo& pmi,
         dex_pc_data->SetIsMissingTypes();
       }
     }
+    if (!cache.hot_classes.empty()) {
+      DexPcData* dex_pc_data = FindOrAddDexPc(inline_cache, cache.dex_pc);
+      if (dex_pc_data->is_megamorphic && dex_pc_data->hot_classes.empty()) {
+        for (const TypeReference& class_ref : cache.hot_classes) {
+          // Only record types with a `TypeId` in the method's dex file, so that the other
+          // receivers do not add extra descriptors to the profile.
+          dex::TypeIndex type_index = FindTypeIndex(*pmi.ref.dex_file, class_ref);
+          if (type_index.IsValid()) {
+            dex_pc_data->hot_classes.push_back(type_index);
+          }
+        }
+      }
+    }
   }
   return true;
 }
@@ -1790,6 +1869,76 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::ReadMethodsSec
   return ProfileLoadStatus::kSuccess;
 }
 
+ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::ReadAllocationSitesSection(
+    ProfileSource& source,
+    const FileSectionInfo& section_info,
+    const dchecked_vector<ProfileIndexType>& dex_profile_index_remap,
+    /*out*/ std::string* error) {
+  DCHECK(section_info.GetType() == FileSectionType::kAllocationSites);
+  SafeBuffer buffer;
+  ProfileLoadStatus status = ReadSectionData(source, section_info, &buffer, error);
+  if (status != ProfileLoadStatus::kSuccess) {
+    return status;
+  }
+
+  while (buffer.GetAvailableBytes() != 0u) {
+    ProfileIndexType profile_index;
+    if (!buffer.ReadUintAndAdvance(&profile_index)) {
+      *error = "Error profile index in allocation sites section.";
+      return ProfileLoadStatus::kBadData;
+    }
+    if (profile_index >= dex_profile_index_remap.size()) {
+      *error = "Invalid profile index in allocation sites section.";
+      return ProfileLoadStatus::kBadData;
+    }
+    profile_index = dex_profile_index_remap[profile_index];
+    if (profile_index == MaxProfileIndex()) {
+      status = DexFileData::SkipAllocationSites(buffer, error);
+    } else {
+      status = info_[profile_index]->ReadAllocationSites(buffer, error);
+    }
+    if (status != ProfileLoadStatus::kSuccess) {
+      return status;
+    }
+  }
+  return ProfileLoadStatus::kSuccess;
+}
+
+ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::ReadHotReceiversSection(
+    ProfileSource& source,
+    const FileSectionInfo& section_info,
+    const dchecked_vector<ProfileIndexType>& dex_profile_index_remap,
+    /*out*/ std::string* error) {
+  DCHECK(section_info.GetType() == FileSectionType::kHotReceivers);
+  SafeBuffer buffer;
+  ProfileLoadStatus status = ReadSectionData(source, section_info, &buffer, error);
+  if (status != ProfileLoadStatus::kSuccess) {
+    return status;
+  }
+
+  while (buffer.GetAvailableBytes() != 0u) {
+    ProfileIndexType profile_index;
+    if (!buffer.ReadUintAndAdvance(&profile_index)) {
+      *error = "Error profile index in hot receivers section.";
+      return ProfileLoadStatus::kBadData;
+    }
+    if (profile_index >= dex_profile_index_remap.size()) {
+      *error = "Invalid profile index in hot receivers section.";
+      return ProfileLoadStatus::kBadData;
+    }
+    profile_index = dex_profile_index_remap[profile_index];
+    if (profile_index == MaxProfileIndex()) {
+      status = DexFileData::SkipHotReceivers(buffer, error);
+    } else {
+      status = info_[profile_index]->ReadHotReceivers(buffer, error);
+    }
+    if (status != ProfileLoadStatus::kSuccess) {
+      return status;
+    }
+  }
+  return ProfileLoadStatus::kSuccess;
+}
+
 // TODO(calin): fail fast if the dex checksums don't match.
 ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::LoadInternal(
     int32_t fd,
@@ -1914,6 +2063,20 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::LoadInternal(
       case FileSectionType::kAggregationCounts:
         // This section is only used on server side.
         break;
+      case FileSectionType::kAllocationSites:
+        // Skip if all dex files were filtered out.
+        if (!info_.empty()) {
+          status = ReadAllocationSitesSection(
+              *source, section_info, dex_profile_index_remap, error);
+        }
+        break;
+      case FileSectionType::kHotReceivers:
+        // Skip if all dex files were filtered out.
+        if (!info_.empty()) {
+          status = ReadHotReceiversSection(
+              *source, section_info, dex_profile_index_remap, error);
+        }
+        break;
       default:
         // Unknown section. Skip it. New versions of ART are allowed
         // to add sections that shall be ignored by old versions.
@@ -2034,6 +2197,11 @@ bool ProfileCompilationInfo::MergeWith(const ProfileCompilationInfo& other,
           dex_pc_data->SetIsMissingTypes();
         } else if (other_ic_it.second.is_megamorphic) {
           dex_pc_data->SetIsMegamorphic();
+          // Hot receivers only reference the dex file itself, see `DexPcData::hot_classes`.
+          if (dex_pc_data->is_megamorphic && dex_pc_data->hot_classes.empty()) {
+            dex_pc_data->hot_classes.assign(other_ic_it.second.hot_classes.begin(),
+                                            other_ic_it.second.hot_classes.end());
+          }
         } else {
           for (dex::TypeIndex type_index : other_class_set) {
             if (type_index.index_ >= num_type_ids) {
@@ -2051,6 +2219,11 @@ bool ProfileCompilationInfo::MergeWith(const ProfileCompilationInfo& other,
       }
     }
 
+    // Merge the allocation sites. They only reference the dex file itself.
+    dex_data->pretenured_allocation_sites.insert(
+        other_dex_data->pretenured_allocation_sites.begin(),
+        other_dex_data->pretenured_allocation_sites.end());
+
     // Merge the method bitmaps.
     dex_data->MergeBitmap(*other_dex_data);
   }
@@ -2067,6 +2240,14 @@ ProfileCompilationInfo::MethodHotness ProfileCompilationInfo::GetMethodHotness(
       : MethodHotness();
 }
 
+bool ProfileCompilationInfo::IsPretenuredAllocationSite(
+    const MethodReference& method_ref,
+    uint32_t dex_pc,
+    const ProfileSampleAnnotation& annotation) const {
+  const DexFileData* dex_data = FindDexDataUsingAnnotations(method_ref.dex_file, annotation);
+  return (dex_data != nullptr) && dex_data->IsPretenuredAllocationSite(method_ref.index, dex_pc);
+}
+
 bool ProfileCompilationInfo::ContainsClass(const DexFile& dex_file,
                                            dex::TypeIndex type_idx,
                                            const ProfileSampleAnnotation& annotation) const {
@@ -2684,6 +2865,211 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::DexFileData::S
   return ProfileLoadStatus::kSuccess;
 }
 
+uint32_t ProfileCompilationInfo::DexFileData::AllocationSitesDataSize() const {
+  return pretenured_allocation_sites.empty()
+      ? 0u
+      : sizeof(ProfileIndexType) +  // Which dex file.
+        sizeof(uint32_t) +          // Number of allocation sites.
+        // Method index diffs and dex pcs.
+        2u * sizeof(uint16_t) * pretenured_allocation_sites.size();
+}
+
+void ProfileCompilationInfo::DexFileData::WriteAllocationSites(SafeBuffer& buffer) const {
+  if (pretenured_allocation_sites.empty()) {
+    return;
+  }
+  buffer.WriteUintAndAdvance(profile_index);
+  buffer.WriteUintAndAdvance(dchecked_integral_cast<uint32_t>(pretenured_allocation_sites.size()));
+  uint16_t last_method_index = 0u;
+  for (const AllocationSite& site : pretenured_allocation_sites) {
+    // Sites are sorted by method index, so we can encode the difference.
+    DCHECK_GE(site.first, last_method_index);
+    buffer.WriteUintAndAdvance(dchecked_integral_cast<uint16_t>(site.first - last_method_index));
+    buffer.WriteUintAndAdvance(site.second);
+    last_method_index = site.first;
+  }
+}
+
+ProfileCompilationInfo::ProfileLoadStatus
+ProfileCompilationInfo::DexFileData::ReadAllocationSites(SafeBuffer& buffer, std::string* error) {
+  uint32_t sites_size;
+  if (!buffer.ReadUintAndAdvance(&sites_size)) {
+    *error = "Error reading allocation sites size.";
+    return ProfileLoadStatus::kBadData;
+  }
+  uint16_t method_index = 0u;
+  for (uint32_t i = 0; i != sites_size; ++i) {
+    uint16_t method_index_diff;
+    uint16_t dex_pc;
+    if (!buffer.ReadUintAndAdvance(&method_index_diff) || !buffer.ReadUintAndAdvance(&dex_pc)) {
+      *error = "Error reading allocation site.";
+      return ProfileLoadStatus::kBadData;
+    }
+    if (method_index_diff >= num_method_ids - method_index) {
+      *error = "Invalid allocation site method index.";
+      return ProfileLoadStatus::kBadData;
+    }
+    method_index += method_index_diff;
+    pretenured_allocation_sites.insert(AllocationSite(method_index, dex_pc));
+  }
+  return ProfileLoadStatus::kSuccess;
+}
+
+ProfileCompilationInfo::ProfileLoadStatus
+ProfileCompilationInfo::DexFileData::SkipAllocationSites(SafeBuffer& buffer, std::string* error) {
+  uint32_t sites_size;
+  if (!buffer.ReadUintAndAdvance(&sites_size)) {
+    *error = "Error reading allocation sites size to skip.";
+    return ProfileLoadStatus::kBadData;
+  }
+  size_t following_data_size = static_cast<size_t>(sites_size) * 2u * sizeof(uint16_t);
+  if (following_data_size > buffer.GetAvailableBytes()) {
+    *error = "Allocation sites data size to skip exceeds remaining data.";
+    return ProfileLoadStatus::kBadData;
+  }
+  buffer.Advance(following_data_size);
+  return ProfileLoadStatus::kSuccess;
+}
+
+uint32_t ProfileCompilationInfo::DexFileData::HotReceiversDataSize() const {
+  uint32_t number_of_sites = 0u;
+  uint32_t number_of_classes = 0u;
+  for (const auto& method_it : method_map) {
+    for (const auto& ic_it : method_it.second) {
+      if (ic_it.second.is_megamorphic && !ic_it.second.hot_classes.empty()) {
+        ++number_of_sites;
+        number_of_classes += ic_it.second.hot_classes.size();
+      }
+    }
+  }
+  return (number_of_sites == 0u)
+      ? 0u
+      : sizeof(ProfileIndexType) +  // Which dex file.
+        sizeof(uint32_t) +          // Number of sites.
+        // Method index diffs, dex pcs and numbers of classes.
+        number_of_sites * (2u * sizeof(uint16_t) + sizeof(uint8_t)) +
+        number_of_classes * sizeof(uint16_t);
+}
+
+void ProfileCompilationInfo::DexFileData::WriteHotReceivers(SafeBuffer& buffer) const {
+  uint32_t number_of_sites = 0u;
+  for (const auto& method_it : method_map) {
+    for (const auto& ic_it : method_it.second) {
+      if (ic_it.second.is_megamorphic && !ic_it.second.hot_classes.empty()) {
+        ++number_of_sites;
+      }
+    }
+  }
+  if (number_of_sites == 0u) {
+    return;
+  }
+  buffer.WriteUintAndAdvance(profile_index);
+  buffer.WriteUintAndAdvance(number_of_sites);
+  uint16_t last_method_index = 0u;
+  for (const auto& method_it : method_map) {
+    for (const auto& ic_it : method_it.second) {
+      const DexPcData& dex_pc_data = ic_it.second;
+      if (!dex_pc_data.is_megamorphic || dex_pc_data.hot_classes.empty()) {
+        continue;
+      }
+      // Methods are sorted by index, so we can encode the difference.
+      DCHECK_GE(method_it.first, last_method_index);
+      buffer.WriteUintAndAdvance(
+          dchecked_integral_cast<uint16_t>(method_it.first - last_method_index));
+      buffer.WriteUintAndAdvance(ic_it.first);
+      buffer.WriteUintAndAdvance(dchecked_integral_cast<uint8_t>(dex_pc_data.hot_classes.size()));
+      for (dex::TypeIndex type_index : dex_pc_data.hot_classes) {
+        buffer.WriteUintAndAdvance(type_index.index_);
+      }
+      last_method_index = method_it.first;
+    }
+  }
+}
+
+ProfileCompilationInfo::ProfileLoadStatus
+ProfileCompilationInfo::DexFileData::ReadHotReceivers(SafeBuffer& buffer, std::string* error) {
+  uint32_t number_of_sites;
+  if (!buffer.ReadUintAndAdvance(&number_of_sites)) {
+    *error = "Error reading hot receivers size.";
+    return ProfileLoadStatus::kBadData;
+  }
+  uint16_t method_index = 0u;
+  for (uint32_t i = 0; i != number_of_sites; ++i) {
+    uint16_t method_index_diff;
+    uint16_t dex_pc;
+    uint8_t number_of_classes;
+    if (!buffer.ReadUintAndAdvance(&method_index_diff) ||
+        !buffer.ReadUintAndAdvance(&dex_pc) ||
+        !buffer.ReadUintAndAdvance(&number_of_classes)) {
+      *error = "Error reading hot receivers site.";
+      return ProfileLoadStatus::kBadData;
+    }
+    if (method_index_diff >= num_method_ids - method_index) {
+      *error = "Invalid hot receivers method index.";
+      return ProfileLoadStatus::kBadData;
+    }
+    if (number_of_classes > kIndividualInlineCacheSize) {
+      *error = "Invalid number of hot receivers.";
+      return ProfileLoadStatus::kBadData;
+    }
+    method_index += method_index_diff;
+    // Hot receivers only complete the megamorphic inline caches read from the
+    // methods section, ignore the others.
+    DexPcData* dex_pc_data = nullptr;
+    auto method_it = method_map.find(method_index);
+    if (method_it != method_map.end()) {
+      auto ic_it = method_it->second.find(dex_pc);
+      if (ic_it != method_it->second.end() &&
+          ic_it->second.is_megamorphic &&
+          ic_it->second.hot_classes.empty()) {
+        dex_pc_data = &ic_it->second;
+      }
+    }
+    for (uint8_t j = 0; j != number_of_classes; ++j) {
+      uint16_t type_index;
+      if (!buffer.ReadUintAndAdvance(&type_index)) {
+        *error = "Error reading hot receiver.";
+        return ProfileLoadStatus::kBadData;
+      }
+      if (type_index >= num_type_ids) {
+        *error = "Invalid hot receiver type index.";
+        return ProfileLoadStatus::kBadData;
+      }
+      if (dex_pc_data != nullptr) {
+        dex_pc_data->hot_classes.push_back(dex::TypeIndex(type_index));
+      }
+    }
+  }
+  return ProfileLoadStatus::kSuccess;
+}
+
+ProfileCompilationInfo::ProfileLoadStatus
+ProfileCompilationInfo::DexFileData::SkipHotReceivers(SafeBuffer& buffer, std::string* error) {
+  uint32_t number_of_sites;
+  if (!buffer.ReadUintAndAdvance(&number_of_sites)) {
+    *error = "Error reading hot receivers size to skip.";
+    return ProfileLoadStatus::kBadData;
+  }
+  for (uint32_t i = 0; i != number_of_sites; ++i) {
+    uint16_t method_index_diff;
+    uint16_t dex_pc;
+    uint8_t number_of_classes;
+    if (!buffer.ReadUintAndAdvance(&method_index_diff) ||
+        !buffer.ReadUintAndAdvance(&dex_pc) ||
+        !buffer.ReadUintAndAdvance(&number_of_classes)) {
+      *error = "Error reading hot receivers site to skip.";
+      return ProfileLoadStatus::kBadData;
+    }
+    size_t classes_size = static_cast<size_t>(number_of_classes) * sizeof(uint16_t);
+    if (classes_size > buffer.GetAvailableBytes()) {
+      *error = "Hot receivers data size to skip exceeds remaining data.";
+      return ProfileLoadStatus::kBadData;
+    }
+    buffer.Advance(classes_size);
+  }
+  return ProfileLoadStatus::kSuccess;
+}
+
 uint32_t ProfileCompilationInfo::DexFileData::MethodsDataSize(
     /*out*/ uint16_t* method_flags,
     /*out*/ size_t* saved_bitmap_bit_size) const {
@@ -28,6 +28,7 @@
 #include "base/array_ref.h"
 #include "base/atomic.h"
 #include "base/bit_memory_region.h"
+#include "base/casts.h"
 #include "base/hash_map.h"
 #include "base/hash_set.h"
 #include "base/malloc_arena_pool.h"
@@ -63,6 +64,8 @@ struct ProfileMethodInfo {
     // by the profman. See `ProfileCompilationInfo::FindOrCreateTypeIndex()`.
     const std::vector<TypeReference> classes;
     const bool is_megamorphic;
+    // For a megamorphic call, the most frequent receivers, most frequent first.
+    std::vector<TypeReference> hot_classes;
   };
 
   explicit ProfileMethodInfo(MethodReference reference) : ref(reference) {}
@@ -73,6 +76,9 @@ struct ProfileMethodInfo {
 
   MethodReference ref;
   std::vector<ProfileInlineCache> inline_caches;
+  // Dex pcs of the allocations whose objects are long-lived and should be
+  // allocated directly in the non-moving space.
+  std::vector<uint32_t> pretenured_allocation_sites;
 };
 
 class FlattenProfileData;
@@ -138,7 +144,8 @@ class ProfileCompilationInfo {
     explicit DexPcData(const ArenaAllocatorAdapter<void>& allocator)
         : is_missing_types(false),
           is_megamorphic(false),
-          classes(std::less<dex::TypeIndex>(), allocator) {}
+          classes(std::less<dex::TypeIndex>(), allocator),
+          hot_classes(allocator) {}
     void AddClass(const dex::TypeIndex& type_idx);
     void SetIsMegamorphic() {
       if (is_missing_types) return;
@@ -149,11 +156,13 @@ class ProfileCompilationInfo {
       is_megamorphic = false;
       is_missing_types = true;
       classes.clear();
+      hot_classes.clear();
     }
     bool operator==(const DexPcData& other) const {
       return is_megamorphic == other.is_megamorphic &&
           is_missing_types == other.is_missing_types &&
-          classes == other.classes;
+          classes == other.classes &&
+          hot_classes == other.hot_classes;
     }
 
     // Not all runtime types can be encoded in the profile. For example if the receiver
@@ -162,6 +171,9 @@ class ProfileCompilationInfo {
     bool is_missing_types;
     bool is_megamorphic;
     ArenaSet<dex::TypeIndex> classes;
+    // For a megamorphic call, the most frequent receivers, most frequent first.
+    // Only types with a `dex::TypeId` in the dex file are recorded.
+    ArenaVector<dex::TypeIndex> hot_classes;
   };
 
   // The inline cache map: DexPc -> DexPcData.
@@ -170,6 +182,9 @@ class ProfileCompilationInfo {
   // Maps a method dex index to its inline cache.
   using MethodMap = ArenaSafeMap<uint16_t, InlineCacheMap>;
 
+  // An allocation site: method dex index and DexPc of the allocation.
+  using AllocationSite = std::pair<uint16_t, uint16_t>;
+
   // Profile method hotness information for a single method. Also includes a pointer to the inline
   // cache map.
   class MethodHotness {
@@ -338,6 +353,10 @@ class ProfileCompilationInfo {
   dex::TypeIndex FindOrCreateTypeIndex(const DexFile& dex_file, TypeReference class_ref);
   dex::TypeIndex FindOrCreateTypeIndex(const DexFile& dex_file, std::string_view descriptor);
 
+  // Find a type index in the `dex_file` if there is a `TypeId` for it, without creating
+  // an artificial type index otherwise. Returns an invalid type index if there is none.
+  static dex::TypeIndex FindTypeIndex(const DexFile& dex_file, TypeReference class_ref);
+
   // Add a class with the specified `type_index` to the profile. The `type_index`
   // can be either a normal index for a `TypeId` in the dex file, or an artificial
   // type index created by `FindOrCreateTypeIndex()`.
@@ -546,6 +565,14 @@ class ProfileCompilationInfo {
       dex::TypeIndex type_idx,
       const ProfileSampleAnnotation& annotation = ProfileSampleAnnotation::kNone) const;
 
+  // Return true if the allocation at `dex_pc` in the referenced method should be pretenured.
+  //
+  // Note: see GetMethodHotness docs for the handling of annotations.
+  bool IsPretenuredAllocationSite(
+      const MethodReference& method_ref,
+      uint32_t dex_pc,
+      const ProfileSampleAnnotation& annotation = ProfileSampleAnnotation::kNone) const;
+
   // Return the dex file for the given `profile_index`, or null if none of the provided
   // dex files has a matching checksum and a location with the same base key.
   template <typename Container>
@@ -782,6 +809,8 @@ class ProfileCompilationInfo {
           checksum(location_checksum),
           method_map(std::less<uint16_t>(), allocator->Adapter(kArenaAllocProfile)),
           class_set(std::less<dex::TypeIndex>(), allocator->Adapter(kArenaAllocProfile)),
+          pretenured_allocation_sites(std::less<AllocationSite>(),
+                                      allocator->Adapter(kArenaAllocProfile)),
           num_type_ids(num_types),
           num_method_ids(num_methods),
           bitmap_storage(allocator->Adapter(kArenaAllocProfile)),
@@ -813,6 +842,7 @@ class ProfileCompilationInfo {
           num_method_ids == other.num_method_ids &&
           method_map == other.method_map &&
           class_set == other.class_set &&
+          pretenured_allocation_sites == other.pretenured_allocation_sites &&
           BitMemoryRegion::Equals(method_bitmap, other.method_bitmap);
     }
 
@@ -879,6 +909,26 @@ class ProfileCompilationInfo {
         std::string* error);
     static ProfileLoadStatus SkipMethods(SafeBuffer& buffer, std::string* error);
 
+    bool IsPretenuredAllocationSite(uint32_t method_index, uint32_t dex_pc) const {
+      DCHECK_LT(method_index, num_method_ids);
+      if (dex_pc >= std::numeric_limits<uint16_t>::max()) {
+        return false;
+      }
+      AllocationSite site(dchecked_integral_cast<uint16_t>(method_index),
+                          dchecked_integral_cast<uint16_t>(dex_pc));
+      return pretenured_allocation_sites.find(site) != pretenured_allocation_sites.end();
+    }
+
+    uint32_t AllocationSitesDataSize() const;
+    void WriteAllocationSites(SafeBuffer& buffer) const;
+    ProfileLoadStatus ReadAllocationSites(SafeBuffer& buffer, std::string* error);
+    static ProfileLoadStatus SkipAllocationSites(SafeBuffer& buffer, std::string* error);
+
+    uint32_t HotReceiversDataSize() const;
+    void WriteHotReceivers(SafeBuffer& buffer) const;
+    ProfileLoadStatus ReadHotReceivers(SafeBuffer& buffer, std::string* error);
+    static ProfileLoadStatus SkipHotReceivers(SafeBuffer& buffer, std::string* error);
+
     // The allocator used to allocate new inline cache maps.
     ArenaAllocator* const allocator_;
     // The profile key this data belongs to.
@@ -892,6 +942,8 @@ class ProfileCompilationInfo {
     // The classes which have been profiled. Note that these don't necessarily include
     // all the classes that can be found in the inline caches reference.
     ArenaSet<dex::TypeIndex> class_set;
+    // The allocation sites to pretenure, as pairs of method index and dex pc.
+    ArenaSet<AllocationSite> pretenured_allocation_sites;
     // Find the inline caches of the the given method index. Add an empty entry if
     // no previous data is found.
     InlineCacheMap* FindOrAddHotMethod(uint16_t method_index);
@@ -1019,6 +1071,18 @@ class ProfileCompilationInfo {
       const dchecked_vector<ExtraDescriptorIndex>& extra_descriptors_remap,
       /*out*/ std::string* error);
 
+  ProfileLoadStatus ReadAllocationSitesSection(
+      ProfileSource& source,
+      const FileSectionInfo& section_info,
+      const dchecked_vector<ProfileIndexType>& dex_profile_index_remap,
+      /*out*/ std::string* error);
+
+  ProfileLoadStatus ReadHotReceiversSection(
+      ProfileSource& source,
+      const FileSectionInfo& section_info,
+      const dchecked_vector<ProfileIndexType>& dex_profile_index_remap,
+      /*out*/ std::string* error);
+
   // Entry point for profile loading functionality.
   ProfileLoadStatus LoadInternal(
       int32_t fd,
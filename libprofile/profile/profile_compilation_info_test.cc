@@ -549,6 +549,133 @@ TEST_F(ProfileCompilationInfoTest, SaveInlineCaches) {
   ASSERT_TRUE(EqualInlineCaches(inline_caches, dex4, loaded_hotness2, loaded_info));
 }
 
+TEST_F(ProfileCompilationInfoTest, SaveAllocationSites) {
+  ScratchFile profile;
+
+  ProfileCompilationInfo saved_info;
+  for (uint16_t method_idx = 0; method_idx < 10; method_idx++) {
+    ProfileMethodInfo pmi(MethodReference(dex1, method_idx));
+    pmi.pretenured_allocation_sites = {2u, method_idx + 5u};
+    ASSERT_TRUE(saved_info.AddMethod(pmi, Hotness::kFlagHot, ProfileSampleAnnotation::kNone,
+                                     /*is_test=*/ true));
+  }
+  // Allocation sites are only recorded for hot methods.
+  ProfileMethodInfo startup_pmi(MethodReference(dex2, /*index=*/ 1));
+  startup_pmi.pretenured_allocation_sites = {3u};
+  ASSERT_TRUE(saved_info.AddMethod(startup_pmi, Hotness::kFlagStartup,
+                                   ProfileSampleAnnotation::kNone, /*is_test=*/ true));
+
+  ASSERT_TRUE(saved_info.Save(GetFd(profile)));
+  ASSERT_EQ(0, profile.GetFile()->Flush());
+
+  // Check that we get back what we saved.
+  ProfileCompilationInfo loaded_info;
+  ASSERT_TRUE(loaded_info.Load(GetFd(profile)));
+  ASSERT_TRUE(loaded_info.Equals(saved_info));
+
+  ASSERT_TRUE(loaded_info.IsPretenuredAllocationSite(MethodReference(dex1, 3), 2u));
+  ASSERT_TRUE(loaded_info.IsPretenuredAllocationSite(MethodReference(dex1, 3), 8u));
+  ASSERT_FALSE(loaded_info.IsPretenuredAllocationSite(MethodReference(dex1, 3), 9u));
+  ASSERT_FALSE(loaded_info.IsPretenuredAllocationSite(MethodReference(dex1, 11), 2u));
+  ASSERT_FALSE(loaded_info.IsPretenuredAllocationSite(MethodReference(dex2, 1), 3u));
+
+  // Merging keeps the sites of both profiles.
+  ProfileCompilationInfo other_info;
+  ProfileMethodInfo other_pmi(MethodReference(dex2, /*index=*/ 4));
+  other_pmi.pretenured_allocation_sites = {7u};
+  ASSERT_TRUE(other_info.AddMethod(other_pmi, Hotness::kFlagHot, ProfileSampleAnnotation::kNone,
+                                   /*is_test=*/ true));
+  ASSERT_TRUE(loaded_info.MergeWith(other_info));
+  ASSERT_TRUE(loaded_info.IsPretenuredAllocationSite(MethodReference(dex1, 3), 2u));
+  ASSERT_TRUE(loaded_info.IsPretenuredAllocationSite(MethodReference(dex2, 4), 7u));
+}
+
+TEST_F(ProfileCompilationInfoTest, SaveHotReceivers) {
+  ScratchFile profile;
+
+  std::vector<TypeReference> types = {
+      TypeReference(dex1, dex::TypeIndex(0)),
+      TypeReference(dex1, dex::TypeIndex(1)),
+      TypeReference(dex1, dex::TypeIndex(2)),
+      TypeReference(dex1, dex::TypeIndex(3)),
+      TypeReference(dex1, dex::TypeIndex(4))};
+  ProfileInlineCache megamorphic_cache(/*pc=*/ 3, /*missing_types=*/ false, types);
+  megamorphic_cache.hot_classes = {TypeReference(dex1, dex::TypeIndex(3)),
+                                   TypeReference(dex1, dex::TypeIndex(1))};
+  // Hot receivers are only recorded for megamorphic calls.
+  ProfileInlineCache polymorphic_cache(/*pc=*/ 4, /*missing_types=*/ false, {types[0], types[1]});
+  polymorphic_cache.hot_classes = {types[0]};
+
+  ProfileCompilationInfo saved_info;
+  ProfileMethodInfo pmi(MethodReference(dex1, /*index=*/ 2),
+                        {megamorphic_cache, polymorphic_cache});
+  ASSERT_TRUE(saved_info.AddMethod(pmi, Hotness::kFlagHot, ProfileSampleAnnotation::kNone,
+                                   /*is_test=*/ true));
+
+  ASSERT_TRUE(saved_info.Save(GetFd(profile)));
+  ASSERT_EQ(0, profile.GetFile()->Flush());
+
+  // Check that we get back what we saved.
+  ProfileCompilationInfo loaded_info;
+  ASSERT_TRUE(loaded_info.Load(GetFd(profile)));
+  ASSERT_TRUE(loaded_info.Equals(saved_info));
+
+  ProfileCompilationInfo::MethodHotness loaded_hotness = GetMethod(loaded_info, dex1, 2);
+  ASSERT_TRUE(loaded_hotness.IsHot());
+  const ProfileCompilationInfo::InlineCacheMap* loaded_caches = loaded_hotness.GetInlineCacheMap();
+  const ProfileCompilationInfo::DexPcData& megamorphic_data = loaded_caches->Get(3);
+  ASSERT_TRUE(megamorphic_data.is_megamorphic);
+  ASSERT_EQ(2u, megamorphic_data.hot_classes.size());
+  ASSERT_EQ(dex::TypeIndex(3), megamorphic_data.hot_classes[0]);
+  ASSERT_EQ(dex::TypeIndex(1), megamorphic_data.hot_classes[1]);
+  ASSERT_TRUE(loaded_caches->Get(4).hot_classes.empty());
+
+  // Merging keeps the receivers we already have.
+  ProfileCompilationInfo other_info;
+  ProfileInlineCache other_cache(/*pc=*/ 3, /*missing_types=*/ false, types);
+  other_cache.hot_classes = {TypeReference(dex1, dex::TypeIndex(0))};
+  ProfileMethodInfo other_pmi(MethodReference(dex1, /*index=*/ 2), {other_cache});
+  ASSERT_TRUE(other_info.AddMethod(other_pmi, Hotness::kFlagHot, ProfileSampleAnnotation::kNone,
+                                   /*is_test=*/ true));
+  ASSERT_TRUE(loaded_info.MergeWith(other_info));
+  ASSERT_TRUE(loaded_info.Equals(saved_info));
+}
+
+TEST_F(ProfileCompilationInfoTest, HotReceiversAcrossDexFiles) {
+  const char kDex1Class[] = "LUnique1;";
+  const dex::TypeId* dex1_tid = dex1->FindTypeId(kDex1Class);
+  ASSERT_TRUE(dex1_tid != nullptr);
+  dex::TypeIndex dex1_tidx = dex1->GetIndexForTypeId(*dex1_tid);
+  ASSERT_FALSE(dex2->FindTypeId(kDex1Class) != nullptr);
+
+  std::vector<TypeReference> types = {
+      TypeReference(dex2, dex::TypeIndex(0)),
+      TypeReference(dex2, dex::TypeIndex(1)),
+      TypeReference(dex2, dex::TypeIndex(2)),
+      TypeReference(dex2, dex::TypeIndex(3)),
+      TypeReference(dex2, dex::TypeIndex(4))};
+  ProfileInlineCache megamorphic_cache(/*pc=*/ 3, /*missing_types=*/ false, types);
+  megamorphic_cache.hot_classes = {TypeReference(dex1, dex1_tidx),
+                                   TypeReference(dex2, dex::TypeIndex(2))};
+
+  ProfileCompilationInfo info;
+  ProfileMethodInfo pmi(MethodReference(dex2, /*index=*/ 0), {megamorphic_cache});
+  ASSERT_TRUE(info.AddMethod(pmi, Hotness::kFlagHot, ProfileSampleAnnotation::kNone,
+                             /*is_test=*/ true));
+
+  // The receiver without a `TypeId` in the method's dex file is dropped.
+  Hotness hotness = GetMethod(info, dex2, /*method_idx=*/ 0);
+  ASSERT_TRUE(hotness.IsHot());
+  const ProfileCompilationInfo::DexPcData& dex_pc_data = hotness.GetInlineCacheMap()->Get(3);
+  ASSERT_TRUE(dex_pc_data.is_megamorphic);
+  ASSERT_EQ(1u, dex_pc_data.hot_classes.size());
+  ASSERT_EQ(dex::TypeIndex(2), dex_pc_data.hot_classes[0]);
+
+  // And it did not add an extra descriptor: the first one gets the first artificial index.
+  ASSERT_EQ(dex::TypeIndex(dex2->NumTypeIds()),
+            info.FindOrCreateTypeIndex(*dex2, "LUnrelated;"));
+}
+
 TEST_F(ProfileCompilationInfoTest, MegamorphicInlineCaches) {
   ProfileCompilationInfo saved_info;
   std::vector<ProfileInlineCache> inline_caches = GetTestInlineCaches();
@@ -10995,6 +10995,7 @@ void ClassLinker::CleanupClassLoaders() {
     return;
   }
   std::set<const OatFile*> unregistered_oat_files;
+  std::vector<const DexFile*> unregistered_dex_files;
   JavaVMExt* vm = self->GetJniEnv()->GetVm();
   {
     WriterMutexLock mu(self, *Locks::dex_lock_);
@@ -11011,6 +11012,7 @@ void ClassLinker::CleanupClassLoaders() {
             dex_file->GetOatDexFile()->GetOatFile()->IsExecutable()) {
           unregistered_oat_files.insert(dex_file->GetOatDexFile()->GetOatFile());
         }
+        unregistered_dex_files.push_back(dex_file);
         vm->DeleteWeakGlobalRef(self, data.weak_root);
         it = dex_caches_.erase(it);
       } else {
@@ -11025,6 +11027,11 @@ void ClassLinker::CleanupClassLoaders() {
       PrepareToDeleteClassLoader(self, data, /*cleanup_cha=*/true);
     }
   }
+  if (Runtime::Current()->GetJit() != nullptr) {
+    // The JIT code calling through these tables was removed with the methods above.
+    Runtime::Current()->GetJit()->GetCodeCache()->RemoveEntryPointTables(
+        self, ArrayRef<const DexFile* const>(unregistered_dex_files));
+  }
   for (const ClassLoaderData& data : to_delete) {
     delete data.allocator;
     delete data.class_table;
@@ -22,15 +22,30 @@
 #include "callee_save_frame.h"
 #include "dex/dex_file_types.h"
 #include "entrypoints/entrypoint_utils-inl.h"
+#include "gc/space/malloc_space.h"
+#include "jit/allocation_site_sampler.h"
+#include "jit/jit.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
 #include "mirror/object_array-inl.h"
 #include "mirror/string-alloc-inl.h"
+#include "runtime.h"
 
 namespace art HIDDEN {
 
 static constexpr bool kUseTlabFastPath = true;
 
+// Allocations reaching the runtime are sampled to compute the survival rate of
+// allocation sites, which drives pretenuring in the JIT. With TLAB allocators,
+// this is mostly the allocation that triggered the refill of the TLAB.
+static ALWAYS_INLINE inline void MaybeSampleAllocation(Thread* self, ObjPtr<mirror::Object> obj)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit != nullptr && jit->GetAllocationSiteSampler() != nullptr) {
+    jit->GetAllocationSiteSampler()->MaybeSampleAllocation(self, obj);
+  }
+}
+
 template <bool kInitialized,
           bool kWithChecks,
           bool kInstrumented,
@@ -61,13 +76,16 @@ static ALWAYS_INLINE inline mirror::Object* artAllocObjectFromCode(
       return obj;
     }
   }
+  ObjPtr<mirror::Object> obj;
   if (kInitialized) {
-    return AllocObjectFromCodeInitialized<kInstrumented>(klass, self, allocator_type).Ptr();
+    obj = AllocObjectFromCodeInitialized<kInstrumented>(klass, self, allocator_type);
   } else if (!kWithChecks) {
-    return AllocObjectFromCodeResolved<kInstrumented>(klass, self, allocator_type).Ptr();
+    obj = AllocObjectFromCodeResolved<kInstrumented>(klass, self, allocator_type);
   } else {
-    return AllocObjectFromCode<kInstrumented>(klass, self, allocator_type).Ptr();
+    obj = AllocObjectFromCode<kInstrumented>(klass, self, allocator_type);
   }
+  MaybeSampleAllocation(self, obj);
+  return obj.Ptr();
 }
 
 #define GENERATE_ENTRYPOINTS_FOR_ALLOCATOR_INST(suffix, suffix2, instrumented_bool, allocator_type) \
@@ -97,8 +115,10 @@ extern "C" mirror::Array* artAllocArrayFromCodeResolved##suffix##suffix2( \
     mirror::Class* klass, int32_t component_count, Thread* self) \
     REQUIRES_SHARED(Locks::mutator_lock_) { \
   ScopedQuickEntrypointChecks sqec(self); \
-  return AllocArrayFromCodeResolved<instrumented_bool>( \
-      klass, component_count, self, allocator_type).Ptr(); \
+  ObjPtr<mirror::Array> array = AllocArrayFromCodeResolved<instrumented_bool>( \
+      klass, component_count, self, allocator_type); \
+  MaybeSampleAllocation(self, array); \
+  return array.Ptr(); \
 } \
 extern "C" mirror::String* artAllocStringFromBytesFromCode##suffix##suffix2( \
     mirror::ByteArray* byte_array, int32_t high, int32_t offset, int32_t byte_count, \
@@ -203,6 +223,64 @@ GENERATE_ENTRYPOINTS(_region)
 GENERATE_ENTRYPOINTS(_region_tlab)
 #endif
 
+// Entrypoints used by compiled code for allocation sites that the JIT found to
+// allocate long-lived objects. These allocate in the non-moving space, so that
+// the objects are not copied by every young collection. They go through the
+// instrumented path as they do not depend on the current allocator.
+//
+// Pretenuring is only a hint: when the non-moving space is full, the objects are
+// allocated with the current allocator rather than collecting or throwing an
+// OutOfMemoryError because of the non-moving space alone.
+static bool NonMovingSpaceHasRoom(gc::Heap* heap) REQUIRES_SHARED(Locks::mutator_lock_) {
+  gc::space::MallocSpace* non_moving_space = heap->GetNonMovingSpace();
+  return non_moving_space != nullptr &&
+         non_moving_space->GetFootprint() < non_moving_space->Capacity();
+}
+
+extern "C" mirror::Object* artAllocObjectFromCodePretenured(mirror::Class* klass, Thread* self)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ScopedQuickEntrypointChecks sqec(self);
+  DCHECK(klass != nullptr);
+  // Resolve and initialize the class first, so that a failed allocation below can
+  // only be an OutOfMemoryError.
+  bool slow_path = false;
+  ObjPtr<mirror::Class> checked_klass = CheckObjectAlloc(klass, self, &slow_path);
+  if (UNLIKELY(checked_klass == nullptr)) {
+    return nullptr;
+  }
+  gc::Heap* heap = Runtime::Current()->GetHeap();
+  if (NonMovingSpaceHasRoom(heap)) {
+    ObjPtr<mirror::Object> obj = AllocObjectFromCodeInitialized</*kInstrumented=*/ true>(
+        checked_klass, self, heap->GetCurrentNonMovingAllocator());
+    if (LIKELY(obj != nullptr)) {
+      return obj.Ptr();
+    }
+    // There should be an OOM exception, since we are retrying, clear it.
+    self->ClearException();
+  }
+  return AllocObjectFromCodeInitialized</*kInstrumented=*/ true>(
+      checked_klass, self, heap->GetCurrentAllocator()).Ptr();
+}
+
+extern "C" mirror::Array* artAllocArrayFromCodePretenured(
+    mirror::Class* klass, int32_t component_count, Thread* self)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ScopedQuickEntrypointChecks sqec(self);
+  gc::Heap* heap = Runtime::Current()->GetHeap();
+  // A negative count throws NegativeArraySizeException below, which must not be retried.
+  if (component_count >= 0 && NonMovingSpaceHasRoom(heap)) {
+    ObjPtr<mirror::Array> array = AllocArrayFromCodeResolved</*kInstrumented=*/ true>(
+        klass, component_count, self, heap->GetCurrentNonMovingAllocator());
+    if (LIKELY(array != nullptr)) {
+      return array.Ptr();
+    }
+    // There should be an OOM exception, since we are retrying, clear it.
+    self->ClearException();
+  }
+  return AllocArrayFromCodeResolved</*kInstrumented=*/ true>(
+      klass, component_count, self, heap->GetCurrentAllocator()).Ptr();
+}
+
 static bool entry_points_instrumented = false;
 static gc::AllocatorType entry_points_allocator = gc::kAllocatorTypeDlMalloc;
 
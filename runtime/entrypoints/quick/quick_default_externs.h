@@ -149,4 +149,8 @@ extern "C" void art_quick_throw_string_bounds(int32_t index, int32_t limit);
 // Inline cache.
 extern "C" void art_quick_update_inline_cache();
 
+// Pretenured allocation entrypoints.
+extern "C" void* art_quick_alloc_object_pretenured(art::mirror::Class*);
+extern "C" void* art_quick_alloc_array_pretenured(art::mirror::Class*, int32_t);
+
 #endif  // ART_RUNTIME_ENTRYPOINTS_QUICK_QUICK_DEFAULT_EXTERNS_H_
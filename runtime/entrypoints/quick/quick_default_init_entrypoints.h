@@ -136,6 +136,10 @@ static void DefaultInitEntryPoints(JniEntryPoints* jpoints,
   qpoints->SetMethodEntryHook(art_quick_method_entry_hook);
   qpoints->SetMethodExitHook(art_quick_method_exit_hook);
 
+  // Pretenured allocations
+  qpoints->SetAllocObjectPretenured(art_quick_alloc_object_pretenured);
+  qpoints->SetAllocArrayPretenured(art_quick_alloc_array_pretenured);
+
   if (monitor_jni_entry_exit) {
     qpoints->SetJniMethodStart(art_jni_monitored_method_start);
     qpoints->SetJniMethodEnd(art_jni_monitored_method_end);
@@ -139,11 +139,14 @@ class EntrypointsOrderTest : public CommonArtTest {
         Thread, tlsPtr_, method_trace_buffer, method_trace_buffer_index, sizeof(void*));
     EXPECT_OFFSET_DIFFP(
         Thread, tlsPtr_, method_trace_buffer_index, thread_exit_flags, sizeof(void*));
+    EXPECT_OFFSET_DIFFP(
+        Thread, tlsPtr_, thread_exit_flags, large_object_cache, sizeof(void*));
     // The first field after tlsPtr_ is forced to a 16 byte alignment so it might have some space.
     auto offset_tlsptr_end = OFFSETOF_MEMBER(Thread, tlsPtr_) +
         sizeof(decltype(reinterpret_cast<Thread*>(16)->tlsPtr_));
-    CHECKED(offset_tlsptr_end - OFFSETOF_MEMBER(Thread, tlsPtr_.thread_exit_flags) == sizeof(void*),
-            "async_exception last field");
+    CHECKED(offset_tlsptr_end - OFFSETOF_MEMBER(Thread, tlsPtr_.large_object_cache) ==
+                sizeof(void*),
+            "large_object_cache last field");
   }
 
   void CheckJniEntryPoints() {
@@ -410,8 +413,11 @@ class EntrypointsOrderTest : public CommonArtTest {
     EXPECT_OFFSET_DIFFNP(
         QuickEntryPoints, pReadBarrierForRootSlow, pMethodEntryHook, sizeof(void*));
     EXPECT_OFFSET_DIFFNP(QuickEntryPoints, pMethodEntryHook, pMethodExitHook, sizeof(void*));
+    EXPECT_OFFSET_DIFFNP(QuickEntryPoints, pMethodExitHook, pAllocObjectPretenured, sizeof(void*));
+    EXPECT_OFFSET_DIFFNP(
+        QuickEntryPoints, pAllocObjectPretenured, pAllocArrayPretenured, sizeof(void*));
 
-    CHECKED(OFFSETOF_MEMBER(QuickEntryPoints, pMethodExitHook) + sizeof(void*) ==
+    CHECKED(OFFSETOF_MEMBER(QuickEntryPoints, pAllocArrayPretenured) + sizeof(void*) ==
                 sizeof(QuickEntryPoints),
             QuickEntryPoints_all);
   }
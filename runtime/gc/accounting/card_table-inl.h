@@ -24,6 +24,7 @@
 #include "base/atomic.h"
 #include "base/bit_utils.h"
 #include "base/mem_map.h"
+#include "simd_scan.h"
 #include "space_bitmap.h"
 
 namespace art HIDDEN {
@@ -62,67 +63,24 @@ inline size_t CardTable::Scan(ContinuousSpaceBitmap* bitmap,
   DCHECK_LE(scan_end, reinterpret_cast<uint8_t*>(bitmap->HeapLimit()));
   uint8_t* const card_begin = CardFromAddr(scan_begin);
   uint8_t* const card_end = CardFromAddr(AlignUp(scan_end, kCardSize));
-  uint8_t* card_cur = card_begin;
-  CheckCardValid(card_cur);
+  CheckCardValid(card_begin);
   CheckCardValid(card_end);
   size_t cards_scanned = 0;
 
-  // Handle any unaligned cards at the start.
-  while (!IsAligned<sizeof(intptr_t)>(card_cur) && card_cur < card_end) {
-    if (*card_cur >= minimum_age) {
-      uintptr_t start = reinterpret_cast<uintptr_t>(AddrFromCard(card_cur));
-      bitmap->VisitMarkedRange(start, start + kCardSize, visitor);
-      ++cards_scanned;
-    }
-    ++card_cur;
-  }
-
-  if (card_cur < card_end) {
-    DCHECK_ALIGNED(card_cur, sizeof(intptr_t));
-    uint8_t* aligned_end = card_end -
-        (reinterpret_cast<uintptr_t>(card_end) & (sizeof(uintptr_t) - 1));
-    DCHECK_LE(card_cur, aligned_end);
-
-    uintptr_t* word_end = reinterpret_cast<uintptr_t*>(aligned_end);
-    for (uintptr_t* word_cur = reinterpret_cast<uintptr_t*>(card_cur); word_cur < word_end;
-        ++word_cur) {
-      while (LIKELY(*word_cur == 0)) {
-        ++word_cur;
-        if (UNLIKELY(word_cur >= word_end)) {
-          goto exit_for;
-        }
-      }
-
-      // Find the first dirty card.
-      uintptr_t start_word = *word_cur;
-      uintptr_t start =
-          reinterpret_cast<uintptr_t>(AddrFromCard(reinterpret_cast<uint8_t*>(word_cur)));
-      // TODO: Investigate if processing continuous runs of dirty cards with
-      // a single bitmap visit is more efficient.
-      for (size_t i = 0; i < sizeof(uintptr_t); ++i) {
-        if (static_cast<uint8_t>(start_word) >= minimum_age) {
-          auto* card = reinterpret_cast<uint8_t*>(word_cur) + i;
-          DCHECK(*card == static_cast<uint8_t>(start_word) || *card == kCardDirty)
-              << "card " << static_cast<size_t>(*card) << " intptr_t " << (start_word & 0xFF);
-          bitmap->VisitMarkedRange(start, start + kCardSize, visitor);
-          ++cards_scanned;
-        }
-        start_word >>= 8;
-        start += kCardSize;
-      }
-    }
-    exit_for:
-
-    // Handle any unaligned cards at the end.
-    card_cur = reinterpret_cast<uint8_t*>(word_end);
-    while (card_cur < card_end) {
-      if (*card_cur >= minimum_age) {
-        uintptr_t start = reinterpret_cast<uintptr_t>(AddrFromCard(card_cur));
-        bitmap->VisitMarkedRange(start, start + kCardSize, visitor);
-        ++cards_scanned;
-      }
-      ++card_cur;
+  // Skip the clean (or too young) stretches of cards with the vectorized search, and visit each
+  // run of consecutive cards that are old enough with a single bitmap visit.
+  for (uint8_t* card_cur = FindCardAtLeast(card_begin, card_end, minimum_age);
+       card_cur < card_end;
+       card_cur = FindCardAtLeast(card_cur, card_end, minimum_age)) {
+    uint8_t* run_end = card_cur + 1;
+    while (run_end < card_end && *run_end >= minimum_age) {
+      ++run_end;
     }
+    const size_t run_length = run_end - card_cur;
+    uintptr_t start = reinterpret_cast<uintptr_t>(AddrFromCard(card_cur));
+    bitmap->VisitMarkedRange(start, start + run_length * kCardSize, visitor);
+    cards_scanned += run_length;
+    card_cur = run_end;
   }
 
   if (kClearCard) {
@@ -184,10 +142,18 @@ inline void CardTable::ModifyCardsAtomic(uint8_t* scan_begin,
 
   // TODO: Parallelize.
   while (word_cur < word_end) {
+    static_assert(kCardClean == 0);
+    if (*word_cur == 0 /* All kCardClean */) {
+      // Skip the whole stretch of clean cards with the vectorized search.
+      uint8_t* card = FindCardAtLeast(reinterpret_cast<uint8_t*>(word_cur + 1),
+                                      reinterpret_cast<uint8_t*>(word_end),
+                                      kCardClean + 1);
+      word_cur = AlignDown(reinterpret_cast<uintptr_t*>(card), sizeof(uintptr_t));
+      continue;
+    }
     while (true) {
       expected_word = *word_cur;
-      static_assert(kCardClean == 0);
-      if (LIKELY(expected_word == 0 /* All kCardClean */ )) {
+      if (UNLIKELY(expected_word == 0 /* All kCardClean */ )) {
         break;
       }
       for (size_t i = 0; i < sizeof(uintptr_t); ++i) {
@@ -17,6 +17,7 @@
 #include "card_table-inl.h"
 
 #include <string>
+#include <vector>
 
 #include "base/atomic.h"
 #include "base/common_art_test.h"
@@ -25,6 +26,7 @@
 #include "mirror/class-inl.h"
 #include "mirror/string-inl.h"  // Strings are easiest to allocate
 #include "scoped_thread_state_change-inl.h"
+#include "space_bitmap-inl.h"
 #include "thread_pool.h"
 
 namespace art HIDDEN {
@@ -145,7 +147,78 @@ TEST_F(CardTableTest, TestModifyCardsAtomic) {
   }
 }
 
-// TODO: Add test for CardTable::Scan.
+template <bool kClearCard>
+static size_t ScanCards(CardTable* card_table,
+                        ContinuousSpaceBitmap* bitmap,
+                        uint8_t* scan_begin,
+                        uint8_t* scan_end,
+                        uint8_t minimum_age,
+                        size_t* objects_visited) NO_THREAD_SAFETY_ANALYSIS {
+  *objects_visited = 0;
+  auto visitor = [card_table, minimum_age, objects_visited](mirror::Object* obj) {
+    EXPECT_GE(card_table->GetCard(obj), minimum_age);
+    ++*objects_visited;
+  };
+  return card_table->Scan<kClearCard>(bitmap, scan_begin, scan_end, visitor, minimum_age);
+}
+
+TEST_F(CardTableTest, TestScan) {
+  CommonSetup();
+  ContinuousSpaceBitmap bitmap(
+      ContinuousSpaceBitmap::Create("test bitmap", HeapBegin(), HeapLimit() - HeapBegin()));
+  ASSERT_TRUE(bitmap.IsValid());
+  // One object in the middle of each card.
+  for (uint8_t* addr = HeapBegin() + CardTable::kCardSize / 2; addr < HeapLimit();
+      addr += CardTable::kCardSize) {
+    bitmap.Set(reinterpret_cast<mirror::Object*>(addr));
+  }
+  // Long clean stretches between runs of dirty cards and single dirty cards, including the first
+  // and the last card.
+  const size_t num_cards = (HeapLimit() - HeapBegin()) / CardTable::kCardSize;
+  const std::vector<size_t> dirty_cards = {0, 1, 2, 3, 4, 100, 102, 1000, 1001, num_cards - 1};
+  for (size_t card : dirty_cards) {
+    card_table_->MarkCard(HeapBegin() + card * CardTable::kCardSize);
+  }
+  size_t objects_visited;
+  EXPECT_EQ(ScanCards<false>(card_table_.get(),
+                             &bitmap,
+                             HeapBegin(),
+                             HeapLimit(),
+                             CardTable::kCardDirty,
+                             &objects_visited),
+            dirty_cards.size());
+  EXPECT_EQ(objects_visited, dirty_cards.size());
+
+  // Once aged, the cards are only found by scans that accept aged cards.
+  card_table_->ModifyCardsAtomic(HeapBegin(), HeapLimit(), AgeCardVisitor(), VoidFunctor());
+  for (size_t card : dirty_cards) {
+    EXPECT_EQ(*card_table_->CardFromAddr(HeapBegin() + card * CardTable::kCardSize),
+              CardTable::kCardAged);
+  }
+  EXPECT_EQ(ScanCards<false>(card_table_.get(),
+                             &bitmap,
+                             HeapBegin(),
+                             HeapLimit(),
+                             CardTable::kCardDirty,
+                             &objects_visited),
+            0u);
+  EXPECT_EQ(objects_visited, 0u);
+
+  // Cards dirtied after the aging are found along with the aged ones.
+  card_table_->MarkCard(HeapBegin() + 500 * CardTable::kCardSize);
+  EXPECT_EQ(ScanCards<true>(card_table_.get(),
+                            &bitmap,
+                            HeapBegin(),
+                            HeapLimit(),
+                            CardTable::kCardAged,
+                            &objects_visited),
+            dirty_cards.size() + 1);
+  EXPECT_EQ(objects_visited, dirty_cards.size() + 1);
+  for (const uint8_t* addr = HeapBegin(); addr < HeapLimit(); addr += CardTable::kCardSize) {
+    EXPECT_TRUE(card_table_->IsClean(reinterpret_cast<const mirror::Object*>(addr)));
+  }
+}
+
 }  // namespace accounting
 }  // namespace gc
 }  // namespace art
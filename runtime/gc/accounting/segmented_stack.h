@@ -0,0 +1,367 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_ACCOUNTING_SEGMENTED_STACK_H_
+#define ART_RUNTIME_GC_ACCOUNTING_SEGMENTED_STACK_H_
+
+#include <sys/mman.h>  // For the PROT_* and MAP_* constants.
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include <android-base/logging.h>
+
+#include "base/atomic.h"
+#include "base/bit_utils.h"
+#include "base/casts.h"
+#include "base/globals.h"
+#include "base/macros.h"
+#include "base/mem_map.h"
+#include "stack_reference.h"
+
+// This implements a mark stack for marking with several threads, made of fixed size segments.
+// Each thread pushes onto and pops from a segment it owns exclusively, through a
+// SegmentedStack::Local, so that the common operations don't need any synchronization. Full
+// segments are published to a lock-free list from which any thread can take them, which is also
+// how idle threads find work. The stack grows by handing out segments from reserved address
+// ranges, which only get backed by memory as they are used. When a range is exhausted, the stack
+// reserves a new one twice as large, so that overflowing the initial capacity does not make the
+// collectors rescan the heap or fall back to a locked stack.
+
+namespace art HIDDEN {
+namespace gc {
+namespace accounting {
+
+// Internal representation is StackReference<T>, so this only works with mirror::Object or its
+// subclasses.
+template <typename T>
+class SegmentedStack {
+ private:
+  struct Segment;
+
+ public:
+  // Size of a segment, including its header.
+  static constexpr size_t kSegmentSize = 4 * KB;
+  // Number of references a segment holds.
+  static constexpr size_t kSegmentCapacity =
+      (kSegmentSize - 2 * sizeof(uint32_t)) / sizeof(StackReference<T>);
+
+  // A thread's handle on the stack. Not thread safe, each thread must use its own.
+  class Local {
+   public:
+    explicit Local(SegmentedStack* stack) : stack_(stack), segment_(nullptr) {}
+
+    ~Local() {
+      DCHECK(segment_ == nullptr) << "Local segment not flushed";
+    }
+
+    // Returns false if the stack could not grow any further.
+    ALWAYS_INLINE bool Push(T* value) REQUIRES_SHARED(Locks::mutator_lock_) {
+      DCHECK(value != nullptr);
+      if (UNLIKELY(segment_ == nullptr || segment_->size_ == kSegmentCapacity)) {
+        if (!NewSegment()) {
+          return false;
+        }
+      }
+      segment_->refs_[segment_->size_++].Assign(value);
+      return true;
+    }
+
+    // Pops from the local segment, or from a published segment once the local one is empty.
+    // Returns null if there is no work left that is visible to this thread.
+    ALWAYS_INLINE T* Pop() REQUIRES_SHARED(Locks::mutator_lock_) {
+      if (UNLIKELY(segment_ == nullptr || segment_->size_ == 0)) {
+        if (!StealSegment()) {
+          return nullptr;
+        }
+      }
+      return segment_->refs_[--segment_->size_].AsMirrorPtr();
+    }
+
+    // Number of references in the local segment.
+    size_t LocalSize() const {
+      return segment_ == nullptr ? 0u : segment_->size_;
+    }
+
+    // Makes the references of the local segment available to the other threads. Must be called
+    // before the Local is destroyed.
+    void Flush() {
+      if (segment_ != nullptr) {
+        if (segment_->size_ != 0) {
+          stack_->PushSegment(&stack_->full_segments_, segment_);
+        } else {
+          stack_->PushSegment(&stack_->free_segments_, segment_);
+        }
+        segment_ = nullptr;
+      }
+    }
+
+   private:
+    bool NewSegment() {
+      if (segment_ != nullptr) {
+        DCHECK_EQ(segment_->size_, kSegmentCapacity);
+        stack_->PushSegment(&stack_->full_segments_, segment_);
+      }
+      segment_ = stack_->AllocateSegment();
+      return segment_ != nullptr;
+    }
+
+    bool StealSegment() {
+      Segment* segment = stack_->PopSegment(&stack_->full_segments_);
+      if (segment == nullptr) {
+        return false;
+      }
+      if (segment_ != nullptr) {
+        DCHECK_EQ(segment_->size_, 0u);
+        stack_->PushSegment(&stack_->free_segments_, segment_);
+      }
+      segment_ = segment;
+      return true;
+    }
+
+    SegmentedStack* const stack_;
+    Segment* segment_;
+
+    DISALLOW_COPY_AND_ASSIGN(Local);
+  };
+
+  // Capacity is how many elements we can store in the stack before it grows, it is rounded up to
+  // whole segments.
+  static SegmentedStack* Create(const std::string& name, size_t capacity) {
+    std::unique_ptr<SegmentedStack> stack(new SegmentedStack(name, capacity));
+    stack->Init();
+    return stack.release();
+  }
+
+  ~SegmentedStack() {}
+
+  // Not thread safe, there must be no Local with a segment at this point. Releases the ranges
+  // reserved when the stack grew.
+  void Reset() {
+    DCHECK(chunks_[0].IsValid());
+    full_segments_.store(0, std::memory_order_relaxed);
+    free_segments_.store(0, std::memory_order_relaxed);
+    num_segments_.store(0, std::memory_order_relaxed);
+    for (size_t chunk = 1; chunk < kMaxChunks; ++chunk) {
+      chunks_[chunk].Reset();
+      chunk_begins_[chunk].store(nullptr, std::memory_order_relaxed);
+    }
+    chunks_[0].MadviseDontNeedAndZero();
+  }
+
+  // Whether there are published segments. Only meaningful when no thread holds references in a
+  // Local.
+  bool IsEmpty() const {
+    return SegmentIndex(full_segments_.load(std::memory_order_acquire)) == kNoSegment;
+  }
+
+  // Number of segments handed out so far, i.e. the high-water mark of the stack.
+  size_t NumSegments() const {
+    return std::min(num_segments_.load(std::memory_order_relaxed), MaxSegments(kMaxChunks));
+  }
+
+  // Number of elements the reserved ranges can hold.
+  size_t Capacity() const {
+    size_t num_segments = 0;
+    for (size_t chunk = 0; chunk < kMaxChunks; ++chunk) {
+      if (chunk_begins_[chunk].load(std::memory_order_relaxed) != nullptr) {
+        num_segments += ChunkSegments(chunk);
+      }
+    }
+    return num_segments * kSegmentCapacity;
+  }
+
+ private:
+  // A list head packs the index of the first segment (plus one, so that zero is the empty list)
+  // with a tag that is incremented on each update, to avoid ABA problems when segments get
+  // recycled between a load of the head and the CAS that updates it.
+  using ListHead = Atomic<uint64_t>;
+  static constexpr uint32_t kNoSegment = 0u;
+  // Maximum number of reserved ranges. Range `n` holds `initial_segments_ << n` segments.
+  static constexpr size_t kMaxChunks = 16;
+
+  struct Segment {
+    // Index (plus one) of the next segment in the list this segment is on.
+    std::atomic<uint32_t> next_;
+    // Number of references in refs_.
+    uint32_t size_;
+    StackReference<T> refs_[kSegmentCapacity];
+  };
+  static_assert(sizeof(Segment) <= kSegmentSize, "Segment header too large");
+
+  SegmentedStack(const std::string& name, size_t capacity)
+      : name_(name),
+        initial_segments_((capacity + kSegmentCapacity - 1) / kSegmentCapacity),
+        full_segments_(0),
+        free_segments_(0),
+        num_segments_(0) {
+    CHECK_NE(initial_segments_, 0u);
+    CHECK_LE(MaxSegments(kMaxChunks), std::numeric_limits<uint32_t>::max());
+    std::fill_n(chunk_begins_, kMaxChunks, nullptr);
+  }
+
+  // Number of segments in the range `chunk`.
+  size_t ChunkSegments(size_t chunk) const {
+    return initial_segments_ << chunk;
+  }
+
+  // Number of segments in the ranges before `chunk`.
+  size_t MaxSegments(size_t chunk) const {
+    return initial_segments_ * ((static_cast<size_t>(1u) << chunk) - 1u);
+  }
+
+  // The range holding the segment at `index`.
+  size_t ChunkOf(uint32_t index) const {
+    return static_cast<size_t>(MostSignificantBit((index - 1u) / initial_segments_ + 1u));
+  }
+
+  static uint32_t SegmentIndex(uint64_t head) {
+    return static_cast<uint32_t>(head);
+  }
+
+  static uint64_t MakeHead(uint64_t old_head, uint32_t index) {
+    return (((old_head >> 32) + 1u) << 32) | index;
+  }
+
+  Segment* GetSegment(uint32_t index) const {
+    DCHECK_NE(index, kNoSegment);
+    const size_t chunk = ChunkOf(index);
+    DCHECK_LT(chunk, kMaxChunks);
+    uint8_t* begin = chunk_begins_[chunk].load(std::memory_order_relaxed);
+    DCHECK(begin != nullptr);
+    return reinterpret_cast<Segment*>(begin + (index - 1u - MaxSegments(chunk)) * kSegmentSize);
+  }
+
+  uint32_t GetIndex(const Segment* segment) const {
+    const uint8_t* addr = reinterpret_cast<const uint8_t*>(segment);
+    for (size_t chunk = 0; chunk < kMaxChunks; ++chunk) {
+      const uint8_t* begin = chunk_begins_[chunk].load(std::memory_order_relaxed);
+      if (begin != nullptr && addr >= begin && addr < begin + ChunkSegments(chunk) * kSegmentSize) {
+        return dchecked_integral_cast<uint32_t>(
+            MaxSegments(chunk) + (addr - begin) / kSegmentSize + 1u);
+      }
+    }
+    LOG(FATAL) << "Segment " << segment << " not in " << name_;
+    UNREACHABLE();
+  }
+
+  void PushSegment(ListHead* list, Segment* segment) {
+    const uint32_t index = GetIndex(segment);
+    uint64_t head;
+    do {
+      head = list->load(std::memory_order_relaxed);
+      segment->next_.store(SegmentIndex(head), std::memory_order_relaxed);
+    } while (!list->CompareAndSetWeakRelease(head, MakeHead(head, index)));
+  }
+
+  Segment* PopSegment(ListHead* list) {
+    uint64_t head = list->load(std::memory_order_acquire);
+    while (true) {
+      const uint32_t index = SegmentIndex(head);
+      if (index == kNoSegment) {
+        return nullptr;
+      }
+      Segment* segment = GetSegment(index);
+      // May read the link of a segment that got popped and pushed again in the meantime, in which
+      // case the tag has changed and the CAS below fails.
+      const uint32_t next = segment->next_.load(std::memory_order_relaxed);
+      if (list->CompareAndSetWeakAcquire(head, MakeHead(head, next))) {
+        return segment;
+      }
+      head = list->load(std::memory_order_acquire);
+    }
+  }
+
+  // Returns a recycled segment, or a new one from the reserved ranges. Returns null if the stack
+  // cannot grow any further.
+  Segment* AllocateSegment() {
+    Segment* segment = PopSegment(&free_segments_);
+    if (segment == nullptr) {
+      const size_t index = num_segments_.fetch_add(1, std::memory_order_relaxed) + 1u;
+      if (UNLIKELY(index > MaxSegments(kMaxChunks))) {
+        return nullptr;
+      }
+      const size_t chunk = ChunkOf(static_cast<uint32_t>(index));
+      if (UNLIKELY(chunk_begins_[chunk].load(std::memory_order_acquire) == nullptr) &&
+          !Grow(chunk)) {
+        return nullptr;
+      }
+      segment = GetSegment(static_cast<uint32_t>(index));
+    }
+    segment->size_ = 0;
+    return segment;
+  }
+
+  // Reserves the range `chunk`. Threads that need the same range race to reserve it, the losers
+  // release their reservation. Segments of the new range are only published to the other threads
+  // through the lists, whose updates order the store of the range.
+  bool Grow(size_t chunk) {
+    std::string error_msg;
+    MemMap mem_map = MemMap::MapAnonymous(name_.c_str(),
+                                          ChunkSegments(chunk) * kSegmentSize,
+                                          PROT_READ | PROT_WRITE,
+                                          /*low_4gb=*/ false,
+                                          &error_msg);
+    if (!mem_map.IsValid()) {
+      LOG(WARNING) << "couldn't grow mark stack " << name_ << ".\n" << error_msg;
+      return false;
+    }
+    uint8_t* expected = nullptr;
+    if (chunk_begins_[chunk].compare_exchange_strong(
+            expected, mem_map.Begin(), std::memory_order_acq_rel)) {
+      chunks_[chunk] = std::move(mem_map);
+    }
+    return true;
+  }
+
+  void Init() {
+    std::string error_msg;
+    chunks_[0] = MemMap::MapAnonymous(name_.c_str(),
+                                      ChunkSegments(0) * kSegmentSize,
+                                      PROT_READ | PROT_WRITE,
+                                      /*low_4gb=*/ false,
+                                      &error_msg);
+    CHECK(chunks_[0].IsValid()) << "couldn't allocate mark stack.\n" << error_msg;
+    chunk_begins_[0].store(chunks_[0].Begin(), std::memory_order_relaxed);
+    Reset();
+  }
+
+  // Name of the mark stack.
+  std::string name_;
+  // Reserved ranges the segments are allocated from. Only the first one is reserved up front.
+  MemMap chunks_[kMaxChunks];
+  std::atomic<uint8_t*> chunk_begins_[kMaxChunks];
+  // Number of segments in the first range.
+  const size_t initial_segments_;
+  // Lock-free lists of published segments and of empty segments.
+  ListHead full_segments_;
+  ListHead free_segments_;
+  // Number of segments allocated from the ranges. May go past the maximum on overflow.
+  std::atomic<size_t> num_segments_;
+
+  DISALLOW_COPY_AND_ASSIGN(SegmentedStack);
+};
+
+using ObjectSegmentedStack = SegmentedStack<mirror::Object>;
+
+}  // namespace accounting
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_ACCOUNTING_SEGMENTED_STACK_H_
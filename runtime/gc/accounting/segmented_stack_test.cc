@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "segmented_stack.h"
+
+#include <memory>
+#include <vector>
+
+#include "common_runtime_test.h"
+#include "runtime_globals.h"
+#include "scoped_thread_state_change-inl.h"
+#include "thread_pool.h"
+
+namespace art HIDDEN {
+namespace gc {
+namespace accounting {
+
+class SegmentedStackTest : public CommonRuntimeTest {};
+
+// Fake, never dereferenced, objects.
+static mirror::Object* FakeObject(size_t i) {
+  return reinterpret_cast<mirror::Object*>(kObjectAlignment * (i + 1));
+}
+
+static size_t FakeObjectIndex(mirror::Object* obj) {
+  return reinterpret_cast<uintptr_t>(obj) / kObjectAlignment - 1;
+}
+
+TEST_F(SegmentedStackTest, PushPop) {
+  ScopedObjectAccess soa(Thread::Current());
+  static constexpr size_t kNumObjects = 3 * ObjectSegmentedStack::kSegmentCapacity + 5;
+  std::unique_ptr<ObjectSegmentedStack> stack(
+      ObjectSegmentedStack::Create("test stack", 4 * ObjectSegmentedStack::kSegmentCapacity));
+  EXPECT_TRUE(stack->IsEmpty());
+  ObjectSegmentedStack::Local pusher(stack.get());
+  for (size_t i = 0; i < kNumObjects; ++i) {
+    ASSERT_TRUE(pusher.Push(FakeObject(i)));
+  }
+  EXPECT_EQ(pusher.LocalSize(), 5u);
+  // The full segments are visible to other threads before the flush.
+  EXPECT_FALSE(stack->IsEmpty());
+  pusher.Flush();
+  EXPECT_EQ(stack->NumSegments(), 4u);
+
+  std::vector<bool> popped(kNumObjects, false);
+  ObjectSegmentedStack::Local popper(stack.get());
+  for (mirror::Object* obj = popper.Pop(); obj != nullptr; obj = popper.Pop()) {
+    size_t index = FakeObjectIndex(obj);
+    ASSERT_LT(index, kNumObjects);
+    ASSERT_FALSE(popped[index]);
+    popped[index] = true;
+  }
+  popper.Flush();
+  EXPECT_TRUE(stack->IsEmpty());
+  for (size_t i = 0; i < kNumObjects; ++i) {
+    EXPECT_TRUE(popped[i]) << i;
+  }
+
+  // Empty segments are recycled.
+  ObjectSegmentedStack::Local reuser(stack.get());
+  for (size_t i = 0; i < kNumObjects; ++i) {
+    ASSERT_TRUE(reuser.Push(FakeObject(i)));
+  }
+  reuser.Flush();
+  EXPECT_EQ(stack->NumSegments(), 4u);
+  stack->Reset();
+  EXPECT_TRUE(stack->IsEmpty());
+  EXPECT_EQ(stack->NumSegments(), 0u);
+}
+
+TEST_F(SegmentedStackTest, Grow) {
+  ScopedObjectAccess soa(Thread::Current());
+  static constexpr size_t kInitialCapacity = 2 * ObjectSegmentedStack::kSegmentCapacity;
+  static constexpr size_t kNumObjects = 10 * ObjectSegmentedStack::kSegmentCapacity;
+  std::unique_ptr<ObjectSegmentedStack> stack(
+      ObjectSegmentedStack::Create("test stack", kInitialCapacity));
+  EXPECT_EQ(stack->Capacity(), kInitialCapacity);
+  ObjectSegmentedStack::Local local(stack.get());
+  for (size_t i = 0; i < kNumObjects; ++i) {
+    ASSERT_TRUE(local.Push(FakeObject(i)));
+  }
+  // The stack reserved ranges of 2, 4 and 8 segments.
+  EXPECT_EQ(stack->Capacity(), 7 * kInitialCapacity);
+  EXPECT_EQ(stack->NumSegments(), 10u);
+  std::vector<bool> popped(kNumObjects, false);
+  for (mirror::Object* obj = local.Pop(); obj != nullptr; obj = local.Pop()) {
+    size_t index = FakeObjectIndex(obj);
+    ASSERT_LT(index, kNumObjects);
+    ASSERT_FALSE(popped[index]);
+    popped[index] = true;
+  }
+  local.Flush();
+  for (size_t i = 0; i < kNumObjects; ++i) {
+    EXPECT_TRUE(popped[i]) << i;
+  }
+  // Resetting releases the ranges reserved when growing.
+  stack->Reset();
+  EXPECT_EQ(stack->Capacity(), kInitialCapacity);
+}
+
+// Pushes a range of fake objects, popping one every few pushes like a marking thread would.
+class PushPopTask : public Task {
+ public:
+  PushPopTask(ObjectSegmentedStack* stack,
+              size_t begin,
+              size_t end,
+              std::vector<mirror::Object*>* popped)
+      : stack_(stack), begin_(begin), end_(end), popped_(popped) {}
+
+  void Run([[maybe_unused]] Thread* self) override NO_THREAD_SAFETY_ANALYSIS {
+    static constexpr size_t kPopInterval = 3;
+    ObjectSegmentedStack::Local local(stack_);
+    for (size_t i = begin_; i != end_; ++i) {
+      CHECK(local.Push(FakeObject(i)));
+      if (i % kPopInterval == 0) {
+        mirror::Object* obj = local.Pop();
+        CHECK(obj != nullptr);
+        popped_->push_back(obj);
+      }
+    }
+    local.Flush();
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  ObjectSegmentedStack* const stack_;
+  const size_t begin_;
+  const size_t end_;
+  std::vector<mirror::Object*>* const popped_;
+};
+
+// Checks that no reference is lost or duplicated on the contended paths, including when
+// the threads grow the stack concurrently.
+TEST_F(SegmentedStackTest, ConcurrentPushPop) {
+  static constexpr size_t kNumThreads = 4;
+  static constexpr size_t kNumTasks = 4 * kNumThreads;
+  static constexpr size_t kObjectsPerTask = 64 * ObjectSegmentedStack::kSegmentCapacity;
+  static constexpr size_t kNumObjects = kNumTasks * kObjectsPerTask;
+  Thread* self = Thread::Current();
+  // Start with a single segment, so that the threads race to grow the stack.
+  std::unique_ptr<ObjectSegmentedStack> stack(
+      ObjectSegmentedStack::Create("test stack", ObjectSegmentedStack::kSegmentCapacity));
+  std::unique_ptr<ThreadPool> thread_pool(
+      ThreadPool::Create("Segmented stack test thread pool", kNumThreads));
+  std::vector<std::vector<mirror::Object*>> popped_by_task(kNumTasks);
+  for (size_t i = 0; i < kNumTasks; ++i) {
+    thread_pool->AddTask(self,
+                         new PushPopTask(stack.get(),
+                                         i * kObjectsPerTask,
+                                         (i + 1) * kObjectsPerTask,
+                                         &popped_by_task[i]));
+  }
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /*do_work=*/ false, /*may_hold_locks=*/ false);
+  thread_pool.reset();
+
+  std::vector<bool> popped(kNumObjects, false);
+  for (const std::vector<mirror::Object*>& task_popped : popped_by_task) {
+    for (mirror::Object* obj : task_popped) {
+      size_t index = FakeObjectIndex(obj);
+      ASSERT_LT(index, kNumObjects);
+      ASSERT_FALSE(popped[index]) << index;
+      popped[index] = true;
+    }
+  }
+  ScopedObjectAccess soa(self);
+  ObjectSegmentedStack::Local local(stack.get());
+  for (mirror::Object* obj = local.Pop(); obj != nullptr; obj = local.Pop()) {
+    size_t index = FakeObjectIndex(obj);
+    ASSERT_LT(index, kNumObjects);
+    ASSERT_FALSE(popped[index]) << index;
+    popped[index] = true;
+  }
+  local.Flush();
+  EXPECT_TRUE(stack->IsEmpty());
+  for (size_t i = 0; i < kNumObjects; ++i) {
+    ASSERT_TRUE(popped[i]) << i;
+  }
+}
+
+}  // namespace accounting
+}  // namespace gc
+}  // namespace art
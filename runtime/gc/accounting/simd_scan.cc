@@ -0,0 +1,320 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "simd_scan.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include <android-base/logging.h>
+
+#include "base/bit_utils.h"
+
+namespace art HIDDEN {
+namespace gc {
+namespace accounting {
+
+static_assert(sizeof(Atomic<uintptr_t>) == sizeof(uintptr_t), "Unexpected atomic word size");
+
+// Scalar kernels, also used for the words that don't fill a whole vector. When `kGarbage` is
+// false, `mark` is null and only `live` is scanned.
+
+template <bool kGarbage>
+ALWAYS_INLINE static uintptr_t LoadWord(const Atomic<uintptr_t>* live,
+                                        const Atomic<uintptr_t>* mark,
+                                        size_t i) {
+  uintptr_t w = live[i].load(std::memory_order_relaxed);
+  if (kGarbage) {
+    w &= ~mark[i].load(std::memory_order_relaxed);
+  }
+  return w;
+}
+
+template <bool kGarbage>
+static size_t FindWordScalar(const Atomic<uintptr_t>* live,
+                             const Atomic<uintptr_t>* mark,
+                             size_t begin,
+                             size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    if (LoadWord<kGarbage>(live, mark, i) != 0) {
+      return i;
+    }
+  }
+  return end;
+}
+
+template <bool kGarbage>
+static size_t CountBitsScalar(const Atomic<uintptr_t>* live,
+                              const Atomic<uintptr_t>* mark,
+                              size_t begin,
+                              size_t end) {
+  size_t count = 0;
+  for (size_t i = begin; i < end; ++i) {
+    count += POPCOUNT(LoadWord<kGarbage>(live, mark, i));
+  }
+  return count;
+}
+
+static uint8_t* FindCardScalar(uint8_t* begin, uint8_t* end, uint8_t minimum_age) {
+  while (begin < end && *begin < minimum_age) {
+    ++begin;
+  }
+  return begin;
+}
+
+#if defined(__x86_64__)
+
+static bool HasAvx2() {
+#if defined(__AVX2__)
+  return true;
+#else
+  static const bool has_avx2 = []() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+  }();
+  return has_avx2;
+#endif
+}
+
+static constexpr size_t kWordsPerAvx2Vector = sizeof(__m256i) / sizeof(uintptr_t);
+
+template <bool kGarbage>
+__attribute__((target("avx2")))
+ALWAYS_INLINE static __m256i LoadAvx2(const Atomic<uintptr_t>* live,
+                                      const Atomic<uintptr_t>* mark,
+                                      size_t i) {
+  __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(live + i));
+  if (kGarbage) {
+    v = _mm256_andnot_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(mark + i)), v);
+  }
+  return v;
+}
+
+template <bool kGarbage>
+__attribute__((target("avx2")))
+static size_t FindWordAvx2(const Atomic<uintptr_t>* live,
+                           const Atomic<uintptr_t>* mark,
+                           size_t begin,
+                           size_t end) {
+  // Test a cache line at a time, then locate the word in the line with the scalar loop.
+  size_t i = begin;
+  for (; i + 2 * kWordsPerAvx2Vector <= end; i += 2 * kWordsPerAvx2Vector) {
+    __m256i v = _mm256_or_si256(LoadAvx2<kGarbage>(live, mark, i),
+                                LoadAvx2<kGarbage>(live, mark, i + kWordsPerAvx2Vector));
+    if (!_mm256_testz_si256(v, v)) {
+      break;
+    }
+  }
+  return FindWordScalar<kGarbage>(live, mark, i, end);
+}
+
+// Per-byte population count with a nibble lookup table, as AVX2 has no vector popcount.
+__attribute__((target("avx2")))
+ALWAYS_INLINE static __m256i PopcountBytesAvx2(__m256i v) {
+  const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                          0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_mask = _mm256_set1_epi8(0x0f);
+  __m256i low = _mm256_and_si256(v, low_mask);
+  __m256i high = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+  return _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+}
+
+template <bool kGarbage>
+__attribute__((target("avx2")))
+static size_t CountBitsAvx2(const Atomic<uintptr_t>* live,
+                            const Atomic<uintptr_t>* mark,
+                            size_t begin,
+                            size_t end) {
+  // Sum the byte counts of each vector into its four 64-bit lanes.
+  __m256i sum = _mm256_setzero_si256();
+  size_t i = begin;
+  for (; i + kWordsPerAvx2Vector <= end; i += kWordsPerAvx2Vector) {
+    __m256i counts = PopcountBytesAvx2(LoadAvx2<kGarbage>(live, mark, i));
+    sum = _mm256_add_epi64(sum, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+  }
+  size_t count = static_cast<size_t>(_mm256_extract_epi64(sum, 0)) +
+                 static_cast<size_t>(_mm256_extract_epi64(sum, 1)) +
+                 static_cast<size_t>(_mm256_extract_epi64(sum, 2)) +
+                 static_cast<size_t>(_mm256_extract_epi64(sum, 3));
+  return count + CountBitsScalar<kGarbage>(live, mark, i, end);
+}
+
+__attribute__((target("avx2")))
+static uint8_t* FindCardAvx2(uint8_t* begin, uint8_t* end, uint8_t minimum_age) {
+  const __m256i minimum = _mm256_set1_epi8(static_cast<char>(minimum_age));
+  uint8_t* cur = begin;
+  for (; static_cast<size_t>(end - cur) >= 2 * sizeof(__m256i); cur += 2 * sizeof(__m256i)) {
+    __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur));
+    __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur + sizeof(__m256i)));
+    // There is no unsigned byte comparison, but `card >= minimum` iff `max(card, minimum) == card`.
+    __m256i old_enough = _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(v0, minimum), v0),
+                                         _mm256_cmpeq_epi8(_mm256_max_epu8(v1, minimum), v1));
+    if (_mm256_movemask_epi8(old_enough) != 0) {
+      break;
+    }
+  }
+  return FindCardScalar(cur, end, minimum_age);
+}
+
+template <bool kGarbage>
+static size_t FindWord(const Atomic<uintptr_t>* live,
+                       const Atomic<uintptr_t>* mark,
+                       size_t begin,
+                       size_t end) {
+  return HasAvx2() ? FindWordAvx2<kGarbage>(live, mark, begin, end)
+                   : FindWordScalar<kGarbage>(live, mark, begin, end);
+}
+
+template <bool kGarbage>
+static size_t CountBits(const Atomic<uintptr_t>* live,
+                        const Atomic<uintptr_t>* mark,
+                        size_t begin,
+                        size_t end) {
+  return HasAvx2() ? CountBitsAvx2<kGarbage>(live, mark, begin, end)
+                   : CountBitsScalar<kGarbage>(live, mark, begin, end);
+}
+
+static uint8_t* FindCard(uint8_t* begin, uint8_t* end, uint8_t minimum_age) {
+  return HasAvx2() ? FindCardAvx2(begin, end, minimum_age)
+                   : FindCardScalar(begin, end, minimum_age);
+}
+
+#elif defined(__aarch64__)
+
+static constexpr size_t kWordsPerNeonVector = sizeof(uint8x16_t) / sizeof(uintptr_t);
+
+template <bool kGarbage>
+ALWAYS_INLINE static uint8x16_t LoadNeon(const Atomic<uintptr_t>* live,
+                                         const Atomic<uintptr_t>* mark,
+                                         size_t i) {
+  uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(live + i));
+  if (kGarbage) {
+    v = vbicq_u8(v, vld1q_u8(reinterpret_cast<const uint8_t*>(mark + i)));
+  }
+  return v;
+}
+
+// NEON is part of the arm64 baseline, so there is no need to check for it at runtime.
+template <bool kGarbage>
+static size_t FindWord(const Atomic<uintptr_t>* live,
+                       const Atomic<uintptr_t>* mark,
+                       size_t begin,
+                       size_t end) {
+  // Test a cache line at a time, then locate the word in the line with the scalar loop.
+  size_t i = begin;
+  for (; i + 4 * kWordsPerNeonVector <= end; i += 4 * kWordsPerNeonVector) {
+    uint8x16_t v0 = vorrq_u8(LoadNeon<kGarbage>(live, mark, i),
+                             LoadNeon<kGarbage>(live, mark, i + kWordsPerNeonVector));
+    uint8x16_t v1 = vorrq_u8(LoadNeon<kGarbage>(live, mark, i + 2 * kWordsPerNeonVector),
+                             LoadNeon<kGarbage>(live, mark, i + 3 * kWordsPerNeonVector));
+    if (vmaxvq_u8(vorrq_u8(v0, v1)) != 0) {
+      break;
+    }
+  }
+  return FindWordScalar<kGarbage>(live, mark, i, end);
+}
+
+template <bool kGarbage>
+static size_t CountBits(const Atomic<uintptr_t>* live,
+                        const Atomic<uintptr_t>* mark,
+                        size_t begin,
+                        size_t end) {
+  size_t count = 0;
+  size_t i = begin;
+  for (; i + kWordsPerNeonVector <= end; i += kWordsPerNeonVector) {
+    // At most 128 bits per vector, so the horizontal byte sum cannot overflow.
+    count += vaddvq_u8(vcntq_u8(LoadNeon<kGarbage>(live, mark, i)));
+  }
+  return count + CountBitsScalar<kGarbage>(live, mark, i, end);
+}
+
+static uint8_t* FindCard(uint8_t* begin, uint8_t* end, uint8_t minimum_age) {
+  const uint8x16_t minimum = vdupq_n_u8(minimum_age);
+  static constexpr size_t kVectorSize = sizeof(uint8x16_t);
+  uint8_t* cur = begin;
+  for (; static_cast<size_t>(end - cur) >= 4 * kVectorSize; cur += 4 * kVectorSize) {
+    uint8x16_t old_enough0 = vorrq_u8(vcgeq_u8(vld1q_u8(cur), minimum),
+                                      vcgeq_u8(vld1q_u8(cur + kVectorSize), minimum));
+    uint8x16_t old_enough1 = vorrq_u8(vcgeq_u8(vld1q_u8(cur + 2 * kVectorSize), minimum),
+                                      vcgeq_u8(vld1q_u8(cur + 3 * kVectorSize), minimum));
+    if (vmaxvq_u8(vorrq_u8(old_enough0, old_enough1)) != 0) {
+      break;
+    }
+  }
+  return FindCardScalar(cur, end, minimum_age);
+}
+
+#else
+
+template <bool kGarbage>
+static size_t FindWord(const Atomic<uintptr_t>* live,
+                       const Atomic<uintptr_t>* mark,
+                       size_t begin,
+                       size_t end) {
+  return FindWordScalar<kGarbage>(live, mark, begin, end);
+}
+
+template <bool kGarbage>
+static size_t CountBits(const Atomic<uintptr_t>* live,
+                        const Atomic<uintptr_t>* mark,
+                        size_t begin,
+                        size_t end) {
+  return CountBitsScalar<kGarbage>(live, mark, begin, end);
+}
+
+static uint8_t* FindCard(uint8_t* begin, uint8_t* end, uint8_t minimum_age) {
+  return FindCardScalar(begin, end, minimum_age);
+}
+
+#endif
+
+size_t FindNonZeroWord(const Atomic<uintptr_t>* words, size_t begin, size_t end) {
+  DCHECK_LE(begin, end);
+  return FindWord</*kGarbage=*/ false>(words, /*mark=*/ nullptr, begin, end);
+}
+
+size_t FindGarbageWord(const Atomic<uintptr_t>* live,
+                       const Atomic<uintptr_t>* mark,
+                       size_t begin,
+                       size_t end) {
+  DCHECK_LE(begin, end);
+  return FindWord</*kGarbage=*/ true>(live, mark, begin, end);
+}
+
+size_t CountSetBits(const Atomic<uintptr_t>* words, size_t begin, size_t end) {
+  DCHECK_LE(begin, end);
+  return CountBits</*kGarbage=*/ false>(words, /*mark=*/ nullptr, begin, end);
+}
+
+size_t CountGarbageBits(const Atomic<uintptr_t>* live,
+                        const Atomic<uintptr_t>* mark,
+                        size_t begin,
+                        size_t end) {
+  DCHECK_LE(begin, end);
+  return CountBits</*kGarbage=*/ true>(live, mark, begin, end);
+}
+
+uint8_t* FindCardAtLeast(uint8_t* begin, uint8_t* end, uint8_t minimum_age) {
+  DCHECK_LE(begin, end);
+  return FindCard(begin, end, minimum_age);
+}
+
+}  // namespace accounting
+}  // namespace gc
+}  // namespace art
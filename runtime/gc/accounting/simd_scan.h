@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_ACCOUNTING_SIMD_SCAN_H_
+#define ART_RUNTIME_GC_ACCOUNTING_SIMD_SCAN_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base/atomic.h"
+#include "base/macros.h"
+
+// Scanning kernels for SpaceBitmap and CardTable. Bitmaps and card tables of large heaps are
+// mostly made of long runs of empty words and clean cards, which these skip a cache line at a
+// time with vector instructions: AVX2 on x86-64 when the CPU supports it, NEON on arm64, and a
+// scalar loop everywhere else. The memory scanned may be concurrently modified; like relaxed
+// loads, the kernels only see some snapshot of it.
+
+namespace art HIDDEN {
+namespace gc {
+namespace accounting {
+
+// The number of words in four 64-byte cache lines. Shorter ranges, like those of a single card,
+// are cheaper to scan with an inline loop than with a call to the kernels.
+static constexpr size_t kMinVectorScanWords = 4 * 64 / sizeof(uintptr_t);
+
+// Returns the index of the first non-zero word in words[begin, end), or `end` if there is none.
+EXPORT size_t FindNonZeroWord(const Atomic<uintptr_t>* words, size_t begin, size_t end);
+
+// Returns the index of the first word in [begin, end) with bits set in `live` that are clear in
+// `mark`, or `end` if there is none.
+EXPORT size_t FindGarbageWord(const Atomic<uintptr_t>* live,
+                              const Atomic<uintptr_t>* mark,
+                              size_t begin,
+                              size_t end);
+
+// Returns the number of bits set in words[begin, end).
+EXPORT size_t CountSetBits(const Atomic<uintptr_t>* words, size_t begin, size_t end);
+
+// Returns the number of bits set in `live` and clear in `mark` in words [begin, end).
+EXPORT size_t CountGarbageBits(const Atomic<uintptr_t>* live,
+                               const Atomic<uintptr_t>* mark,
+                               size_t begin,
+                               size_t end);
+
+// Returns the first card in [begin, end) whose value is at least `minimum_age`, or `end` if
+// there is none.
+EXPORT uint8_t* FindCardAtLeast(uint8_t* begin, uint8_t* end, uint8_t minimum_age);
+
+}  // namespace accounting
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_ACCOUNTING_SIMD_SCAN_H_
@@ -25,6 +25,7 @@
 
 #include "base/atomic.h"
 #include "base/bit_utils.h"
+#include "simd_scan.h"
 
 namespace art HIDDEN {
 namespace gc {
@@ -161,18 +162,25 @@ inline void SpaceBitmap<kAlignment>::VisitMarkedRange(uintptr_t visit_begin,
     // Traverse the middle, full part.
     for (size_t i = index_start + 1; i < index_end; ++i) {
       uintptr_t w = bitmap_begin_[i].load(std::memory_order_relaxed);
-      if (w != 0) {
-        const uintptr_t ptr_base = IndexToOffset(i) + heap_begin_;
-        // Iterate on the bits set in word `w`, from the least to the most significant bit.
-        do {
-          const size_t shift = CTZ(w);
-          mirror::Object* obj = reinterpret_cast<mirror::Object*>(ptr_base + shift * kAlignment);
-          visitor(obj);
-          if (kVisitOnce) {
-            return;
-          }
-          w ^= (static_cast<uintptr_t>(1)) << shift;
-        } while (w != 0);
+      if (w == 0 && index_end - i > kMinVectorScanWords) {
+        // Skip the run of empty words that starts here with the vectorized scan.
+        i = FindNonZeroWord(bitmap_begin_, i + 1, index_end);
+        if (i == index_end) {
+          break;
+        }
+        w = bitmap_begin_[i].load(std::memory_order_relaxed);
+      }
+      const uintptr_t ptr_base = IndexToOffset(i) + heap_begin_;
+      // Iterate on the bits set in word `w`, from the least to the most significant bit. The word
+      // is reloaded after the scan, and may have been cleared concurrently in the meantime.
+      while (w != 0) {
+        const size_t shift = CTZ(w);
+        mirror::Object* obj = reinterpret_cast<mirror::Object*>(ptr_base + shift * kAlignment);
+        visitor(obj);
+        if (kVisitOnce) {
+          return;
+        }
+        w ^= (static_cast<uintptr_t>(1)) << shift;
       }
     }
 
@@ -214,16 +222,16 @@ void SpaceBitmap<kAlignment>::Walk(Visitor&& visitor) {
 
   uintptr_t end = OffsetToIndex(HeapLimit() - heap_begin_ - 1);
   Atomic<uintptr_t>* bitmap_begin = bitmap_begin_;
-  for (uintptr_t i = 0; i <= end; ++i) {
+  for (uintptr_t i = FindNonZeroWord(bitmap_begin, 0, end + 1);
+       i <= end;
+       i = FindNonZeroWord(bitmap_begin, i + 1, end + 1)) {
     uintptr_t w = bitmap_begin[i].load(std::memory_order_relaxed);
-    if (w != 0) {
-      uintptr_t ptr_base = IndexToOffset(i) + heap_begin_;
-      do {
-        const size_t shift = CTZ(w);
-        mirror::Object* obj = reinterpret_cast<mirror::Object*>(ptr_base + shift * kAlignment);
-        visitor(obj);
-        w ^= (static_cast<uintptr_t>(1)) << shift;
-      } while (w != 0);
+    uintptr_t ptr_base = IndexToOffset(i) + heap_begin_;
+    while (w != 0) {
+      const size_t shift = CTZ(w);
+      mirror::Object* obj = reinterpret_cast<mirror::Object*>(ptr_base + shift * kAlignment);
+      visitor(obj);
+      w ^= (static_cast<uintptr_t>(1)) << shift;
     }
   }
 }
@@ -27,6 +27,7 @@
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
 #include "mirror/object_array.h"
+#include "simd_scan.h"
 
 namespace art HIDDEN {
 namespace gc {
@@ -160,14 +161,28 @@ template<size_t kAlignment>
 void SpaceBitmap<kAlignment>::ClearRange(const mirror::Object* begin, const mirror::Object* end) {
   uintptr_t begin_offset = reinterpret_cast<uintptr_t>(begin) - heap_begin_;
   uintptr_t end_offset = reinterpret_cast<uintptr_t>(end) - heap_begin_;
-  // Align begin and end to bitmap word boundaries.
-  while (begin_offset < end_offset && OffsetBitIndex(begin_offset) != 0) {
-    Clear(reinterpret_cast<mirror::Object*>(heap_begin_ + begin_offset));
-    begin_offset += kAlignment;
+  // Align begin and end to bitmap word boundaries, clearing the bits of the partial words at
+  // either end with a mask rather than one at a time.
+  if (begin_offset < end_offset && OffsetBitIndex(begin_offset) != 0) {
+    const uintptr_t index = OffsetToIndex(begin_offset);
+    const uintptr_t next_word_offset = IndexToOffset(index + 1);
+    uintptr_t mask = ~(OffsetToMask(begin_offset) - 1);
+    if (end_offset < next_word_offset) {
+      // The range is within a single word.
+      mask &= OffsetToMask(end_offset) - 1;
+      begin_offset = end_offset;
+    } else {
+      begin_offset = next_word_offset;
+    }
+    uintptr_t old_word = bitmap_begin_[index].load(std::memory_order_relaxed);
+    bitmap_begin_[index].store(old_word & ~mask, std::memory_order_relaxed);
   }
-  while (begin_offset < end_offset && OffsetBitIndex(end_offset) != 0) {
-    end_offset -= kAlignment;
-    Clear(reinterpret_cast<mirror::Object*>(heap_begin_ + end_offset));
+  if (begin_offset < end_offset && OffsetBitIndex(end_offset) != 0) {
+    const uintptr_t index = OffsetToIndex(end_offset);
+    const uintptr_t mask = OffsetToMask(end_offset) - 1;
+    uintptr_t old_word = bitmap_begin_[index].load(std::memory_order_relaxed);
+    bitmap_begin_[index].store(old_word & ~mask, std::memory_order_relaxed);
+    end_offset = IndexToOffset(index);
   }
   // Bitmap word boundaries.
   const uintptr_t start_index = OffsetToIndex(begin_offset);
@@ -176,6 +191,35 @@ void SpaceBitmap<kAlignment>::ClearRange(const mirror::Object* begin, const mirr
                        (end_index - start_index) * sizeof(*bitmap_begin_));
 }
 
+template<size_t kAlignment>
+size_t SpaceBitmap<kAlignment>::CountMarked(uintptr_t visit_begin, uintptr_t visit_end) const {
+  DCHECK_LE(visit_begin, visit_end);
+  DCHECK_LE(heap_begin_, visit_begin);
+  DCHECK_LE(visit_end, HeapLimit());
+  if (visit_begin == visit_end) {
+    return 0u;
+  }
+  const uintptr_t offset_start = visit_begin - heap_begin_;
+  const uintptr_t offset_end = visit_end - heap_begin_;
+  const uintptr_t index_start = OffsetToIndex(offset_start);
+  const uintptr_t index_end = OffsetToIndex(offset_end);
+  // Mask of the bits in range in the left edge, and in the right edge.
+  const uintptr_t left_mask = ~(OffsetToMask(offset_start) - 1);
+  const uintptr_t right_mask = OffsetToMask(offset_end) - 1;
+  if (index_start == index_end) {
+    return POPCOUNT(bitmap_begin_[index_start].load(std::memory_order_relaxed) &
+                    left_mask &
+                    right_mask);
+  }
+  size_t count = POPCOUNT(bitmap_begin_[index_start].load(std::memory_order_relaxed) & left_mask);
+  count += CountSetBits(bitmap_begin_, index_start + 1, index_end);
+  if (right_mask != 0) {
+    // Do not read the right edge otherwise, as it could be after the end of the bitmap.
+    count += POPCOUNT(bitmap_begin_[index_end].load(std::memory_order_relaxed) & right_mask);
+  }
+  return count;
+}
+
 template<size_t kAlignment>
 void SpaceBitmap<kAlignment>::CopyFrom(SpaceBitmap* source_bitmap) {
   DCHECK_EQ(Size(), source_bitmap->Size());
@@ -216,32 +260,29 @@ void SpaceBitmap<kAlignment>::SweepWalk(const SpaceBitmap<kAlignment>& live_bitm
     // we get the size of objects (and hence read the class) inside of the freeing logic. This can
     // cause crashes for unloaded classes since the class may get zeroed out before it is read.
     // See b/131542326
-    for (size_t i = start; i <= end; i++) {
-      uintptr_t garbage =
-          live[i].load(std::memory_order_relaxed) & ~mark[i].load(std::memory_order_relaxed);
-      buffer_size += POPCOUNT(garbage);
-    }
+    buffer_size += CountGarbageBits(live, mark, start, end + 1);
   }
   std::vector<mirror::Object*> pointer_buf(buffer_size);
   mirror::Object** cur_pointer = &pointer_buf[0];
   mirror::Object** pointer_end = cur_pointer + (buffer_size - kBitsPerIntPtrT);
 
-  for (size_t i = start; i <= end; i++) {
+  // Garbage is usually sparse, so skip the words without any with the vectorized scan.
+  for (size_t i = FindGarbageWord(live, mark, start, end + 1);
+       i <= end;
+       i = FindGarbageWord(live, mark, i + 1, end + 1)) {
     uintptr_t garbage =
         live[i].load(std::memory_order_relaxed) & ~mark[i].load(std::memory_order_relaxed);
-    if (UNLIKELY(garbage != 0)) {
-      uintptr_t ptr_base = IndexToOffset(i) + live_bitmap.heap_begin_;
-      do {
-        const size_t shift = CTZ(garbage);
-        garbage ^= (static_cast<uintptr_t>(1)) << shift;
-        *cur_pointer++ = reinterpret_cast<mirror::Object*>(ptr_base + shift * kAlignment);
-      } while (garbage != 0);
-      // Make sure that there are always enough slots available for an
-      // entire word of one bits.
-      if (cur_pointer >= pointer_end) {
-        (*callback)(cur_pointer - &pointer_buf[0], &pointer_buf[0], arg);
-        cur_pointer  = &pointer_buf[0];
-      }
+    uintptr_t ptr_base = IndexToOffset(i) + live_bitmap.heap_begin_;
+    while (garbage != 0) {
+      const size_t shift = CTZ(garbage);
+      garbage ^= (static_cast<uintptr_t>(1)) << shift;
+      *cur_pointer++ = reinterpret_cast<mirror::Object*>(ptr_base + shift * kAlignment);
+    }
+    // Make sure that there are always enough slots available for an
+    // entire word of one bits.
+    if (cur_pointer >= pointer_end) {
+      (*callback)(cur_pointer - &pointer_buf[0], &pointer_buf[0], arg);
+      cur_pointer  = &pointer_buf[0];
     }
   }
   if (cur_pointer > &pointer_buf[0]) {
@@ -147,6 +147,9 @@ class SpaceBitmap {
   void VisitMarkedRange(uintptr_t visit_begin, uintptr_t visit_end, Visitor&& visitor) const
       NO_THREAD_SAFETY_ANALYSIS;
 
+  // Return the number of set bits in the range [visit_begin, visit_end).
+  size_t CountMarked(uintptr_t visit_begin, uintptr_t visit_end) const;
+
   // Visit all of the set bits in HeapBegin(), HeapLimit().
   template <typename Visitor>
   void VisitAllMarked(Visitor&& visitor) const {
@@ -18,6 +18,7 @@
 
 #include <stdint.h>
 #include <memory>
+#include <set>
 
 #include "base/mutex.h"
 #include "common_runtime_test.h"
@@ -274,6 +275,54 @@ TYPED_TEST(SpaceBitmapTest, OrderAlignment) {
   RunTest<SpaceBitmap>(TypeParam::GetObjectAlignment(), order_test_fn);
 }
 
+TYPED_TEST(SpaceBitmapTest, CountMarked) {
+  using SpaceBitmap = typename TypeParam::SpaceBitmap;
+  auto count_test_fn = [](SpaceBitmap* space_bitmap,
+                          uintptr_t range_begin,
+                          uintptr_t range_end,
+                          size_t manual_count) {
+    EXPECT_EQ(space_bitmap->CountMarked(range_begin, range_end), manual_count);
+  };
+  RunTest<SpaceBitmap>(TypeParam::GetObjectAlignment(), count_test_fn);
+}
+
+TYPED_TEST(SpaceBitmapTest, SweepWalk) {
+  using SpaceBitmap = typename TypeParam::SpaceBitmap;
+  uint8_t* heap_begin = reinterpret_cast<uint8_t*>(0x10000000);
+  size_t heap_capacity = 16 * MB;
+  const size_t alignment = TypeParam::GetObjectAlignment();
+  SpaceBitmap live_bitmap(SpaceBitmap::Create("live bitmap", heap_begin, heap_capacity));
+  SpaceBitmap mark_bitmap(SpaceBitmap::Create("mark bitmap", heap_begin, heap_capacity));
+
+  // Sparse live objects, with long empty runs in between, of which every third is marked.
+  RandGen r(0x1234);
+  std::set<mirror::Object*> expected_garbage;
+  for (size_t i = 0; i < 1000; ++i) {
+    size_t offset = RoundDown(r.next() % heap_capacity, alignment);
+    mirror::Object* obj = reinterpret_cast<mirror::Object*>(heap_begin + offset);
+    live_bitmap.Set(obj);
+    if (i % 3 == 0) {
+      mark_bitmap.Set(obj);
+      expected_garbage.erase(obj);
+    } else if (!mark_bitmap.Test(obj)) {
+      expected_garbage.insert(obj);
+    }
+  }
+
+  std::set<mirror::Object*> garbage;
+  auto callback = [](size_t ptr_count, mirror::Object** ptrs, void* arg) {
+    std::set<mirror::Object*>* out = reinterpret_cast<std::set<mirror::Object*>*>(arg);
+    out->insert(ptrs, ptrs + ptr_count);
+  };
+  SpaceBitmap::SweepWalk(live_bitmap,
+                         mark_bitmap,
+                         reinterpret_cast<uintptr_t>(heap_begin),
+                         reinterpret_cast<uintptr_t>(heap_begin) + heap_capacity,
+                         callback,
+                         &garbage);
+  EXPECT_EQ(garbage, expected_garbage);
+}
+
 }  // namespace accounting
 }  // namespace gc
 }  // namespace art
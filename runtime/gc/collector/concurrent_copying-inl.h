@@ -105,7 +105,8 @@ inline mirror::Object* ConcurrentCopying::MarkImmuneSpace(Thread* const self,
                updated_all_immune_objects_.load(std::memory_order_relaxed) ||
                gc_grays_immune_objects_);
       } else {
-        DCHECK(kGrayImmuneObject);
+        // Parallel markers scan objects on behalf of the GC-running thread.
+        DCHECK(kGrayImmuneObject || parallel_marking_.load(std::memory_order_relaxed));
       }
     }
     if (!kGrayImmuneObject || updated_all_immune_objects_.load(std::memory_order_relaxed)) {
@@ -136,7 +137,8 @@ inline mirror::Object* ConcurrentCopying::Mark(Thread* const self,
   DCHECK(heap_->collector_type_ == kCollectorTypeCC);
   if (kFromGCThread) {
     DCHECK(is_active_);
-    DCHECK_EQ(self, thread_running_gc_);
+    // The parallel marking helpers mark on behalf of the GC thread.
+    DCHECK(self == thread_running_gc_ || parallel_marking_.load(std::memory_order_relaxed));
   } else if (UNLIKELY(kUseBakerReadBarrier && !is_active_)) {
     // In the lock word forward address state, the read barrier bits
     // in the lock word are part of the stored forwarding address and
@@ -45,6 +45,7 @@
 #include "scoped_thread_state_change-inl.h"
 #include "thread-inl.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "well_known_classes.h"
 
 namespace art HIDDEN {
@@ -87,7 +88,12 @@ ConcurrentCopying::ConcurrentCopying(Heap* heap,
                                                          kReadBarrierMarkStackSize)),
       rb_mark_bit_stack_full_(false),
       mark_stack_lock_("concurrent copying mark stack lock", kMarkSweepMarkStackLock),
+      mark_stack_cond_("concurrent copying mark stack condition", mark_stack_lock_),
       thread_running_gc_(nullptr),
+      parallel_marking_(false),
+      num_active_markers_(0),
+      parallel_marked_count_(0),
+      parallel_bytes_scanned_(0),
       is_marking_(false),
       is_using_read_barrier_entrypoints_(false),
       is_active_(false),
@@ -229,6 +235,11 @@ void ConcurrentCopying::RunPhases() {
   Thread* self = Thread::Current();
   thread_running_gc_ = self;
   Locks::mutator_lock_->AssertNotHeld(self);
+  if (heap_->GetConcGCThreadCount() > 0 && heap_->GetThreadPool() == nullptr) {
+    // Create the helper threads for parallel marking (see ProcessMarkStackParallel()) before
+    // taking the mutator lock.
+    heap_->CreateThreadPool();
+  }
   {
     ReaderMutexLock mu(self, *Locks::mutator_lock_);
     InitializePhase();
@@ -1868,6 +1879,10 @@ void ConcurrentCopying::PushOntoMarkStack(Thread* const self, mirror::Object* to
         if (tl_mark_stack != nullptr) {
           // Store the old full stack into a vector.
           revoked_mark_stacks_.push_back(tl_mark_stack);
+          if (parallel_marking_.load(std::memory_order_relaxed)) {
+            // Wake up the idle parallel markers to steal it.
+            mark_stack_cond_.Broadcast(self);
+          }
         }
       } else {
         tl_mark_stack->PushBack(to_ref);
@@ -2139,7 +2154,13 @@ bool ConcurrentCopying::ProcessMarkStackOnce() {
   DCHECK(thread_running_gc_->GetThreadLocalMarkStack() == nullptr);
   size_t count = 0;
   MarkStackMode mark_stack_mode = mark_stack_mode_.load(std::memory_order_acquire);
-  if (mark_stack_mode == kMarkStackModeThreadLocal) {
+  if (mark_stack_mode == kMarkStackModeThreadLocal && ShouldMarkInParallel()) {
+    // Collect the thread-local mark stacks and process them, along with the GC mark stack, with
+    // the parallel markers.
+    RevokeThreadLocalMarkStacks(/* disable_weak_ref_access= */ false,
+                                /* checkpoint_callback= */ nullptr);
+    count += ProcessMarkStackParallel();
+  } else if (mark_stack_mode == kMarkStackModeThreadLocal) {
     // Process the thread-local mark stacks and the GC mark stack.
     count += ProcessThreadLocalMarkStacks(/* disable_weak_ref_access= */ false,
                                           /* checkpoint_callback= */ nullptr,
@@ -2228,17 +2249,7 @@ size_t ConcurrentCopying::ProcessThreadLocalMarkStacks(bool disable_weak_ref_acc
       processor(to_ref);
       ++count;
     }
-    {
-      MutexLock mu(thread_running_gc_, mark_stack_lock_);
-      if (pooled_mark_stacks_.size() >= kMarkStackPoolSize) {
-        // The pool has enough. Delete it.
-        delete mark_stack;
-      } else {
-        // Otherwise, put it into the pool for later reuse.
-        mark_stack->Reset();
-        pooled_mark_stacks_.push_back(mark_stack);
-      }
-    }
+    RecycleMarkStack(thread_running_gc_, mark_stack);
   }
   if (disable_weak_ref_access) {
     MutexLock mu(thread_running_gc_, mark_stack_lock_);
@@ -2248,6 +2259,178 @@ size_t ConcurrentCopying::ProcessThreadLocalMarkStacks(bool disable_weak_ref_acc
   return count;
 }
 
+void ConcurrentCopying::RecycleMarkStack(Thread* const self,
+                                         accounting::ObjectStack* mark_stack) {
+  MutexLock mu(self, mark_stack_lock_);
+  if (pooled_mark_stacks_.size() >= kMarkStackPoolSize) {
+    // The pool has enough. Delete it.
+    delete mark_stack;
+  } else {
+    // Otherwise, put it into the pool for later reuse.
+    mark_stack->Reset();
+    pooled_mark_stacks_.push_back(mark_stack);
+  }
+}
+
+class ConcurrentCopying::ParallelMarkTask : public SelfDeletingTask {
+ public:
+  explicit ParallelMarkTask(ConcurrentCopying* collector) : collector_(collector) {}
+
+  // Like the GC thread, the helpers don't transition to the runnable state: the GC thread holds
+  // the mutator lock on their behalf and waits for them before it can get suspended.
+  void Run(Thread* self) override NO_THREAD_SAFETY_ANALYSIS {
+    size_t count = collector_->ParallelMarkLoop(self);
+    collector_->parallel_marked_count_.fetch_add(count, std::memory_order_relaxed);
+  }
+
+ private:
+  ConcurrentCopying* const collector_;
+};
+
+bool ConcurrentCopying::ShouldMarkInParallel() const {
+  return heap_->GetConcGCThreadCount() > 0 && heap_->GetThreadPool() != nullptr;
+}
+
+size_t ConcurrentCopying::ProcessMarkStackParallel() {
+  Thread* const self = Thread::Current();
+  DCHECK_EQ(self, thread_running_gc_);
+  ThreadPool* pool = heap_->GetThreadPool();
+  DCHECK(pool != nullptr);
+  const size_t num_helpers = std::min(pool->GetThreadCount(), heap_->GetConcGCThreadCount());
+  parallel_marked_count_.store(0, std::memory_order_relaxed);
+  parallel_bytes_scanned_.store(0, std::memory_order_relaxed);
+  // The GC thread is a marker too.
+  num_active_markers_.store(num_helpers + 1, std::memory_order_relaxed);
+  parallel_marking_.store(true, std::memory_order_relaxed);
+  for (size_t i = 0; i < num_helpers; ++i) {
+    pool->AddTask(self, new ParallelMarkTask(this));
+  }
+  pool->SetMaxActiveWorkers(num_helpers);
+  pool->StartWorkers(self);
+  size_t count = ParallelMarkLoop(self);
+  pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ true);
+  pool->StopWorkers(self);
+  parallel_marking_.store(false, std::memory_order_relaxed);
+  DCHECK(self->GetThreadLocalMarkStack() == nullptr);
+  DCHECK(gc_mark_stack_->IsEmpty());
+  gc_mark_stack_->Reset();
+  bytes_scanned_ += parallel_bytes_scanned_.load(std::memory_order_relaxed);
+  return count + parallel_marked_count_.load(std::memory_order_relaxed);
+}
+
+size_t ConcurrentCopying::ParallelMarkLoop(Thread* const self) {
+  // Number of references processed between checks for idle markers.
+  static constexpr size_t kDonationCheckInterval = 64;
+  // Only donate if at least that many references are left for this marker.
+  static constexpr size_t kMinDonationSize = 32;
+  const bool is_gc_thread = self == thread_running_gc_;
+  const size_t num_markers = num_active_markers_.load(std::memory_order_relaxed);
+  size_t count = 0;
+  while (true) {
+    // Drain our own mark stack. The GC thread pushes onto the GC mark stack and the helpers onto
+    // their thread-local mark stacks, which get published as they fill up.
+    while (true) {
+      accounting::ObjectStack* mark_stack =
+          is_gc_thread ? gc_mark_stack_.get() : self->GetThreadLocalMarkStack();
+      if (mark_stack == nullptr || mark_stack->IsEmpty()) {
+        break;
+      }
+      if (count % kDonationCheckInterval == 0 &&
+          mark_stack->Size() >= 2 * kMinDonationSize &&
+          num_active_markers_.load(std::memory_order_relaxed) < num_markers) {
+        DonateMarkStackWork(self, mark_stack);
+      }
+      ProcessMarkStackRef(mark_stack->PopBack());
+      ++count;
+    }
+    // Steal a published mark stack. Processing it fills our own mark stack.
+    accounting::ObjectStack* stolen = StealMarkStack(self);
+    if (stolen != nullptr) {
+      for (StackReference<mirror::Object>* p = stolen->Begin(); p != stolen->End(); ++p) {
+        ProcessMarkStackRef(p->AsMirrorPtr());
+        ++count;
+      }
+      RecycleMarkStack(self, stolen);
+      continue;
+    }
+    // Out of work. Wait until some other marker publishes work, or all markers are idle. Markers
+    // only publish while active, and the count only changes with the lock held, so no marker can
+    // publish once it drops to zero. Stacks published by mutators after that are left to the next
+    // ProcessMarkStackOnce() round.
+    MutexLock mu(self, mark_stack_lock_);
+    if (!revoked_mark_stacks_.empty()) {
+      continue;  // Published since we tried to steal.
+    }
+    if (num_active_markers_.fetch_sub(1, std::memory_order_relaxed) == 1) {
+      mark_stack_cond_.Broadcast(self);
+      break;
+    }
+    while (revoked_mark_stacks_.empty() &&
+           num_active_markers_.load(std::memory_order_relaxed) != 0) {
+      // The GC thread holds the mutator lock on behalf of all the markers.
+      mark_stack_cond_.WaitHoldingLocks(self);
+    }
+    if (num_active_markers_.load(std::memory_order_relaxed) == 0) {
+      break;
+    }
+    num_active_markers_.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (!is_gc_thread) {
+    // Give the thread-local mark stack back so that the thread pool workers don't hold on to
+    // pooled mark stacks between GCs.
+    accounting::ObjectStack* tl_mark_stack = self->GetThreadLocalMarkStack();
+    if (tl_mark_stack != nullptr) {
+      DCHECK(tl_mark_stack->IsEmpty());
+      self->SetThreadLocalMarkStack(nullptr);
+      RecycleMarkStack(self, tl_mark_stack);
+    }
+  }
+  return count;
+}
+
+void ConcurrentCopying::DonateMarkStackWork(Thread* const self,
+                                            accounting::ObjectStack* mark_stack) {
+  accounting::ObjectStack* donated;
+  {
+    MutexLock mu(self, mark_stack_lock_);
+    if (!pooled_mark_stacks_.empty()) {
+      donated = pooled_mark_stacks_.back();
+      pooled_mark_stacks_.pop_back();
+    } else {
+      donated = accounting::ObjectStack::Create(
+          "thread local mark stack", GetMarkStackSize(), GetMarkStackSize());
+    }
+  }
+  DCHECK(donated->IsEmpty());
+  const size_t num_refs = std::min(mark_stack->Size() / 2, donated->Capacity());
+  for (StackReference<mirror::Object>* p = mark_stack->End() - num_refs;
+       p != mark_stack->End();
+       ++p) {
+    donated->PushBack(p->AsMirrorPtr());
+  }
+  mark_stack->PopBackCount(static_cast<int32_t>(num_refs));
+  MutexLock mu(self, mark_stack_lock_);
+  revoked_mark_stacks_.push_back(donated);
+  mark_stack_cond_.Broadcast(self);
+}
+
+accounting::ObjectStack* ConcurrentCopying::StealMarkStack(Thread* const self) {
+  MutexLock mu(self, mark_stack_lock_);
+  if (revoked_mark_stacks_.empty()) {
+    return nullptr;
+  }
+  accounting::ObjectStack* mark_stack = revoked_mark_stacks_.back();
+  revoked_mark_stacks_.pop_back();
+  return mark_stack;
+}
+
+// Set the mark bit of `obj` and return its previous value. The bit is set atomically if other
+// markers may be setting bits in the same bitmap concurrently.
+template <typename Bitmap>
+static ALWAYS_INLINE bool SetMarkBit(Bitmap* bitmap, mirror::Object* obj, bool atomic) {
+  return atomic ? bitmap->AtomicTestAndSet(obj) : bitmap->Set(obj);
+}
+
 inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
   DCHECK(!region_space_->IsInFromSpace(to_ref));
   size_t obj_size = 0;
@@ -2263,6 +2446,9 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
         << " region_type=" << rtype;
   }
   bool add_to_live_bytes = false;
+  // With parallel marking, the helper threads and the GC thread race on the bitmaps and the
+  // live bytes.
+  const bool parallel = parallel_marking_.load(std::memory_order_relaxed);
   // Invariant: There should be no object from a newly-allocated
   // region (either large or non-large) on the mark stack.
   DCHECK(!region_space_->IsInNewlyAllocatedRegion(to_ref)) << to_ref;
@@ -2270,7 +2456,7 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
   switch (rtype) {
     case space::RegionSpace::RegionType::kRegionTypeUnevacFromSpace:
       // Mark the bitmap only in the GC thread here so that we don't need a CAS.
-      if (!kUseBakerReadBarrier || !region_space_bitmap_->Set(to_ref)) {
+      if (!kUseBakerReadBarrier || !SetMarkBit(region_space_bitmap_, to_ref, parallel)) {
         // It may be already marked if we accidentally pushed the same object twice due to the racy
         // bitmap read in MarkUnevacFromSpaceRegion.
         if (use_generational_cc_ && young_gen_) {
@@ -2292,7 +2478,7 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
     case space::RegionSpace::RegionType::kRegionTypeToSpace:
       if (use_generational_cc_) {
         // Copied to to-space, set the bit so that the next GC can scan objects.
-        region_space_bitmap_->Set(to_ref);
+        SetMarkBit(region_space_bitmap_, to_ref, parallel);
       }
       perform_scan = true;
       break;
@@ -2323,12 +2509,12 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
               heap_->GetLargeObjectsSpace()->GetMarkBitmap();
           DCHECK(los_bitmap->HasAddress(to_ref));
           // Only the GC thread could be setting the LOS bit map hence doesn't
-          // need to be atomically done.
-          perform_scan = !los_bitmap->Set(to_ref);
+          // need to be atomically done, unless marking in parallel.
+          perform_scan = !SetMarkBit(los_bitmap, to_ref, parallel);
         } else {
           // Only the GC thread could be setting the non-moving space bit map
-          // hence doesn't need to be atomically done.
-          perform_scan = !mark_bitmap->Set(to_ref);
+          // hence doesn't need to be atomically done, unless marking in parallel.
+          perform_scan = !SetMarkBit(mark_bitmap, to_ref, parallel);
         }
       } else {
         perform_scan = true;
@@ -2380,12 +2566,17 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
 
   if (add_to_live_bytes) {
     // Add to the live bytes per unevacuated from-space. Note this code is always run by the
-    // GC-running thread (no synchronization required).
+    // GC-running thread (no synchronization required), unless marking in parallel.
     DCHECK(region_space_bitmap_->Test(to_ref));
     if (obj_size == 0) {
       obj_size = to_ref->SizeOf<kDefaultVerifyFlags>();
     }
-    region_space_->AddLiveBytes(to_ref, RoundUp(obj_size, space::RegionSpace::kAlignment));
+    if (UNLIKELY(parallel)) {
+      region_space_->AtomicAddLiveBytes(to_ref,
+                                        RoundUp(obj_size, space::RegionSpace::kAlignment));
+    } else {
+      region_space_->AddLiveBytes(to_ref, RoundUp(obj_size, space::RegionSpace::kAlignment));
+    }
   }
   if (ReadBarrier::kEnableToSpaceInvariantChecks) {
     CHECK(to_ref != nullptr);
@@ -3129,8 +3320,10 @@ void ConcurrentCopying::AssertToSpaceInvariantInNonMovingSpace(mirror::Object* o
   if (immune_spaces_.ContainsObject(ref)) {
     // Immune space case.
     if (kUseBakerReadBarrier) {
-      // Immune object may not be gray if called from the GC.
-      if (Thread::Current() == thread_running_gc_ && !gc_grays_immune_objects_) {
+      // Immune object may not be gray if called from the GC or a parallel marker.
+      if ((Thread::Current() == thread_running_gc_ ||
+           parallel_marking_.load(std::memory_order_relaxed)) &&
+          !gc_grays_immune_objects_) {
         return;
       }
       bool updated_all_immune_objects = updated_all_immune_objects_.load(std::memory_order_seq_cst);
@@ -3171,7 +3364,7 @@ class ConcurrentCopying::RefFieldsVisitor {
   void operator()(mirror::Object* obj, MemberOffset offset, bool /* is_static */)
       const ALWAYS_INLINE REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES_SHARED(Locks::heap_bitmap_lock_) {
-    collector_->Process<kNoUnEvac>(obj, offset);
+    collector_->Process<kNoUnEvac>(thread_, obj, offset);
   }
 
   void operator()(ObjPtr<mirror::Class> klass, ObjPtr<mirror::Reference> ref) const
@@ -3212,28 +3405,36 @@ inline void ConcurrentCopying::Scan(mirror::Object* to_ref, size_t obj_size) {
   if (obj_size == 0) {
     obj_size = to_ref->SizeOf<kDefaultVerifyFlags>();
   }
-  bytes_scanned_ += obj_size;
+  Thread* const self = Thread::Current();
+  if (UNLIKELY(parallel_marking_.load(std::memory_order_relaxed))) {
+    parallel_bytes_scanned_.fetch_add(obj_size, std::memory_order_relaxed);
+  } else {
+    DCHECK_EQ(self, thread_running_gc_);
+    bytes_scanned_ += obj_size;
+  }
 
   DCHECK(!region_space_->IsInFromSpace(to_ref));
-  DCHECK_EQ(Thread::Current(), thread_running_gc_);
-  RefFieldsVisitor<kNoUnEvac> visitor(this, thread_running_gc_);
+  RefFieldsVisitor<kNoUnEvac> visitor(this, self);
   // Disable the read barrier for a performance reason.
   to_ref->VisitReferences</*kVisitNativeRoots=*/true, kDefaultVerifyFlags, kWithoutReadBarrier>(
       visitor, visitor);
   if (kDisallowReadBarrierDuringScan && !Runtime::Current()->IsActiveTransaction()) {
-    thread_running_gc_->ModifyDebugDisallowReadBarrier(-1);
+    self->ModifyDebugDisallowReadBarrier(-1);
   }
 }
 
 template <bool kNoUnEvac>
-inline void ConcurrentCopying::Process(mirror::Object* obj, MemberOffset offset) {
+inline void ConcurrentCopying::Process(Thread* const self,
+                                       mirror::Object* obj,
+                                       MemberOffset offset) {
   // Cannot have `kNoUnEvac` when Generational CC collection is disabled.
   DCHECK_IMPLIES(kNoUnEvac, use_generational_cc_);
-  DCHECK_EQ(Thread::Current(), thread_running_gc_);
+  DCHECK_EQ(Thread::Current(), self);
+  DCHECK(self == thread_running_gc_ || parallel_marking_.load(std::memory_order_relaxed));
   mirror::Object* ref = obj->GetFieldObject<
       mirror::Object, kVerifyNone, kWithoutReadBarrier, false>(offset);
   mirror::Object* to_ref = Mark</*kGrayImmuneObject=*/false, kNoUnEvac, /*kFromGCThread=*/true>(
-      thread_running_gc_,
+      self,
       ref,
       /*holder=*/ obj,
       offset);
@@ -3473,8 +3674,13 @@ mirror::Object* ConcurrentCopying::Copy(Thread* const self,
   size_t bytes_allocated = 0U;
   size_t unused_size;
   bool fall_back_to_non_moving = false;
+  // Keep the copy on the NUMA node the object was on.
   mirror::Object* to_ref = region_space_->AllocNonvirtual</*kForEvac=*/ true>(
-      region_space_alloc_size, &region_space_bytes_allocated, nullptr, &unused_size);
+      region_space_alloc_size,
+      &region_space_bytes_allocated,
+      nullptr,
+      &unused_size,
+      region_space_->GetNumaNode(from_ref));
   bytes_allocated = region_space_bytes_allocated;
   if (LIKELY(to_ref != nullptr)) {
     DCHECK_EQ(region_space_alloc_size, region_space_bytes_allocated);
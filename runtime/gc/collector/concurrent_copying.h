@@ -191,7 +191,7 @@ class ConcurrentCopying : public GarbageCollector {
       REQUIRES(!mark_stack_lock_);
   // Process a field.
   template <bool kNoUnEvac>
-  void Process(mirror::Object* obj, MemberOffset offset)
+  void Process(Thread* const self, mirror::Object* obj, MemberOffset offset)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_ , !skipped_blocks_lock_, !immune_gray_stack_lock_);
   void VisitRoots(mirror::Object*** roots, size_t count, const RootInfo& info) override
@@ -214,6 +214,28 @@ class ConcurrentCopying : public GarbageCollector {
   bool ProcessMarkStackOnce() REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_);
   void ProcessMarkStackRef(mirror::Object* to_ref) REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
+  // Whether to drain the mark stacks with ConcGCThreads helper threads in addition to the
+  // GC thread. Only used in the thread-local mark stack mode.
+  bool ShouldMarkInParallel() const;
+  // Process the GC mark stack and the revoked thread-local mark stacks with the GC thread and
+  // helper threads from the heap thread pool. Returns the number of references processed.
+  size_t ProcessMarkStackParallel() REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!mark_stack_lock_);
+  // Marking loop run by each parallel marker (the GC thread and the helpers). A marker drains
+  // its own mark stack, donates part of it when other markers are idle, and steals published
+  // mark stacks until all of the markers run out of work. Returns the number of references
+  // processed.
+  size_t ParallelMarkLoop(Thread* const self) REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!mark_stack_lock_);
+  // Move the top part of `mark_stack` into a pooled mark stack and publish it in
+  // revoked_mark_stacks_ so that idle markers can steal it.
+  void DonateMarkStackWork(Thread* const self, accounting::ObjectStack* mark_stack)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_);
+  // Take a mark stack published in revoked_mark_stacks_. Returns null if there is none.
+  accounting::ObjectStack* StealMarkStack(Thread* const self) REQUIRES(!mark_stack_lock_);
+  // Return a drained mark stack to the pool, or delete it if the pool is full.
+  void RecycleMarkStack(Thread* const self, accounting::ObjectStack* mark_stack)
+      REQUIRES(!mark_stack_lock_);
   void GrayAllDirtyImmuneObjects()
       REQUIRES(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
@@ -374,6 +396,9 @@ class ConcurrentCopying : public GarbageCollector {
   Mutex mark_stack_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   std::vector<accounting::ObjectStack*> revoked_mark_stacks_
       GUARDED_BY(mark_stack_lock_);
+  // Idle parallel markers wait on it for published mark stacks, or for the
+  // termination of parallel marking.
+  ConditionVariable mark_stack_cond_ GUARDED_BY(mark_stack_lock_);
   // Size of thread local mark stack.
   static size_t GetMarkStackSize() {
     return gPageSize;
@@ -382,6 +407,15 @@ class ConcurrentCopying : public GarbageCollector {
   std::vector<accounting::ObjectStack*> pooled_mark_stacks_
       GUARDED_BY(mark_stack_lock_);
   Thread* thread_running_gc_;
+  // True while ProcessMarkStackParallel() runs the helper threads. The GC thread and the
+  // helpers then use atomic operations on the mark bitmaps and the region live bytes.
+  Atomic<bool> parallel_marking_;
+  // Number of parallel markers which may still produce work. Parallel marking terminates once
+  // it drops to zero. Only changed with mark_stack_lock_ held.
+  Atomic<size_t> num_active_markers_;
+  // Number of references processed, and bytes scanned, by parallel markers.
+  Atomic<size_t> parallel_marked_count_;
+  Atomic<uint64_t> parallel_bytes_scanned_;
   bool is_marking_;                       // True while marking is ongoing.
   // True while we might dispatch on the read barrier entrypoints.
   bool is_using_read_barrier_entrypoints_;
@@ -505,6 +539,7 @@ class ConcurrentCopying : public GarbageCollector {
   template <bool kConcurrent> class GrayImmuneObjectVisitor;
   class ImmuneSpaceScanObjVisitor;
   class LostCopyVisitor;
+  class ParallelMarkTask;
   template <bool kNoUnEvac> class RefFieldsVisitor;
   class RevokeThreadLocalMarkStackCheckpoint;
   class ScopedGcGraysImmuneObjects;
@@ -297,6 +297,7 @@ inline bool MarkCompact::VerifyRootSingleUpdate(void* root,
       }
     }
     DCHECK(reinterpret_cast<uint8_t*>(old_ref) >= black_allocations_begin_ ||
+           reinterpret_cast<uint8_t*>(old_ref) < old_gen_end_ ||
            live_words_bitmap_->Test(old_ref))
         << "ref=" << old_ref << " <" << mirror::Object::PrettyTypeOf(old_ref) << "> RootInfo ["
         << info << "]";
@@ -377,6 +378,10 @@ inline mirror::Object* MarkCompact::PostCompactAddressUnchecked(mirror::Object*
   if (reinterpret_cast<uint8_t*>(old_ref) >= black_allocations_begin_) {
     return PostCompactBlackObjAddr(old_ref);
   }
+  if (reinterpret_cast<uint8_t*>(old_ref) < old_gen_end_) {
+    // Old-generation objects are not moved in young-gen cycles.
+    return old_ref;
+  }
   if (kIsDebugBuild) {
     mirror::Object* from_ref = GetFromSpaceAddr(old_ref);
     DCHECK(live_words_bitmap_->Test(old_ref))
@@ -28,6 +28,7 @@
 #include <sys/syscall.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <fstream>
 #include <numeric>
 #include <string>
@@ -336,9 +337,21 @@ static constexpr size_t kMaxNumUffdWorkers = 2;
 // of mutator threads trying to access the moving-space during one compaction
 // phase.
 static constexpr size_t kMutatorCompactionBufferCount = 2048;
+// Number of moving-space pages claimed at a time by a parallel-compaction
+// worker. Small enough to balance the load, but large enough to keep the
+// contention on the range cursors low.
+static constexpr size_t kParallelCompactionChunkPages = 16;
+// Parallel compaction isn't worth the thread-pool overhead for small heaps.
+static constexpr size_t kMinParallelCompactionPages = 256;
 // Minimum from-space chunk to be madvised (during concurrent compaction) in one go.
 // Choose a reasonable size to avoid making too many batched ioctl and madvise calls.
 static constexpr ssize_t kMinFromSpaceMadviseSize = 8 * MB;
+// Number of objects to be freed at a time by SweepArray().
+static constexpr size_t kSweepArrayChunkFreeSize = 1024;
+// Initial capacity of the mark-stack used by the thread roots checkpoint, which
+// grows past that. If it cannot grow, the threads push onto the mark-stack with
+// lock_ held.
+static constexpr size_t kRootMarkStackCapacity = 64 * KB;
 // Concurrent compaction termination logic is different (and slightly more efficient) if the
 // kernel has the fault-retry feature (allowing repeated faults on the same page), which was
 // introduced in 5.7 (https://android-review.git.corp.google.com/c/kernel/common/+/1540088).
@@ -460,17 +473,29 @@ MarkCompact::MarkCompact(Heap* heap)
     : GarbageCollector(heap, "concurrent mark compact"),
       gc_barrier_(0),
       lock_("mark compact lock", kGenericBottomLock),
+      root_mark_stack_(accounting::ObjectSegmentedStack::Create("mark compact root mark stack",
+                                                                kRootMarkStackCapacity)),
       bump_pointer_space_(heap->GetBumpPointerSpace()),
       moving_space_bitmap_(bump_pointer_space_->GetMarkBitmap()),
       moving_space_begin_(bump_pointer_space_->Begin()),
       moving_space_end_(bump_pointer_space_->Limit()),
+      old_gen_end_(moving_space_begin_),
+      old_gen_objects_(0),
       moving_to_space_fd_(kFdUnused),
       moving_from_space_fd_(kFdUnused),
       uffd_(kFdUnused),
       sigbus_in_progress_count_(kSigbusCounterCompactionDoneMask),
       compaction_in_progress_count_(0),
       thread_pool_counter_(0),
+      parallel_compaction_worker_count_(0),
       compacting_(false),
+      use_generational_(heap->GetUseGenerationalCMC()),
+      young_gen_requested_(false),
+      young_gen_(false),
+      full_gc_count_(0),
+      full_gc_freed_bytes_(0),
+      full_gc_duration_ns_(0),
+      gc_start_time_ns_(0),
       uffd_initialized_(false),
       uffd_minor_fault_supported_(false),
       use_uffd_sigbus_(IsSigbusFeatureAvailable()),
@@ -584,25 +609,68 @@ MarkCompact::MarkCompact(Heap* heap)
   // not required in the first place.
   CHECK(ret == 0 || errno == EINVAL);
 
-  // Initialize GC metrics.
-  metrics::ArtMetrics* metrics = GetMetrics();
-  // The mark-compact collector supports only full-heap collections at the moment.
-  gc_time_histogram_ = metrics->FullGcCollectionTime();
-  metrics_gc_count_ = metrics->FullGcCount();
-  metrics_gc_count_delta_ = metrics->FullGcCountDelta();
-  gc_throughput_histogram_ = metrics->FullGcThroughput();
-  gc_tracing_throughput_hist_ = metrics->FullGcTracingThroughput();
-  gc_throughput_avg_ = metrics->FullGcThroughputAvg();
-  gc_tracing_throughput_avg_ = metrics->FullGcTracingThroughputAvg();
-  gc_scanned_bytes_ = metrics->FullGcScannedBytes();
-  gc_scanned_bytes_delta_ = metrics->FullGcScannedBytesDelta();
-  gc_freed_bytes_ = metrics->FullGcFreedBytes();
-  gc_freed_bytes_delta_ = metrics->FullGcFreedBytesDelta();
-  gc_duration_ = metrics->FullGcDuration();
-  gc_duration_delta_ = metrics->FullGcDurationDelta();
+  if (use_generational_) {
+    sweep_array_free_buffer_mem_map_ = MemMap::MapAnonymous(
+        "concurrent mark-compact sweep array free buffer",
+        RoundUp(kSweepArrayChunkFreeSize * sizeof(mirror::Object*), gPageSize),
+        PROT_READ | PROT_WRITE,
+        /*low_4gb=*/false,
+        &err_msg);
+    CHECK(sweep_array_free_buffer_mem_map_.IsValid())
+        << "Couldn't allocate sweep array free buffer: " << err_msg;
+  }
+  // Initialize GC metrics. They are switched between young and full ones in
+  // InitializePhase() in generational mode.
+  SetMetrics(/*young_gen=*/false);
   are_metrics_initialized_ = true;
 }
 
+void MarkCompact::SetMetrics(bool young_gen) {
+  metrics::ArtMetrics* metrics = GetMetrics();
+  if (young_gen) {
+    gc_time_histogram_ = metrics->YoungGcCollectionTime();
+    metrics_gc_count_ = metrics->YoungGcCount();
+    metrics_gc_count_delta_ = metrics->YoungGcCountDelta();
+    gc_throughput_histogram_ = metrics->YoungGcThroughput();
+    gc_tracing_throughput_hist_ = metrics->YoungGcTracingThroughput();
+    gc_throughput_avg_ = metrics->YoungGcThroughputAvg();
+    gc_tracing_throughput_avg_ = metrics->YoungGcTracingThroughputAvg();
+    gc_scanned_bytes_ = metrics->YoungGcScannedBytes();
+    gc_scanned_bytes_delta_ = metrics->YoungGcScannedBytesDelta();
+    gc_freed_bytes_ = metrics->YoungGcFreedBytes();
+    gc_freed_bytes_delta_ = metrics->YoungGcFreedBytesDelta();
+    gc_duration_ = metrics->YoungGcDuration();
+    gc_duration_delta_ = metrics->YoungGcDurationDelta();
+  } else {
+    gc_time_histogram_ = metrics->FullGcCollectionTime();
+    metrics_gc_count_ = metrics->FullGcCount();
+    metrics_gc_count_delta_ = metrics->FullGcCountDelta();
+    gc_throughput_histogram_ = metrics->FullGcThroughput();
+    gc_tracing_throughput_hist_ = metrics->FullGcTracingThroughput();
+    gc_throughput_avg_ = metrics->FullGcThroughputAvg();
+    gc_tracing_throughput_avg_ = metrics->FullGcTracingThroughputAvg();
+    gc_scanned_bytes_ = metrics->FullGcScannedBytes();
+    gc_scanned_bytes_delta_ = metrics->FullGcScannedBytesDelta();
+    gc_freed_bytes_ = metrics->FullGcFreedBytes();
+    gc_freed_bytes_delta_ = metrics->FullGcFreedBytesDelta();
+    gc_duration_ = metrics->FullGcDuration();
+    gc_duration_delta_ = metrics->FullGcDurationDelta();
+  }
+}
+
+uint64_t MarkCompact::GetEstimatedFullGcMeanThroughput() const {
+  // Add 1ms to prevent possible division by 0.
+  return (full_gc_freed_bytes_ * 1000) / (NsToMs(full_gc_duration_ns_) + 1);
+}
+
+void MarkCompact::ResetGenerations() {
+  // The caller has evacuated the moving space. So there is nothing left in the
+  // old generation.
+  moving_space_bitmap_->Clear();
+  old_gen_end_ = moving_space_begin_;
+  old_gen_objects_ = 0;
+}
+
 void MarkCompact::AddLinearAllocSpaceData(uint8_t* begin, size_t len) {
   DCHECK_ALIGNED_PARAM(begin, gPageSize);
   DCHECK_ALIGNED_PARAM(len, gPageSize);
@@ -727,16 +795,47 @@ void MarkCompact::PrepareCardTableForMarking(bool clear_alloc_space_cards) {
     } else if (clear_alloc_space_cards) {
       CHECK(!space->IsZygoteSpace());
       CHECK(!space->IsImageSpace());
-      // The card-table corresponding to bump-pointer and non-moving space can
-      // be cleared, because we are going to traverse all the reachable objects
-      // in these spaces. This card-table will eventually be used to track
-      // mutations while concurrent marking is going on.
-      card_table->ClearCardRange(space->Begin(), space->Limit());
+      if (young_gen_) {
+        // The old generation (and all of non-moving space) isn't traced in
+        // young-gen cycles. Age the dirty cards so that the objects on them,
+        // which are the only ones possibly referring to the young generation,
+        // are scanned in ScanOldGenObjects(). The young part's cards can be
+        // cleared like in full-heap cycles.
+        uint8_t* young_begin = space == bump_pointer_space_ ? old_gen_end_ : space->Limit();
+        card_table->ModifyCardsAtomic(space->Begin(),
+                                      young_begin,
+                                      AgeCardVisitor(),
+                                      /* card modified visitor */ VoidFunctor());
+        card_table->ClearCardRange(young_begin, space->Limit());
+      } else {
+        // The card-table corresponding to bump-pointer and non-moving space can
+        // be cleared, because we are going to traverse all the reachable objects
+        // in these spaces. This card-table will eventually be used to track
+        // mutations while concurrent marking is going on.
+        card_table->ClearCardRange(space->Begin(), space->Limit());
+      }
       if (space != bump_pointer_space_) {
         CHECK_EQ(space, heap_->GetNonMovingSpace());
+        if (young_gen_) {
+          // The allocation stack tells which objects were allocated since the
+          // last GC. Binding the bitmaps makes every other object marked.
+          space->AsContinuousMemMapAllocSpace()->BindLiveToMarkBitmap();
+        }
         non_moving_space_ = space;
         non_moving_space_bitmap_ = space->GetMarkBitmap();
       }
+    } else if (young_gen_) {
+      // Unlike full-heap cycles, aged cards cannot be cleared here as the
+      // old-generation objects on them are updated in the compaction pause.
+      card_table->ModifyCardsAtomic(
+          space->Begin(),
+          space->End(),
+          [](uint8_t card) {
+            return (card == gc::accounting::CardTable::kCardClean)
+                ? card
+                : gc::accounting::CardTable::kCardAged;
+          },
+          /* card modified visitor */ VoidFunctor());
     } else {
       card_table->ModifyCardsAtomic(
           space->Begin(),
@@ -793,6 +892,21 @@ void MarkCompact::InitializePhase() {
   // TODO: Would it suffice to read it once in the constructor, which is called
   // in zygote process?
   pointer_size_ = Runtime::Current()->GetClassLinker()->GetImagePointerSize();
+  gc_start_time_ns_ = NanoTime();
+  if (use_generational_) {
+    // Cycles which have to clear soft references must trace the entire heap.
+    young_gen_ = young_gen_requested_ && !GetCurrentIteration()->GetClearSoftReferences();
+    SetMetrics(young_gen_);
+    if (!young_gen_) {
+      // Full-heap cycle: dissolve the old generation. Its mark-bits are
+      // recomputed by marking.
+      moving_space_bitmap_->ClearRange(reinterpret_cast<mirror::Object*>(moving_space_begin_),
+                                       reinterpret_cast<mirror::Object*>(old_gen_end_));
+      old_gen_end_ = moving_space_begin_;
+      old_gen_objects_ = 0;
+    }
+  }
+  DCHECK(young_gen_ || old_gen_end_ == moving_space_begin_);
 }
 
 class MarkCompact::ThreadFlipVisitor : public Closure {
@@ -872,17 +986,19 @@ void MarkCompact::RunPhases() {
   thread_running_gc_ = nullptr;
 }
 
-void MarkCompact::InitMovingSpaceFirstObjects(const size_t vec_len) {
+void MarkCompact::InitMovingSpaceFirstObjects(const size_t vec_len, size_t to_space_page_idx) {
   // Find the first live word first.
-  size_t to_space_page_idx = 0;
   uint32_t offset_in_chunk_word;
   uint32_t offset;
   mirror::Object* obj;
   const uintptr_t heap_begin = moving_space_bitmap_->HeapBegin();
 
   size_t chunk_idx;
-  // Find the first live word in the space
-  for (chunk_idx = 0; chunk_info_vec_[chunk_idx] == 0; chunk_idx++) {
+  // Find the first live word in the space. The old generation, if any, is
+  // skipped as it stays in place.
+  for (chunk_idx = to_space_page_idx * (gPageSize / kOffsetChunkSize);
+       chunk_info_vec_[chunk_idx] == 0;
+       chunk_idx++) {
     if (chunk_idx >= vec_len) {
       // We don't have any live data on the moving-space.
       return;
@@ -1063,8 +1179,17 @@ void MarkCompact::PrepareForCompaction() {
     DCHECK_LE(chunk_info_vec_[i], kOffsetChunkSize);
     DCHECK_EQ(chunk_info_vec_[i], live_words_bitmap_->LiveBytesInBitmapWord(i));
   }
-  InitMovingSpaceFirstObjects(vector_len);
+  // The old generation is not compacted. Its pages are retained as-is.
+  size_t old_gen_page_count = DivideByPageSize(old_gen_end_ - space_begin);
+  moving_first_objs_count_ = old_gen_page_count;
+  InitMovingSpaceFirstObjects(vector_len, old_gen_page_count);
   InitNonMovingSpaceFirstObjects();
+  // Treat the old generation as fully live for the old-to-new address
+  // computation below, so that the young objects slide to old_gen_end_ onwards.
+  // Post-compact addresses of old objects are never computed this way though.
+  std::fill_n(chunk_info_vec_,
+              old_gen_page_count * (gPageSize / kOffsetChunkSize),
+              kOffsetChunkSize);
 
   // TODO: We can do a lot of neat tricks with this offset vector to tune the
   // compaction as we wish. Originally, the compaction algorithm slides all
@@ -1392,6 +1517,10 @@ void MarkCompact::MarkingPause() {
     // Fetch only the accumulated objects-allocated count as it is guaranteed to
     // be up-to-date after the TLAB revocation above.
     freed_objects_ += bump_pointer_space_->GetAccumulatedObjectsAllocated();
+    if (young_gen_) {
+      // Old-generation objects are neither marked, nor freed in this cycle.
+      freed_objects_ -= old_gen_objects_;
+    }
     // Capture 'end' of moving-space at this point. Every allocation beyond this
     // point will be considered as black.
     // Align-up to page boundary so that black allocations happen from next page
@@ -1449,6 +1578,12 @@ void MarkCompact::Sweep(bool swap_bitmaps) {
   // Ensure that nobody inserted objects in the live stack after we swapped the
   // stacks.
   CHECK_GE(live_stack_freeze_size_, GetHeap()->GetLiveStack()->Size());
+  if (young_gen_) {
+    // Only the objects allocated since the last GC may have died.
+    SweepArray(heap_->GetLiveStack(), swap_bitmaps);
+    DCHECK(mark_stack_->IsEmpty());
+    return;
+  }
   {
     TimingLogger::ScopedTiming t2("MarkAllocStackAsLive", GetTimings());
     // Mark everything allocated since the last GC as live so that we can sweep
@@ -1470,6 +1605,95 @@ void MarkCompact::Sweep(bool swap_bitmaps) {
   SweepLargeObjects(swap_bitmaps);
 }
 
+// Copied and adapted from MarkSweep::SweepArray.
+void MarkCompact::SweepArray(accounting::ObjectStack* allocations, bool swap_bitmaps) {
+  DCHECK(young_gen_);
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  Thread* self = thread_running_gc_;
+  mirror::Object** chunk_free_buffer = reinterpret_cast<mirror::Object**>(
+      sweep_array_free_buffer_mem_map_.BaseBegin());
+  size_t chunk_free_pos = 0;
+  ObjectBytePair freed;
+  ObjectBytePair freed_los;
+  // How many objects are left in the array, modified after each space is swept.
+  StackReference<mirror::Object>* objects = allocations->Begin();
+  size_t count = allocations->Size();
+  // Start by sweeping the continuous spaces.
+  for (space::ContinuousSpace* space : heap_->GetContinuousSpaces()) {
+    if (!space->IsAllocSpace() ||
+        space == bump_pointer_space_ ||
+        immune_spaces_.ContainsSpace(space) ||
+        space->GetLiveBitmap() == nullptr) {
+      continue;
+    }
+    space::AllocSpace* alloc_space = space->AsAllocSpace();
+    accounting::ContinuousSpaceBitmap* live_bitmap = space->GetLiveBitmap();
+    accounting::ContinuousSpaceBitmap* mark_bitmap = space->GetMarkBitmap();
+    if (swap_bitmaps) {
+      std::swap(live_bitmap, mark_bitmap);
+    }
+    StackReference<mirror::Object>* out = objects;
+    for (size_t i = 0; i < count; ++i) {
+      mirror::Object* const obj = objects[i].AsMirrorPtr();
+      if (kUseThreadLocalAllocationStack && obj == nullptr) {
+        continue;
+      }
+      if (space->HasAddress(obj)) {
+        // This object is in the space, remove it from the array and add it to the sweep buffer
+        // if needed.
+        if (!mark_bitmap->Test(obj)) {
+          if (chunk_free_pos >= kSweepArrayChunkFreeSize) {
+            TimingLogger::ScopedTiming t2("FreeList", GetTimings());
+            freed.objects += chunk_free_pos;
+            freed.bytes += alloc_space->FreeList(self, chunk_free_pos, chunk_free_buffer);
+            chunk_free_pos = 0;
+          }
+          chunk_free_buffer[chunk_free_pos++] = obj;
+        }
+      } else {
+        (out++)->Assign(obj);
+      }
+    }
+    if (chunk_free_pos > 0) {
+      TimingLogger::ScopedTiming t2("FreeList", GetTimings());
+      freed.objects += chunk_free_pos;
+      freed.bytes += alloc_space->FreeList(self, chunk_free_pos, chunk_free_buffer);
+      chunk_free_pos = 0;
+    }
+    // All of the references which space contained are no longer in the allocation stack, update
+    // the count.
+    count = out - objects;
+  }
+  // Handle the large object space.
+  space::LargeObjectSpace* large_object_space = heap_->GetLargeObjectsSpace();
+  if (large_object_space != nullptr) {
+    accounting::LargeObjectBitmap* large_live_objects = large_object_space->GetLiveBitmap();
+    accounting::LargeObjectBitmap* large_mark_objects = large_object_space->GetMarkBitmap();
+    if (swap_bitmaps) {
+      std::swap(large_live_objects, large_mark_objects);
+    }
+    for (size_t i = 0; i < count; ++i) {
+      mirror::Object* const obj = objects[i].AsMirrorPtr();
+      // Handle large objects.
+      if (kUseThreadLocalAllocationStack && obj == nullptr) {
+        continue;
+      }
+      if (!large_mark_objects->Test(obj)) {
+        ++freed_los.objects;
+        freed_los.bytes += large_object_space->Free(self, obj);
+      }
+    }
+  }
+  {
+    TimingLogger::ScopedTiming t2("RecordFree", GetTimings());
+    RecordFree(freed);
+    RecordFreeLOS(freed_los);
+    t2.NewTiming("ResetStack");
+    allocations->Reset();
+  }
+  sweep_array_free_buffer_mem_map_.MadviseDontNeedAndZero();
+}
+
 void MarkCompact::SweepLargeObjects(bool swap_bitmaps) {
   space::LargeObjectSpace* los = heap_->GetLargeObjectsSpace();
   if (los != nullptr) {
@@ -1596,7 +1820,9 @@ void MarkCompact::VerifyObject(mirror::Object* ref, Callback& callback) const {
           << " post_compact_end=" << static_cast<void*>(post_compact_end_)
           << " pre_compact_klass=" << pre_compact_klass
           << " black_allocations_begin=" << static_cast<void*>(black_allocations_begin_);
-      CHECK(live_words_bitmap_->Test(pre_compact_klass));
+      // Old-generation objects are not tracked in the live-words bitmap.
+      CHECK(reinterpret_cast<uint8_t*>(pre_compact_klass) < old_gen_end_ ||
+            live_words_bitmap_->Test(pre_compact_klass));
     }
     if (!IsValidObject(ref)) {
       std::ostringstream oss;
@@ -2507,7 +2733,9 @@ void MarkCompact::CompactMovingSpace(uint8_t* page) {
   // Reserved page to be used if we can't find any reclaimable page for processing.
   uint8_t* reserve_page = page;
   size_t end_idx_for_mapping = idx;
-  while (idx > 0) {
+  // The old-generation pages, if any, stay in place.
+  const size_t old_gen_page_count = DivideByPageSize(old_gen_end_ - bump_pointer_space_->Begin());
+  while (idx > old_gen_page_count) {
     idx--;
     to_space_end -= gPageSize;
     if (kMode == kMinorFaultMode) {
@@ -2544,11 +2772,11 @@ void MarkCompact::CompactMovingSpace(uint8_t* page) {
     }
   }
   // map one last time to finish anything left.
-  if (kMode == kCopyMode && end_idx_for_mapping > 0) {
+  if (kMode == kCopyMode && end_idx_for_mapping > idx) {
     MapMovingSpacePages(
         idx, end_idx_for_mapping, /*from_fault=*/false, /*return_on_contention=*/false);
   }
-  DCHECK_EQ(to_space_end, bump_pointer_space_->Begin());
+  DCHECK_EQ(to_space_end, old_gen_end_);
 }
 
 size_t MarkCompact::MapMovingSpacePages(size_t start_idx,
@@ -2897,6 +3125,19 @@ class MarkCompact::ImmuneSpaceUpdateObjVisitor {
   MarkCompact* const collector_;
 };
 
+void MarkCompact::UpdateOldGenObjects() {
+  TimingLogger::ScopedTiming t("(Paused)UpdateOldGenObjects", GetTimings());
+  // This is invoked before the moving space is mremapped, so the old-generation
+  // objects can be updated in place without requiring from-space accesses.
+  WriterMutexLock wmu(thread_running_gc_, *Locks::heap_bitmap_lock_);
+  ImmuneSpaceUpdateObjVisitor visitor(this);
+  heap_->GetCardTable()->Scan</*kClearCard*/ false>(moving_space_bitmap_,
+                                                    moving_space_begin_,
+                                                    old_gen_end_,
+                                                    visitor,
+                                                    accounting::CardTable::kCardDirty - 1);
+}
+
 class MarkCompact::ClassLoaderRootsUpdater : public ClassLoaderVisitor {
  public:
   explicit ClassLoaderRootsUpdater(MarkCompact* collector)
@@ -3181,6 +3422,15 @@ void MarkCompact::CompactionPause() {
       }
     }
   }
+  if (young_gen_) {
+    UpdateOldGenObjects();
+  }
+  if (use_generational_) {
+    // The cards of the compacted portion of the moving space are stale as the
+    // objects have moved. Those of the promoted objects which refer to the
+    // young generation are dirtied in PromoteSurvivors().
+    heap_->GetCardTable()->ClearCardRange(old_gen_end_, post_compact_end_);
+  }
 
   {
     TimingLogger::ScopedTiming t2("(Paused)UpdateRoots", GetTimings());
@@ -3293,17 +3543,22 @@ void MarkCompact::CompactionPause() {
   stack_low_addr_ = nullptr;
 }
 
-void MarkCompact::KernelPrepareRangeForUffd(uint8_t* to_addr,
+bool MarkCompact::KernelPrepareRangeForUffd(uint8_t* to_addr,
                                             uint8_t* from_addr,
                                             size_t map_size,
                                             int fd,
-                                            uint8_t* shadow_addr) {
+                                            uint8_t* shadow_addr,
+                                            bool allow_split_vmas) {
   int mremap_flags = MREMAP_MAYMOVE | MREMAP_FIXED;
   if (gHaveMremapDontunmap) {
     mremap_flags |= MREMAP_DONTUNMAP;
   }
 
   void* ret = mremap(to_addr, map_size, map_size, mremap_flags, from_addr);
+  if (allow_split_vmas && ret == MAP_FAILED && errno == EFAULT) {
+    // The range spans more than one vma. Nothing has been moved.
+    return false;
+  }
   CHECK_EQ(ret, static_cast<void*>(from_addr))
       << "mremap to move pages failed: " << strerror(errno)
       << ". space-addr=" << reinterpret_cast<void*>(to_addr) << " size=" << PrettySize(map_size);
@@ -3336,6 +3591,56 @@ void MarkCompact::KernelPrepareRangeForUffd(uint8_t* to_addr,
     CHECK_EQ(ret, static_cast<void*>(to_addr))
         << "mmap for moving space failed: " << strerror(errno);
   }
+  return true;
+}
+
+void MarkCompact::KernelPrepareMovingSpaceForUffd(uint8_t* to_space_begin) {
+  // Young-gen cycles leave the old generation mapped in place. As a result the
+  // moving space's vma gets split at old_gen_end_, and these vmas may not merge
+  // afterwards. mremap cannot move a range spanning multiple vmas. So first try
+  // to move the range in one go, which fails without side-effects if it spans
+  // multiple vmas, and otherwise move it piece-wise at the recorded splits.
+  DCHECK(!minor_fault_initialized_);
+  DCHECK_EQ(moving_to_space_fd_, kFdUnused);
+  uint8_t* const moving_space_begin = bump_pointer_space_->Begin();
+  uint8_t* const moving_space_end = moving_space_begin + bump_pointer_space_->Capacity();
+  auto to_from_space = [this, moving_space_begin](uint8_t* addr) {
+    return from_space_begin_ + (addr - moving_space_begin);
+  };
+  auto splits_begin = std::upper_bound(
+      moving_space_vma_splits_.begin(), moving_space_vma_splits_.end(), to_space_begin);
+  bool moved = KernelPrepareRangeForUffd(to_space_begin,
+                                         to_from_space(to_space_begin),
+                                         moving_space_end - to_space_begin,
+                                         moving_to_space_fd_,
+                                         /*shadow_addr=*/nullptr,
+                                         /*allow_split_vmas=*/splits_begin !=
+                                             moving_space_vma_splits_.end());
+  if (moved) {
+    // The vmas, if split earlier, have merged since.
+    moving_space_vma_splits_.erase(splits_begin, moving_space_vma_splits_.end());
+  } else {
+    uint8_t* piece_begin = to_space_begin;
+    for (auto it = splits_begin; it != moving_space_vma_splits_.end(); it++) {
+      DCHECK_LT(*it, moving_space_end);
+      KernelPrepareRangeForUffd(
+          piece_begin, to_from_space(piece_begin), *it - piece_begin, moving_to_space_fd_);
+      piece_begin = *it;
+    }
+    KernelPrepareRangeForUffd(piece_begin,
+                              to_from_space(piece_begin),
+                              moving_space_end - piece_begin,
+                              moving_to_space_fd_);
+  }
+  if (to_space_begin > moving_space_begin) {
+    // Record the split caused by this mremap.
+    DCHECK(young_gen_);
+    auto it = std::lower_bound(
+        moving_space_vma_splits_.begin(), moving_space_vma_splits_.end(), to_space_begin);
+    if (it == moving_space_vma_splits_.end() || *it != to_space_begin) {
+      moving_space_vma_splits_.insert(it, to_space_begin);
+    }
+  }
 }
 
 void MarkCompact::KernelPreparation() {
@@ -3385,11 +3690,18 @@ void MarkCompact::KernelPreparation() {
     shadow_addr = shadow_to_space_map_.Begin();
   }
 
-  KernelPrepareRangeForUffd(moving_space_begin,
-                            from_space_begin_,
-                            moving_space_size,
-                            moving_to_space_fd_,
-                            shadow_addr);
+  if (use_generational_) {
+    DCHECK_EQ(shadow_addr, nullptr);
+    // The old generation, if any, is neither moved, nor registered.
+    KernelPrepareMovingSpaceForUffd(old_gen_end_);
+    moving_space_register_sz -= old_gen_end_ - moving_space_begin;
+  } else {
+    KernelPrepareRangeForUffd(moving_space_begin,
+                              from_space_begin_,
+                              moving_space_size,
+                              moving_to_space_fd_,
+                              shadow_addr);
+  }
 
   if (IsValidFd(uffd_)) {
     if (moving_space_register_sz > 0) {
@@ -3405,11 +3717,11 @@ void MarkCompact::KernelPreparation() {
       // the used portion after compaction, the two split vmas merge. This is
       // necessary for the mremap of the next GC cycle to not fail due to having
       // more than one vma in the source range.
-      if (moving_space_register_sz < moving_space_size) {
-        *const_cast<volatile uint8_t*>(moving_space_begin + moving_space_register_sz) = 0;
+      if (old_gen_end_ + moving_space_register_sz < moving_space_begin + moving_space_size) {
+        *const_cast<volatile uint8_t*>(old_gen_end_ + moving_space_register_sz) = 0;
       }
       // Register the moving space with userfaultfd.
-      RegisterUffd(moving_space_begin, moving_space_register_sz, mode);
+      RegisterUffd(old_gen_end_, moving_space_register_sz, mode);
     }
     // Prepare linear-alloc for concurrent compaction.
     for (auto& data : linear_alloc_spaces_data_) {
@@ -3745,6 +4057,110 @@ void MarkCompact::ConcurrentlyProcessMovingPage(uint8_t* fault_page,
   }
 }
 
+class MarkCompact::ParallelCompactionGcTask : public SelfDeletingTask {
+ public:
+  ParallelCompactionGcTask(MarkCompact* collector, size_t idx)
+      : collector_(collector), index_(idx) {}
+
+  void Run([[maybe_unused]] Thread* self) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    collector_->ParallelCompactPages(index_);
+  }
+
+ private:
+  MarkCompact* const collector_;
+  const size_t index_;
+};
+
+bool MarkCompact::ShouldCompactInParallel() const {
+  // Without SIGBUS feature the thread-pool workers are busy serving userfaults.
+  if (!use_uffd_sigbus_ || heap_->GetParallelGCThreadCount() <= 1) {
+    return false;
+  }
+  size_t old_gen_page_count = DivideByPageSize(old_gen_end_ - bump_pointer_space_->Begin());
+  if (moving_first_objs_count_ + black_page_count_ - old_gen_page_count <
+      kMinParallelCompactionPages) {
+    return false;
+  }
+  switch (GetCurrentIteration()->GetGcCause()) {
+    case kGcCauseExplicit:
+    case kGcCauseForAlloc:
+    case kGcCauseCollectorTransition:
+    case kGcCauseTrim:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void MarkCompact::StartParallelCompaction() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  Thread* self = Thread::Current();
+  ThreadPool* pool = heap_->GetThreadPool();
+  if (pool == nullptr) {
+    heap_->CreateThreadPool(heap_->GetParallelGCThreadCount());
+    pool = heap_->GetThreadPool();
+  }
+  const size_t num_workers = pool->GetThreadCount();
+  // Each worker uses one of the mutator compaction buffers.
+  DCHECK_LT(num_workers, kMutatorCompactionBufferCount);
+  const size_t begin_idx = DivideByPageSize(old_gen_end_ - bump_pointer_space_->Begin());
+  const size_t end_idx = moving_first_objs_count_ + black_page_count_;
+  const size_t pages_per_worker = (end_idx - begin_idx + num_workers - 1) / num_workers;
+  parallel_compaction_ranges_.reset(new ParallelCompactionRange[num_workers]);
+  for (size_t i = 0; i < num_workers; i++) {
+    size_t range_begin = std::min(begin_idx + i * pages_per_worker, end_idx);
+    parallel_compaction_ranges_[i].next_.store(range_begin, std::memory_order_relaxed);
+    parallel_compaction_ranges_[i].end_ = std::min(range_begin + pages_per_worker, end_idx);
+  }
+  parallel_compaction_worker_count_ = num_workers;
+  for (size_t i = 0; i < num_workers; i++) {
+    pool->AddTask(self, new ParallelCompactionGcTask(this, i));
+  }
+  pool->StartWorkers(self);
+}
+
+void MarkCompact::FinishParallelCompaction() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  Thread* self = Thread::Current();
+  ThreadPool* pool = heap_->GetThreadPool();
+  // The workers must be done before the moving space is unregistered from
+  // userfaultfd.
+  pool->Wait(self, /*do_work=*/true, /*may_hold_locks=*/true);
+  pool->StopWorkers(self);
+  parallel_compaction_worker_count_ = 0;
+  parallel_compaction_ranges_.reset();
+}
+
+void MarkCompact::ParallelCompactPages(size_t worker_idx) {
+  Thread* self = Thread::Current();
+  uint8_t* const space_begin = bump_pointer_space_->Begin();
+  const size_t nr_moving_space_used_pages = moving_first_objs_count_ + black_page_count_;
+  // Start with our own range and then steal from others in a round-robin manner.
+  for (size_t i = 0; i < parallel_compaction_worker_count_; i++) {
+    ParallelCompactionRange& range =
+        parallel_compaction_ranges_[(worker_idx + i) % parallel_compaction_worker_count_];
+    while (true) {
+      size_t idx = range.next_.fetch_add(kParallelCompactionChunkPages, std::memory_order_relaxed);
+      if (idx >= range.end_) {
+        break;
+      }
+      size_t chunk_end = std::min(idx + kParallelCompactionChunkPages, range.end_);
+      for (; idx < chunk_end; idx++) {
+        // Skip the pages which are already taken by the gc-thread or mutators,
+        // as well as the unused black-allocation pages, which are taken care
+        // of by the gc-thread.
+        if (GetMovingPageState(idx) != PageState::kUnprocessed ||
+            first_objs_moving_space_[idx].AsMirrorPtr() == nullptr) {
+          continue;
+        }
+        ConcurrentlyProcessMovingPage<kCopyMode>(space_begin + idx * gPageSize,
+                                                 self->GetThreadLocalGcBuffer(),
+                                                 nr_moving_space_used_pages);
+      }
+    }
+  }
+}
+
 bool MarkCompact::MapUpdatedLinearAllocPages(uint8_t* start_page,
                                              uint8_t* start_shadow_page,
                                              Atomic<PageState>* state,
@@ -4171,7 +4587,14 @@ void MarkCompact::CompactionPhase() {
   if (CanCompactMovingSpaceWithMinorFault()) {
     CompactMovingSpace<kMinorFaultMode>(/*page=*/nullptr);
   } else {
+    const bool parallel = ShouldCompactInParallel();
+    if (parallel) {
+      StartParallelCompaction();
+    }
     CompactMovingSpace<kCopyMode>(compaction_buffers_map_.Begin());
+    if (parallel) {
+      FinishParallelCompaction();
+    }
   }
 
   ProcessLinearAlloc();
@@ -4224,9 +4647,11 @@ void MarkCompact::CompactionPhase() {
     BackOff(i);
   }
   size_t moving_space_size = bump_pointer_space_->Capacity();
-  size_t used_size = (moving_first_objs_count_ + black_page_count_) * gPageSize;
+  // The old generation isn't registered in young-gen cycles.
+  size_t used_size = (moving_first_objs_count_ + black_page_count_) * gPageSize -
+                     (old_gen_end_ - bump_pointer_space_->Begin());
   if (used_size > 0) {
-    UnregisterUffd(bump_pointer_space_->Begin(), used_size);
+    UnregisterUffd(old_gen_end_, used_size);
   }
   // Release all of the memory taken by moving-space's from-map
   if (minor_fault_initialized_) {
@@ -4271,14 +4696,16 @@ void MarkCompact::CompactionPhase() {
   }
 }
 
-template <size_t kBufferSize>
 class MarkCompact::ThreadRootsVisitor : public RootVisitor {
  public:
   explicit ThreadRootsVisitor(MarkCompact* mark_compact, Thread* const self)
-        : mark_compact_(mark_compact), self_(self) {}
+        : mark_compact_(mark_compact),
+          self_(self),
+          local_mark_stack_(mark_compact->root_mark_stack_.get()) {}
 
   ~ThreadRootsVisitor() {
-    Flush();
+    // Publish the marked roots to the GC thread.
+    local_mark_stack_.Flush();
   }
 
   void VisitRoots(mirror::Object*** roots,
@@ -4306,37 +4733,18 @@ class MarkCompact::ThreadRootsVisitor : public RootVisitor {
   }
 
  private:
-  void Flush() REQUIRES_SHARED(Locks::mutator_lock_)
-               REQUIRES(Locks::heap_bitmap_lock_) {
-    StackReference<mirror::Object>* start;
-    StackReference<mirror::Object>* end;
-    {
-      MutexLock mu(self_, mark_compact_->lock_);
-      // Loop here because even after expanding once it may not be sufficient to
-      // accommodate all references. It's almost impossible, but there is no harm
-      // in implementing it this way.
-      while (!mark_compact_->mark_stack_->BumpBack(idx_, &start, &end)) {
-        mark_compact_->ExpandMarkStack();
-      }
-    }
-    while (idx_ > 0) {
-      *start++ = roots_[--idx_];
-    }
-    DCHECK_EQ(start, end);
-  }
-
   void Push(mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_)
                                  REQUIRES(Locks::heap_bitmap_lock_) {
-    if (UNLIKELY(idx_ >= kBufferSize)) {
-      Flush();
+    if (UNLIKELY(!local_mark_stack_.Push(obj))) {
+      // The root mark-stack could not grow, push directly onto the mark-stack.
+      MutexLock mu(self_, mark_compact_->lock_);
+      mark_compact_->PushOnMarkStack(obj);
     }
-    roots_[idx_++].Assign(obj);
   }
 
-  StackReference<mirror::Object> roots_[kBufferSize];
-  size_t idx_ = 0;
   MarkCompact* const mark_compact_;
   Thread* const self_;
+  accounting::ObjectSegmentedStack::Local local_mark_stack_;
 };
 
 class MarkCompact::CheckpointMarkThreadRoots : public Closure {
@@ -4353,7 +4761,7 @@ class MarkCompact::CheckpointMarkThreadRoots : public Closure {
           || thread->GetState() == ThreadState::kWaitingPerformingGc)
         << thread->GetState() << " thread " << thread << " self " << self;
     {
-      ThreadRootsVisitor</*kBufferSize*/ 20> visitor(mark_compact_, self);
+      ThreadRootsVisitor visitor(mark_compact_, self);
       thread->VisitRoots(&visitor, kVisitRootFlagAllRoots);
     }
     // Clear page-buffer to prepare for compaction phase.
@@ -4380,17 +4788,28 @@ void MarkCompact::MarkRootsCheckpoint(Thread* self, Runtime* runtime) {
   // Release locks then wait for all mutator threads to pass the barrier.
   // If there are no threads to wait which implys that all the checkpoint functions are finished,
   // then no need to release locks.
-  if (barrier_count == 0) {
-    return;
+  if (barrier_count != 0) {
+    Locks::heap_bitmap_lock_->ExclusiveUnlock(self);
+    Locks::mutator_lock_->SharedUnlock(self);
+    {
+      ScopedThreadStateChange tsc(self, ThreadState::kWaitingForCheckPointsToRun);
+      gc_barrier_.Increment(self, barrier_count);
+    }
+    Locks::mutator_lock_->SharedLock(self);
+    Locks::heap_bitmap_lock_->ExclusiveLock(self);
   }
-  Locks::heap_bitmap_lock_->ExclusiveUnlock(self);
-  Locks::mutator_lock_->SharedUnlock(self);
-  {
-    ScopedThreadStateChange tsc(self, ThreadState::kWaitingForCheckPointsToRun);
-    gc_barrier_.Increment(self, barrier_count);
+  DrainRootMarkStack();
+}
+
+void MarkCompact::DrainRootMarkStack() {
+  accounting::ObjectSegmentedStack::Local local_mark_stack(root_mark_stack_.get());
+  for (mirror::Object* obj = local_mark_stack.Pop();
+       obj != nullptr;
+       obj = local_mark_stack.Pop()) {
+    PushOnMarkStack(obj);
   }
-  Locks::mutator_lock_->SharedLock(self);
-  Locks::heap_bitmap_lock_->ExclusiveLock(self);
+  local_mark_stack.Flush();
+  DCHECK(root_mark_stack_->IsEmpty());
 }
 
 void MarkCompact::MarkNonThreadRoots(Runtime* runtime) {
@@ -4450,8 +4869,28 @@ void MarkCompact::UpdateAndMarkModUnion() {
   }
 }
 
+void MarkCompact::ScanOldGenObjects() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  accounting::CardTable* const card_table = heap_->GetCardTable();
+  // Old-generation objects have their mark-bits already set in the moving-space
+  // bitmap. Likewise, the non-moving space's mark-bitmap is bound to the live one.
+  card_table->Scan</*kClearCard*/ false>(moving_space_bitmap_,
+                                         moving_space_begin_,
+                                         old_gen_end_,
+                                         ScanObjectVisitor(this),
+                                         accounting::CardTable::kCardAged);
+  card_table->Scan</*kClearCard*/ false>(non_moving_space_bitmap_,
+                                         non_moving_space_->Begin(),
+                                         non_moving_space_->End(),
+                                         ScanObjectVisitor(this),
+                                         accounting::CardTable::kCardAged);
+}
+
 void MarkCompact::MarkReachableObjects() {
   UpdateAndMarkModUnion();
+  if (young_gen_) {
+    ScanOldGenObjects();
+  }
   // Recursively mark all the non-image bits set in the mark bitmap.
   ProcessMarkStack();
 }
@@ -4523,7 +4962,15 @@ void MarkCompact::MarkingPhase() {
   WriterMutexLock mu(thread_running_gc_, *Locks::heap_bitmap_lock_);
   MaybeClampGcStructures();
   PrepareCardTableForMarking(/*clear_alloc_space_cards*/ true);
-  MarkZygoteLargeObjects();
+  if (young_gen_) {
+    // Large objects which survived the previous cycles are old.
+    space::LargeObjectSpace* const los = heap_->GetLargeObjectsSpace();
+    if (los != nullptr) {
+      los->CopyLiveToMarked();
+    }
+  } else {
+    MarkZygoteLargeObjects();
+  }
   MarkRoots(
         static_cast<VisitRootFlags>(kVisitRootFlagAllRoots | kVisitRootFlagStartLoggingNewRoots));
   MarkReachableObjects();
@@ -4767,6 +5214,9 @@ mirror::Object* MarkCompact::IsMarked(mirror::Object* obj) {
     if (compacting_) {
       if (is_black) {
         return PostCompactBlackObjAddr(obj);
+      } else if (reinterpret_cast<uint8_t*>(obj) < old_gen_end_) {
+        // Old-generation objects are considered marked and are not moved.
+        return obj;
       } else if (live_words_bitmap_->Test(obj)) {
         return PostCompactOldObjAddr(obj);
       } else {
@@ -4814,6 +5264,91 @@ void MarkCompact::DelayReferenceReferent(ObjPtr<mirror::Class> klass,
   heap_->GetReferenceProcessor()->DelayReferenceReferent(klass, ref, this);
 }
 
+// Finds if a promoted object refers to an object which remains in the young
+// generation after this cycle. These are the moving-space objects allocated
+// black, and the non-moving/large objects allocated after the marking pause,
+// none of which are in the respective live bitmaps yet.
+class MarkCompact::YoungRefsCheckVisitor {
+ public:
+  explicit YoungRefsCheckVisitor(MarkCompact* collector)
+      : collector_(collector),
+        non_moving_live_bitmap_(collector->non_moving_space_->GetLiveBitmap()),
+        los_(collector->heap_->GetLargeObjectsSpace()),
+        refers_young_(false) {}
+
+  bool RefersYoung() const { return refers_young_; }
+
+  void operator()(mirror::Object* obj, MemberOffset offset, [[maybe_unused]] bool is_static) const
+      REQUIRES_SHARED(Locks::mutator_lock_, Locks::heap_bitmap_lock_) {
+    Check(obj->GetFieldObject<mirror::Object, kVerifyNone, kWithoutReadBarrier>(offset));
+  }
+
+  void operator()([[maybe_unused]] ObjPtr<mirror::Class> klass,
+                  ObjPtr<mirror::Reference> ref) const
+      REQUIRES_SHARED(Locks::mutator_lock_, Locks::heap_bitmap_lock_) {
+    Check(ref->GetReferent<kWithoutReadBarrier>());
+  }
+
+  // Native roots are not in the heap.
+  void VisitRootIfNonNull(
+      [[maybe_unused]] mirror::CompressedReference<mirror::Object>* root) const {}
+  void VisitRoot([[maybe_unused]] mirror::CompressedReference<mirror::Object>* root) const {}
+
+ private:
+  void Check(mirror::Object* ref) const
+      REQUIRES_SHARED(Locks::mutator_lock_, Locks::heap_bitmap_lock_) {
+    if (ref == nullptr || refers_young_) {
+      return;
+    }
+    uint8_t* addr = reinterpret_cast<uint8_t*>(ref);
+    if (collector_->HasAddress(ref)) {
+      refers_young_ = addr >= collector_->post_compact_end_;
+    } else if (non_moving_live_bitmap_->HasAddress(ref)) {
+      refers_young_ = !non_moving_live_bitmap_->Test(ref);
+    } else if (!collector_->immune_spaces_.ContainsObject(ref)) {
+      DCHECK(los_ != nullptr);
+      refers_young_ = !los_->GetLiveBitmap()->Test(ref);
+    }
+  }
+
+  MarkCompact* const collector_;
+  accounting::ContinuousSpaceBitmap* const non_moving_live_bitmap_;
+  space::LargeObjectSpace* const los_;
+  mutable bool refers_young_;
+};
+
+void MarkCompact::PromoteSurvivors() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  accounting::CardTable* const card_table = heap_->GetCardTable();
+  // In full-heap cycles old_gen_end_ is the moving-space's beginning.
+  uint8_t* begin = old_gen_end_;
+  // Everything beyond the old generation, including the mark-bits of black
+  // allocations, is young after this cycle.
+  moving_space_bitmap_->ClearRange(reinterpret_cast<mirror::Object*>(begin),
+                                   reinterpret_cast<mirror::Object*>(moving_space_end_));
+  // The compacted objects are densely packed in [begin, post_compact_end_),
+  // possibly followed by a zeroed tail on the last page.
+  int32_t promoted_objects = 0;
+  uint8_t* addr = begin;
+  while (addr < post_compact_end_) {
+    mirror::Object* obj = reinterpret_cast<mirror::Object*>(addr);
+    if (obj->GetClass<kVerifyNone, kWithoutReadBarrier>() == nullptr) {
+      break;
+    }
+    moving_space_bitmap_->Set(obj);
+    promoted_objects++;
+    YoungRefsCheckVisitor visitor(this);
+    obj->VisitReferences</*kVisitNativeRoots=*/false, kVerifyNone, kWithoutReadBarrier>(visitor,
+                                                                                      visitor);
+    if (visitor.RefersYoung()) {
+      card_table->MarkCard(obj);
+    }
+    addr += RoundUp(obj->SizeOf<kVerifyNone>(), kAlignment);
+  }
+  old_gen_objects_ += promoted_objects;
+  old_gen_end_ = post_compact_end_;
+}
+
 void MarkCompact::FinishPhase() {
   GetCurrentIteration()->SetScannedBytes(bytes_scanned_);
   bool is_zygote = Runtime::Current()->IsZygote();
@@ -4840,7 +5375,11 @@ void MarkCompact::FinishPhase() {
   // case we need to ensure that we don't assert on this bitmap afterwards.
   // Also, we would still need to clear it here again as we may have to use the
   // bitmap for black-allocations (see UpdateMovingSpaceBlackAllocations()).
-  moving_space_bitmap_->Clear();
+  // In generational mode it's rebuilt for the old generation in
+  // PromoteSurvivors() below instead.
+  if (!use_generational_) {
+    moving_space_bitmap_->Clear();
+  }
 
   if (UNLIKELY(is_zygote && IsValidFd(uffd_))) {
     heap_->DeleteThreadPool();
@@ -4851,6 +5390,9 @@ void MarkCompact::FinishPhase() {
   }
   CHECK(mark_stack_->IsEmpty());  // Ensure that the mark stack is empty.
   mark_stack_->Reset();
+  // Also releases the ranges the root mark stack reserved when it grew.
+  DCHECK(root_mark_stack_->IsEmpty());
+  root_mark_stack_->Reset();
   DCHECK_EQ(thread_running_gc_, Thread::Current());
   if (kIsDebugBuild) {
     MutexLock mu(thread_running_gc_, lock_);
@@ -4864,6 +5406,15 @@ void MarkCompact::FinishPhase() {
     ReaderMutexLock mu(thread_running_gc_, *Locks::mutator_lock_);
     WriterMutexLock mu2(thread_running_gc_, *Locks::heap_bitmap_lock_);
     heap_->ClearMarkedObjects();
+    if (use_generational_) {
+      PromoteSurvivors();
+    }
+  }
+  if (use_generational_ && !young_gen_) {
+    full_gc_count_++;
+    full_gc_freed_bytes_ += GetCurrentIteration()->GetFreedBytes() +
+                            GetCurrentIteration()->GetFreedLargeObjectBytes();
+    full_gc_duration_ns_ += NanoTime() - gc_start_time_ns_;
   }
   std::swap(moving_to_space_fd_, moving_from_space_fd_);
   if (IsValidFd(moving_to_space_fd_)) {
@@ -23,6 +23,7 @@
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "barrier.h"
 #include "base/atomic.h"
@@ -33,6 +34,7 @@
 #include "gc/accounting/atomic_stack.h"
 #include "gc/accounting/bitmap-inl.h"
 #include "gc/accounting/heap_bitmap.h"
+#include "gc/accounting/segmented_stack.h"
 #include "gc_root.h"
 #include "immune_spaces.h"
 #include "offsets.h"
@@ -89,9 +91,22 @@ class MarkCompact final : public GarbageCollector {
   bool SigbusHandler(siginfo_t* info) REQUIRES(!lock_) NO_THREAD_SAFETY_ANALYSIS;
 
   GcType GetGcType() const override {
-    return kGcTypeFull;
+    return young_gen_ ? kGcTypeSticky : kGcTypeFull;
   }
 
+  bool IsGenerational() const { return use_generational_; }
+  // Request the next cycle to collect only the young generation. Ignored if
+  // generational mode is disabled, or if the cycle has to clear soft references.
+  void SetYoungGenRequested(bool young_gen) { young_gen_requested_ = young_gen; }
+  // Estimated throughput (in bytes/s) of the full-heap cycles only. As the same
+  // collector instance runs both young and full cycles, this is used by the
+  // heap instead of GetEstimatedMeanThroughput() for choosing the next GC type.
+  uint64_t GetEstimatedFullGcMeanThroughput() const;
+  size_t NumberOfFullGcIterations() const { return full_gc_count_; }
+  // Forget about the old generation. Called after the moving space has been
+  // evacuated outside this collector, i.e. by the zygote compaction.
+  void ResetGenerations() REQUIRES_SHARED(Locks::mutator_lock_);
+
   CollectorType GetCollectorType() const override {
     return kCollectorTypeCMC;
   }
@@ -137,6 +152,8 @@ class MarkCompact final : public GarbageCollector {
   mirror::Object* GetFromSpaceAddrFromBarrier(mirror::Object* old_ref) {
     CHECK(compacting_);
     if (HasAddress(old_ref)) {
+      // GetFromSpaceAddr() takes care of old-generation objects, which are
+      // not relocated to the from-space in young-gen cycles.
       return GetFromSpaceAddr(old_ref);
     }
     return old_ref;
@@ -256,6 +273,10 @@ class MarkCompact final : public GarbageCollector {
   // pause.
   mirror::Object* GetFromSpaceAddr(mirror::Object* obj) const {
     DCHECK(HasAddress(obj)) << " obj=" << obj;
+    if (reinterpret_cast<uint8_t*>(obj) < old_gen_end_) {
+      // The old generation stays mapped in place during young-gen cycles.
+      return obj;
+    }
     return reinterpret_cast<mirror::Object*>(reinterpret_cast<uintptr_t>(obj)
                                              + from_space_slide_diff_);
   }
@@ -347,6 +368,21 @@ class MarkCompact final : public GarbageCollector {
   // userfaultfd.
   template <int kMode>
   void CompactMovingSpace(uint8_t* page) REQUIRES_SHARED(Locks::mutator_lock_);
+  // Returns true if the moving-space compaction in the current cycle should be
+  // shared with the heap's thread-pool workers. This is done when the GC cause
+  // implies that mutators are waiting for the GC to finish, like explicit GCs,
+  // allocation failures and collector transitions.
+  bool ShouldCompactInParallel() const REQUIRES_SHARED(Locks::mutator_lock_);
+  // Split the to-be-compacted moving-space pages into one range per
+  // thread-pool worker and start the workers. The gc-thread compacts the space
+  // in reverse order concurrently (see CompactMovingSpace()), skipping the pages
+  // already claimed by the workers.
+  void StartParallelCompaction() REQUIRES_SHARED(Locks::mutator_lock_);
+  // Wait for the workers started by StartParallelCompaction() to finish.
+  void FinishParallelCompaction() REQUIRES_SHARED(Locks::mutator_lock_);
+  // Called by parallel-compaction workers. Claims chunks of pages from the
+  // worker's own range first, and then steals from the ranges of other workers.
+  void ParallelCompactPages(size_t worker_idx) REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Compact the given page as per func and change its state. Also map/copy the
   // page, if required. Returns true if the page was compacted, else false.
@@ -364,6 +400,10 @@ class MarkCompact final : public GarbageCollector {
       REQUIRES_SHARED(Locks::mutator_lock_);
   // Update all the references in the non-moving space.
   void UpdateNonMovingSpace() REQUIRES_SHARED(Locks::mutator_lock_);
+  // Update references in the old-generation objects which are on aged or dirty
+  // cards. Only such objects may refer to the young generation. Invoked in
+  // young-gen cycles.
+  void UpdateOldGenObjects() REQUIRES(Locks::mutator_lock_);
 
   // For all the pages in non-moving space, find the first object that overlaps
   // with the pages' start address, and store in first_objs_non_moving_space_ array.
@@ -373,7 +413,10 @@ class MarkCompact final : public GarbageCollector {
   // copied to the page. The offsets are relative to the moving-space's
   // beginning. Store the computed first-object and offset in first_objs_moving_space_
   // and pre_compact_offset_moving_space_ respectively.
-  void InitMovingSpaceFirstObjects(const size_t vec_len) REQUIRES_SHARED(Locks::mutator_lock_);
+  // 'to_space_page_idx' is the first post-compact page to be computed; all the
+  // pages preceding it belong to the old generation, which is not compacted.
+  void InitMovingSpaceFirstObjects(const size_t vec_len, size_t to_space_page_idx)
+      REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Gather the info related to black allocations from bump-pointer space to
   // enable concurrent sliding of these pages.
@@ -418,6 +461,11 @@ class MarkCompact final : public GarbageCollector {
   // Traverse through the reachable objects and mark them.
   void MarkReachableObjects() REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::heap_bitmap_lock_);
+  // In young-gen cycles, scan the old-generation and non-moving space objects
+  // on aged cards. These are the only objects which may refer to the young
+  // generation.
+  void ScanOldGenObjects() REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_);
   // Scan (only) immune spaces looking for references into the garbage collected
   // spaces.
   void UpdateAndMarkModUnion() REQUIRES_SHARED(Locks::mutator_lock_)
@@ -437,6 +485,9 @@ class MarkCompact final : public GarbageCollector {
       REQUIRES(Locks::heap_bitmap_lock_);
   void ExpandMarkStack() REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::heap_bitmap_lock_);
+  // Move the objects the threads marked in the thread roots checkpoint to the mark-stack.
+  void DrainRootMarkStack() REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_);
 
   // Scan object for references. If kUpdateLivewords is true then set bits in
   // the live-words bitmap and add size to chunk-info.
@@ -479,18 +530,42 @@ class MarkCompact final : public GarbageCollector {
       REQUIRES(Locks::heap_bitmap_lock_);
   void SweepLargeObjects(bool swap_bitmaps) REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::heap_bitmap_lock_);
+  // Sweep only the objects on the given allocation stack. Used in young-gen
+  // cycles, wherein the non-moving and large-object spaces' bitmaps are
+  // pre-populated with the old objects.
+  void SweepArray(accounting::ObjectStack* allocations, bool swap_bitmaps)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::heap_bitmap_lock_);
+  // Switch the GC metrics being reported to the young or full-heap ones.
+  void SetMetrics(bool young_gen);
+  // Add all the objects compacted in this cycle to the old generation. Also
+  // dirty the cards of the promoted objects which refer to objects that remain
+  // young.
+  //
+  // Objects are tenured the first time they survive. The old generation is a
+  // page-aligned prefix of the moving space which young-gen cycles retain
+  // page-by-page, whereas survivors are slid densely behind it regardless of
+  // their age. Keeping the older survivors apart from the ones to stay young
+  // would need a hole in the compacted space, which the sliding compaction
+  // doesn't support.
+  void PromoteSurvivors() REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_);
 
   // Perform all kernel operations required for concurrent compaction. Includes
   // mremap to move pre-compact pages to from-space, followed by userfaultfd
   // registration on the moving space and linear-alloc.
   void KernelPreparation();
   // Called by KernelPreparation() for every memory range being prepared for
-  // userfaultfd registration.
-  void KernelPrepareRangeForUffd(uint8_t* to_addr,
+  // userfaultfd registration. If 'allow_split_vmas' is true, then returns false
+  // (without any side-effects) if the range spans more than one vma.
+  bool KernelPrepareRangeForUffd(uint8_t* to_addr,
                                  uint8_t* from_addr,
                                  size_t map_size,
                                  int fd,
-                                 uint8_t* shadow_addr = nullptr);
+                                 uint8_t* shadow_addr = nullptr,
+                                 bool allow_split_vmas = false);
+  // Move the moving-space pages in [to_space_begin, moving-space capacity) to
+  // from-space. Takes care of the vma splits created by young-gen cycles.
+  void KernelPrepareMovingSpaceForUffd(uint8_t* to_space_begin);
 
   void RegisterUffd(void* addr, size_t size, int mode);
   void UnregisterUffd(uint8_t* start, size_t len);
@@ -626,6 +701,9 @@ class MarkCompact final : public GarbageCollector {
   // to synchronize on updated_roots_ in debug-builds.
   Mutex lock_;
   accounting::ObjectStack* mark_stack_;
+  // Mark-stack the threads push onto, without locking, when marking their
+  // roots in the checkpoint.
+  std::unique_ptr<accounting::ObjectSegmentedStack> root_mark_stack_;
   // Special bitmap wherein all the bits corresponding to an object are set.
   // TODO: make LiveWordsBitmap encapsulated in this class rather than a
   // pointer. We tend to access its members in performance-sensitive
@@ -649,6 +727,9 @@ class MarkCompact final : public GarbageCollector {
   // the first page is also used for termination of concurrent compaction by
   // making worker threads terminate the userfaultfd read loop.
   MemMap compaction_buffers_map_;
+  // Buffer for batching FreeList() calls in SweepArray(). Allocated only in
+  // generational mode.
+  MemMap sweep_array_free_buffer_mem_map_;
 
   class LessByArenaAddr {
    public:
@@ -813,6 +894,18 @@ class MarkCompact final : public GarbageCollector {
   // Cache (black_allocations_begin_ - post_compact_end_) for post-compact
   // address computations.
   ptrdiff_t black_objs_slide_diff_;
+  // End of the old generation in the moving space. Aligned to page size.
+  // Objects in [moving_space_begin_, old_gen_end_) are neither traced, nor
+  // compacted in young-gen cycles. Always equal to moving_space_begin_
+  // during full-heap cycles.
+  uint8_t* old_gen_end_;
+  // Number of objects (including the ones which have died since promotion) in
+  // the old generation. Used for computing freed_objects_ in young-gen cycles.
+  int32_t old_gen_objects_;
+  // Sorted addresses where the moving space's mapping may have been split by
+  // young-gen cycles' mremap. As mremap cannot move a range spanning multiple
+  // vmas, such ranges are mremapped piece-wise at these addresses.
+  std::vector<uint8_t*> moving_space_vma_splits_;
   // Cache (from_space_begin_ - bump_pointer_space_->Begin()) so that we can
   // compute from-space address of a given pre-comapct addr efficiently.
   ptrdiff_t from_space_slide_diff_;
@@ -852,8 +945,30 @@ class MarkCompact final : public GarbageCollector {
   std::atomic<uint16_t> compaction_buffer_counter_;
   // Used to exit from compaction loop at the end of concurrent compaction
   uint8_t thread_pool_counter_;
+  // Range of moving-space page indices assigned to a parallel-compaction
+  // worker. Chunks are claimed by incrementing 'next_', which may be done by
+  // the owner as well as by other workers stealing from the range.
+  struct ParallelCompactionRange {
+    std::atomic<size_t> next_;
+    size_t end_;
+  };
+  std::unique_ptr<ParallelCompactionRange[]> parallel_compaction_ranges_;
+  // Number of workers participating in parallel compaction in this cycle. 0 if
+  // parallel compaction isn't used.
+  size_t parallel_compaction_worker_count_;
   // True while compacting.
   bool compacting_;
+  // Set if generational mode (-Xgc:generational_cmc) is enabled.
+  const bool use_generational_;
+  // Young-gen cycle requested by the heap for the next cycle.
+  bool young_gen_requested_;
+  // True if the current cycle collects only the young generation.
+  bool young_gen_;
+  // Statistics of full-heap cycles for GetEstimatedFullGcMeanThroughput().
+  size_t full_gc_count_;
+  uint64_t full_gc_freed_bytes_;
+  uint64_t full_gc_duration_ns_;
+  uint64_t gc_start_time_ns_;
   // Flag indicating whether one-time uffd initialization has been done. It will
   // be false on the first GC for non-zygote processes, and always for zygote.
   // Its purpose is to minimize the userfaultfd overhead to the minimal in
@@ -884,7 +999,6 @@ class MarkCompact final : public GarbageCollector {
   class VerifyRootMarkedVisitor;
   class ScanObjectVisitor;
   class CheckpointMarkThreadRoots;
-  template <size_t kBufferSize>
   class ThreadRootsVisitor;
   class RefFieldsVisitor;
   template <bool kCheckBegin, bool kCheckEnd> class RefsUpdateVisitor;
@@ -893,6 +1007,8 @@ class MarkCompact final : public GarbageCollector {
   class LinearAllocPageUpdater;
   class ImmuneSpaceUpdateObjVisitor;
   class ConcurrentCompactionGcTask;
+  class ParallelCompactionGcTask;
+  class YoungRefsCheckVisitor;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(MarkCompact);
 };
@@ -72,6 +72,11 @@ static constexpr bool kMeasureOverhead = false;
 static constexpr bool kCountTasks = false;
 static constexpr bool kCountMarkedObjects = false;
 
+// Initial capacity of the mark stack used by the thread roots checkpoint, which grows past that.
+// If it cannot grow, the threads fall back to pushing onto the mark stack with mark_stack_lock_
+// held.
+static constexpr size_t kRootMarkStackCapacity = 64 * KB;
+
 // Turn off kCheckLocks when profiling the GC since it slows the GC down by up to 40%.
 static constexpr bool kCheckLocks = kDebugLocking;
 static constexpr bool kVerifyRootsMarked = kIsDebugBuild;
@@ -98,6 +103,8 @@ MarkSweep::MarkSweep(Heap* heap, bool is_concurrent, const std::string& name_pre
       current_space_bitmap_(nullptr),
       mark_bitmap_(nullptr),
       mark_stack_(nullptr),
+      root_mark_stack_(accounting::ObjectSegmentedStack::Create("mark sweep root mark stack",
+                                                                kRootMarkStackCapacity)),
       gc_barrier_(new Barrier(0)),
       mark_stack_lock_("mark sweep mark stack lock", kMarkSweepMarkStackLock),
       is_concurrent_(is_concurrent),
@@ -398,14 +405,27 @@ void MarkSweep::ResizeMarkStack(size_t new_size) {
   }
 }
 
+void MarkSweep::DrainRootMarkStack() {
+  accounting::ObjectSegmentedStack::Local local_mark_stack(root_mark_stack_.get());
+  for (mirror::Object* obj = local_mark_stack.Pop();
+       obj != nullptr;
+       obj = local_mark_stack.Pop()) {
+    PushOnMarkStack(obj);
+  }
+  local_mark_stack.Flush();
+  DCHECK(root_mark_stack_->IsEmpty());
+}
+
 mirror::Object* MarkSweep::MarkObject(mirror::Object* obj) {
   MarkObject(obj, nullptr, MemberOffset(0));
   return obj;
 }
 
-inline void MarkSweep::MarkObjectNonNullParallel(mirror::Object* obj) {
+inline void MarkSweep::MarkObjectNonNullParallel(
+    mirror::Object* obj, accounting::ObjectSegmentedStack::Local* local_mark_stack) {
   DCHECK(obj != nullptr);
-  if (MarkObjectParallel(obj)) {
+  if (MarkObjectParallel(obj) && !local_mark_stack->Push(obj)) {
+    // The root mark stack could not grow.
     MutexLock mu(Thread::Current(), mark_stack_lock_);
     if (UNLIKELY(mark_stack_->Size() >= mark_stack_->Capacity())) {
       ExpandMarkStack();
@@ -1130,7 +1150,7 @@ void MarkSweep::VerifySystemWeaks() {
   runtime->SweepSystemWeaks(&visitor);
 }
 
-class MarkSweep::CheckpointMarkThreadRoots : public Closure, public RootVisitor {
+class MarkSweep::CheckpointMarkThreadRoots : public Closure {
  public:
   CheckpointMarkThreadRoots(MarkSweep* mark_sweep,
                             bool revoke_ros_alloc_thread_local_buffers_at_checkpoint)
@@ -1139,24 +1159,6 @@ class MarkSweep::CheckpointMarkThreadRoots : public Closure, public RootVisitor
             revoke_ros_alloc_thread_local_buffers_at_checkpoint) {
   }
 
-  void VisitRoots(mirror::Object*** roots,
-                  size_t count,
-                  [[maybe_unused]] const RootInfo& info) override
-      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::heap_bitmap_lock_) {
-    for (size_t i = 0; i < count; ++i) {
-      mark_sweep_->MarkObjectNonNullParallel(*roots[i]);
-    }
-  }
-
-  void VisitRoots(mirror::CompressedReference<mirror::Object>** roots,
-                  size_t count,
-                  [[maybe_unused]] const RootInfo& info) override
-      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::heap_bitmap_lock_) {
-    for (size_t i = 0; i < count; ++i) {
-      mark_sweep_->MarkObjectNonNullParallel(roots[i]->AsMirrorPtr());
-    }
-  }
-
   void Run(Thread* thread) override NO_THREAD_SAFETY_ANALYSIS {
     ScopedTrace trace("Marking thread roots");
     // Note: self is not necessarily equal to thread since thread may be suspended.
@@ -1165,7 +1167,10 @@ class MarkSweep::CheckpointMarkThreadRoots : public Closure, public RootVisitor
           thread->IsSuspended() ||
           thread->GetState() == ThreadState::kWaitingPerformingGc)
         << thread->GetState() << " thread " << thread << " self " << self;
-    thread->VisitRoots(this, kVisitRootFlagAllRoots);
+    {
+      ThreadRootsVisitor visitor(mark_sweep_);
+      thread->VisitRoots(&visitor, kVisitRootFlagAllRoots);
+    }
     if (revoke_ros_alloc_thread_local_buffers_at_checkpoint_) {
       ScopedTrace trace2("RevokeRosAllocThreadLocalBuffers");
       mark_sweep_->GetHeap()->RevokeRosAllocThreadLocalBuffers(thread);
@@ -1176,6 +1181,40 @@ class MarkSweep::CheckpointMarkThreadRoots : public Closure, public RootVisitor
   }
 
  private:
+  // Marks the roots of one thread. Pushes onto a segment of the root mark stack owned by the
+  // thread running the checkpoint, published when the visitor goes out of scope.
+  class ThreadRootsVisitor : public RootVisitor {
+   public:
+    explicit ThreadRootsVisitor(MarkSweep* mark_sweep)
+        : mark_sweep_(mark_sweep), local_mark_stack_(mark_sweep->root_mark_stack_.get()) {}
+
+    ~ThreadRootsVisitor() {
+      local_mark_stack_.Flush();
+    }
+
+    void VisitRoots(mirror::Object*** roots,
+                    size_t count,
+                    [[maybe_unused]] const RootInfo& info) override
+        REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::heap_bitmap_lock_) {
+      for (size_t i = 0; i < count; ++i) {
+        mark_sweep_->MarkObjectNonNullParallel(*roots[i], &local_mark_stack_);
+      }
+    }
+
+    void VisitRoots(mirror::CompressedReference<mirror::Object>** roots,
+                    size_t count,
+                    [[maybe_unused]] const RootInfo& info) override
+        REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::heap_bitmap_lock_) {
+      for (size_t i = 0; i < count; ++i) {
+        mark_sweep_->MarkObjectNonNullParallel(roots[i]->AsMirrorPtr(), &local_mark_stack_);
+      }
+    }
+
+   private:
+    MarkSweep* const mark_sweep_;
+    accounting::ObjectSegmentedStack::Local local_mark_stack_;
+  };
+
   MarkSweep* const mark_sweep_;
   const bool revoke_ros_alloc_thread_local_buffers_at_checkpoint_;
 };
@@ -1191,17 +1230,18 @@ void MarkSweep::MarkRootsCheckpoint(Thread* self,
   // Release locks then wait for all mutator threads to pass the barrier.
   // If there are no threads to wait which implys that all the checkpoint functions are finished,
   // then no need to release locks.
-  if (barrier_count == 0) {
-    return;
-  }
-  Locks::heap_bitmap_lock_->ExclusiveUnlock(self);
-  Locks::mutator_lock_->SharedUnlock(self);
-  {
-    ScopedThreadStateChange tsc(self, ThreadState::kWaitingForCheckPointsToRun);
-    gc_barrier_->Increment(self, barrier_count);
+  if (barrier_count != 0) {
+    Locks::heap_bitmap_lock_->ExclusiveUnlock(self);
+    Locks::mutator_lock_->SharedUnlock(self);
+    {
+      ScopedThreadStateChange tsc(self, ThreadState::kWaitingForCheckPointsToRun);
+      gc_barrier_->Increment(self, barrier_count);
+    }
+    Locks::mutator_lock_->SharedLock(self);
+    Locks::heap_bitmap_lock_->ExclusiveLock(self);
   }
-  Locks::mutator_lock_->SharedLock(self);
-  Locks::heap_bitmap_lock_->ExclusiveLock(self);
+  // All the threads have published the roots they marked.
+  DrainRootMarkStack();
 }
 
 void MarkSweep::SweepArray(accounting::ObjectStack* allocations, bool swap_bitmaps) {
@@ -1493,6 +1533,9 @@ void MarkSweep::FinishPhase() {
   }
   CHECK(mark_stack_->IsEmpty());  // Ensure that the mark stack is empty.
   mark_stack_->Reset();
+  // Also releases the ranges the root mark stack reserved when it grew.
+  DCHECK(root_mark_stack_->IsEmpty());
+  root_mark_stack_->Reset();
   Thread* const self = Thread::Current();
   ReaderMutexLock mu(self, *Locks::mutator_lock_);
   WriterMutexLock mu2(self, *Locks::heap_bitmap_lock_);
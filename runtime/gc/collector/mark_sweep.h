@@ -25,6 +25,7 @@
 #include "base/mutex.h"
 #include "garbage_collector.h"
 #include "gc/accounting/heap_bitmap.h"
+#include "gc/accounting/segmented_stack.h"
 #include "gc_root.h"
 #include "immune_spaces.h"
 #include "offsets.h"
@@ -241,8 +242,15 @@ class MarkSweep : public GarbageCollector {
       REQUIRES(!mark_stack_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Marks an object atomically, safe to use from multiple threads.
-  void MarkObjectNonNullParallel(mirror::Object* obj)
+  // Marks an object atomically, safe to use from multiple threads. Newly marked objects are
+  // pushed onto the calling thread's segment of root_mark_stack_.
+  void MarkObjectNonNullParallel(mirror::Object* obj,
+                                 accounting::ObjectSegmentedStack::Local* local_mark_stack)
+      REQUIRES(!mark_stack_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Moves the objects pushed by MarkObjectNonNullParallel to the mark stack.
+  void DrainRootMarkStack()
       REQUIRES(!mark_stack_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -313,6 +321,9 @@ class MarkSweep : public GarbageCollector {
   accounting::HeapBitmap* mark_bitmap_;
 
   accounting::ObjectStack* mark_stack_;
+  // Mark stack for the threads marking their own roots in the checkpoint, which don't need to take
+  // mark_stack_lock_ for each object they push.
+  std::unique_ptr<accounting::ObjectSegmentedStack> root_mark_stack_;
 
   // Every object inside the immune spaces is assumed to be marked. Immune spaces that aren't in the
   // immune region are handled by the normal marking logic.
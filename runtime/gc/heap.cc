@@ -310,9 +310,11 @@ Heap::Heap(size_t initial_size,
            bool measure_gc_performance,
            bool use_homogeneous_space_compaction_for_oom,
            bool use_generational_cc,
+           bool use_generational_cmc,
            uint64_t min_interval_homogeneous_space_compaction_by_oom,
            bool dump_region_info_before_gc,
-           bool dump_region_info_after_gc)
+           bool dump_region_info_after_gc,
+           bool numa_aware_region_allocation)
     : non_moving_space_(nullptr),
       rosalloc_space_(nullptr),
       dlmalloc_space_(nullptr),
@@ -411,6 +413,7 @@ Heap::Heap(size_t initial_size,
       pending_heap_trim_(nullptr),
       use_homogeneous_space_compaction_for_oom_(use_homogeneous_space_compaction_for_oom),
       use_generational_cc_(use_generational_cc),
+      use_generational_cmc_(use_generational_cmc),
       running_collection_is_blocking_(false),
       blocking_gc_count_(0U),
       blocking_gc_time_(0U),
@@ -651,8 +654,10 @@ Heap::Heap(size_t initial_size,
     MemMap region_space_mem_map =
         space::RegionSpace::CreateMemMap(kRegionSpaceName, capacity_ * 2, request_begin);
     CHECK(region_space_mem_map.IsValid()) << "No region space mem map";
-    region_space_ = space::RegionSpace::Create(
-        kRegionSpaceName, std::move(region_space_mem_map), use_generational_cc_);
+    region_space_ = space::RegionSpace::Create(kRegionSpaceName,
+                                               std::move(region_space_mem_map),
+                                               use_generational_cc_,
+                                               numa_aware_region_allocation);
     AddSpace(region_space_);
   } else if (IsMovingGc(foreground_collector_type_)) {
     // Create bump pointer spaces.
@@ -1716,6 +1721,10 @@ void Heap::TrimSpaces(Thread* self) {
       }
     }
   }
+  if (large_object_space_ != nullptr) {
+    // Release the memory of freed large objects cached for reuse.
+    managed_reclaimed += large_object_space_->ReleaseCachedBlocks();
+  }
   total_alloc_space_allocated = GetBytesAllocated();
   if (large_object_space_ != nullptr) {
     total_alloc_space_allocated -= large_object_space_->GetBytesAllocated();
@@ -2312,6 +2321,9 @@ void Heap::ChangeCollector(CollectorType collector_type) {
         break;
       }
       case kCollectorTypeCMC: {
+        if (use_generational_cmc_) {
+          gc_plan_.push_back(collector::kGcTypeSticky);
+        }
         gc_plan_.push_back(collector::kGcTypeFull);
         if (use_tlab_) {
           ChangeAllocator(kAllocatorTypeTLAB);
@@ -2553,6 +2565,11 @@ void Heap::PreZygoteFork() {
         region_space_->GetMarkBitmap()->Clear();
       } else {
         bump_pointer_space_->GetMemMap()->Protect(PROT_READ | PROT_WRITE);
+        if (mark_compact_ != nullptr) {
+          // Evacuated everything out of the moving space, including the old
+          // generation.
+          mark_compact_->ResetGenerations();
+        }
       }
     }
     if (temp_space_ != nullptr) {
@@ -2840,6 +2857,8 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
           collector = semi_space_collector_;
           break;
         case kCollectorTypeCMC:
+          // The same collector instance performs both young and full-heap cycles.
+          mark_compact_->SetYoungGenRequested(gc_type == collector::kGcTypeSticky);
           collector = mark_compact_;
           break;
         case kCollectorTypeCC:
@@ -3781,15 +3800,28 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
     next_gc_type_ = collector::kGcTypeSticky;
   } else {
     collector::GcType non_sticky_gc_type = NonStickyGcType();
-    // Find what the next non sticky collector will be.
-    collector::GarbageCollector* non_sticky_collector = FindCollectorByGcType(non_sticky_gc_type);
-    if (use_generational_cc_) {
-      if (non_sticky_collector == nullptr) {
-        non_sticky_collector = FindCollectorByGcType(collector::kGcTypePartial);
+    uint64_t non_sticky_throughput;
+    size_t non_sticky_iterations;
+    if (collector_ran == mark_compact_) {
+      // The same collector instance performs both young and full-heap cycles.
+      // So only the statistics of the latter are to be considered.
+      non_sticky_throughput = mark_compact_->GetEstimatedFullGcMeanThroughput();
+      non_sticky_iterations = mark_compact_->NumberOfFullGcIterations();
+    } else {
+      // Find what the next non sticky collector will be.
+      collector::GarbageCollector* non_sticky_collector =
+          FindCollectorByGcType(non_sticky_gc_type);
+      if (use_generational_cc_) {
+        if (non_sticky_collector == nullptr) {
+          non_sticky_collector = FindCollectorByGcType(collector::kGcTypePartial);
+        }
+        CHECK(non_sticky_collector != nullptr);
       }
-      CHECK(non_sticky_collector != nullptr);
+      non_sticky_throughput = non_sticky_collector->GetEstimatedMeanThroughput();
+      non_sticky_iterations = non_sticky_collector->NumberOfIterations();
     }
-    double sticky_gc_throughput_adjustment = GetStickyGcThroughputAdjustment(use_generational_cc_);
+    double sticky_gc_throughput_adjustment =
+        GetStickyGcThroughputAdjustment(use_generational_cc_ || use_generational_cmc_);
 
     // If the throughput of the current sticky GC >= throughput of the non sticky collector, then
     // do another sticky collection next.
@@ -3799,8 +3831,8 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
     // if the sticky GC throughput always remained >= the full/partial throughput.
     size_t target_footprint = target_footprint_.load(std::memory_order_relaxed);
     if (current_gc_iteration_.GetEstimatedThroughput() * sticky_gc_throughput_adjustment >=
-        non_sticky_collector->GetEstimatedMeanThroughput() &&
-        non_sticky_collector->NumberOfIterations() > 0 &&
+        non_sticky_throughput &&
+        non_sticky_iterations > 0 &&
         bytes_allocated <= (IsGcConcurrent() ? concurrent_start_bytes_ : target_footprint)) {
       next_gc_type_ = collector::kGcTypeSticky;
     } else {
@@ -4142,6 +4174,9 @@ void Heap::RevokeThreadLocalBuffers(Thread* thread) {
   if (region_space_ != nullptr) {
     CHECK_EQ(region_space_->RevokeThreadLocalBuffers(thread), 0U);
   }
+  if (large_object_space_ != nullptr) {
+    CHECK_EQ(large_object_space_->RevokeThreadLocalBuffers(thread), 0U);
+  }
 }
 
 void Heap::RevokeRosAllocThreadLocalBuffers(Thread* thread) {
@@ -4166,6 +4201,9 @@ void Heap::RevokeAllThreadLocalBuffers() {
   if (region_space_ != nullptr) {
     CHECK_EQ(region_space_->RevokeAllThreadLocalBuffers(), 0U);
   }
+  if (large_object_space_ != nullptr) {
+    CHECK_EQ(large_object_space_->RevokeAllThreadLocalBuffers(), 0U);
+  }
 }
 
 // For GC triggering purposes, we count old (pre-last-GC) and new native allocations as
@@ -238,9 +238,11 @@ class Heap {
        bool measure_gc_performance,
        bool use_homogeneous_space_compaction,
        bool use_generational_cc,
+       bool use_generational_cmc,
        uint64_t min_interval_homogeneous_space_compaction_by_oom,
        bool dump_region_info_before_gc,
-       bool dump_region_info_after_gc);
+       bool dump_region_info_after_gc,
+       bool numa_aware_region_allocation);
 
   ~Heap();
 
@@ -573,6 +575,10 @@ class Heap {
     return use_generational_cc_;
   }
 
+  bool GetUseGenerationalCMC() const {
+    return use_generational_cmc_;
+  }
+
   // Returns the number of objects currently allocated.
   size_t GetObjectsAllocated() const
       REQUIRES(!Locks::heap_bitmap_lock_);
@@ -1691,6 +1697,11 @@ class Heap {
   // for major collections. Set in Heap constructor.
   const bool use_generational_cc_;
 
+  // If true, enable generational collection when using the Concurrent
+  // Mark-Compact (CMC) collector, i.e. compact only the young generation in
+  // minor collections. Set in Heap constructor.
+  const bool use_generational_cmc_;
+
   // True if the currently running collection has made some thread wait.
   bool running_collection_is_blocking_ GUARDED_BY(gc_complete_lock_);
   // The number of blocking GC runs.
@@ -23,6 +23,7 @@
 #include "base/systrace.h"
 #include "class_root-inl.h"
 #include "collector/garbage_collector.h"
+#include "heap.h"
 #include "jni/java_vm_ext.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
@@ -30,6 +31,7 @@
 #include "nativehelper/scoped_local_ref.h"
 #include "object_callbacks.h"
 #include "reflection.h"
+#include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
 #include "task_processor.h"
 #include "thread-inl.h"
@@ -41,6 +43,11 @@ namespace gc {
 
 static constexpr bool kAsyncReferenceQueueAdd = false;
 
+// Minimum number of references per thread when processing a reference queue in parallel. Shorter
+// queues are processed by the GC thread alone since handing out the work would cost more than it
+// saves.
+static constexpr size_t kMinReferencesPerThread = 1024;
+
 ReferenceProcessor::ReferenceProcessor()
     : collector_(nullptr),
       condition_("reference processor condition", *Locks::reference_processor_lock_) ,
@@ -171,6 +178,7 @@ uint32_t ReferenceProcessor::ForwardSoftReferences(TimingLogger* timings) {
   // We used to argue that we should be smarter about doing this conditionally, but it's unclear
   // that's actually better than the more predictable strategy of basically only clearing
   // SoftReferences just before we would otherwise run out of memory.
+  const uint64_t start_ns = NanoTime();
   uint32_t non_null_refs = soft_reference_queue_.ForwardSoftReferences(collector_);
   if (ATraceEnabled()) {
     static constexpr size_t kBufSize = 80;
@@ -182,6 +190,8 @@ uint32_t ReferenceProcessor::ForwardSoftReferences(TimingLogger* timings) {
   } else {
     collector_->ProcessMarkStack();
   }
+  soft_reference_stats_.num_refs += non_null_refs;
+  soft_reference_stats_.time_ns += NanoTime() - start_ns;
   return non_null_refs;
 }
 
@@ -195,6 +205,186 @@ void ReferenceProcessor::Setup(Thread* self,
   rp_state_ = RpState::kStarting;
   concurrent_ = concurrent;
   clear_soft_references_ = clear_soft_references;
+  soft_reference_stats_ = ReferenceTypeStats();
+  weak_reference_stats_ = ReferenceTypeStats();
+  finalizer_reference_stats_ = ReferenceTypeStats();
+  phantom_reference_stats_ = ReferenceTypeStats();
+}
+
+class ReferenceProcessor::ReferenceSliceTask : public SelfDeletingTask {
+ public:
+  ReferenceSliceTask(ReferenceProcessor* reference_processor,
+                     ReferenceQueue* queue,
+                     mirror::Reference** begin,
+                     mirror::Reference** end,
+                     bool is_finalizer_queue,
+                     bool report_cleared)
+      : reference_processor_(reference_processor),
+        queue_(queue),
+        begin_(begin),
+        end_(end),
+        is_finalizer_queue_(is_finalizer_queue),
+        report_cleared_(report_cleared) {}
+
+  // The workers don't transition to the runnable state: the GC thread holds the mutator lock on
+  // their behalf and waits for them before releasing it.
+  void Run(Thread* self) override NO_THREAD_SAFETY_ANALYSIS {
+    reference_processor_->ProcessPendingReferenceSlice(
+        self, queue_, begin_, end_, is_finalizer_queue_, report_cleared_);
+  }
+
+ private:
+  ReferenceProcessor* const reference_processor_;
+  ReferenceQueue* const queue_;
+  mirror::Reference** const begin_;
+  mirror::Reference** const end_;
+  const bool is_finalizer_queue_;
+  const bool report_cleared_;
+};
+
+size_t ReferenceProcessor::GetThreadCount(size_t num_refs) const {
+  Runtime* runtime = Runtime::Current();
+  Heap* heap = runtime->GetHeap();
+  ThreadPool* thread_pool = heap->GetThreadPool();
+  // Like MarkSweep::GetThreadCount(), leave the CPUs to the foreground apps when in background.
+  // Transactions record the cleared referents in a log that isn't thread safe.
+  if (thread_pool == nullptr ||
+      !runtime->InJankPerceptibleProcessState() ||
+      runtime->IsActiveTransaction()) {
+    return 1;
+  }
+  const size_t max_workers =
+      std::min(thread_pool->GetThreadCount(),
+               concurrent_ ? heap->GetConcGCThreadCount() : heap->GetParallelGCThreadCount());
+  return std::min(max_workers + 1, std::max<size_t>(num_refs / kMinReferencesPerThread, 1u));
+}
+
+void ReferenceProcessor::ProcessPendingReferencesInParallel(Thread* self,
+                                                            size_t thread_count,
+                                                            ReferenceQueue* queue,
+                                                            bool is_finalizer_queue,
+                                                            bool report_cleared) {
+  mirror::Reference** const refs = pending_references_.data();
+  const size_t num_refs = pending_references_.size();
+  if (thread_count <= 1) {
+    ProcessPendingReferenceSlice(
+        self, queue, refs, refs + num_refs, is_finalizer_queue, report_cleared);
+    return;
+  }
+  ThreadPool* thread_pool = Runtime::Current()->GetHeap()->GetThreadPool();
+  const size_t slice_size = (num_refs + thread_count - 1) / thread_count;
+  for (size_t begin = 0; begin < num_refs; begin += slice_size) {
+    const size_t end = std::min(begin + slice_size, num_refs);
+    thread_pool->AddTask(self,
+                         new ReferenceSliceTask(this,
+                                                queue,
+                                                refs + begin,
+                                                refs + end,
+                                                is_finalizer_queue,
+                                                report_cleared));
+  }
+  // The GC thread processes slices too while waiting.
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ true);
+  thread_pool->StopWorkers(self);
+}
+
+void ReferenceProcessor::ProcessPendingReferenceSlice(Thread* self,
+                                                      ReferenceQueue* queue,
+                                                      mirror::Reference** begin,
+                                                      mirror::Reference** end,
+                                                      bool is_finalizer_queue,
+                                                      bool report_cleared) {
+  if (is_finalizer_queue) {
+    // Only filter out the references with marked referents. Marking the white referents is left
+    // to the GC thread.
+    for (mirror::Reference** it = begin; it != end; ++it) {
+      ObjPtr<mirror::Reference> ref = *it;
+      // do_atomic_update is false because this happens during the reference processing phase
+      // where Reference.clear() would block.
+      if (collector_->IsNullOrMarkedHeapReference(ref->GetReferentReferenceAddr(),
+                                                  /*do_atomic_update=*/ false)) {
+        queue->DisableReadBarrierForReference(ref, std::memory_order_relaxed);
+        *it = nullptr;
+      }
+    }
+    return;
+  }
+  // Collect the cleared references locally and hand them over with a single lock acquisition.
+  ReferenceQueue cleared_batch(Locks::reference_queue_cleared_references_lock_);
+  for (mirror::Reference** it = begin; it != end; ++it) {
+    ObjPtr<mirror::Reference> ref = *it;
+    ReferenceQueue::ClearWhiteReference(ref, &cleared_batch, collector_, report_cleared);
+    // Delay disabling the read barrier until here so that the ClearReferent call above in
+    // transaction mode will trigger the read barrier.
+    queue->DisableReadBarrierForReference(ref, std::memory_order_relaxed);
+  }
+  cleared_references_.AtomicEnqueueQueue(self, &cleared_batch);
+}
+
+void ReferenceProcessor::ClearWhiteReferences(Thread* self,
+                                              ReferenceQueue* queue,
+                                              ReferenceTypeStats* stats,
+                                              bool report_cleared) {
+  if (queue->IsEmpty()) {
+    return;
+  }
+  const uint64_t start_ns = NanoTime();
+  DCHECK(pending_references_.empty());
+  queue->DequeuePendingReferences(&pending_references_);
+  const size_t num_refs = pending_references_.size();
+  ProcessPendingReferencesInParallel(self,
+                                     GetThreadCount(num_refs),
+                                     queue,
+                                     /*is_finalizer_queue=*/ false,
+                                     report_cleared);
+  pending_references_.clear();
+  stats->num_refs += num_refs;
+  stats->time_ns += NanoTime() - start_ns;
+}
+
+FinalizerStats ReferenceProcessor::EnqueueFinalizerReferences(Thread* self) {
+  DCHECK(pending_references_.empty());
+  finalizer_reference_queue_.DequeuePendingReferences(&pending_references_);
+  const size_t num_refs = pending_references_.size();
+  const size_t thread_count = GetThreadCount(num_refs);
+  if (thread_count > 1) {
+    ProcessPendingReferencesInParallel(self,
+                                       thread_count,
+                                       &finalizer_reference_queue_,
+                                       /*is_finalizer_queue=*/ true,
+                                       /*report_cleared=*/ false);
+  }
+  uint32_t num_enqueued = 0;
+  for (mirror::Reference* ref : pending_references_) {
+    if (ref == nullptr) {
+      // The referent was marked, the reference was handled by ProcessPendingReferenceSlice.
+      continue;
+    }
+    if (ReferenceQueue::EnqueueFinalizerReference(
+            ref->AsFinalizerReference(), &cleared_references_, collector_)) {
+      ++num_enqueued;
+    }
+    // Delay disabling the read barrier until here so that the ClearReferent call above in
+    // transaction mode will trigger the read barrier.
+    finalizer_reference_queue_.DisableReadBarrierForReference(ref, std::memory_order_relaxed);
+  }
+  pending_references_.clear();
+  return FinalizerStats(num_refs, num_enqueued);
+}
+
+void ReferenceProcessor::ReportMetrics() const {
+  metrics::ArtMetrics* metrics = Runtime::Current()->GetMetrics();
+  metrics->GcSoftReferenceCount()->Add(soft_reference_stats_.num_refs);
+  metrics->GcSoftReferenceProcessingTime()->Add(NsToUs(soft_reference_stats_.time_ns));
+  metrics->GcWeakReferenceCount()->Add(weak_reference_stats_.num_refs);
+  metrics->GcWeakReferenceProcessingTime()->Add(NsToUs(weak_reference_stats_.time_ns));
+  metrics->GcFinalizerReferenceCount()->Add(finalizer_reference_stats_.num_refs);
+  metrics->GcFinalizerReferenceProcessingTime()->Add(
+      NsToUs(finalizer_reference_stats_.time_ns));
+  metrics->GcPhantomReferenceCount()->Add(phantom_reference_stats_.num_refs);
+  metrics->GcPhantomReferenceProcessingTime()->Add(NsToUs(phantom_reference_stats_.time_ns));
 }
 
 // Process reference class instances and schedule finalizations.
@@ -230,8 +420,8 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
   }
   // Clear all remaining soft and weak references with white referents.
   // This misses references only reachable through finalizers.
-  soft_reference_queue_.ClearWhiteReferences(&cleared_references_, collector_);
-  weak_reference_queue_.ClearWhiteReferences(&cleared_references_, collector_);
+  ClearWhiteReferences(self, &soft_reference_queue_, &soft_reference_stats_);
+  ClearWhiteReferences(self, &weak_reference_queue_, &weak_reference_stats_);
   // Defer PhantomReference processing until we've finished marking through finalizers.
   {
     // TODO: Capture mark state of some system weaks here. If the referent was marked here,
@@ -250,9 +440,9 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
   {
     TimingLogger::ScopedTiming t2(
         concurrent_ ? "EnqueueFinalizerReferences" : "(Paused)EnqueueFinalizerReferences", timings);
+    const uint64_t start_ns = NanoTime();
     // Preserve all white objects with finalize methods and schedule them for finalization.
-    FinalizerStats finalizer_stats =
-        finalizer_reference_queue_.EnqueueFinalizerReferences(&cleared_references_, collector_);
+    FinalizerStats finalizer_stats = EnqueueFinalizerReferences(self);
     if (ATraceEnabled()) {
       static constexpr size_t kBufSize = 80;
       char buf[kBufSize];
@@ -264,6 +454,8 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
     } else {
       collector_->ProcessMarkStack();
     }
+    finalizer_reference_stats_.num_refs += finalizer_stats.num_refs_;
+    finalizer_reference_stats_.time_ns += NanoTime() - start_ns;
   }
 
   // Process all soft and weak references with white referents, where the references are reachable
@@ -285,13 +477,13 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
   // finalized object containing pointers to native objects that have already been deallocated.
   // But it can be argued that this is just an instance of the broader rule that it is not safe
   // for finalizers to access otherwise inaccessible finalizable objects.
-  soft_reference_queue_.ClearWhiteReferences(&cleared_references_, collector_,
-                                             /*report_cleared=*/ true);
-  weak_reference_queue_.ClearWhiteReferences(&cleared_references_, collector_,
-                                             /*report_cleared=*/ true);
+  ClearWhiteReferences(
+      self, &soft_reference_queue_, &soft_reference_stats_, /*report_cleared=*/ true);
+  ClearWhiteReferences(
+      self, &weak_reference_queue_, &weak_reference_stats_, /*report_cleared=*/ true);
 
   // Clear all phantom references with white referents. It's fine to do this just once here.
-  phantom_reference_queue_.ClearWhiteReferences(&cleared_references_, collector_);
+  ClearWhiteReferences(self, &phantom_reference_queue_, &phantom_reference_stats_);
 
   // At this point all reference queues other than the cleared references should be empty.
   DCHECK(soft_reference_queue_.IsEmpty());
@@ -310,6 +502,7 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
       DisableSlowPath(self);
     }
   }
+  ReportMetrics();
 }
 
 // Process the "referent" field in a java.lang.ref.Reference.  If the referent has not yet been
@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_GC_REFERENCE_PROCESSOR_H_
 #define ART_RUNTIME_GC_REFERENCE_PROCESSOR_H_
 
+#include <vector>
+
 #include "base/macros.h"
 #include "base/locks.h"
 #include "jni.h"
@@ -93,6 +95,50 @@ class ReferenceProcessor {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
  private:
+  class ReferenceSliceTask;
+
+  // Number of references of one type seen by the current reference processing pass, and the time
+  // spent on them. Reported to the runtime metrics at the end of ProcessReferences.
+  struct ReferenceTypeStats {
+    uint64_t num_refs = 0;
+    uint64_t time_ns = 0;
+  };
+
+  // Like ReferenceQueue::ClearWhiteReferences, but splits large queues among the GC thread and
+  // the heap thread pool workers. Cleared references are added to cleared_references_ in one
+  // batch per worker.
+  void ClearWhiteReferences(Thread* self,
+                            ReferenceQueue* queue,
+                            ReferenceTypeStats* stats,
+                            bool report_cleared = false)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  // Like ReferenceQueue::EnqueueFinalizerReferences. The liveness of the referents of large queues
+  // is checked in parallel, the white referents are then marked by the GC thread since the mark
+  // stacks of the collectors have a single producer.
+  FinalizerStats EnqueueFinalizerReferences(Thread* self)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  // Returns the number of threads, including the GC thread, to process `num_refs` references
+  // dequeued into pending_references_.
+  size_t GetThreadCount(size_t num_refs) const;
+  // Process pending_references_ with the GC thread and `thread_count - 1` pool workers.
+  void ProcessPendingReferencesInParallel(Thread* self,
+                                          size_t thread_count,
+                                          ReferenceQueue* queue,
+                                          bool is_finalizer_queue,
+                                          bool report_cleared)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  // Process the given slice of pending_references_. Soft, weak and phantom references with white
+  // referents are cleared. Finalizer references with marked referents are replaced with null, the
+  // remaining ones are left to the GC thread.
+  void ProcessPendingReferenceSlice(Thread* self,
+                                    ReferenceQueue* queue,
+                                    mirror::Reference** begin,
+                                    mirror::Reference** end,
+                                    bool is_finalizer_queue,
+                                    bool report_cleared)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  void ReportMetrics() const;
+
   bool SlowPathEnabled() REQUIRES_SHARED(Locks::mutator_lock_);
   // Called by ProcessReferences.
   void DisableSlowPath(Thread* self) REQUIRES(Locks::reference_processor_lock_)
@@ -124,6 +170,15 @@ class ReferenceProcessor {
   ReferenceQueue phantom_reference_queue_;
   ReferenceQueue cleared_references_;
 
+  // References dequeued for parallel processing. Only used by GC thread, kept around to avoid
+  // reallocating it for each GC.
+  std::vector<mirror::Reference*> pending_references_;
+  // Per-type statistics of the current GC. Reset by Setup, only used by GC thread.
+  ReferenceTypeStats soft_reference_stats_;
+  ReferenceTypeStats weak_reference_stats_;
+  ReferenceTypeStats finalizer_reference_stats_;
+  ReferenceTypeStats phantom_reference_stats_;
+
   DISALLOW_COPY_AND_ASSIGN(ReferenceProcessor);
 };
 
@@ -16,6 +16,8 @@
 
 #include "reference_queue.h"
 
+#include <atomic>
+
 #include "accounting/card_table-inl.h"
 #include "base/mutex.h"
 #include "collector/concurrent_copying.h"
@@ -72,6 +74,40 @@ ObjPtr<mirror::Reference> ReferenceQueue::DequeuePendingReference() {
   return ref;
 }
 
+void ReferenceQueue::AtomicEnqueueQueue(Thread* self, ReferenceQueue* queue) {
+  DCHECK(queue != this);
+  if (queue->IsEmpty()) {
+    return;
+  }
+  MutexLock mu(self, *lock_);
+  if (IsEmpty()) {
+    list_ = queue->list_;
+  } else {
+    // Join the two cycles into one by swapping the successors of their entry points.
+    ObjPtr<mirror::Reference> head = list_->GetPendingNext<kWithoutReadBarrier>();
+    DCHECK(head != nullptr);
+    list_->SetPendingNext(queue->list_->GetPendingNext<kWithoutReadBarrier>());
+    queue->list_->SetPendingNext(head);
+  }
+  queue->Clear();
+}
+
+void ReferenceQueue::DequeuePendingReferences(std::vector<mirror::Reference*>* refs) {
+  if (IsEmpty()) {
+    return;
+  }
+  // Walk the cycle once and unlink every reference, starting after the entry point.
+  mirror::Reference* ref = list_->GetPendingNext<kWithoutReadBarrier>();
+  list_->SetPendingNext(nullptr);
+  list_ = nullptr;
+  while (ref != nullptr) {
+    mirror::Reference* next = ref->GetPendingNext<kWithoutReadBarrier>();
+    ref->SetPendingNext(nullptr);
+    refs->push_back(ref);
+    ref = next;
+  }
+}
+
 // This must be called whenever DequeuePendingReference is called.
 void ReferenceQueue::DisableReadBarrierForReference(ObjPtr<mirror::Reference> ref,
                                                     std::memory_order order) {
@@ -131,58 +167,76 @@ size_t ReferenceQueue::GetLength() const {
   return count;
 }
 
+bool ReferenceQueue::ClearWhiteReference(ObjPtr<mirror::Reference> ref,
+                                         ReferenceQueue* cleared_references,
+                                         collector::GarbageCollector* collector,
+                                         bool report_cleared) {
+  mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
+  // do_atomic_update is false because this happens during the reference processing phase where
+  // Reference.clear() would block.
+  if (collector->IsNullOrMarkedHeapReference(referent_addr, /*do_atomic_update=*/false)) {
+    return false;
+  }
+  // Referent is white, clear it.
+  if (Runtime::Current()->IsActiveTransaction()) {
+    ref->ClearReferent<true>();
+  } else {
+    ref->ClearReferent<false>();
+  }
+  cleared_references->EnqueueReference(ref);
+  if (report_cleared) {
+    // May be reached from several GC threads at once.
+    static std::atomic<bool> already_reported(false);
+    if (!already_reported.exchange(true, std::memory_order_relaxed)) {
+      // TODO: Maybe do this only if the queue is non-null?
+      LOG(WARNING)
+          << "Cleared Reference was only reachable from finalizer (only reported once)";
+    }
+  }
+  return true;
+}
+
 void ReferenceQueue::ClearWhiteReferences(ReferenceQueue* cleared_references,
                                           collector::GarbageCollector* collector,
                                           bool report_cleared) {
   while (!IsEmpty()) {
     ObjPtr<mirror::Reference> ref = DequeuePendingReference();
-    mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
-    // do_atomic_update is false because this happens during the reference processing phase where
-    // Reference.clear() would block.
-    if (!collector->IsNullOrMarkedHeapReference(referent_addr, /*do_atomic_update=*/false)) {
-      // Referent is white, clear it.
-      if (Runtime::Current()->IsActiveTransaction()) {
-        ref->ClearReferent<true>();
-      } else {
-        ref->ClearReferent<false>();
-      }
-      cleared_references->EnqueueReference(ref);
-      if (report_cleared) {
-        static bool already_reported = false;
-        if (!already_reported) {
-          // TODO: Maybe do this only if the queue is non-null?
-          LOG(WARNING)
-              << "Cleared Reference was only reachable from finalizer (only reported once)";
-          already_reported = true;
-        }
-      }
-    }
+    ClearWhiteReference(ref, cleared_references, collector, report_cleared);
     // Delay disabling the read barrier until here so that the ClearReferent call above in
     // transaction mode will trigger the read barrier.
     DisableReadBarrierForReference(ref, std::memory_order_relaxed);
   }
 }
 
+bool ReferenceQueue::EnqueueFinalizerReference(ObjPtr<mirror::FinalizerReference> ref,
+                                               ReferenceQueue* cleared_references,
+                                               collector::GarbageCollector* collector) {
+  mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
+  // do_atomic_update is false because this happens during the reference processing phase where
+  // Reference.clear() would block.
+  if (collector->IsNullOrMarkedHeapReference(referent_addr, /*do_atomic_update=*/false)) {
+    return false;
+  }
+  ObjPtr<mirror::Object> forward_address = collector->MarkObject(referent_addr->AsMirrorPtr());
+  // Move the updated referent to the zombie field.
+  if (Runtime::Current()->IsActiveTransaction()) {
+    ref->SetZombie<true>(forward_address);
+    ref->ClearReferent<true>();
+  } else {
+    ref->SetZombie<false>(forward_address);
+    ref->ClearReferent<false>();
+  }
+  cleared_references->EnqueueReference(ref);
+  return true;
+}
+
 FinalizerStats ReferenceQueue::EnqueueFinalizerReferences(ReferenceQueue* cleared_references,
                                                 collector::GarbageCollector* collector) {
   uint32_t num_refs(0), num_enqueued(0);
   while (!IsEmpty()) {
     ObjPtr<mirror::FinalizerReference> ref = DequeuePendingReference()->AsFinalizerReference();
     ++num_refs;
-    mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
-    // do_atomic_update is false because this happens during the reference processing phase where
-    // Reference.clear() would block.
-    if (!collector->IsNullOrMarkedHeapReference(referent_addr, /*do_atomic_update=*/false)) {
-      ObjPtr<mirror::Object> forward_address = collector->MarkObject(referent_addr->AsMirrorPtr());
-      // Move the updated referent to the zombie field.
-      if (Runtime::Current()->IsActiveTransaction()) {
-        ref->SetZombie<true>(forward_address);
-        ref->ClearReferent<true>();
-      } else {
-        ref->SetZombie<false>(forward_address);
-        ref->ClearReferent<false>();
-      }
-      cleared_references->EnqueueReference(ref);
+    if (EnqueueFinalizerReference(ref, cleared_references, collector)) {
       ++num_enqueued;
     }
     // Delay disabling the read barrier until here so that the ClearReferent call above in
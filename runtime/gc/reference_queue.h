@@ -36,6 +36,7 @@ namespace art HIDDEN {
 class Mutex;
 
 namespace mirror {
+class FinalizerReference;
 class Reference;
 }  // namespace mirror
 
@@ -79,6 +80,16 @@ class ReferenceQueue {
   // Call DisableReadBarrierForReference for the reference that's returned from this function.
   ObjPtr<mirror::Reference> DequeuePendingReference() REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Move all the references of `queue` to this queue, leaving `queue` empty. Thread safe, the
+  // whole batch is added with a single lock acquisition.
+  void AtomicEnqueueQueue(Thread* self, ReferenceQueue* queue)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!*lock_);
+
+  // Dequeue all the references of the queue into `refs`, so that they can be processed by several
+  // threads. Call DisableReadBarrierForReference for each of the dequeued references.
+  void DequeuePendingReferences(std::vector<mirror::Reference*>* refs)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // If applicable, disable the read barrier for the reference after its referent is handled (see
   // ConcurrentCopying::ProcessMarkStackRef.) This must be called for a reference that's dequeued
   // from pending queue (DequeuePendingReference). 'order' is expected to be
@@ -109,6 +120,22 @@ class ReferenceQueue {
                             bool report_cleared = false)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Clear the referent of a dequeued reference if it is white and add the reference to
+  // `cleared_references`. Returns true if the referent was cleared.
+  static bool ClearWhiteReference(ObjPtr<mirror::Reference> ref,
+                                  ReferenceQueue* cleared_references,
+                                  collector::GarbageCollector* collector,
+                                  bool report_cleared)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Preserve the white referent of a dequeued finalizer reference by moving it to the zombie
+  // field, and add the reference to `cleared_references`. Returns true if the reference was
+  // enqueued.
+  static bool EnqueueFinalizerReference(ObjPtr<mirror::FinalizerReference> ref,
+                                        ReferenceQueue* cleared_references,
+                                        collector::GarbageCollector* collector)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   void Dump(std::ostream& os) const REQUIRES_SHARED(Locks::mutator_lock_);
   size_t GetLength() const REQUIRES_SHARED(Locks::mutator_lock_);
 
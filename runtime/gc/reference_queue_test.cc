@@ -14,7 +14,9 @@
  * limitations under the License.
  */
 
+#include <set>
 #include <sstream>
+#include <vector>
 
 #include "common_runtime_test.h"
 #include "handle_scope-inl.h"
@@ -67,6 +69,52 @@ TEST_F(ReferenceQueueTest, EnqueueDequeue) {
   ASSERT_EQ(refs, dequeued);
 }
 
+TEST_F(ReferenceQueueTest, EnqueueQueueAndDequeueAll) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<20> hs(self);
+  Mutex lock("Reference queue lock");
+  ReferenceQueue queue(&lock);
+  ReferenceQueue batch(&lock);
+  auto ref_class = hs.NewHandle(
+      Runtime::Current()->GetClassLinker()->FindClass(self, "Ljava/lang/ref/WeakReference;",
+                                                      ScopedNullHandle<mirror::ClassLoader>()));
+  ASSERT_TRUE(ref_class != nullptr);
+  auto ref1(hs.NewHandle(ref_class->AllocObject(self)->AsReference()));
+  ASSERT_TRUE(ref1 != nullptr);
+  auto ref2(hs.NewHandle(ref_class->AllocObject(self)->AsReference()));
+  ASSERT_TRUE(ref2 != nullptr);
+  auto ref3(hs.NewHandle(ref_class->AllocObject(self)->AsReference()));
+  ASSERT_TRUE(ref3 != nullptr);
+
+  // Enqueueing a batch into an empty queue takes over the batch's list.
+  batch.EnqueueReference(ref1.Get());
+  queue.AtomicEnqueueQueue(self, &batch);
+  ASSERT_TRUE(batch.IsEmpty());
+  ASSERT_EQ(queue.GetLength(), 1U);
+
+  // Enqueueing a batch into a non-empty queue joins the two lists.
+  batch.EnqueueReference(ref2.Get());
+  batch.EnqueueReference(ref3.Get());
+  queue.AtomicEnqueueQueue(self, &batch);
+  ASSERT_TRUE(batch.IsEmpty());
+  ASSERT_EQ(queue.GetLength(), 3U);
+
+  // Enqueueing an empty batch is a no-op.
+  queue.AtomicEnqueueQueue(self, &batch);
+  ASSERT_EQ(queue.GetLength(), 3U);
+
+  std::vector<mirror::Reference*> dequeued;
+  queue.DequeuePendingReferences(&dequeued);
+  ASSERT_TRUE(queue.IsEmpty());
+  ASSERT_EQ(dequeued.size(), 3U);
+  std::set<mirror::Reference*> refs = {ref1.Get(), ref2.Get(), ref3.Get()};
+  ASSERT_EQ(refs, std::set<mirror::Reference*>(dequeued.begin(), dequeued.end()));
+  for (mirror::Reference* ref : dequeued) {
+    ASSERT_TRUE(ref->IsUnprocessed());
+  }
+}
+
 TEST_F(ReferenceQueueTest, Dump) {
   Thread* self = Thread::Current();
   ScopedObjectAccess soa(self);
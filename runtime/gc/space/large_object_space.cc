@@ -18,6 +18,8 @@
 
 #include <sys/mman.h>
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 
 #include <android-base/logging.h>
@@ -35,6 +37,7 @@
 #include "scoped_thread_state_change-inl.h"
 #include "space-inl.h"
 #include "thread-current-inl.h"
+#include "thread_list.h"
 
 namespace art HIDDEN {
 namespace gc {
@@ -42,7 +45,8 @@ namespace space {
 
 class MemoryToolLargeObjectMapSpace final : public LargeObjectMapSpace {
  public:
-  explicit MemoryToolLargeObjectMapSpace(const std::string& name) : LargeObjectMapSpace(name) {
+  explicit MemoryToolLargeObjectMapSpace(const std::string& name)
+      : LargeObjectMapSpace(name, /*cache_freed_maps=*/ false) {
   }
 
   ~MemoryToolLargeObjectMapSpace() override {
@@ -116,7 +120,30 @@ LargeObjectSpace::LargeObjectSpace(const std::string& name, uint8_t* begin, uint
     : DiscontinuousSpace(name, kGcRetentionPolicyAlwaysCollect),
       lock_(lock_name, kAllocSpaceLock),
       num_bytes_allocated_(0), num_objects_allocated_(0), total_bytes_allocated_(0),
-      total_objects_allocated_(0), begin_(begin), end_(end) {
+      total_objects_allocated_(0), cached_bytes_(0), begin_(begin), end_(end) {
+}
+
+// Roughly geometric so that rounding up to a size class wastes at most a third of the allocation.
+static constexpr size_t kSizeClassBytes[] = {
+    4 * KB, 8 * KB, 12 * KB, 16 * KB, 24 * KB, 32 * KB,
+    48 * KB, 64 * KB, 96 * KB, 128 * KB, 192 * KB, 256 * KB,
+};
+static_assert(arraysize(kSizeClassBytes) == LargeObjectSpace::kNumSizeClasses);
+static_assert(kSizeClassBytes[LargeObjectSpace::kNumSizeClasses - 1] ==
+              LargeObjectSpace::kMaxSizeClassBytes);
+
+size_t LargeObjectSpace::SizeClassIndex(size_t num_bytes) {
+  size_t size_class = 0;
+  while (size_class < kNumSizeClasses && SizeClassBytes(size_class) < num_bytes) {
+    ++size_class;
+  }
+  return size_class;
+}
+
+size_t LargeObjectSpace::SizeClassBytes(size_t size_class) {
+  DCHECK_LT(size_class, kNumSizeClasses);
+  // With large page sizes some of the smaller size classes coincide, which is harmless.
+  return RoundUp(kSizeClassBytes[size_class], ObjectAlignment());
 }
 
 
@@ -124,14 +151,15 @@ void LargeObjectSpace::CopyLiveToMarked() {
   mark_bitmap_.CopyFrom(&live_bitmap_);
 }
 
-LargeObjectMapSpace::LargeObjectMapSpace(const std::string& name)
-    : LargeObjectSpace(name, nullptr, nullptr, "large object map space lock") {}
+LargeObjectMapSpace::LargeObjectMapSpace(const std::string& name, bool cache_freed_maps)
+    : LargeObjectSpace(name, nullptr, nullptr, "large object map space lock"),
+      cache_freed_maps_(cache_freed_maps) {}
 
 LargeObjectMapSpace* LargeObjectMapSpace::Create(const std::string& name) {
   if (Runtime::Current()->IsRunningOnMemoryTool()) {
     return new MemoryToolLargeObjectMapSpace(name);
   } else {
-    return new LargeObjectMapSpace(name);
+    return new LargeObjectMapSpace(name, /*cache_freed_maps=*/ true);
   }
 }
 
@@ -141,15 +169,38 @@ mirror::Object* LargeObjectMapSpace::Alloc(Thread* self, size_t num_bytes,
   DCHECK_LE(gPageSize, ObjectAlignment())
       << "MapAnonymousAligned() should be used if the large-object alignment is larger than the "
          "runtime page size";
-  std::string error_msg;
-  MemMap mem_map = MemMap::MapAnonymous("large object space allocation",
-                                        num_bytes,
-                                        PROT_READ | PROT_WRITE,
-                                        /*low_4gb=*/true,
-                                        &error_msg);
-  if (UNLIKELY(!mem_map.IsValid())) {
-    LOG(WARNING) << "Large object allocation failed: " << error_msg;
-    return nullptr;
+  const size_t size_class = cache_freed_maps_ ? SizeClassIndex(num_bytes) : kNumSizeClasses;
+  // Only the requested bytes are cleared when reusing a mapping, so only those
+  // are usable.
+  const size_t requested_bytes = num_bytes;
+  MemMap mem_map;
+  if (size_class < kNumSizeClasses) {
+    num_bytes = SizeClassBytes(size_class);
+    MutexLock mu(self, lock_);
+    std::vector<MemMap>& cached_maps = cached_maps_[size_class];
+    if (!cached_maps.empty()) {
+      mem_map = std::move(cached_maps.back());
+      cached_maps.pop_back();
+      DCHECK_GE(cached_bytes_, num_bytes);
+      cached_bytes_ -= num_bytes;
+    }
+  }
+  if (mem_map.IsValid()) {
+    // Reusing the mapping of a freed object, which is cheaper to clear than
+    // to unmap and fault in again.
+    DCHECK_EQ(mem_map.BaseSize(), num_bytes);
+    memset(mem_map.Begin(), 0, requested_bytes);
+  } else {
+    std::string error_msg;
+    mem_map = MemMap::MapAnonymous("large object space allocation",
+                                   num_bytes,
+                                   PROT_READ | PROT_WRITE,
+                                   /*low_4gb=*/true,
+                                   &error_msg);
+    if (UNLIKELY(!mem_map.IsValid())) {
+      LOG(WARNING) << "Large object allocation failed: " << error_msg;
+      return nullptr;
+    }
   }
   mirror::Object* const obj = reinterpret_cast<mirror::Object*>(mem_map.Begin());
   const size_t allocation_size = mem_map.BaseSize();
@@ -164,14 +215,14 @@ mirror::Object* LargeObjectMapSpace::Alloc(Thread* self, size_t num_bytes,
 
   *bytes_allocated = allocation_size;
   if (usable_size != nullptr) {
-    *usable_size = allocation_size;
+    *usable_size = size_class < kNumSizeClasses ? requested_bytes : allocation_size;
   }
   DCHECK(bytes_tl_bulk_allocated != nullptr);
   *bytes_tl_bulk_allocated = allocation_size;
-  num_bytes_allocated_ += allocation_size;
-  total_bytes_allocated_ += allocation_size;
-  ++num_objects_allocated_;
-  ++total_objects_allocated_;
+  num_bytes_allocated_.fetch_add(allocation_size, std::memory_order_relaxed);
+  total_bytes_allocated_.fetch_add(allocation_size, std::memory_order_relaxed);
+  num_objects_allocated_.fetch_add(1, std::memory_order_relaxed);
+  total_objects_allocated_.fetch_add(1, std::memory_order_relaxed);
   return obj;
 }
 
@@ -194,22 +245,53 @@ void LargeObjectMapSpace::SetAllLargeObjectsAsZygoteObjects(Thread* self, bool s
 }
 
 size_t LargeObjectMapSpace::Free(Thread* self, mirror::Object* ptr) {
-  MutexLock mu(self, lock_);
-  auto it = large_objects_.find(ptr);
-  if (UNLIKELY(it == large_objects_.end())) {
-    ScopedObjectAccess soa(self);
-    Runtime::Current()->GetHeap()->DumpSpaces(LOG_STREAM(FATAL_WITHOUT_ABORT));
-    LOG(FATAL) << "Attempted to free large object " << ptr << " which was not live";
-  }
-  const size_t map_size = it->second.mem_map.BaseSize();
-  DCHECK_GE(num_bytes_allocated_, map_size);
-  size_t allocation_size = map_size;
-  num_bytes_allocated_ -= allocation_size;
-  --num_objects_allocated_;
-  large_objects_.erase(it);
+  size_t allocation_size;
+  bool release_cached_maps = false;
+  {
+    MutexLock mu(self, lock_);
+    auto it = large_objects_.find(ptr);
+    if (UNLIKELY(it == large_objects_.end())) {
+      ScopedObjectAccess soa(self);
+      Runtime::Current()->GetHeap()->DumpSpaces(LOG_STREAM(FATAL_WITHOUT_ABORT));
+      LOG(FATAL) << "Attempted to free large object " << ptr << " which was not live";
+    }
+    const size_t map_size = it->second.mem_map.BaseSize();
+    DCHECK_GE(num_bytes_allocated_.load(std::memory_order_relaxed), map_size);
+    allocation_size = map_size;
+    num_bytes_allocated_.fetch_sub(allocation_size, std::memory_order_relaxed);
+    num_objects_allocated_.fetch_sub(1, std::memory_order_relaxed);
+    const size_t size_class = cache_freed_maps_ ? SizeClassIndex(map_size) : kNumSizeClasses;
+    if (size_class < kNumSizeClasses && SizeClassBytes(size_class) == map_size) {
+      // Keep the mapping for a future allocation of the same size class.
+      cached_maps_[size_class].push_back(std::move(it->second.mem_map));
+      cached_bytes_ += map_size;
+      release_cached_maps = cached_bytes_ > kMaxCachedBytes;
+    }
+    large_objects_.erase(it);
+  }
+  if (release_cached_maps) {
+    ReleaseCachedBlocks();
+  }
   return allocation_size;
 }
 
+size_t LargeObjectMapSpace::ReleaseCachedBlocks() {
+  std::vector<MemMap> released_maps;
+  size_t released_bytes;
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    for (std::vector<MemMap>& cached_maps : cached_maps_) {
+      std::move(cached_maps.begin(), cached_maps.end(), std::back_inserter(released_maps));
+      cached_maps.clear();
+    }
+    released_bytes = cached_bytes_;
+    cached_bytes_ = 0;
+  }
+  // The mappings are unmapped in one go when 'released_maps' goes out of scope,
+  // without holding the lock.
+  return released_bytes;
+}
+
 size_t LargeObjectMapSpace::AllocationSize(mirror::Object* obj, size_t* usable_size) {
   MutexLock mu(Thread::Current(), lock_);
   auto it = large_objects_.find(obj);
@@ -246,6 +328,11 @@ void LargeObjectMapSpace::ForEachMemMap(std::function<void(const MemMap&)> func)
   for (auto& pair : large_objects_) {
     func(pair.second.mem_map);
   }
+  for (const std::vector<MemMap>& cached_maps : cached_maps_) {
+    for (const MemMap& mem_map : cached_maps) {
+      func(mem_map);
+    }
+  }
 }
 
 bool LargeObjectMapSpace::Contains(const mirror::Object* obj) const {
@@ -295,6 +382,16 @@ class AllocationInfo {
   void SetZygoteObject() {
     alloc_size_ |= kFlagZygote;
   }
+  // Return true if the block is reserved in a thread-local cache or cached for reuse after being
+  // freed, rather than holding a large object.
+  bool IsCached() const {
+    return (alloc_size_ & kFlagCached) != 0;
+  }
+  // Only the flag bit changes, so lock holders reading the size of a block which is concurrently
+  // allocated from a thread-local cache still read the right size.
+  void SetCached(bool cached) {
+    alloc_size_ = cached ? (alloc_size_ | kFlagCached) : (alloc_size_ & ~kFlagCached);
+  }
   // Return true if this is a zygote large object.
   // Finds and returns the next non free allocation info after ourself.
   AllocationInfo* GetNextInfo() {
@@ -332,7 +429,9 @@ class AllocationInfo {
  private:
   static constexpr uint32_t kFlagFree = 0x80000000;  // If block is free.
   static constexpr uint32_t kFlagZygote = 0x40000000;  // If the large object is a zygote object.
-  static constexpr uint32_t kFlagsMask = ~(kFlagFree | kFlagZygote);  // Combined flags for masking.
+  static constexpr uint32_t kFlagCached = 0x20000000;  // If the block is cached (see IsCached()).
+  // Combined flags for masking.
+  static constexpr uint32_t kFlagsMask = ~(kFlagFree | kFlagZygote | kFlagCached);
   // Contains the size of the previous free block with the large-object alignment value as the
   // unit. If 0 then the allocation before us is not free.
   // These variables are undefined in the middle of allocations / free blocks.
@@ -387,6 +486,7 @@ FreeListSpace::FreeListSpace(const std::string& name,
       mem_map_(std::move(mem_map)) {
   const size_t space_capacity = end - begin;
   free_end_ = space_capacity;
+  std::fill_n(cached_blocks_, kNumSizeClasses, nullptr);
   CHECK_ALIGNED_PARAM(space_capacity, ObjectAlignment());
   const size_t alloc_info_size = sizeof(AllocationInfo) * (space_capacity / ObjectAlignment());
   std::string error_msg;
@@ -421,7 +521,13 @@ void FreeListSpace::ClampGrowthLimit(size_t new_capacity) {
   end_ -= diff;
 }
 
-FreeListSpace::~FreeListSpace() {}
+FreeListSpace::~FreeListSpace() {
+  // Don't leave the threads with caches pointing into the space.
+  Runtime* runtime = Runtime::Current();
+  if (runtime != nullptr && runtime->GetThreadList() != nullptr) {
+    RevokeAllThreadLocalBuffers();
+  }
+}
 
 void FreeListSpace::Walk(DlMallocSpace::WalkCallback callback, void* arg) {
   MutexLock mu(Thread::Current(), lock_);
@@ -429,7 +535,7 @@ void FreeListSpace::Walk(DlMallocSpace::WalkCallback callback, void* arg) {
   AllocationInfo* cur_info = &allocation_info_[0];
   const AllocationInfo* end_info = GetAllocationInfoForAddress(free_end_start);
   while (cur_info < end_info) {
-    if (!cur_info->IsFree()) {
+    if (!cur_info->IsFree() && !cur_info->IsCached()) {
       size_t alloc_size = cur_info->ByteSize();
       uint8_t* byte_start = reinterpret_cast<uint8_t*>(GetAddressForAllocationInfo(cur_info));
       uint8_t* byte_end = byte_start + alloc_size;
@@ -461,9 +567,31 @@ size_t FreeListSpace::Free(Thread* self, mirror::Object* obj) {
   DCHECK_ALIGNED_PARAM(obj, ObjectAlignment());
   AllocationInfo* info = GetAllocationInfoForAddress(reinterpret_cast<uintptr_t>(obj));
   DCHECK(!info->IsFree());
+  DCHECK(!info->IsCached());
   const size_t allocation_size = info->ByteSize();
   DCHECK_GT(allocation_size, 0U);
   DCHECK_ALIGNED_PARAM(allocation_size, ObjectAlignment());
+  DCHECK_LE(allocation_size, num_bytes_allocated_.load(std::memory_order_relaxed));
+  num_bytes_allocated_.fetch_sub(allocation_size, std::memory_order_relaxed);
+  num_objects_allocated_.fetch_sub(1, std::memory_order_relaxed);
+
+  const size_t size_class = SizeClassIndex(allocation_size);
+  if (size_class < kNumSizeClasses && SizeClassBytes(size_class) == allocation_size) {
+    // Cache the block for reuse, deferring the madvise to a batched release.
+    bool release_cached_blocks;
+    {
+      MutexLock mu(self, lock_);
+      // Also clears the zygote flag.
+      info->SetByteSize(allocation_size, /*free=*/ false);
+      info->SetCached(true);
+      PushCachedBlockLocked(reinterpret_cast<uint8_t*>(obj), size_class);
+      release_cached_blocks = cached_bytes_ > kMaxCachedBytes;
+    }
+    if (release_cached_blocks) {
+      ReleaseCachedBlocks();
+    }
+    return allocation_size;
+  }
 
   // madvise the pages without lock
   madvise(obj, allocation_size, MADV_DONTNEED);
@@ -473,6 +601,11 @@ size_t FreeListSpace::Free(Thread* self, mirror::Object* obj) {
   }
 
   MutexLock mu(self, lock_);
+  FreeLocked(info, allocation_size);
+  return allocation_size;
+}
+
+void FreeListSpace::FreeLocked(AllocationInfo* info, size_t allocation_size) {
   info->SetByteSize(allocation_size, true);  // Mark as free.
   // Look at the next chunk.
   AllocationInfo* next_info = info->GetNextInfo();
@@ -515,10 +648,47 @@ size_t FreeListSpace::Free(Thread* self, mirror::Object* obj) {
     info->SetByteSize(new_free_size, true);
     DCHECK_EQ(info->GetNextInfo(), new_free_info);
   }
-  --num_objects_allocated_;
-  DCHECK_LE(allocation_size, num_bytes_allocated_);
-  num_bytes_allocated_ -= allocation_size;
-  return allocation_size;
+}
+
+void FreeListSpace::PushCachedBlockLocked(uint8_t* block, size_t size_class) {
+  DCHECK(GetAllocationInfoForAddress(reinterpret_cast<uintptr_t>(block))->IsCached());
+  *reinterpret_cast<uint8_t**>(block) = cached_blocks_[size_class];
+  cached_blocks_[size_class] = block;
+  cached_bytes_ += SizeClassBytes(size_class);
+}
+
+size_t FreeListSpace::ReleaseCachedBlocks() {
+  Thread* self = Thread::Current();
+  std::vector<std::pair<uint8_t*, size_t>> blocks;
+  size_t released_bytes;
+  {
+    MutexLock mu(self, lock_);
+    for (size_t size_class = 0; size_class < kNumSizeClasses; ++size_class) {
+      for (uint8_t* block = cached_blocks_[size_class]; block != nullptr;
+           block = *reinterpret_cast<uint8_t**>(block)) {
+        blocks.emplace_back(block, SizeClassBytes(size_class));
+      }
+      cached_blocks_[size_class] = nullptr;
+    }
+    released_bytes = cached_bytes_;
+    cached_bytes_ = 0;
+  }
+  if (blocks.empty()) {
+    return 0U;
+  }
+  // The blocks are still marked as cached, so nobody else touches them while we
+  // madvise them without holding the lock.
+  for (const auto& [block, size] : blocks) {
+    madvise(block, size, MADV_DONTNEED);
+    if (kIsDebugBuild) {
+      CheckedCall(mprotect, __FUNCTION__, block, size, PROT_READ);
+    }
+  }
+  MutexLock mu(self, lock_);
+  for (const auto& [block, size] : blocks) {
+    FreeLocked(GetAllocationInfoForAddress(reinterpret_cast<uintptr_t>(block)), size);
+  }
+  return released_bytes;
 }
 
 size_t FreeListSpace::AllocationSize(mirror::Object* obj, size_t* usable_size) {
@@ -532,10 +702,7 @@ size_t FreeListSpace::AllocationSize(mirror::Object* obj, size_t* usable_size) {
   return alloc_size;
 }
 
-mirror::Object* FreeListSpace::Alloc(Thread* self, size_t num_bytes, size_t* bytes_allocated,
-                                     size_t* usable_size, size_t* bytes_tl_bulk_allocated) {
-  MutexLock mu(self, lock_);
-  const size_t allocation_size = RoundUp(num_bytes, ObjectAlignment());
+mirror::Object* FreeListSpace::AllocLocked(size_t allocation_size) {
   AllocationInfo temp_info;
   temp_info.SetPrevFreeBytes(allocation_size);
   temp_info.SetByteSize(0, false);
@@ -566,18 +733,6 @@ mirror::Object* FreeListSpace::Alloc(Thread* self, size_t num_bytes, size_t* byt
       return nullptr;
     }
   }
-  DCHECK(bytes_allocated != nullptr);
-  *bytes_allocated = allocation_size;
-  if (usable_size != nullptr) {
-    *usable_size = allocation_size;
-  }
-  DCHECK(bytes_tl_bulk_allocated != nullptr);
-  *bytes_tl_bulk_allocated = allocation_size;
-  // Need to do these inside of the lock.
-  ++num_objects_allocated_;
-  ++total_objects_allocated_;
-  num_bytes_allocated_ += allocation_size;
-  total_bytes_allocated_ += allocation_size;
   mirror::Object* obj = reinterpret_cast<mirror::Object*>(GetAddressForAllocationInfo(new_info));
   // We always put our object at the start of the free block, there cannot be another free block
   // before it.
@@ -589,6 +744,163 @@ mirror::Object* FreeListSpace::Alloc(Thread* self, size_t num_bytes, size_t* byt
   return obj;
 }
 
+mirror::Object* FreeListSpace::Alloc(Thread* self, size_t num_bytes, size_t* bytes_allocated,
+                                     size_t* usable_size, size_t* bytes_tl_bulk_allocated) {
+  const size_t size_class = SizeClassIndex(num_bytes);
+  size_t allocation_size;
+  mirror::Object* obj;
+  if (size_class < kNumSizeClasses) {
+    allocation_size = SizeClassBytes(size_class);
+    obj = AllocThreadLocal(self, size_class);
+  } else {
+    allocation_size = RoundUp(num_bytes, ObjectAlignment());
+    MutexLock mu(self, lock_);
+    obj = AllocLocked(allocation_size);
+  }
+  if (UNLIKELY(obj == nullptr)) {
+    // The cached blocks may be fragmenting the space. Give them back to the
+    // free-list and retry once.
+    RevokeThreadLocalBuffers(self);
+    if (ReleaseCachedBlocks() == 0U) {
+      return nullptr;
+    }
+    MutexLock mu(self, lock_);
+    obj = AllocLocked(allocation_size);
+    if (obj == nullptr) {
+      return nullptr;
+    }
+  }
+  DCHECK(bytes_allocated != nullptr);
+  *bytes_allocated = allocation_size;
+  if (usable_size != nullptr) {
+    *usable_size = allocation_size;
+  }
+  DCHECK(bytes_tl_bulk_allocated != nullptr);
+  *bytes_tl_bulk_allocated = allocation_size;
+  num_objects_allocated_.fetch_add(1, std::memory_order_relaxed);
+  total_objects_allocated_.fetch_add(1, std::memory_order_relaxed);
+  num_bytes_allocated_.fetch_add(allocation_size, std::memory_order_relaxed);
+  total_bytes_allocated_.fetch_add(allocation_size, std::memory_order_relaxed);
+  return obj;
+}
+
+// Blocks of size-classed large objects reserved by a thread, which it can
+// allocate from without taking the space's lock. Only accessed by the owning
+// thread, or by others while it's suspended or exiting.
+class LargeObjectThreadLocalCache {
+ public:
+  // Size of the blocks reserved at a time for a size class.
+  static constexpr size_t kRefillBytes = 256 * KB;
+  static constexpr size_t kMaxBlocksPerSizeClass = 8;
+  // Set in the blocks taken from the space's cache, as they need to be zeroed before being
+  // handed out. The blocks are page aligned so the bit is available.
+  static constexpr uintptr_t kDirtyBlockTag = 1;
+
+  explicit LargeObjectThreadLocalCache(FreeListSpace* space) : space_(space), counts_() {}
+
+  FreeListSpace* const space_;
+  size_t counts_[LargeObjectSpace::kNumSizeClasses];
+  uintptr_t blocks_[LargeObjectSpace::kNumSizeClasses][kMaxBlocksPerSizeClass];
+};
+
+mirror::Object* FreeListSpace::AllocThreadLocal(Thread* self, size_t size_class) {
+  DCHECK_EQ(self, Thread::Current());
+  LargeObjectThreadLocalCache* cache =
+      reinterpret_cast<LargeObjectThreadLocalCache*>(self->GetLargeObjectCache());
+  if (UNLIKELY(cache == nullptr || cache->space_ != this)) {
+    // A cache of another space can only be left behind by a deleted space in tests.
+    delete cache;
+    cache = new LargeObjectThreadLocalCache(this);
+    self->SetLargeObjectCache(cache);
+  }
+  if (cache->counts_[size_class] == 0 && !RefillThreadLocalCache(self, cache, size_class)) {
+    return nullptr;
+  }
+  const size_t block_size = SizeClassBytes(size_class);
+  uintptr_t block = cache->blocks_[size_class][--cache->counts_[size_class]];
+  uint8_t* addr = reinterpret_cast<uint8_t*>(block & ~LargeObjectThreadLocalCache::kDirtyBlockTag);
+  if ((block & LargeObjectThreadLocalCache::kDirtyBlockTag) != 0) {
+    memset(addr, 0, block_size);
+  }
+  {
+    // Walk() and Dump() read the cached bit with the lock held.
+    MutexLock mu(self, lock_);
+    GetAllocationInfoForAddress(reinterpret_cast<uintptr_t>(addr))->SetCached(false);
+  }
+  return reinterpret_cast<mirror::Object*>(addr);
+}
+
+bool FreeListSpace::RefillThreadLocalCache(Thread* self,
+                                           LargeObjectThreadLocalCache* cache,
+                                           size_t size_class) {
+  DCHECK_EQ(cache->counts_[size_class], 0u);
+  const size_t block_size = SizeClassBytes(size_class);
+  const size_t count = std::clamp(LargeObjectThreadLocalCache::kRefillBytes / block_size,
+                                  static_cast<size_t>(1),
+                                  LargeObjectThreadLocalCache::kMaxBlocksPerSizeClass);
+  MutexLock mu(self, lock_);
+  size_t n = 0;
+  for (; n < count; ++n) {
+    uintptr_t block;
+    // Prefer the memory of freed objects as it's already faulted in.
+    if (cached_blocks_[size_class] != nullptr) {
+      uint8_t* addr = cached_blocks_[size_class];
+      cached_blocks_[size_class] = *reinterpret_cast<uint8_t**>(addr);
+      DCHECK_GE(cached_bytes_, block_size);
+      cached_bytes_ -= block_size;
+      block = reinterpret_cast<uintptr_t>(addr) | LargeObjectThreadLocalCache::kDirtyBlockTag;
+    } else {
+      mirror::Object* obj = AllocLocked(block_size);
+      if (obj == nullptr) {
+        break;
+      }
+      GetAllocationInfoForAddress(reinterpret_cast<uintptr_t>(obj))->SetCached(true);
+      block = reinterpret_cast<uintptr_t>(obj);
+    }
+    cache->blocks_[size_class][n] = block;
+  }
+  cache->counts_[size_class] = n;
+  return n > 0;
+}
+
+size_t FreeListSpace::RevokeThreadLocalBuffers(Thread* thread) {
+  LargeObjectThreadLocalCache* cache =
+      reinterpret_cast<LargeObjectThreadLocalCache*>(thread->GetLargeObjectCache());
+  if (cache == nullptr) {
+    return 0U;
+  }
+  bool release_cached_blocks = false;
+  if (cache->space_ == this) {
+    MutexLock mu(Thread::Current(), lock_);
+    for (size_t size_class = 0; size_class < kNumSizeClasses; ++size_class) {
+      for (size_t i = 0; i < cache->counts_[size_class]; ++i) {
+        uintptr_t block =
+            cache->blocks_[size_class][i] & ~LargeObjectThreadLocalCache::kDirtyBlockTag;
+        PushCachedBlockLocked(reinterpret_cast<uint8_t*>(block), size_class);
+      }
+    }
+    release_cached_blocks = cached_bytes_ > kMaxCachedBytes;
+  }
+  thread->SetLargeObjectCache(nullptr);
+  delete cache;
+  if (release_cached_blocks) {
+    ReleaseCachedBlocks();
+  }
+  // The reserved blocks aren't accounted as allocated, so there is nothing to
+  // report back to the heap.
+  return 0U;
+}
+
+size_t FreeListSpace::RevokeAllThreadLocalBuffers() {
+  Thread* self = Thread::Current();
+  MutexLock mu(self, *Locks::runtime_shutdown_lock_);
+  MutexLock mu2(self, *Locks::thread_list_lock_);
+  for (Thread* thread : Runtime::Current()->GetThreadList()->GetList()) {
+    RevokeThreadLocalBuffers(thread);
+  }
+  return 0U;
+}
+
 void FreeListSpace::Dump(std::ostream& os) const {
   MutexLock mu(Thread::Current(), lock_);
   os << GetName() << " -"
@@ -604,6 +916,9 @@ void FreeListSpace::Dump(std::ostream& os) const {
     if (cur_info->IsFree()) {
       os << "Free block at address: " << reinterpret_cast<const void*>(address)
          << " of length " << size << " bytes\n";
+    } else if (cur_info->IsCached()) {
+      os << "Cached block at address: " << reinterpret_cast<const void*>(address)
+         << " of length " << size << " bytes\n";
     } else {
       os << "Large object at address: " << reinterpret_cast<const void*>(address)
          << " of length " << size << " bytes\n";
@@ -628,7 +943,7 @@ void FreeListSpace::SetAllLargeObjectsAsZygoteObjects(Thread* self, bool set_mar
   for (AllocationInfo* cur_info = GetAllocationInfoForAddress(reinterpret_cast<uintptr_t>(Begin())),
       *end_info = GetAllocationInfoForAddress(free_end_start); cur_info < end_info;
       cur_info = cur_info->GetNextInfo()) {
-    if (!cur_info->IsFree()) {
+    if (!cur_info->IsFree() && !cur_info->IsCached()) {
       cur_info->SetZygoteObject();
       if (set_mark_bit) {
         ObjPtr<mirror::Object> obj =
@@ -24,6 +24,7 @@
 #include "space.h"
 #include "thread-current-inl.h"
 
+#include <atomic>
 #include <set>
 #include <vector>
 
@@ -32,6 +33,7 @@ namespace gc {
 namespace space {
 
 class AllocationInfo;
+class LargeObjectThreadLocalCache;
 
 enum class LargeObjectSpaceType {
   kDisabled,
@@ -51,29 +53,34 @@ class LargeObjectSpace : public DiscontinuousSpace, public AllocSpace {
   virtual ~LargeObjectSpace() {}
 
   uint64_t GetBytesAllocated() override {
-    MutexLock mu(Thread::Current(), lock_);
-    return num_bytes_allocated_;
+    return num_bytes_allocated_.load(std::memory_order_relaxed);
   }
   uint64_t GetObjectsAllocated() override {
-    MutexLock mu(Thread::Current(), lock_);
-    return num_objects_allocated_;
+    return num_objects_allocated_.load(std::memory_order_relaxed);
   }
   uint64_t GetTotalBytesAllocated() const {
-    MutexLock mu(Thread::Current(), lock_);
-    return total_bytes_allocated_;
+    return total_bytes_allocated_.load(std::memory_order_relaxed);
   }
   uint64_t GetTotalObjectsAllocated() const {
+    return total_objects_allocated_.load(std::memory_order_relaxed);
+  }
+  // Bytes held by freed large objects which are cached for reuse and haven't
+  // been released back to the OS yet.
+  size_t GetCachedBytes() const REQUIRES(!lock_) {
     MutexLock mu(Thread::Current(), lock_);
-    return total_objects_allocated_;
+    return cached_bytes_;
   }
   size_t FreeList(Thread* self, size_t num_ptrs, mirror::Object** ptrs) override;
-  // LargeObjectSpaces don't have thread local state.
+  // By default large object spaces don't have thread local state.
   size_t RevokeThreadLocalBuffers(art::Thread*) override {
     return 0U;
   }
   size_t RevokeAllThreadLocalBuffers() override {
     return 0U;
   }
+  // Release the memory of all the freed large objects which are cached for
+  // reuse back to the OS. Returns the number of bytes released.
+  virtual size_t ReleaseCachedBlocks() REQUIRES(!lock_) = 0;
   bool IsAllocSpace() const override {
     return true;
   }
@@ -128,6 +135,19 @@ class LargeObjectSpace : public DiscontinuousSpace, public AllocSpace {
   static constexpr size_t ObjectAlignment() { return kMinPageSize; }
 #endif
 
+  // Large objects up to this size are allocated in size classes so that their
+  // memory can be cached and reused once they are freed.
+  static constexpr size_t kMaxSizeClassBytes = 256 * KB;
+  static constexpr size_t kNumSizeClasses = 12;
+  // Cached memory is released back to the OS in one batch when it grows
+  // beyond this size, or when the heap is trimmed.
+  static constexpr size_t kMaxCachedBytes = 8 * MB;
+  // Returns the index of the smallest size class that fits 'num_bytes', or
+  // kNumSizeClasses if the allocation is too large to be size-classed.
+  static size_t SizeClassIndex(size_t num_bytes);
+  // Returns the allocation size of the given size class.
+  static size_t SizeClassBytes(size_t size_class);
+
  protected:
   explicit LargeObjectSpace(const std::string& name, uint8_t* begin, uint8_t* end,
                             const char* lock_name);
@@ -141,13 +161,17 @@ class LargeObjectSpace : public DiscontinuousSpace, public AllocSpace {
   // included in the identically named field in Heap. Counts actual allocated (after rounding),
   // not requested, sizes. TODO: It would be cheaper to just maintain total allocated and total
   // free counts.
-  uint64_t num_bytes_allocated_ GUARDED_BY(lock_);
-  uint64_t num_objects_allocated_ GUARDED_BY(lock_);
+  // The counters are atomic as thread-local allocations update them without holding lock_.
+  std::atomic<uint64_t> num_bytes_allocated_;
+  std::atomic<uint64_t> num_objects_allocated_;
 
   // Totals for large objects ever allocated, including those that have since been deallocated.
   // Never decremented.
-  uint64_t total_bytes_allocated_ GUARDED_BY(lock_);
-  uint64_t total_objects_allocated_ GUARDED_BY(lock_);
+  std::atomic<uint64_t> total_bytes_allocated_;
+  std::atomic<uint64_t> total_objects_allocated_;
+
+  // Bytes held by freed large objects cached for reuse.
+  size_t cached_bytes_ GUARDED_BY(lock_);
 
   // Begin and end, may change as more large objects are allocated.
   uint8_t* begin_;
@@ -177,13 +201,15 @@ class LargeObjectMapSpace : public LargeObjectSpace {
   void ForEachMemMap(std::function<void(const MemMap&)> func) const override REQUIRES(!lock_);
   std::pair<uint8_t*, uint8_t*> GetBeginEndAtomic() const override REQUIRES(!lock_);
   void ClampGrowthLimit(size_t capacity ATTRIBUTE_UNUSED) override {}
+  // Unmaps the cached mappings of freed large objects.
+  size_t ReleaseCachedBlocks() override REQUIRES(!lock_);
 
  protected:
   struct LargeObject {
     MemMap mem_map;
     bool is_zygote;
   };
-  explicit LargeObjectMapSpace(const std::string& name);
+  LargeObjectMapSpace(const std::string& name, bool cache_freed_maps);
   virtual ~LargeObjectMapSpace() {}
 
   bool IsZygoteLargeObject(Thread* self, mirror::Object* obj) const override REQUIRES(!lock_);
@@ -193,6 +219,11 @@ class LargeObjectMapSpace : public LargeObjectSpace {
 
   AllocationTrackingSafeMap<mirror::Object*, LargeObject, kAllocatorTagLOSMaps> large_objects_
       GUARDED_BY(lock_);
+  // Mappings of freed size-classed large objects, kept to avoid an mmap/munmap
+  // pair for every such allocation.
+  std::vector<MemMap> cached_maps_[kNumSizeClasses] GUARDED_BY(lock_);
+  // False if the mappings shouldn't be reused, like when running on a memory tool.
+  const bool cache_freed_maps_;
 };
 
 // A continuous large object space with a free-list to handle holes.
@@ -211,6 +242,12 @@ class FreeListSpace final : public LargeObjectSpace {
   void ForEachMemMap(std::function<void(const MemMap&)> func) const override REQUIRES(!lock_);
   std::pair<uint8_t*, uint8_t*> GetBeginEndAtomic() const override REQUIRES(!lock_);
   void ClampGrowthLimit(size_t capacity) override REQUIRES(!lock_);
+  // Returns the blocks reserved by the thread to the space's cache.
+  size_t RevokeThreadLocalBuffers(Thread* thread) override REQUIRES(!lock_);
+  size_t RevokeAllThreadLocalBuffers() override
+      REQUIRES(!Locks::runtime_shutdown_lock_, !Locks::thread_list_lock_, !lock_);
+  // Madvises the cached blocks of freed large objects and returns them to the free-list.
+  size_t ReleaseCachedBlocks() override REQUIRES(!lock_);
 
  protected:
   FreeListSpace(const std::string& name, MemMap&& mem_map, uint8_t* begin, uint8_t* end);
@@ -229,6 +266,18 @@ class FreeListSpace final : public LargeObjectSpace {
   }
   // Removes header from the free blocks set by finding the corresponding iterator and erasing it.
   void RemoveFreePrev(AllocationInfo* info) REQUIRES(lock_);
+  // Allocates a block of 'allocation_size' bytes from the free-list. Doesn't update the counters.
+  mirror::Object* AllocLocked(size_t allocation_size) REQUIRES(lock_);
+  // Returns the block to the free-list, coalescing it with the neighboring free blocks.
+  void FreeLocked(AllocationInfo* info, size_t allocation_size) REQUIRES(lock_);
+  // Allocates a block of the given size class from the thread's cache, refilling it if required.
+  mirror::Object* AllocThreadLocal(Thread* self, size_t size_class) REQUIRES(!lock_);
+  // Reserves a batch of blocks of the given size class for the thread's cache. Returns false if
+  // no block could be reserved.
+  bool RefillThreadLocalCache(Thread* self, LargeObjectThreadLocalCache* cache, size_t size_class)
+      REQUIRES(!lock_);
+  // Adds the block, which must be marked as cached, to the list of its size class.
+  void PushCachedBlockLocked(uint8_t* block, size_t size_class) REQUIRES(lock_);
   bool IsZygoteLargeObject(Thread* self, mirror::Object* obj) const override;
   void SetAllLargeObjectsAsZygoteObjects(Thread* self, bool set_mark_bit) override
       REQUIRES(!lock_)
@@ -252,6 +301,9 @@ class FreeListSpace final : public LargeObjectSpace {
   // Free bytes at the end of the space.
   size_t free_end_ GUARDED_BY(lock_);
   FreeBlocks free_blocks_ GUARDED_BY(lock_);
+  // Singly-linked lists, one per size class, of freed blocks cached for reuse. The link to the
+  // next block is stored in the first word of the block.
+  uint8_t* cached_blocks_[kNumSizeClasses] GUARDED_BY(lock_);
 };
 
 }  // namespace space
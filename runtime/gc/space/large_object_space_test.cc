@@ -16,6 +16,10 @@
 
 #include "large_object_space.h"
 
+#include <iostream>
+#include <memory>
+
+#include "base/histogram-inl.h"
 #include "base/time_utils.h"
 #include "space_test.h"
 
@@ -30,6 +34,9 @@ class LargeObjectSpaceTest : public SpaceTest<CommonRuntimeTest> {
   static constexpr size_t kNumThreads = 10;
   static constexpr size_t kNumIterations = 1000;
   void RaceTest();
+
+  void SizeClassTest();
+  void AllocFreeBenchmark();
 };
 
 
@@ -175,6 +182,110 @@ void LargeObjectSpaceTest::RaceTest() {
   }
 }
 
+static LargeObjectSpace* CreateLargeObjectSpace(size_t los_type) {
+  if (los_type == 0) {
+    return space::LargeObjectMapSpace::Create("large object space");
+  } else {
+    return space::FreeListSpace::Create("large object space", 128 * MB);
+  }
+}
+
+void LargeObjectSpaceTest::SizeClassTest() {
+  Thread* const self = Thread::Current();
+  for (size_t los_type = 0; los_type < 2; ++los_type) {
+    LargeObjectSpace* los = CreateLargeObjectSpace(los_type);
+    const size_t request_size = 20 * KB;
+    const size_t size_class = LargeObjectSpace::SizeClassIndex(request_size);
+    ASSERT_LT(size_class, LargeObjectSpace::kNumSizeClasses);
+    const size_t class_size = LargeObjectSpace::SizeClassBytes(size_class);
+    ASSERT_GE(class_size, request_size);
+
+    size_t allocation_size, bytes_tl_bulk_allocated;
+    mirror::Object* obj = los->Alloc(self, request_size, &allocation_size, nullptr,
+                                     &bytes_tl_bulk_allocated);
+    ASSERT_TRUE(obj != nullptr);
+    ASSERT_EQ(allocation_size, class_size);
+    ASSERT_EQ(allocation_size, los->AllocationSize(obj, nullptr));
+    memset(obj, 0xff, allocation_size);
+    ASSERT_EQ(los->Free(self, obj), allocation_size);
+    // The freed memory is cached for the next allocation of the size class.
+    EXPECT_GE(los->GetCachedBytes(), class_size);
+    EXPECT_EQ(0U, los->GetBytesAllocated());
+
+    // The requested bytes of allocations reusing the cached memory must be
+    // zeroed. Allocate enough objects to drain the thread-local cache, if any.
+    std::vector<mirror::Object*> objs;
+    for (size_t i = 0; i < 16; ++i) {
+      obj = los->Alloc(self, request_size, &allocation_size, nullptr, &bytes_tl_bulk_allocated);
+      ASSERT_TRUE(obj != nullptr);
+      ASSERT_EQ(allocation_size, class_size);
+      for (size_t k = 0; k < request_size; ++k) {
+        ASSERT_EQ(reinterpret_cast<const uint8_t*>(obj)[k], 0u);
+      }
+      memset(obj, 0xff, allocation_size);
+      objs.push_back(obj);
+    }
+    EXPECT_EQ(16 * class_size, los->GetBytesAllocated());
+    EXPECT_EQ(16U, los->GetObjectsAllocated());
+    for (mirror::Object* o : objs) {
+      los->Free(self, o);
+    }
+    EXPECT_EQ(0U, los->GetBytesAllocated());
+    EXPECT_EQ(0U, los->GetObjectsAllocated());
+
+    los->RevokeThreadLocalBuffers(self);
+    EXPECT_GT(los->ReleaseCachedBlocks(), 0U);
+    EXPECT_EQ(0U, los->GetCachedBytes());
+    delete los;
+  }
+}
+
+// Churns through the medium-sized buffers which dominate large-object
+// allocations in practice, reusing freed memory across size classes, and
+// reports the cost of an allocation and free of such a buffer.
+void LargeObjectSpaceTest::AllocFreeBenchmark() {
+  static constexpr size_t kIterations = 20000;
+  static constexpr size_t kIterationsPerSample = 1000;
+  static constexpr size_t kLiveObjects = 16;
+  static constexpr size_t kRequestSizes[] = {
+      12 * KB, 20 * KB, 33 * KB, 64 * KB, 100 * KB, 256 * KB};
+  Thread* const self = Thread::Current();
+  for (size_t los_type = 0; los_type < 2; ++los_type) {
+    LargeObjectSpace* los = CreateLargeObjectSpace(los_type);
+    std::unique_ptr<Histogram<uint64_t>> hist(new Histogram<uint64_t>(
+        los_type == 0 ? "LargeObjectMapSpaceAllocFree" : "FreeListSpaceAllocFree", 5));
+    std::vector<mirror::Object*> objs(kLiveObjects, nullptr);
+    uint64_t last_time = NanoTime();
+    for (size_t i = 0; i < kIterations; ++i) {
+      mirror::Object*& slot = objs[i % kLiveObjects];
+      if (slot != nullptr) {
+        los->Free(self, slot);
+      }
+      size_t allocation_size, bytes_tl_bulk_allocated;
+      slot = los->Alloc(self, kRequestSizes[i % arraysize(kRequestSizes)], &allocation_size,
+                        nullptr, &bytes_tl_bulk_allocated);
+      ASSERT_TRUE(slot != nullptr);
+      ASSERT_EQ(reinterpret_cast<uint8_t*>(slot)[0], 0u);
+      // Touch the object like the allocator's caller would.
+      reinterpret_cast<uint8_t*>(slot)[0] = 1;
+      if ((i + 1) % kIterationsPerSample == 0) {
+        // Nanoseconds per allocation and free.
+        uint64_t cur_time = NanoTime();
+        hist->AddValue((cur_time - last_time) / kIterationsPerSample);
+        last_time = cur_time;
+      }
+    }
+    Histogram<uint64_t>::CumulativeData data;
+    hist->CreateHistogram(&data);
+    hist->PrintConfidenceIntervals(std::cout, 0.99, data);
+    for (mirror::Object* obj : objs) {
+      los->Free(self, obj);
+    }
+    EXPECT_EQ(0U, los->GetBytesAllocated());
+    delete los;
+  }
+}
+
 TEST_F(LargeObjectSpaceTest, LargeObjectTest) {
   LargeObjectTest();
 }
@@ -183,6 +294,14 @@ TEST_F(LargeObjectSpaceTest, RaceTest) {
   RaceTest();
 }
 
+TEST_F(LargeObjectSpaceTest, SizeClassTest) {
+  SizeClassTest();
+}
+
+TEST_F(LargeObjectSpaceTest, AllocFreeBenchmark) {
+  AllocFreeBenchmark();
+}
+
 }  // namespace space
 }  // namespace gc
 }  // namespace art
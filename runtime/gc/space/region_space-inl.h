@@ -49,36 +49,38 @@ template<bool kForEvac>
 inline mirror::Object* RegionSpace::AllocNonvirtual(size_t num_bytes,
                                                     /* out */ size_t* bytes_allocated,
                                                     /* out */ size_t* usable_size,
-                                                    /* out */ size_t* bytes_tl_bulk_allocated) {
+                                                    /* out */ size_t* bytes_tl_bulk_allocated,
+                                                    size_t evac_node) {
   DCHECK_ALIGNED(num_bytes, kAlignment);
+  DCHECK_LT(evac_node, num_numa_nodes_);
   mirror::Object* obj;
   if (LIKELY(num_bytes <= kRegionSize)) {
     // Non-large object.
-    obj = (kForEvac ? evac_region_ : current_region_)->Alloc(num_bytes,
-                                                             bytes_allocated,
-                                                             usable_size,
-                                                             bytes_tl_bulk_allocated);
+    obj = (kForEvac ? evac_regions_[evac_node] : current_region_)->Alloc(num_bytes,
+                                                                         bytes_allocated,
+                                                                         usable_size,
+                                                                         bytes_tl_bulk_allocated);
     if (LIKELY(obj != nullptr)) {
       return obj;
     }
     MutexLock mu(Thread::Current(), region_lock_);
     // Retry with current region since another thread may have updated
-    // current_region_ or evac_region_.  TODO: fix race.
-    obj = (kForEvac ? evac_region_ : current_region_)->Alloc(num_bytes,
-                                                             bytes_allocated,
-                                                             usable_size,
-                                                             bytes_tl_bulk_allocated);
+    // current_region_ or evac_regions_.  TODO: fix race.
+    obj = (kForEvac ? evac_regions_[evac_node] : current_region_)->Alloc(num_bytes,
+                                                                         bytes_allocated,
+                                                                         usable_size,
+                                                                         bytes_tl_bulk_allocated);
     if (LIKELY(obj != nullptr)) {
       return obj;
     }
-    Region* r = AllocateRegion(kForEvac);
+    Region* r = AllocateRegion(kForEvac, kForEvac ? evac_node : GetCurrentNumaNode());
     if (LIKELY(r != nullptr)) {
       obj = r->Alloc(num_bytes, bytes_allocated, usable_size, bytes_tl_bulk_allocated);
       CHECK(obj != nullptr);
       // Do our allocation before setting the region, this makes sure no threads race ahead
       // and fill in the region before we allocate the object. b/63153464
       if (kForEvac) {
-        evac_region_ = r;
+        evac_regions_[evac_node] = r;
       } else {
         current_region_ = r;
       }
@@ -15,6 +15,16 @@
  */
 #include <deque>
 
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "android-base/file.h"
+#include "android-base/parseint.h"
+#include "android-base/strings.h"
+
 #include "bump_pointer_space-inl.h"
 #include "bump_pointer_space.h"
 #include "base/dumpable.h"
@@ -94,12 +104,35 @@ MemMap RegionSpace::CreateMemMap(const std::string& name,
   return mem_map;
 }
 
-RegionSpace* RegionSpace::Create(
-    const std::string& name, MemMap&& mem_map, bool use_generational_cc) {
-  return new RegionSpace(name, std::move(mem_map), use_generational_cc);
+// Returns the number of possible NUMA nodes as listed by sysfs, or 1 if unknown.
+static size_t GetNumaNodeCount() {
+  std::string possible;
+  if (!android::base::ReadFileToString("/sys/devices/system/node/possible", &possible)) {
+    return 1u;
+  }
+  // The format is a list of ranges, e.g. "0" or "0-3". The last number is the highest node.
+  possible = android::base::Trim(possible);
+  size_t pos = possible.find_last_of(",-");
+  std::string last = pos == std::string::npos ? possible : possible.substr(pos + 1);
+  size_t max_node;
+  if (!android::base::ParseUint(last, &max_node)) {
+    return 1u;
+  }
+  return max_node + 1;
 }
 
-RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_generational_cc)
+RegionSpace* RegionSpace::Create(const std::string& name,
+                                 MemMap&& mem_map,
+                                 bool use_generational_cc,
+                                 bool numa_aware) {
+  return new RegionSpace(
+      name, std::move(mem_map), use_generational_cc, numa_aware ? GetNumaNodeCount() : 1u);
+}
+
+RegionSpace::RegionSpace(const std::string& name,
+                         MemMap&& mem_map,
+                         bool use_generational_cc,
+                         size_t num_numa_nodes)
     : ContinuousMemMapAllocSpace(name,
                                  std::move(mem_map),
                                  mem_map.Begin(),
@@ -115,8 +148,9 @@ RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_gen
       num_evac_regions_(0U),
       max_peak_num_non_free_regions_(0U),
       non_free_region_index_limit_(0U),
+      num_numa_nodes_(1U),
+      regions_per_numa_node_(num_regions_),
       current_region_(&full_region_),
-      evac_region_(nullptr),
       cyclic_alloc_region_index_(0U) {
   CHECK_ALIGNED(mem_map_.Size(), kRegionSize);
   CHECK_ALIGNED(mem_map_.Begin(), kRegionSize);
@@ -126,6 +160,8 @@ RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_gen
   for (size_t i = 0; i < num_regions_; ++i, region_addr += kRegionSize) {
     regions_[i].Init(i, region_addr, region_addr + kRegionSize);
   }
+  std::fill_n(evac_regions_, kMaxNumaNodes, nullptr);
+  InitNumaNodes(num_numa_nodes);
   mark_bitmap_ =
       accounting::ContinuousSpaceBitmap::Create("region space live bitmap", Begin(), Capacity());
   if (kIsDebugBuild) {
@@ -147,6 +183,52 @@ RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_gen
   Protect();
 }
 
+void RegionSpace::InitNumaNodes(size_t num_nodes) {
+  num_nodes = std::min(num_nodes, kMaxNumaNodes);
+  // Each pool should have a reasonable number of regions.
+  static constexpr size_t kMinRegionsPerNumaNode = 16;
+  if (num_nodes <= 1 || num_regions_ / num_nodes < kMinRegionsPerNumaNode) {
+    VLOG(heap) << "NUMA-aware region allocation disabled, NUMA nodes: " << num_nodes;
+    return;
+  }
+  num_numa_nodes_ = num_nodes;
+  regions_per_numa_node_ = RoundUp(num_regions_, num_nodes) / num_nodes;
+#if defined(__linux__)
+  // Prefer the memory of a pool to be on its node. Pages are backed lazily, so this takes effect
+  // as regions get used, including after they are released by Region::Clear().
+  for (size_t node = 0; node < num_numa_nodes_; ++node) {
+    uint8_t* begin = regions_[NumaNodeRegionBegin(node)].Begin();
+    size_t length = (NumaNodeRegionBegin(node + 1) - NumaNodeRegionBegin(node)) * kRegionSize;
+    unsigned long node_mask = 1UL << node;  // NOLINT(runtime/int)
+    if (syscall(__NR_mbind,
+                begin,
+                length,
+                MPOL_PREFERRED,
+                &node_mask,
+                kMaxNumaNodes + 1,
+                /*flags=*/ 0) != 0) {
+      PLOG(WARNING) << "Failed to bind the regions of NUMA node " << node;
+    }
+  }
+#endif
+  VLOG(heap) << "NUMA-aware region allocation with " << num_numa_nodes_ << " nodes, "
+             << regions_per_numa_node_ << " regions per node";
+}
+
+size_t RegionSpace::GetCurrentNumaNode() const {
+  if (num_numa_nodes_ == 1) {
+    return 0u;
+  }
+#if defined(__linux__)
+  unsigned int cpu;
+  unsigned int node;
+  if (syscall(__NR_getcpu, &cpu, &node, /*tcache=*/ nullptr) == 0) {
+    return node % num_numa_nodes_;
+  }
+#endif
+  return 0u;
+}
+
 size_t RegionSpace::FromSpaceSize() {
   uint64_t num_regions = 0;
   MutexLock mu(Thread::Current(), region_lock_);
@@ -390,7 +472,7 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
   }
   DCHECK_EQ(num_expected_large_tails, 0U);
   current_region_ = &full_region_;
-  evac_region_ = &full_region_;
+  std::fill_n(evac_regions_, num_numa_nodes_, &full_region_);
 }
 
 static void ZeroAndProtectRegion(uint8_t* begin, uint8_t* end, bool release_eagerly) {
@@ -626,7 +708,7 @@ void RegionSpace::ClearFromSpace(/* out */ uint64_t* cleared_bytes,
   }
   // Update non_free_region_index_limit_.
   SetNonFreeRegionLimit(new_non_free_region_index_limit);
-  evac_region_ = nullptr;
+  std::fill_n(evac_regions_, num_numa_nodes_, nullptr);
   num_non_free_regions_ += num_evac_regions_;
   num_evac_regions_ = 0;
 }
@@ -786,7 +868,7 @@ void RegionSpace::Clear() {
   SetNonFreeRegionLimit(0);
   DCHECK_EQ(num_non_free_regions_, 0u);
   current_region_ = &full_region_;
-  evac_region_ = &full_region_;
+  std::fill_n(evac_regions_, num_numa_nodes_, &full_region_);
 }
 
 void RegionSpace::Protect() {
@@ -868,7 +950,10 @@ bool RegionSpace::AllocNewTlab(Thread* self,
     // Fetch the largest partial TLAB. The multimap is ordered in decreasing
     // size.
     auto largest_partial_tlab = partial_tlabs_.begin();
-    if (largest_partial_tlab != partial_tlabs_.end() && largest_partial_tlab->first >= tlab_size) {
+    if (largest_partial_tlab != partial_tlabs_.end() &&
+        largest_partial_tlab->first >= tlab_size &&
+        (num_numa_nodes_ == 1 ||
+         GetNumaNode(largest_partial_tlab->second->Begin()) == GetCurrentNumaNode())) {
       r = largest_partial_tlab->second;
       pos = r->End() - largest_partial_tlab->first;
       partial_tlabs_.erase(largest_partial_tlab);
@@ -879,8 +964,9 @@ bool RegionSpace::AllocNewTlab(Thread* self,
     }
   }
   if (r == nullptr) {
-    // Fallback to allocating an entire region as TLAB.
-    r = AllocateRegion(/*for_evac=*/ false);
+    // Fallback to allocating an entire region as TLAB, from the pool of the
+    // thread's NUMA node.
+    r = AllocateRegion(/*for_evac=*/ false, GetCurrentNumaNode());
   }
   if (r != nullptr) {
     uint8_t* start = pos != nullptr ? pos : r->Begin();
@@ -1038,18 +1124,22 @@ void RegionSpace::TraceHeapSize() {
   heap->TraceHeapSize(heap->GetBytesAllocated() + EvacBytes());
 }
 
-RegionSpace::Region* RegionSpace::AllocateRegion(bool for_evac) {
+RegionSpace::Region* RegionSpace::AllocateRegion(bool for_evac, size_t node) {
   if (!for_evac && (num_non_free_regions_ + 1) * 2 > num_regions_) {
     return nullptr;
   }
+  DCHECK_LT(node, num_numa_nodes_);
+  // With NUMA-aware allocation, search the pool of `node` first and then the
+  // pools of the other nodes.
+  const size_t first_region = NumaNodeRegionBegin(node);
   for (size_t i = 0; i < num_regions_; ++i) {
     // When using the cyclic region allocation strategy, try to
     // allocate a region starting from the last cyclic allocated
     // region marker. Otherwise, try to allocate a region starting
     // from the beginning of the region space.
-    size_t region_index = kCyclicRegionAllocation
+    size_t region_index = (kCyclicRegionAllocation && num_numa_nodes_ == 1)
         ? ((cyclic_alloc_region_index_ + i) % num_regions_)
-        : i;
+        : ((first_region + i) % num_regions_);
     Region* r = &regions_[region_index];
     if (r->IsFree()) {
       r->Unfree(this, time_);
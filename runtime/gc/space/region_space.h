@@ -43,6 +43,11 @@ namespace space {
 // only enable it in debug mode.
 static constexpr bool kCyclicRegionAllocation = kIsDebugBuild;
 
+// Maximum number of NUMA nodes the region space distinguishes when NUMA-aware
+// region allocation is enabled. Nodes beyond this limit share the pools of the
+// lower nodes.
+static constexpr size_t kMaxNumaNodes = 8;
+
 // A space that consists of equal-sized regions.
 class RegionSpace final : public ContinuousMemMapAllocSpace {
  public:
@@ -62,7 +67,13 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // guaranteed to be granted, if it is required, the caller should call Begin on the returned
   // space to confirm the request was granted.
   static MemMap CreateMemMap(const std::string& name, size_t capacity, uint8_t* requested_begin);
-  static RegionSpace* Create(const std::string& name, MemMap&& mem_map, bool use_generational_cc);
+  // If `numa_aware` is true and the machine has more than one NUMA node, the regions are split
+  // into one pool per node, TLABs are taken from the pool of the allocating thread's node, and
+  // objects are evacuated into regions of the node they were on.
+  static RegionSpace* Create(const std::string& name,
+                             MemMap&& mem_map,
+                             bool use_generational_cc,
+                             bool numa_aware = false);
 
   // Allocate `num_bytes`, returns null if the space is full.
   mirror::Object* Alloc(Thread* self,
@@ -78,13 +89,24 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
                                     /* out */ size_t* usable_size,
                                     /* out */ size_t* bytes_tl_bulk_allocated)
       override REQUIRES(Locks::mutator_lock_) REQUIRES(!region_lock_);
-  // The main allocation routine.
+  // The main allocation routine. Evacuation allocates from the pool of NUMA node `evac_node`.
   template<bool kForEvac>
   ALWAYS_INLINE mirror::Object* AllocNonvirtual(size_t num_bytes,
                                                 /* out */ size_t* bytes_allocated,
                                                 /* out */ size_t* usable_size,
-                                                /* out */ size_t* bytes_tl_bulk_allocated)
+                                                /* out */ size_t* bytes_tl_bulk_allocated,
+                                                size_t evac_node = 0)
       REQUIRES(!region_lock_);
+  // The NUMA node whose region pool contains `addr`. Always 0 if NUMA-aware region allocation
+  // is disabled.
+  size_t GetNumaNode(const void* addr) const {
+    if (num_numa_nodes_ == 1) {
+      return 0;
+    }
+    DCHECK(HasAddress(reinterpret_cast<const mirror::Object*>(addr)));
+    size_t offset = static_cast<size_t>(reinterpret_cast<const uint8_t*>(addr) - Begin());
+    return offset / kRegionSize / regions_per_numa_node_;
+  }
   // Allocate/free large objects (objects that are larger than the region size).
   template<bool kForEvac>
   mirror::Object* AllocLarge(size_t num_bytes,
@@ -322,6 +344,12 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     reg->AddLiveBytes(alloc_size);
   }
 
+  // Same as AddLiveBytes(), but may be called concurrently by parallel markers.
+  void AtomicAddLiveBytes(mirror::Object* ref, size_t alloc_size) {
+    Region* reg = RefToRegionUnlocked(ref);
+    reg->AtomicAddLiveBytes(alloc_size);
+  }
+
   void AssertAllRegionLiveBytesZeroOrCleared() REQUIRES(!region_lock_) {
     if (kIsDebugBuild) {
       MutexLock mu(Thread::Current(), region_lock_);
@@ -388,7 +416,11 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   void ReleaseFreeRegions();
 
  private:
-  RegionSpace(const std::string& name, MemMap&& mem_map, bool use_generational_cc);
+  // Split the regions into `num_numa_nodes` pools, if there are enough regions for that.
+  RegionSpace(const std::string& name,
+              MemMap&& mem_map,
+              bool use_generational_cc,
+              size_t num_numa_nodes);
 
   class Region {
    public:
@@ -568,6 +600,15 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
       DCHECK_LE(live_bytes_, BytesAllocated());
     }
 
+    void AtomicAddLiveBytes(size_t live_bytes) {
+      DCHECK(GetUseGenerationalCC() || IsInUnevacFromSpace());
+      DCHECK(!IsLargeTail());
+      // For large allocations, we always consider all bytes in the regions live.
+      size_t delta = IsLarge() ? Top() - begin_ : live_bytes;
+      reinterpret_cast<Atomic<size_t>*>(&live_bytes_)->fetch_add(delta,
+                                                                 std::memory_order_relaxed);
+    }
+
     bool AllAllocatedBytesAreLive() const {
       return LiveBytes() == static_cast<size_t>(Top() - Begin());
     }
@@ -715,7 +756,16 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     }
   }
 
-  EXPORT Region* AllocateRegion(bool for_evac) REQUIRES(region_lock_);
+  // Allocate a free region, preferably from the pool of NUMA node `node`.
+  EXPORT Region* AllocateRegion(bool for_evac, size_t node = 0) REQUIRES(region_lock_);
+  // Set up one region pool per NUMA node and bind the memory of each pool to its node.
+  void InitNumaNodes(size_t num_nodes);
+  // The NUMA node the calling thread is running on.
+  size_t GetCurrentNumaNode() const;
+  // Index of the first region of the pool of NUMA node `node`.
+  size_t NumaNodeRegionBegin(size_t node) const {
+    return std::min(node * regions_per_numa_node_, num_regions_);
+  }
   void RevokeThreadLocalBuffersLocked(Thread* thread, bool reuse) REQUIRES(region_lock_);
 
   // Scan region range [`begin`, `end`) in increasing order to try to
@@ -776,8 +826,15 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   //   for all `i >= non_free_region_index_limit_`, `regions_[i].IsFree()` is true.
   size_t non_free_region_index_limit_ GUARDED_BY(region_lock_);
 
+  // Number of NUMA nodes with their own region pool. 1 if NUMA-aware region
+  // allocation is disabled. The pool of node `n` consists of regions
+  // [n * regions_per_numa_node_, (n + 1) * regions_per_numa_node_).
+  size_t num_numa_nodes_;
+  size_t regions_per_numa_node_;
+
   Region* current_region_;         // The region currently used for allocation.
-  Region* evac_region_;            // The region currently used for evacuation.
+  // The regions currently used for evacuation, one per NUMA node.
+  Region* evac_regions_[kMaxNumaNodes];
   Region full_region_;             // The fake/sentinel region that looks full.
 
   // Index into the region array pointing to the starting region when
@@ -788,6 +845,8 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // Mark bitmap used by the GC.
   accounting::ContinuousSpaceBitmap mark_bitmap_;
 
+  friend class RegionSpaceTest;  // For creating spaces with a given number of NUMA nodes.
+
   DISALLOW_COPY_AND_ASSIGN(RegionSpace);
 };
 
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "region_space-inl.h"
+
+#include "space_test.h"
+
+namespace art HIDDEN {
+namespace gc {
+namespace space {
+
+class RegionSpaceTest : public SpaceTest<CommonRuntimeTest> {
+ public:
+  static constexpr size_t kNumRegions = 64;
+
+  std::unique_ptr<RegionSpace> CreateRegionSpace(size_t num_numa_nodes) {
+    MemMap mem_map = RegionSpace::CreateMemMap(
+        "region space", kNumRegions * RegionSpace::kRegionSize, /*requested_begin=*/ nullptr);
+    CHECK(mem_map.IsValid());
+    return std::unique_ptr<RegionSpace>(new RegionSpace(
+        "region space", std::move(mem_map), /*use_generational_cc=*/ false, num_numa_nodes));
+  }
+
+  static size_t GetNumNumaNodes(RegionSpace* space) {
+    return space->num_numa_nodes_;
+  }
+
+  // Returns the beginning of the allocated region, or null if no region is free.
+  static uint8_t* AllocateRegion(RegionSpace* space, size_t node) {
+    MutexLock mu(Thread::Current(), space->region_lock_);
+    RegionSpace::Region* region = space->AllocateRegion(/*for_evac=*/ false, node);
+    return region != nullptr ? region->Begin() : nullptr;
+  }
+};
+
+TEST_F(RegionSpaceTest, SingleNumaNode) {
+  std::unique_ptr<RegionSpace> space = CreateRegionSpace(/*num_numa_nodes=*/ 1);
+  EXPECT_EQ(GetNumNumaNodes(space.get()), 1u);
+  EXPECT_EQ(space->GetNumaNode(space->Begin()), 0u);
+  EXPECT_EQ(space->GetNumaNode(space->End() - 1), 0u);
+}
+
+TEST_F(RegionSpaceTest, TooFewRegionsPerNumaNode) {
+  // 64 regions are not enough for 8 pools, the space falls back to a single pool.
+  std::unique_ptr<RegionSpace> space = CreateRegionSpace(/*num_numa_nodes=*/ 8);
+  EXPECT_EQ(GetNumNumaNodes(space.get()), 1u);
+  EXPECT_EQ(space->GetNumaNode(space->End() - 1), 0u);
+}
+
+TEST_F(RegionSpaceTest, NumaNodePools) {
+  static constexpr size_t kNumNodes = 4;
+  static constexpr size_t kRegionsPerNode = kNumRegions / kNumNodes;
+  std::unique_ptr<RegionSpace> space = CreateRegionSpace(kNumNodes);
+  ASSERT_EQ(GetNumNumaNodes(space.get()), kNumNodes);
+  for (size_t node = 0; node < kNumNodes; ++node) {
+    uint8_t* pool_begin = space->Begin() + node * kRegionsPerNode * RegionSpace::kRegionSize;
+    EXPECT_EQ(space->GetNumaNode(pool_begin), node);
+    EXPECT_EQ(space->GetNumaNode(pool_begin + kRegionsPerNode * RegionSpace::kRegionSize - 1),
+              node);
+  }
+
+  // Regions come from the pool of the requested node until that pool is exhausted.
+  for (size_t node = 1; node < kNumNodes; node += 2) {
+    uint8_t* region = AllocateRegion(space.get(), node);
+    ASSERT_TRUE(region != nullptr);
+    EXPECT_EQ(space->GetNumaNode(region), node);
+  }
+  for (size_t i = 1; i < kRegionsPerNode; ++i) {
+    uint8_t* region = AllocateRegion(space.get(), kNumNodes - 1);
+    ASSERT_TRUE(region != nullptr);
+    EXPECT_EQ(space->GetNumaNode(region), kNumNodes - 1);
+  }
+  // The pool of the last node is full, the next region comes from another node.
+  uint8_t* region = AllocateRegion(space.get(), kNumNodes - 1);
+  ASSERT_TRUE(region != nullptr);
+  EXPECT_NE(space->GetNumaNode(region), kNumNodes - 1);
+}
+
+}  // namespace space
+}  // namespace gc
+}  // namespace art
@@ -1228,6 +1228,22 @@ void Instrumentation::UpdateMethodsCode(ArtMethod* method, const void* new_code)
   UpdateMethodsCodeImpl(method, new_code);
 }
 
+void Instrumentation::UpdateMethodsCode(
+    const std::vector<std::pair<ArtMethod*, const void*>>& updates) {
+  if (EntryExitStubsInstalled()) {
+    for (const auto& [method, new_code] : updates) {
+      UpdateMethodsCode(method, new_code);
+    }
+    return;
+  }
+  // Fast path: no instrumentation.
+  for (const auto& [method, new_code] : updates) {
+    DCHECK(method->GetDeclaringClass()->IsResolved());
+    DCHECK(!IsDeoptimized(method));
+    UpdateEntryPoints(method, new_code);
+  }
+}
+
 bool Instrumentation::AddDeoptimizedMethod(ArtMethod* method) {
   if (IsDeoptimizedMethod(method)) {
     // Already in the map. Return.
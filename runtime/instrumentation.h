@@ -25,6 +25,8 @@
 #include <optional>
 #include <queue>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "arch/instruction_set.h"
 #include "base/locks.h"
@@ -329,6 +331,10 @@ class Instrumentation {
   void UpdateMethodsCode(ArtMethod* method, const void* new_code)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Same as above for several methods, checking the installed stubs once.
+  void UpdateMethodsCode(const std::vector<std::pair<ArtMethod*, const void*>>& updates)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Update the code of a native method to a JITed stub.
   void UpdateNativeMethodsCodeToJitCode(ArtMethod* method, const void* new_code)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "allocation_site_sampler.h"
+
+#include "art_method-inl.h"
+#include "base/mutex.h"
+#include "callee_save_frame.h"
+#include "dex/dex_file_types.h"
+#include "entrypoints/entrypoint_utils.h"
+#include "gc_root-inl.h"
+#include "jit/jit_code_cache.h"
+#include "thread-inl.h"
+
+namespace art HIDDEN {
+namespace jit {
+
+AllocationSiteSampler::AllocationSiteSampler(JitCodeCache* code_cache)
+    : gc::SystemWeakHolder(kGenericBottomLock),
+      code_cache_(code_cache),
+      sample_counter_(0u) {}
+
+void AllocationSiteSampler::SampleAllocation(Thread* self, ObjPtr<mirror::Object> obj) {
+  if (obj == nullptr) {
+    // The allocation failed and an OutOfMemoryError is pending.
+    return;
+  }
+  ArtMethod** sp = self->GetManagedStack()->GetTopQuickFrame();
+  if (sp == nullptr) {
+    return;
+  }
+  uint32_t dex_pc = dex::kDexNoIndex;
+  ArtMethod* caller = GetCalleeSaveMethodCallerAndDexPc(sp, CalleeSaveType::kSaveRefsOnly, &dex_pc);
+  if (caller == nullptr || caller->IsRuntimeMethod() || dex_pc == dex::kDexNoIndex) {
+    return;
+  }
+
+  MutexLock mu(self, allow_disallow_lock_);
+  if ((!gUseReadBarrier && !allow_new_system_weak_) ||
+      (gUseReadBarrier && !self->GetWeakRefAccessEnabled())) {
+    // The GC is processing system weaks, drop the sample rather than waiting.
+    return;
+  }
+  if (samples_.size() >= kMaxSamples) {
+    return;
+  }
+  samples_.push_back(Sample{GcRoot<mirror::Object>(obj), caller, dex_pc});
+}
+
+void AllocationSiteSampler::Sweep(IsMarkedVisitor* visitor) {
+  Thread* self = Thread::Current();
+  std::vector<Sample> samples;
+  {
+    MutexLock mu(self, allow_disallow_lock_);
+    samples.swap(samples_);
+  }
+  if (samples.empty()) {
+    return;
+  }
+  // All samples are consumed by this GC: the ones that are still alive are
+  // now old objects and would not tell anything about the next GC.
+  MutexLock mu(self, *Locks::jit_lock_);
+  for (const Sample& sample : samples) {
+    mirror::Object* obj = sample.object.Read<kWithoutReadBarrier>();
+    bool survived = visitor->IsMarked(obj) != nullptr;
+    code_cache_->AddAllocationSiteSample(sample.method, sample.dex_pc, survived);
+  }
+}
+
+}  // namespace jit
+}  // namespace art
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_ALLOCATION_SITE_SAMPLER_H_
+#define ART_RUNTIME_JIT_ALLOCATION_SITE_SAMPLER_H_
+
+#include <vector>
+
+#include "base/atomic.h"
+#include "base/globals.h"
+#include "base/macros.h"
+#include "gc/system_weak.h"
+#include "gc_root.h"
+#include "obj_ptr.h"
+
+namespace art HIDDEN {
+
+class ArtMethod;
+class Thread;
+
+namespace mirror {
+class Object;
+}  // namespace mirror
+
+namespace jit {
+
+class JitCodeCache;
+
+// Samples objects allocated by compiled code and records, at the next GC,
+// whether they survived. The survival rates are accumulated per allocation
+// site in the `AllocationSiteCache`s of the allocating method's
+// `ProfilingInfo`, and are used by the compiler to pretenure long-lived sites.
+//
+// Samples are weak references swept with the other system weaks. Objects
+// allocated while the GC has disallowed new system weaks are not sampled, as
+// the GC would treat them as live regardless of their reachability.
+class AllocationSiteSampler : public gc::SystemWeakHolder {
+ public:
+  // Only one in `kSampleInterval` allocations that reach the runtime is sampled.
+  static constexpr uint32_t kSampleInterval = 16;
+  // Maximum number of objects tracked between two GCs.
+  static constexpr size_t kMaxSamples = 4 * KB;
+
+  explicit AllocationSiteSampler(JitCodeCache* code_cache);
+
+  // Maybe sample `obj`, which was just allocated by the allocation entrypoint
+  // whose caller is at the top of the quick stack of `self`.
+  ALWAYS_INLINE void MaybeSampleAllocation(Thread* self, ObjPtr<mirror::Object> obj)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (LIKELY(sample_counter_.fetch_add(1u, std::memory_order_relaxed) % kSampleInterval != 0u)) {
+      return;
+    }
+    SampleAllocation(self, obj);
+  }
+
+  void Sweep(IsMarkedVisitor* visitor) override REQUIRES_SHARED(Locks::mutator_lock_);
+
+ private:
+  struct Sample {
+    GcRoot<mirror::Object> object;
+    ArtMethod* method;
+    uint32_t dex_pc;
+  };
+
+  void SampleAllocation(Thread* self, ObjPtr<mirror::Object> obj)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  JitCodeCache* const code_cache_;
+  Atomic<uint32_t> sample_counter_;
+  std::vector<Sample> samples_ GUARDED_BY(allow_disallow_lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(AllocationSiteSampler);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_ALLOCATION_SITE_SAMPLER_H_
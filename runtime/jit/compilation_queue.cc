@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "compilation_queue.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <android-base/logging.h>
+
+namespace art HIDDEN {
+namespace jit {
+
+bool CompilationQueue::Add(ArtMethod* method, uint64_t now_ns) {
+  DCHECK(method != nullptr);
+  auto it = methods_.find(method);
+  if (it == methods_.end()) {
+    const uint64_t sequence_number = Push(method, /*priority=*/ 1u);
+    methods_.insert({ method, MethodState{ /*priority=*/ 1u, sequence_number, now_ns } });
+    ++num_queued_;
+    return true;
+  }
+  MethodState& state = it->second;
+  if (state.priority != kCompiling && state.priority != std::numeric_limits<uint32_t>::max()) {
+    ++state.priority;
+    state.sequence_number = Push(method, state.priority);
+    MaybeCompact();
+  }
+  return false;
+}
+
+ArtMethod* CompilationQueue::Pop(/*out*/ uint64_t* enqueue_time_ns) {
+  while (!heap_.empty()) {
+    std::pop_heap(heap_.begin(), heap_.end(), Colder);
+    HeapEntry entry = heap_.back();
+    heap_.pop_back();
+    if (IsStale(entry)) {
+      continue;
+    }
+    auto it = methods_.find(entry.method);
+    DCHECK(it != methods_.end());
+    it->second.priority = kCompiling;
+    *enqueue_time_ns = it->second.enqueue_time_ns;
+    DCHECK_NE(num_queued_, 0u);
+    --num_queued_;
+    return entry.method;
+  }
+  DCHECK_EQ(num_queued_, 0u);
+  return nullptr;
+}
+
+void CompilationQueue::Done(ArtMethod* method) {
+  auto it = methods_.find(method);
+  if (it != methods_.end()) {
+    DCHECK_EQ(it->second.priority, kCompiling);
+    methods_.erase(it);
+  }
+}
+
+void CompilationQueue::Clear() {
+  for (auto it = methods_.begin(); it != methods_.end();) {
+    if (it->second.priority != kCompiling) {
+      it = methods_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  heap_.clear();
+  num_queued_ = 0;
+}
+
+uint32_t CompilationQueue::GetPriority(ArtMethod* method) const {
+  auto it = methods_.find(method);
+  return it == methods_.end() ? 0u : it->second.priority;
+}
+
+uint64_t CompilationQueue::Push(ArtMethod* method, uint32_t priority) {
+  const uint64_t sequence_number = next_sequence_number_++;
+  heap_.push_back(HeapEntry{ method, priority, sequence_number });
+  std::push_heap(heap_.begin(), heap_.end(), Colder);
+  return sequence_number;
+}
+
+bool CompilationQueue::IsStale(const HeapEntry& entry) const {
+  auto it = methods_.find(entry.method);
+  return it == methods_.end() ||
+      it->second.priority == kCompiling ||
+      it->second.sequence_number != entry.sequence_number;
+}
+
+void CompilationQueue::MaybeCompact() {
+  if (heap_.size() <= 2 * num_queued_) {
+    return;
+  }
+  heap_.erase(std::remove_if(heap_.begin(),
+                             heap_.end(),
+                             [this](const HeapEntry& entry) { return IsStale(entry); }),
+              heap_.end());
+  DCHECK_EQ(heap_.size(), num_queued_);
+  std::make_heap(heap_.begin(), heap_.end(), Colder);
+}
+
+}  // namespace jit
+}  // namespace art
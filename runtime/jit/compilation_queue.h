@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_COMPILATION_QUEUE_H_
+#define ART_RUNTIME_JIT_COMPILATION_QUEUE_H_
+
+#include <stdint.h>
+
+#include <utility>
+#include <vector>
+
+#include "base/hash_map.h"
+#include "base/macros.h"
+
+namespace art HIDDEN {
+
+class ArtMethod;
+
+namespace jit {
+
+// Queue of the methods waiting for a compilation of a given kind, served hottest first.
+//
+// The hotness of a queued method is the number of times it was requested: the hotness counter
+// of a method is reset each time it reaches its threshold and requests a compilation, so a
+// method requested again while queued has been executing (or calling, or looping) since. Methods
+// requested as often are served in request order.
+//
+// Raising the priority of a queued method pushes a new entry in the heap and leaves the old one
+// behind, to be skipped when it reaches the top. The queue also remembers the methods it handed
+// out until they are done compiling, so that they are not queued again in the meantime.
+//
+// Not thread safe, the JitThreadPool guards its queues with its task queue lock.
+class CompilationQueue {
+ public:
+  CompilationQueue() : num_queued_(0), next_sequence_number_(0) {}
+
+  // Queue `method`, or raise its priority if it is already queued. Returns false if `method`
+  // was already queued or being compiled.
+  bool Add(ArtMethod* method, uint64_t now_ns);
+
+  // Remove the hottest method from the queue and return it, along with the time it was first
+  // queued at. Returns null if the queue is empty. The method is considered as being compiled
+  // until `Done` is called for it.
+  ArtMethod* Pop(/*out*/ uint64_t* enqueue_time_ns);
+
+  // Forget about `method` once its compilation is finished.
+  void Done(ArtMethod* method);
+
+  // Remove all the queued methods. Methods being compiled still need a call to `Done`.
+  void Clear();
+
+  // Number of queued methods.
+  size_t size() const {
+    return num_queued_;
+  }
+
+  bool empty() const {
+    return num_queued_ == 0;
+  }
+
+  // Current priority of `method`, or 0 if it isn't queued.
+  uint32_t GetPriority(ArtMethod* method) const;
+
+  // Visit the queued methods. Stale heap entries are not visited, as their method may have
+  // been unloaded since.
+  template <typename Visitor>
+  void VisitMethods(const Visitor& visitor) const {
+    for (const std::pair<ArtMethod*, MethodState>& entry : methods_) {
+      if (entry.second.priority != kCompiling) {
+        visitor(entry.first);
+      }
+    }
+  }
+
+ private:
+  // Priority recorded for methods that have been popped and are being compiled.
+  static constexpr uint32_t kCompiling = 0;
+
+  struct MethodState {
+    uint32_t priority;
+    // Sequence number of the heap entry with the current priority.
+    uint64_t sequence_number;
+    uint64_t enqueue_time_ns;
+  };
+
+  struct HeapEntry {
+    ArtMethod* method;
+    uint32_t priority;
+    uint64_t sequence_number;
+  };
+
+  // Orders the heap hottest first, then oldest first.
+  static bool Colder(const HeapEntry& lhs, const HeapEntry& rhs) {
+    return lhs.priority != rhs.priority
+        ? lhs.priority < rhs.priority
+        : lhs.sequence_number > rhs.sequence_number;
+  }
+
+  // Push a heap entry for `method` and return its sequence number.
+  uint64_t Push(ArtMethod* method, uint32_t priority);
+
+  // Whether `entry` was superseded by a later priority raise, or its method was popped.
+  bool IsStale(const HeapEntry& entry) const;
+
+  // Drop the stale entries once they outnumber the live ones.
+  void MaybeCompact();
+
+  std::vector<HeapEntry> heap_;
+  HashMap<ArtMethod*, MethodState> methods_;
+  size_t num_queued_;
+  uint64_t next_sequence_number_;
+
+  DISALLOW_COPY_AND_ASSIGN(CompilationQueue);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_COMPILATION_QUEUE_H_
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit/compilation_queue.h"
+
+#include <set>
+
+#include <gtest/gtest.h>
+
+namespace art HIDDEN {
+namespace jit {
+
+class CompilationQueueTest : public testing::Test {
+ protected:
+  // The queue never dereferences the methods, so fake ones are enough.
+  static ArtMethod* FakeMethod(size_t index) {
+    return reinterpret_cast<ArtMethod*>(static_cast<uintptr_t>(index + 1u) * 16u);
+  }
+
+  static ArtMethod* Pop(CompilationQueue& queue) {
+    uint64_t enqueue_time_ns = 0u;
+    return queue.Pop(&enqueue_time_ns);
+  }
+};
+
+TEST_F(CompilationQueueTest, RequestOrderForEqualPriorities) {
+  CompilationQueue queue;
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(Pop(queue), nullptr);
+  for (size_t i = 0; i < 10; ++i) {
+    EXPECT_TRUE(queue.Add(FakeMethod(i), /*now_ns=*/ i));
+  }
+  EXPECT_EQ(queue.size(), 10u);
+  for (size_t i = 0; i < 10; ++i) {
+    uint64_t enqueue_time_ns = 0u;
+    EXPECT_EQ(queue.Pop(&enqueue_time_ns), FakeMethod(i));
+    EXPECT_EQ(enqueue_time_ns, i);
+  }
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(Pop(queue), nullptr);
+}
+
+TEST_F(CompilationQueueTest, HottestFirst) {
+  CompilationQueue queue;
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_TRUE(queue.Add(FakeMethod(i), /*now_ns=*/ i));
+  }
+  // Request method 2 three more times and method 3 once more.
+  EXPECT_FALSE(queue.Add(FakeMethod(2), /*now_ns=*/ 10u));
+  EXPECT_FALSE(queue.Add(FakeMethod(3), /*now_ns=*/ 11u));
+  EXPECT_FALSE(queue.Add(FakeMethod(2), /*now_ns=*/ 12u));
+  EXPECT_FALSE(queue.Add(FakeMethod(2), /*now_ns=*/ 13u));
+  EXPECT_EQ(queue.size(), 4u);
+  EXPECT_EQ(queue.GetPriority(FakeMethod(0)), 1u);
+  EXPECT_EQ(queue.GetPriority(FakeMethod(2)), 4u);
+  EXPECT_EQ(queue.GetPriority(FakeMethod(3)), 2u);
+
+  uint64_t enqueue_time_ns = 0u;
+  EXPECT_EQ(queue.Pop(&enqueue_time_ns), FakeMethod(2));
+  // The latency is measured from the first request.
+  EXPECT_EQ(enqueue_time_ns, 2u);
+  EXPECT_EQ(Pop(queue), FakeMethod(3));
+  EXPECT_EQ(Pop(queue), FakeMethod(0));
+  EXPECT_EQ(Pop(queue), FakeMethod(1));
+  EXPECT_EQ(Pop(queue), nullptr);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(CompilationQueueTest, NoRequeueWhileCompiling) {
+  CompilationQueue queue;
+  EXPECT_TRUE(queue.Add(FakeMethod(0), /*now_ns=*/ 0u));
+  EXPECT_EQ(Pop(queue), FakeMethod(0));
+  // Requests for a method being compiled are dropped.
+  EXPECT_FALSE(queue.Add(FakeMethod(0), /*now_ns=*/ 1u));
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(Pop(queue), nullptr);
+
+  queue.Done(FakeMethod(0));
+  EXPECT_TRUE(queue.Add(FakeMethod(0), /*now_ns=*/ 2u));
+  EXPECT_EQ(queue.GetPriority(FakeMethod(0)), 1u);
+  EXPECT_EQ(Pop(queue), FakeMethod(0));
+  EXPECT_EQ(Pop(queue), nullptr);
+}
+
+TEST_F(CompilationQueueTest, StaleEntriesAfterRequeue) {
+  CompilationQueue queue;
+  // Leave stale entries for method 0 behind, then queue it again after it was compiled.
+  EXPECT_TRUE(queue.Add(FakeMethod(0), /*now_ns=*/ 0u));
+  EXPECT_FALSE(queue.Add(FakeMethod(0), /*now_ns=*/ 1u));
+  EXPECT_TRUE(queue.Add(FakeMethod(1), /*now_ns=*/ 2u));
+  EXPECT_EQ(Pop(queue), FakeMethod(0));
+  queue.Done(FakeMethod(0));
+  EXPECT_TRUE(queue.Add(FakeMethod(0), /*now_ns=*/ 3u));
+  EXPECT_EQ(queue.size(), 2u);
+  // The stale entry with priority 1 must not take the place of the new request.
+  EXPECT_EQ(Pop(queue), FakeMethod(1));
+  EXPECT_EQ(Pop(queue), FakeMethod(0));
+  EXPECT_EQ(Pop(queue), nullptr);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(CompilationQueueTest, Clear) {
+  CompilationQueue queue;
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_TRUE(queue.Add(FakeMethod(i), /*now_ns=*/ i));
+  }
+  EXPECT_EQ(Pop(queue), FakeMethod(0));
+  queue.Clear();
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(Pop(queue), nullptr);
+  // Methods being compiled are still known after a clear, the others can be queued again.
+  EXPECT_FALSE(queue.Add(FakeMethod(0), /*now_ns=*/ 3u));
+  EXPECT_TRUE(queue.Add(FakeMethod(1), /*now_ns=*/ 4u));
+  queue.Done(FakeMethod(0));
+  EXPECT_TRUE(queue.Add(FakeMethod(0), /*now_ns=*/ 5u));
+  EXPECT_EQ(Pop(queue), FakeMethod(1));
+  EXPECT_EQ(Pop(queue), FakeMethod(0));
+}
+
+TEST_F(CompilationQueueTest, ManyPriorityRaises) {
+  static constexpr size_t kNumMethods = 64;
+  CompilationQueue queue;
+  // Method `i` is requested `i + 1` times, interleaved so that the heap keeps compacting.
+  for (size_t round = 0; round < kNumMethods; ++round) {
+    for (size_t i = round; i < kNumMethods; ++i) {
+      EXPECT_EQ(queue.Add(FakeMethod(i), /*now_ns=*/ round), round == 0u);
+    }
+  }
+  EXPECT_EQ(queue.size(), kNumMethods);
+  std::set<ArtMethod*> visited;
+  queue.VisitMethods([&visited](ArtMethod* method) { visited.insert(method); });
+  EXPECT_EQ(visited.size(), kNumMethods);
+  for (size_t i = kNumMethods; i != 0u; --i) {
+    EXPECT_EQ(queue.GetPriority(FakeMethod(i - 1u)), i);
+    EXPECT_EQ(Pop(queue), FakeMethod(i - 1u));
+  }
+  EXPECT_EQ(Pop(queue), nullptr);
+}
+
+}  // namespace jit
+}  // namespace art
@@ -19,18 +19,27 @@
 #include <dlfcn.h>
 #include <sys/resource.h>
 
+#include <algorithm>
+#include <set>
+#include <thread>
+
+#include "allocation_site_sampler.h"
 #include "art_method-inl.h"
 #include "base/file_utils.h"
 #include "base/logging.h"  // For VLOG.
 #include "base/memfd.h"
 #include "base/memory_tool.h"
+#include "base/os.h"
 #include "base/pointer_size.h"
 #include "base/runtime_debug.h"
 #include "base/scoped_flock.h"
+#include "base/stl_util.h"
+#include "base/time_utils.h"
 #include "base/utils.h"
 #include "class_root-inl.h"
 #include "compilation_kind.h"
 #include "debugger.h"
+#include "dex/dex_file_loader.h"
 #include "dex/type_lookup_table.h"
 #include "entrypoints/entrypoint_utils-inl.h"
 #include "entrypoints/runtime_asm_entrypoints.h"
@@ -64,6 +73,11 @@ namespace jit {
 
 static constexpr bool kEnableOnStackReplacement = true;
 
+// Default sizing of the JIT thread pool: one compiler thread per `kCoresPerJitThread` cores, up
+// to `kMaxDefaultJitThreads`.
+static constexpr size_t kCoresPerJitThread = 4;
+static constexpr size_t kMaxDefaultJitThreads = 4;
+
 // JIT compiler
 JitCompilerInterface* Jit::jit_compiler_ = nullptr;
 
@@ -126,6 +140,12 @@ std::unique_ptr<Jit> Jit::Create(JitCodeCache* code_cache, JitOptions* options)
     }
   }
 
+  // Only moving collectors copy surviving objects, so there is nothing to gain
+  // from pretenuring with other collectors.
+  if (options->UseJitCompilation() && Runtime::Current()->GetHeap()->IsMovingGc()) {
+    jit->allocation_site_sampler_.reset(new AllocationSiteSampler(code_cache));
+  }
+
   // Notify native debugger about the classes already loaded before the creation of the jit.
   jit->DumpTypeInfoForLoadedTypes(Runtime::Current()->GetClassLinker());
 
@@ -134,9 +154,11 @@ std::unique_ptr<Jit> Jit::Create(JitCodeCache* code_cache, JitOptions* options)
 
 
 bool Jit::TryPatternMatch(ArtMethod* method_to_compile, CompilationKind compilation_kind) {
-  // Try to pattern match the method. Only on arm and arm64 for now as we have
+  // Try to pattern match the method. Only on arm, arm64 and x86-64 for now as we have
   // sufficiently similar calling convention between C++ and managed code.
-  if (kRuntimeISA == InstructionSet::kArm || kRuntimeISA == InstructionSet::kArm64) {
+  if (kRuntimeISA == InstructionSet::kArm ||
+      kRuntimeISA == InstructionSet::kArm64 ||
+      kRuntimeISA == InstructionSet::kX86_64) {
     if (!Runtime::Current()->IsJavaDebuggable() &&
         compilation_kind == CompilationKind::kBaseline &&
         !method_to_compile->StillNeedsClinitCheck()) {
@@ -947,6 +969,71 @@ class JitProfileTask final : public Task {
   DISALLOW_COPY_AND_ASSIGN(JitProfileTask);
 };
 
+// Whether `entry_point` runs the method without compiled code.
+static bool IsUncompiledEntryPoint(ClassLinker* class_linker, const void* entry_point) {
+  return class_linker->IsQuickToInterpreterBridge(entry_point) ||
+         class_linker->IsQuickGenericJniStub(entry_point) ||
+         class_linker->IsNterpEntryPoint(entry_point) ||
+         // We explicitly check for the resolution stub, and not the resolution trampoline.
+         // The trampoline is for methods backed by a .oat file that has a compiled version of
+         // the method.
+         (entry_point == GetQuickResolutionStub());
+}
+
+// Compiles the hot methods of an app profile, once the app has registered it with the profile
+// saver.
+class JitAppProfileTask final : public Task {
+ public:
+  JitAppProfileTask(const std::string& profile, const std::vector<std::string>& code_paths)
+      : profile_(profile), code_paths_(code_paths.begin(), code_paths.end()) {}
+
+  void Run(Thread* self) override {
+    // Read the profile before taking the mutator lock, so that the file I/O does not hold up
+    // the GC. The profile saver locks the file while it writes it.
+    ProfileCompilationInfo profile_info;
+    if (!profile_info.Load(profile_, /*clear_if_invalid=*/ false)) {
+      return;
+    }
+    ScopedObjectAccess soa(self);
+    VariableSizedHandleScope handles(self);
+    // The dex caches of the code paths.
+    std::vector<Handle<mirror::DexCache>> dex_caches;
+    ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+    {
+      ReaderMutexLock mu(self, *Locks::dex_lock_);
+      for (const auto& [dex_file, data] : class_linker->GetDexCachesData()) {
+        const std::string base_location = DexFileLoader::GetBaseLocation(dex_file->GetLocation());
+        if (!ContainsElement(code_paths_, base_location)) {
+          continue;
+        }
+        ObjPtr<mirror::DexCache> dex_cache =
+            ObjPtr<mirror::DexCache>::DownCast(self->DecodeJObject(data.weak_root));
+        if (dex_cache == nullptr || dex_cache->GetClassLoader() == nullptr) {
+          // Unloaded, or on the boot class path.
+          continue;
+        }
+        dex_caches.push_back(handles.NewHandle(dex_cache));
+      }
+    }
+    Jit* jit = Runtime::Current()->GetJit();
+    uint32_t added_to_queue = 0u;
+    for (Handle<mirror::DexCache> dex_cache : dex_caches) {
+      added_to_queue += jit->CompileHotMethodsFromProfile(self, profile_info, dex_cache);
+    }
+    VLOG(jit) << "Added " << added_to_queue << " hot methods from " << profile_ << " to the queue";
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  const std::string profile_;
+  const std::set<std::string> code_paths_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitAppProfileTask);
+};
+
 static void CopyIfDifferent(void* s1, const void* s2, size_t n) {
   if (memcmp(s1, s2, n) != 0) {
     memcpy(s1, s2, n);
@@ -1086,7 +1173,16 @@ void Jit::CreateThreadPool() {
   // There is a DCHECK in the 'AddSamples' method to ensure the tread pool
   // is not null when we instrument.
 
-  thread_pool_.reset(JitThreadPool::Create("Jit thread pool", 1));
+  size_t num_threads = options_->GetThreadPoolSize();
+  if (num_threads == 0) {
+    // One compiler thread per few cores. Workers are only woken up when the queues grow, see
+    // JitThreadPool::UpdateActiveWorkersLocked.
+    num_threads = std::clamp(static_cast<size_t>(std::thread::hardware_concurrency()) /
+                                 kCoresPerJitThread,
+                             static_cast<size_t>(1),
+                             kMaxDefaultJitThreads);
+  }
+  thread_pool_.reset(JitThreadPool::Create("Jit thread pool", num_threads));
 
   Runtime* runtime = Runtime::Current();
   thread_pool_->SetPthreadPriority(
@@ -1213,6 +1309,56 @@ void Jit::RegisterDexFiles(const std::vector<std::unique_ptr<const DexFile>>& de
   }
 }
 
+void Jit::CompileHotMethodsFromAppProfile(Thread* self,
+                                          const std::string& profile,
+                                          const std::vector<std::string>& code_paths) {
+  Runtime* runtime = Runtime::Current();
+  if (!options_->UseProfiledAppJitCompilation() ||
+      !UseJitCompilation() ||
+      runtime->IsZygote() ||
+      runtime->IsJavaDebuggable() ||
+      !OS::FileExists(profile.c_str())) {
+    return;
+  }
+  thread_pool_->AddTask(self, new JitAppProfileTask(profile, code_paths));
+}
+
+std::set<uint16_t> Jit::GetHotMethods(const ProfileCompilationInfo& profile_info,
+                                      const DexFile& dex_file) {
+  std::set<dex::TypeIndex> classes;
+  std::set<uint16_t> hot_methods;
+  std::set<uint16_t> startup_methods;
+  std::set<uint16_t> post_startup_methods;
+  profile_info.GetClassesAndMethods(
+      dex_file, &classes, &hot_methods, &startup_methods, &post_startup_methods);
+  return hot_methods;
+}
+
+uint32_t Jit::CompileHotMethodsFromProfile(Thread* self,
+                                           const ProfileCompilationInfo& profile_info,
+                                           Handle<mirror::DexCache> dex_cache) {
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  StackHandleScope<1> hs(self);
+  Handle<mirror::ClassLoader> class_loader = hs.NewHandle(dex_cache->GetClassLoader());
+  uint32_t added_to_queue = 0u;
+  for (uint16_t method_idx : GetHotMethods(profile_info, *dex_cache->GetDexFile())) {
+    ArtMethod* method = class_linker->ResolveMethodWithoutInvokeType(
+        method_idx, dex_cache, class_loader);
+    if (method == nullptr) {
+      self->ClearException();
+      continue;
+    }
+    if (!method->IsCompilable() || !method->IsInvokable() || method->IsPreCompiled()) {
+      continue;
+    }
+    if (IsUncompiledEntryPoint(class_linker, method->GetEntryPointFromQuickCompiledCode())) {
+      AddCompileTask(self, method, CompilationKind::kOptimized);
+      ++added_to_queue;
+    }
+  }
+  return added_to_queue;
+}
+
 void Jit::AddCompileTask(Thread* self,
                          ArtMethod* method,
                          CompilationKind compilation_kind) {
@@ -1240,14 +1386,7 @@ bool Jit::CompileMethodFromProfile(Thread* self,
     return false;
   }
   CompilationKind compilation_kind = CompilationKind::kOptimized;
-  const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
-  if (class_linker->IsQuickToInterpreterBridge(entry_point) ||
-      class_linker->IsQuickGenericJniStub(entry_point) ||
-      class_linker->IsNterpEntryPoint(entry_point) ||
-      // We explicitly check for the resolution stub, and not the resolution trampoline.
-      // The trampoline is for methods backed by a .oat file that has a compiled version of
-      // the method.
-      (entry_point == GetQuickResolutionStub())) {
+  if (IsUncompiledEntryPoint(class_linker, method->GetEntryPointFromQuickCompiledCode())) {
     VLOG(jit) << "JIT Zygote processing method " << ArtMethod::PrettyMethod(method)
               << " from profile";
     method->SetPreCompiled();
@@ -1668,6 +1807,23 @@ bool Jit::CanAssumeInitialized(ObjPtr<mirror::Class> cls, bool is_for_shared_reg
   }
 }
 
+bool Jit::CanCallThroughEntryPointTable(ArtMethod* method, bool is_for_shared_region) const {
+  if (!options_->UseEntryPointTable() ||
+      is_for_shared_region ||
+      Runtime::Current()->IsJavaDebuggable() ||
+      (kRuntimeISA != InstructionSet::kArm64 && kRuntimeISA != InstructionSet::kX86_64)) {
+    return false;
+  }
+  // Native and copied methods share their code or their dex method index with other methods.
+  // Boot image methods can get their entry point remapped by the zygote without going through
+  // `ArtMethod::SetEntryPointFromQuickCompiledCode()`, which keeps the slots up to date.
+  return !method->IsNative() &&
+         !method->IsCopied() &&
+         !method->IsObsolete() &&
+         !method->IsProxyMethod() &&
+         !method->GetDeclaringClass()->IsBootStrapClassLoaded();
+}
+
 void Jit::MaybeEnqueueCompilation(ArtMethod* method, Thread* self) {
   if (thread_pool_ == nullptr) {
     return;
@@ -1748,6 +1904,11 @@ size_t JitThreadPool::GetTaskCount(Thread* self) {
       osr_queue_.size();
 }
 
+size_t JitThreadPool::GetMaxActiveWorkers(Thread* self) {
+  MutexLock mu(self, task_queue_lock_);
+  return max_active_workers_;
+}
+
 void JitThreadPool::RemoveAllTasks(Thread* self) {
   // The ThreadPool is responsible for calling Finalize (which usually deletes
   // the task memory) on all the tasks.
@@ -1765,9 +1926,9 @@ void JitThreadPool::RemoveAllTasks(Thread* self) {
   } while (true);
 
   MutexLock mu(self, task_queue_lock_);
-  baseline_queue_.clear();
-  optimized_queue_.clear();
-  osr_queue_.clear();
+  baseline_queue_.Clear();
+  optimized_queue_.Clear();
+  osr_queue_.Clear();
 }
 
 JitThreadPool::~JitThreadPool() {
@@ -1775,6 +1936,30 @@ JitThreadPool::~JitThreadPool() {
   RemoveAllTasks(Thread::Current());
 }
 
+void JitThreadPool::UpdateActiveWorkersLocked(Thread* self) {
+  const size_t num_threads = GetThreadCount();
+  if (num_threads <= 1) {
+    return;
+  }
+  size_t active_workers;
+  Runtime* runtime = Runtime::Current();
+  if (runtime->IsZygote() || !runtime->InJankPerceptibleProcessState()) {
+    // Compilations are not urgent, don't compete with the app for the cores.
+    active_workers = 1;
+  } else {
+    const size_t pending = generic_queue_.size() +
+        osr_queue_.size() +
+        baseline_queue_.size() +
+        optimized_queue_.size();
+    active_workers = std::min(1 + pending / kPendingMethodsPerWorker, num_threads);
+  }
+  if (active_workers > max_active_workers_ && waiting_count_ != 0) {
+    // Wake up the workers that are now allowed to compile.
+    task_queue_condition_.Broadcast(self);
+  }
+  max_active_workers_ = active_workers;
+}
+
 void JitThreadPool::AddTask(Thread* self, Task* task) {
   MutexLock mu(self, task_queue_lock_);
   // We don't want to enqueue any new tasks when thread pool has stopped. This simplifies
@@ -1784,6 +1969,7 @@ void JitThreadPool::AddTask(Thread* self, Task* task) {
     return;
   }
   generic_queue_.push_back(task);
+  UpdateActiveWorkersLocked(self);
   // If we have any waiters, signal one.
   if (waiting_count_ != 0) {
     task_queue_condition_.Signal(self);
@@ -1797,29 +1983,11 @@ void JitThreadPool::AddTask(Thread* self, ArtMethod* method, CompilationKind kin
   if (!started_) {
     return;
   }
-  switch (kind) {
-    case CompilationKind::kOsr:
-      if (ContainsElement(osr_enqueued_methods_, method)) {
-        return;
-      }
-      osr_enqueued_methods_.insert(method);
-      osr_queue_.push_back(method);
-      break;
-    case CompilationKind::kBaseline:
-      if (ContainsElement(baseline_enqueued_methods_, method)) {
-        return;
-      }
-      baseline_enqueued_methods_.insert(method);
-      baseline_queue_.push_back(method);
-      break;
-    case CompilationKind::kOptimized:
-      if (ContainsElement(optimized_enqueued_methods_, method)) {
-        return;
-      }
-      optimized_enqueued_methods_.insert(method);
-      optimized_queue_.push_back(method);
-      break;
+  if (!GetQueue(kind).Add(method, NanoTime())) {
+    // Already enqueued, in which case its priority was raised, or being compiled.
+    return;
   }
+  UpdateActiveWorkersLocked(self);
   // If we have any waiters, signal one.
   if (waiting_count_ != 0) {
     task_queue_condition_.Signal(self);
@@ -1830,6 +1998,7 @@ Task* JitThreadPool::TryGetTaskLocked() {
   if (!started_) {
     return nullptr;
   }
+  UpdateActiveWorkersLocked(Thread::Current());
 
   // Fetch generic tasks first.
   if (!generic_queue_.empty()) {
@@ -1838,22 +2007,57 @@ Task* JitThreadPool::TryGetTaskLocked() {
     return task;
   }
 
-  // OSR requests second, then baseline and finally optimized.
+  // OSR requests second, then baseline and finally optimized. Optimized requests still get
+  // their turn every few baseline requests, so that a steady flow of baseline requests doesn't
+  // starve them.
   Task* task = FetchFrom(osr_queue_, CompilationKind::kOsr);
+  if (task == nullptr &&
+      consecutive_baseline_fetches_ >= kMaxConsecutiveBaselineFetches &&
+      CanStartOptimizedCompilation()) {
+    task = FetchFrom(optimized_queue_, CompilationKind::kOptimized);
+  }
   if (task == nullptr) {
     task = FetchFrom(baseline_queue_, CompilationKind::kBaseline);
-    if (task == nullptr) {
+    if (task == nullptr && CanStartOptimizedCompilation()) {
       task = FetchFrom(optimized_queue_, CompilationKind::kOptimized);
     }
   }
   return task;
 }
 
-Task* JitThreadPool::FetchFrom(std::deque<ArtMethod*>& methods, CompilationKind kind) {
-  if (!methods.empty()) {
-    ArtMethod* method = methods.front();
-    methods.pop_front();
-    JitCompileTask* task = new JitCompileTask(method, JitCompileTask::TaskKind::kCompile, kind);
+CompilationQueue& JitThreadPool::GetQueue(CompilationKind kind) {
+  switch (kind) {
+    case CompilationKind::kOsr:
+      return osr_queue_;
+    case CompilationKind::kBaseline:
+      return baseline_queue_;
+    case CompilationKind::kOptimized:
+      return optimized_queue_;
+  }
+}
+
+Task* JitThreadPool::FetchFrom(CompilationQueue& queue, CompilationKind kind) {
+  uint64_t enqueue_time_ns = 0u;
+  ArtMethod* method = queue.Pop(&enqueue_time_ns);
+  if (method != nullptr) {
+    const uint64_t latency_ms = NsToMs(NanoTime() - enqueue_time_ns);
+    metrics::ArtMetrics* metrics = Runtime::Current()->GetMetrics();
+    switch (kind) {
+      case CompilationKind::kOsr:
+        metrics->JitOsrQueueLatency()->Add(latency_ms);
+        break;
+      case CompilationKind::kBaseline:
+        metrics->JitBaselineQueueLatency()->Add(latency_ms);
+        ++consecutive_baseline_fetches_;
+        break;
+      case CompilationKind::kOptimized:
+        metrics->JitOptimizedQueueLatency()->Add(latency_ms);
+        consecutive_baseline_fetches_ = 0;
+        ++num_optimized_compilations_;
+        break;
+    }
+    JitCompileTask* task =
+        new JitCompileTask(method, JitCompileTask::TaskKind::kCompile, kind);
     current_compilations_.insert(task);
     return task;
   }
@@ -1861,20 +2065,19 @@ Task* JitThreadPool::FetchFrom(std::deque<ArtMethod*>& methods, CompilationKind
 }
 
 void JitThreadPool::Remove(JitCompileTask* task) {
-  MutexLock mu(Thread::Current(), task_queue_lock_);
-  current_compilations_.erase(task);
-  switch (task->GetCompilationKind()) {
-    case CompilationKind::kOsr: {
-      osr_enqueued_methods_.erase(task->GetArtMethod());
-      break;
-    }
-    case CompilationKind::kBaseline: {
-      baseline_enqueued_methods_.erase(task->GetArtMethod());
-      break;
-    }
-    case CompilationKind::kOptimized: {
-      optimized_enqueued_methods_.erase(task->GetArtMethod());
-      break;
+  Thread* self = Thread::Current();
+  MutexLock mu(self, task_queue_lock_);
+  if (current_compilations_.erase(task) == 0) {
+    // Tasks added to the generic queue were never tracked by the compilation queues.
+    return;
+  }
+  GetQueue(task->GetCompilationKind()).Done(task->GetArtMethod());
+  if (task->GetCompilationKind() == CompilationKind::kOptimized) {
+    DCHECK_NE(num_optimized_compilations_, 0u);
+    --num_optimized_compilations_;
+    // A worker may be waiting for this compilation to finish to start another optimized one.
+    if (!optimized_queue_.empty() && waiting_count_ != 0) {
+      task_queue_condition_.Signal(self);
     }
   }
 }
@@ -1900,9 +2103,10 @@ void JitThreadPool::VisitRoots(RootVisitor* visitor) {
     // - Generic tasks like `ZygoteVerificationTask` which don't hold any root.
     // - `JitCompileTask` for precompiled methods, which we know are live, being
     //   part of the boot classpath or system server classpath.
-    methods.insert(methods.end(), osr_queue_.begin(), osr_queue_.end());
-    methods.insert(methods.end(), baseline_queue_.begin(), baseline_queue_.end());
-    methods.insert(methods.end(), optimized_queue_.begin(), optimized_queue_.end());
+    auto add_method = [&methods](ArtMethod* method) { methods.push_back(method); };
+    osr_queue_.VisitMethods(add_method);
+    baseline_queue_.VisitMethods(add_method);
+    optimized_queue_.VisitMethods(add_method);
     for (JitCompileTask* task : current_compilations_) {
       methods.push_back(task->GetArtMethod());
     }
@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_JIT_JIT_H_
 #define ART_RUNTIME_JIT_JIT_H_
 
+#include <set>
 #include <unordered_set>
 
 #include <android-base/unique_fd.h>
@@ -26,6 +27,7 @@
 #include "base/mutex.h"
 #include "base/timing_logger.h"
 #include "compilation_kind.h"
+#include "compilation_queue.h"
 #include "handle.h"
 #include "offsets.h"
 #include "interpreter/mterp/nterp.h"
@@ -40,6 +42,7 @@ class ArtMethod;
 class ClassLinker;
 class DexFile;
 class OatDexFile;
+class ProfileCompilationInfo;
 class RootVisitor;
 struct RuntimeArgumentMap;
 union JValue;
@@ -54,6 +57,7 @@ class String;
 
 namespace jit {
 
+class AllocationSiteSampler;
 class JitCodeCache;
 class JitCompileTask;
 class JitMemoryRegion;
@@ -137,6 +141,9 @@ class JitThreadPool : public AbstractThreadPool {
   // Visit the ArtMethods stored in the various queues.
   void VisitRoots(RootVisitor* visitor);
 
+  // Number of workers allowed to compile, out of `GetThreadCount()`.
+  size_t GetMaxActiveWorkers(Thread* self) REQUIRES(!task_queue_lock_);
+
  protected:
   Task* TryGetTaskLocked() REQUIRES(task_queue_lock_) override;
 
@@ -149,32 +156,57 @@ class JitThreadPool : public AbstractThreadPool {
   }
 
  private:
+  // Number of pending compilations each active worker is expected to handle before waking up
+  // another one.
+  static constexpr size_t kPendingMethodsPerWorker = 16;
+
+  // Maximum number of baseline compilations served in a row while optimized compilations wait.
+  static constexpr size_t kMaxConsecutiveBaselineFetches = 8;
+
   JitThreadPool(const char* name,
                 size_t num_threads,
                 size_t worker_stack_size)
       // We need peers as we may report the JIT thread, e.g., in the debugger.
-      : AbstractThreadPool(name, num_threads, /* create_peers= */ true, worker_stack_size) {}
+      : AbstractThreadPool(name, num_threads, /* create_peers= */ true, worker_stack_size),
+        num_optimized_compilations_(0),
+        consecutive_baseline_fetches_(0) {}
 
-  // Try to fetch an entry from `methods`. Return null if `methods` is empty.
-  Task* FetchFrom(std::deque<ArtMethod*>& methods, CompilationKind kind) REQUIRES(task_queue_lock_);
+  // Try to fetch the hottest entry from `queue`. Return null if `queue` is empty.
+  Task* FetchFrom(CompilationQueue& queue, CompilationKind kind) REQUIRES(task_queue_lock_);
 
-  std::deque<Task*> generic_queue_ GUARDED_BY(task_queue_lock_);
+  // Return the queue holding the requests of the given kind.
+  CompilationQueue& GetQueue(CompilationKind kind) REQUIRES(task_queue_lock_);
+
+  // Whether a worker can start an optimized compilation. When several workers are active, one
+  // of them is kept for OSR and baseline compilations, which must not wait behind the much
+  // slower optimized compilations.
+  bool CanStartOptimizedCompilation() const REQUIRES(task_queue_lock_) {
+    return max_active_workers_ <= 1 || num_optimized_compilations_ + 1 < max_active_workers_;
+  }
+
+  // Adjust the number of active workers to the number of pending compilations and the process
+  // state.
+  void UpdateActiveWorkersLocked(Thread* self) REQUIRES(task_queue_lock_);
 
-  std::deque<ArtMethod*> osr_queue_ GUARDED_BY(task_queue_lock_);
-  std::deque<ArtMethod*> baseline_queue_ GUARDED_BY(task_queue_lock_);
-  std::deque<ArtMethod*> optimized_queue_ GUARDED_BY(task_queue_lock_);
+  std::deque<Task*> generic_queue_ GUARDED_BY(task_queue_lock_);
 
-  // We track the methods that are currently enqueued to avoid
-  // adding them to the queue multiple times, which could bloat the
-  // queues.
-  std::set<ArtMethod*> osr_enqueued_methods_ GUARDED_BY(task_queue_lock_);
-  std::set<ArtMethod*> baseline_enqueued_methods_ GUARDED_BY(task_queue_lock_);
-  std::set<ArtMethod*> optimized_enqueued_methods_ GUARDED_BY(task_queue_lock_);
+  // The queues track the methods that are enqueued or being compiled to avoid adding them to
+  // the queue multiple times, which could bloat the queues. A repeated request instead raises
+  // the priority of the queued method.
+  CompilationQueue osr_queue_ GUARDED_BY(task_queue_lock_);
+  CompilationQueue baseline_queue_ GUARDED_BY(task_queue_lock_);
+  CompilationQueue optimized_queue_ GUARDED_BY(task_queue_lock_);
 
   // A set to keep track of methods that are currently being compiled. Entries
   // will be removed when JitCompileTask->Finalize is called.
   std::unordered_set<JitCompileTask*> current_compilations_ GUARDED_BY(task_queue_lock_);
 
+  // Number of optimized compilations in `current_compilations_`.
+  size_t num_optimized_compilations_ GUARDED_BY(task_queue_lock_);
+
+  // Number of baseline compilations fetched since the last optimized one.
+  size_t consecutive_baseline_fetches_ GUARDED_BY(task_queue_lock_);
+
   DISALLOW_COPY_AND_ASSIGN(JitThreadPool);
 };
 
@@ -203,6 +235,11 @@ class Jit {
     return code_cache_;
   }
 
+  // Returns null if allocation sites are not being profiled.
+  AllocationSiteSampler* GetAllocationSiteSampler() {
+    return allocation_site_sampler_.get();
+  }
+
   JitCompilerInterface* GetJitCompiler() const {
     return jit_compiler_;
   }
@@ -362,6 +399,27 @@ class Jit {
                                          Handle<mirror::ClassLoader> class_loader,
                                          bool add_to_queue);
 
+  // With -Xuseprofiledappjit, compile the methods that previous runs of the app recorded as hot
+  // in `profile`, the profile the profile saver writes for `code_paths`, instead of waiting for
+  // them to get hot again.
+  void CompileHotMethodsFromAppProfile(Thread* self,
+                                       const std::string& profile,
+                                       const std::vector<std::string>& code_paths);
+
+  // Add to the JIT queue the methods of `dex_cache` that `profile_info` records as hot and that
+  // have no compiled code yet. Unlike the methods of the boot and zygote profiles, they are not
+  // marked pre-compiled, so their code is collected like the code of methods that got hot.
+  // Return the number of methods added to the queue.
+  uint32_t CompileHotMethodsFromProfile(Thread* self,
+                                        const ProfileCompilationInfo& profile_info,
+                                        Handle<mirror::DexCache> dex_cache)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Return the methods of `dex_file` that `profile_info` records as hot. Startup and
+  // post-startup methods are left out, as they need not get hot in this run.
+  static std::set<uint16_t> GetHotMethods(const ProfileCompilationInfo& profile_info,
+                                          const DexFile& dex_file);
+
   // Register the dex files to the JIT. This is to perform any compilation/optimization
   // at the point of loading the dex files.
   void RegisterDexFiles(const std::vector<std::unique_ptr<const DexFile>>& dex_files,
@@ -378,6 +436,11 @@ class Jit {
   bool CanAssumeInitialized(ObjPtr<mirror::Class> cls, bool is_for_shared_region) const
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Called by the compiler to know whether it can call `method` through the entry point table
+  // of its dex file, see `JitCodeCache::GetEntryPointSlot()`.
+  bool CanCallThroughEntryPointTable(ArtMethod* method, bool is_for_shared_region) const
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Map boot image methods after all compilation in zygote has been done.
   void MapBootImageMethods() REQUIRES(Locks::mutator_lock_);
 
@@ -433,6 +496,10 @@ class Jit {
   std::unique_ptr<JitThreadPool> thread_pool_;
   std::vector<std::unique_ptr<OatDexFile>> type_lookup_tables_;
 
+  // Sampler of the survival of objects allocated by compiled code, used for
+  // pretenuring.
+  std::unique_ptr<AllocationSiteSampler> allocation_site_sampler_;
+
   Mutex boot_completed_lock_;
   bool boot_completed_ GUARDED_BY(boot_completed_lock_) = false;
   std::deque<Task*> tasks_after_boot_ GUARDED_BY(boot_completed_lock_);
@@ -16,6 +16,8 @@
 
 #include "jit_code_cache.h"
 
+#include <algorithm>
+#include <optional>
 #include <sstream>
 
 #include <android-base/logging.h>
@@ -66,6 +68,17 @@ namespace jit {
 static constexpr size_t kCodeSizeLogThreshold = 50 * KB;
 static constexpr size_t kStackMapSizeLogThreshold = 50 * KB;
 
+// Usage of code committed since the last sample, also the bit set by samples finding the code
+// on a thread stack.
+static constexpr uint8_t kRecentCodeUsage = 0x80u;
+
+// Number of commits at maximum capacity between two samples of the code usage.
+static constexpr size_t kCommitsPerUsageSample = 32;
+
+// Evict at least this fraction of the capacity at once, so that each compilation at maximum
+// capacity does not pay for a collection.
+static constexpr size_t kEvictionCapacityDivisor = 16;
+
 class JitCodeCache::JniStubKey {
  public:
   explicit JniStubKey(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_)
@@ -259,14 +272,18 @@ JitCodeCache::JitCodeCache()
     : is_weak_access_enabled_(true),
       inline_cache_cond_("Jit inline cache condition variable", *Locks::jit_lock_),
       reserved_capacity_(GetInitialCapacity() * kReservedCapacityMultiplier),
+      pending_commits_lock_("Jit pending commits lock", kGenericBottomLock),
       zygote_map_(&shared_region_),
       lock_cond_("Jit code cache condition variable", *Locks::jit_lock_),
       collection_in_progress_(false),
       garbage_collect_code_(true),
+      commits_since_usage_sample_(0),
+      sample_task_scheduled_(false),
       number_of_baseline_compilations_(0),
       number_of_optimized_compilations_(0),
       number_of_osr_compilations_(0),
       number_of_collections_(0),
+      number_of_evictions_(0),
       histogram_stack_map_memory_use_("Memory used for stack maps", 16),
       histogram_code_memory_use_("Memory used for compiled code", 16),
       histogram_profiling_info_memory_use_("Memory used for profiling info", 16) {
@@ -354,6 +371,59 @@ const void* JitCodeCache::GetSavedEntryPointOfPreCompiledMethod(ArtMethod* metho
   return nullptr;
 }
 
+std::atomic<const void*>* JitCodeCache::GetEntryPointSlot(Thread* self, ArtMethod* method) {
+  const DexFile* dex_file = method->GetDexFile();
+  ScopedDebugDisallowReadBarriers sddrb(self);
+  MutexLock mu(self, *Locks::jit_lock_);
+  if (entry_point_tables_.find(dex_file) == entry_point_tables_.end()) {
+    // Value-initialized, so all the slots start out null.
+    entry_point_tables_.Put(
+        dex_file, std::make_unique<std::atomic<const void*>[]>(dex_file->NumMethodIds()));
+  }
+  // The method may already run JIT code installed before the table existed.
+  PublishEntryPointLocked(method, method->GetEntryPointFromQuickCompiledCode());
+  std::atomic<const void*>* slot = FindEntryPointSlotLocked(method);
+  DCHECK(slot != nullptr);
+  return slot;
+}
+
+void JitCodeCache::RemoveEntryPointTables(Thread* self,
+                                          ArrayRef<const DexFile* const> dex_files) {
+  MutexLock mu(self, *Locks::jit_lock_);
+  for (const DexFile* dex_file : dex_files) {
+    entry_point_tables_.erase(dex_file);
+  }
+}
+
+std::atomic<const void*>* JitCodeCache::FindEntryPointSlotLocked(ArtMethod* method) {
+  if (entry_point_tables_.empty() ||
+      method->IsNative() ||
+      method->IsCopied() ||
+      method->IsObsolete() ||
+      method->IsProxyMethod()) {
+    return nullptr;
+  }
+  auto it = entry_point_tables_.find(method->GetDexFile());
+  if (it == entry_point_tables_.end()) {
+    return nullptr;
+  }
+  DCHECK_LT(method->GetDexMethodIndex(), method->GetDexFile()->NumMethodIds());
+  return &it->second[method->GetDexMethodIndex()];
+}
+
+void JitCodeCache::PublishEntryPointLocked(ArtMethod* method, const void* entry_point) {
+  // Shared code is only called through the ArtMethod, and debuggable code must not be
+  // reached without going through the instrumentation.
+  if (!private_region_.IsInExecSpace(entry_point) || Runtime::Current()->IsJavaDebuggable()) {
+    return;
+  }
+  std::atomic<const void*>* slot = FindEntryPointSlotLocked(method);
+  if (slot != nullptr) {
+    // Release, so that callers loading the slot also see the data the code was committed with.
+    slot->store(entry_point, std::memory_order_release);
+  }
+}
+
 bool JitCodeCache::WaitForPotentialCollectionToComplete(Thread* self) {
   bool in_collection = false;
   while (collection_in_progress_) {
@@ -458,6 +528,10 @@ void JitCodeCache::SweepRootTables(IsMarkedVisitor* visitor) {
           if (new_klass != klass) {
             cache->classes_[j] = GcRoot<mirror::Class>(new_klass);
           }
+          if (new_klass == nullptr) {
+            // Don't let the next class stored in this entry inherit the count.
+            cache->counts_[j] = 0u;
+          }
         }
       }
     }
@@ -569,11 +643,19 @@ void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
         VLOG(jit) << "JIT removed " << it->second->PrettyMethod() << ": " << it->first;
         zombie_code_.erase(it->first);
         processed_zombie_code_.erase(it->first);
+        code_usage_.erase(it->first);
         it = method_code_map_.erase(it);
       } else {
         ++it;
       }
     }
+    for (auto it = evicted_methods_.begin(); it != evicted_methods_.end();) {
+      if (alloc.ContainsUnsafe(*it)) {
+        it = evicted_methods_.erase(it);
+      } else {
+        ++it;
+      }
+    }
   }
   for (auto it = osr_code_map_.begin(); it != osr_code_map_.end();) {
     DCHECK(!ContainsElement(zombie_code_, it->second));
@@ -649,6 +731,40 @@ void JitCodeCache::CopyInlineCacheInto(
   }
 }
 
+void JitCodeCache::CopyHotReceiversInto(
+    const InlineCache& ic,
+    /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes) {
+  DCHECK_EQ(classes->Size(), 0u);
+  WaitUntilInlineCacheAccessible(Thread::Current());
+  size_t slots[InlineCache::kMaxHotReceivers];
+  size_t number_of_slots = ic.GetHotReceiverSlots(slots);
+  for (size_t i = 0; i < number_of_slots; ++i) {
+    mirror::Class* object = ic.classes_[slots[i]].Read();
+    if (object != nullptr) {
+      classes->NewHandle(object);
+    }
+  }
+}
+
+struct JitCodeCache::PendingCommit {
+  JitMemoryRegion* region;
+  ArtMethod* method;
+  ArrayRef<const uint8_t> reserved_code;
+  ArrayRef<const uint8_t> code;
+  ArrayRef<const uint8_t> reserved_data;
+  const std::vector<Handle<mirror::Object>>& roots;
+  ArrayRef<const uint8_t> stack_map;
+  const std::vector<uint8_t>& debug_info;
+  bool is_full_debug_info;
+  CompilationKind compilation_kind;
+  const ArenaSet<ArtMethod*>& cha_single_implementation_list;
+
+  // Set when the method is installed, by whichever thread commits its batch.
+  const uint8_t* code_ptr = nullptr;
+  bool success = false;
+  bool done = false;
+};
+
 bool JitCodeCache::Commit(Thread* self,
                           JitMemoryRegion* region,
                           ArtMethod* method,
@@ -662,6 +778,7 @@ bool JitCodeCache::Commit(Thread* self,
                           CompilationKind compilation_kind,
                           const ArenaSet<ArtMethod*>& cha_single_implementation_list) {
   DCHECK_IMPLIES(method->IsNative(), (compilation_kind != CompilationKind::kOsr));
+  DCHECK(region == &private_region_ || region == &shared_region_);
 
   if (!method->IsNative()) {
     // We need to do this before grabbing the lock_ because it needs to be able to see the string
@@ -669,127 +786,227 @@ bool JitCodeCache::Commit(Thread* self,
     DCheckRootsAreValid(roots, IsSharedRegion(*region));
   }
 
-  const uint8_t* roots_data = reserved_data.data();
-  size_t root_table_size = ComputeRootTableSize(roots.size());
-  const uint8_t* stack_map_data = roots_data + root_table_size;
-
-  OatQuickMethodHeader* method_header = nullptr;
+  PendingCommit pending = {
+      region,
+      method,
+      reserved_code,
+      code,
+      reserved_data,
+      roots,
+      stack_map,
+      debug_info,
+      is_full_debug_info,
+      compilation_kind,
+      cha_single_implementation_list
+  };
+  {
+    MutexLock mu(self, pending_commits_lock_);
+    pending_commits_.push_back(&pending);
+  }
   {
     MutexLock mu(self, *Locks::jit_lock_);
-    const uint8_t* code_ptr = region->CommitCode(reserved_code, code, stack_map_data);
-    if (code_ptr == nullptr) {
-      return false;
+    // Compiler threads queue their method, and the first one to get the lock installs all
+    // the queued methods. The other threads find their method installed once they get the lock.
+    // Until then, they are blocked runnable, so their handles can be read by the installing
+    // thread.
+    if (!pending.done) {
+      std::vector<PendingCommit*> batch;
+      {
+        MutexLock mu2(self, pending_commits_lock_);
+        batch.swap(pending_commits_);
+      }
+      DCHECK(ContainsElement(batch, &pending));
+      CommitBatchLocked(self, ArrayRef<PendingCommit* const>(batch));
     }
-    method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
+    DCHECK(pending.done);
+  }
 
-    // Commit roots and stack maps before updating the entry point.
-    if (!region->CommitData(reserved_data, roots, stack_map)) {
-      return false;
-    }
+  if (kIsDebugBuild && pending.success) {
+    const OatQuickMethodHeader* method_header =
+        OatQuickMethodHeader::FromCodePointer(pending.code_ptr);
+    uintptr_t entry_point = reinterpret_cast<uintptr_t>(method_header->GetEntryPoint());
+    DCHECK_EQ(LookupMethodHeader(entry_point, method), method_header) << method->PrettyMethod();
+    DCHECK_EQ(LookupMethodHeader(entry_point + method_header->GetCodeSize() - 1, method),
+              method_header) << method->PrettyMethod();
+  }
+  return pending.success;
+}
 
-    switch (compilation_kind) {
-      case CompilationKind::kOsr:
-        number_of_osr_compilations_++;
-        break;
-      case CompilationKind::kBaseline:
-        number_of_baseline_compilations_++;
-        break;
-      case CompilationKind::kOptimized:
-        number_of_optimized_compilations_++;
-        break;
+void JitCodeCache::CommitBatchLocked(Thread* self, ArrayRef<PendingCommit* const> batch) {
+  ScopedTrace trace(__FUNCTION__);
+  // Copy the code of all methods with a single write permission toggle per region.
+  for (JitMemoryRegion* region : { &shared_region_, &private_region_ }) {
+    std::optional<ScopedCodeCacheWrite> ccw;
+    for (PendingCommit* pending : batch) {
+      if (pending->region != region) {
+        continue;
+      }
+      if (!ccw.has_value()) {
+        ccw.emplace(*region);
+      }
+      const uint8_t* stack_map_data =
+          pending->reserved_data.data() + ComputeRootTableSize(pending->roots.size());
+      pending->code_ptr = region->WriteCode(pending->reserved_code, pending->code, stack_map_data);
+    }
+  }
+  // Then make all of it visible to other cores at once, before publishing any of it.
+  JitMemoryRegion::SyncCodeWrites();
+
+  std::vector<std::pair<ArtMethod*, const void*>> entry_point_updates;
+  for (PendingCommit* pending : batch) {
+    pending->success =
+        pending->code_ptr != nullptr && InstallLocked(self, *pending, &entry_point_updates);
+  }
+  // Update the entry points of all the methods with a single instrumentation pass.
+  if (!entry_point_updates.empty()) {
+    Runtime::Current()->GetInstrumentation()->UpdateMethodsCode(entry_point_updates);
+    // Then publish the code to the callers going through entry point tables, unless the
+    // instrumentation kept the method on other code.
+    for (const auto& [method, entry_point] : entry_point_updates) {
+      if (method->GetEntryPointFromQuickCompiledCode() == entry_point) {
+        PublishEntryPointLocked(method, entry_point);
+      }
     }
+  }
+  for (PendingCommit* pending : batch) {
+    pending->done = true;
+  }
+  Runtime::Current()->GetMetrics()->JitCommitBatchSizeAvg()->Add(batch.size());
+}
 
-    // We need to update the debug info before the entry point gets set.
-    // At the same time we want to do under JIT lock so that debug info and JIT maps are in sync.
-    if (!debug_info.empty()) {
-      // NB: Don't allow packing of full info since it would remove non-backtrace data.
-      AddNativeDebugInfoForJit(code_ptr, debug_info, /*allow_packing=*/ !is_full_debug_info);
-    }
+bool JitCodeCache::InstallLocked(
+    Thread* self,
+    const PendingCommit& pending,
+    /*inout*/ std::vector<std::pair<ArtMethod*, const void*>>* entry_point_updates) {
+  JitMemoryRegion* region = pending.region;
+  ArtMethod* method = pending.method;
+  CompilationKind compilation_kind = pending.compilation_kind;
+  const uint8_t* code_ptr = pending.code_ptr;
+  OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
 
-    // The following needs to be guarded by cha_lock_ also. Otherwise it's possible that the
-    // compiled code is considered invalidated by some class linking, but below we still make the
-    // compiled code valid for the method.  Need cha_lock_ for checking all single-implementation
-    // flags and register dependencies.
-    {
-      ScopedDebugDisallowReadBarriers sddrb(self);
-      MutexLock cha_mu(self, *Locks::cha_lock_);
-      bool single_impl_still_valid = true;
-      for (ArtMethod* single_impl : cha_single_implementation_list) {
-        if (!single_impl->HasSingleImplementation()) {
-          // Simply discard the compiled code.
-          // Hopefully the class hierarchy will be more stable when compilation is retried.
-          single_impl_still_valid = false;
-          break;
-        }
+  // Several JIT threads may compile the method at the same time, and its baseline code may be
+  // ready after its optimized code. Do not replace the optimized code, including when it is
+  // installed earlier in the same batch.
+  if (compilation_kind == CompilationKind::kBaseline && !method->IsNative()) {
+    const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
+    for (const std::pair<ArtMethod*, const void*>& update : *entry_point_updates) {
+      if (update.first == method) {
+        entry_point = update.second;
       }
+    }
+    if (ContainsPc(entry_point) &&
+        !CodeInfo::IsBaseline(
+            OatQuickMethodHeader::FromEntryPoint(entry_point)->GetOptimizedCodeInfoPtr())) {
+      VLOG(jit) << "JIT discarded baseline code of " << method->PrettyMethod()
+                << " as it already has optimized code";
+      return false;
+    }
+  }
 
-      // Discard the code if any single-implementation assumptions are now invalid.
-      if (UNLIKELY(!single_impl_still_valid)) {
-        VLOG(jit) << "JIT discarded jitted code due to invalid single-implementation assumptions.";
-        return false;
-      }
-      DCHECK(cha_single_implementation_list.empty() || !Runtime::Current()->IsJavaDebuggable())
-          << "Should not be using cha on debuggable apps/runs!";
+  // Commit roots and stack maps before updating the entry point.
+  if (!region->CommitData(pending.reserved_data, pending.roots, pending.stack_map)) {
+    return false;
+  }
 
-      ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
-      for (ArtMethod* single_impl : cha_single_implementation_list) {
-        class_linker->GetClassHierarchyAnalysis()->AddDependency(
-            single_impl, method, method_header);
+  switch (compilation_kind) {
+    case CompilationKind::kOsr:
+      number_of_osr_compilations_++;
+      break;
+    case CompilationKind::kBaseline:
+      number_of_baseline_compilations_++;
+      break;
+    case CompilationKind::kOptimized:
+      number_of_optimized_compilations_++;
+      break;
+  }
+
+  // We need to update the debug info before the entry point gets set.
+  // At the same time we want to do under JIT lock so that debug info and JIT maps are in sync.
+  if (!pending.debug_info.empty()) {
+    // NB: Don't allow packing of full info since it would remove non-backtrace data.
+    AddNativeDebugInfoForJit(
+        code_ptr, pending.debug_info, /*allow_packing=*/ !pending.is_full_debug_info);
+  }
+
+  // The following needs to be guarded by cha_lock_ also. Otherwise it's possible that the
+  // compiled code is considered invalidated by some class linking, but below we still make the
+  // compiled code valid for the method.  Need cha_lock_ for checking all single-implementation
+  // flags and register dependencies.
+  {
+    ScopedDebugDisallowReadBarriers sddrb(self);
+    MutexLock cha_mu(self, *Locks::cha_lock_);
+    bool single_impl_still_valid = true;
+    for (ArtMethod* single_impl : pending.cha_single_implementation_list) {
+      if (!single_impl->HasSingleImplementation()) {
+        // Simply discard the compiled code.
+        // Hopefully the class hierarchy will be more stable when compilation is retried.
+        single_impl_still_valid = false;
+        break;
       }
     }
 
-    if (UNLIKELY(method->IsNative())) {
+    // Discard the code if any single-implementation assumptions are now invalid.
+    if (UNLIKELY(!single_impl_still_valid)) {
+      VLOG(jit) << "JIT discarded jitted code due to invalid single-implementation assumptions.";
+      return false;
+    }
+    DCHECK(pending.cha_single_implementation_list.empty() ||
+           !Runtime::Current()->IsJavaDebuggable())
+        << "Should not be using cha on debuggable apps/runs!";
+
+    ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+    for (ArtMethod* single_impl : pending.cha_single_implementation_list) {
+      class_linker->GetClassHierarchyAnalysis()->AddDependency(
+          single_impl, method, method_header);
+    }
+  }
+
+  if (UNLIKELY(method->IsNative())) {
+    ScopedDebugDisallowReadBarriers sddrb(self);
+    auto it = jni_stubs_map_.find(JniStubKey(method));
+    DCHECK(it != jni_stubs_map_.end())
+        << "Entry inserted in NotifyCompilationOf() should be alive.";
+    JniStubData* data = &it->second;
+    DCHECK(ContainsElement(data->GetMethods(), method))
+        << "Entry inserted in NotifyCompilationOf() should contain this method.";
+    data->SetCode(code_ptr);
+    data->UpdateEntryPoints(method_header->GetEntryPoint());
+  } else {
+    if (method->IsPreCompiled() && IsSharedRegion(*region)) {
       ScopedDebugDisallowReadBarriers sddrb(self);
-      auto it = jni_stubs_map_.find(JniStubKey(method));
-      DCHECK(it != jni_stubs_map_.end())
-          << "Entry inserted in NotifyCompilationOf() should be alive.";
-      JniStubData* data = &it->second;
-      DCHECK(ContainsElement(data->GetMethods(), method))
-          << "Entry inserted in NotifyCompilationOf() should contain this method.";
-      data->SetCode(code_ptr);
-      data->UpdateEntryPoints(method_header->GetEntryPoint());
+      zygote_map_.Put(code_ptr, method);
     } else {
-      if (method->IsPreCompiled() && IsSharedRegion(*region)) {
-        ScopedDebugDisallowReadBarriers sddrb(self);
-        zygote_map_.Put(code_ptr, method);
-      } else {
-        ScopedDebugDisallowReadBarriers sddrb(self);
-        method_code_map_.Put(code_ptr, method);
+      ScopedDebugDisallowReadBarriers sddrb(self);
+      method_code_map_.Put(code_ptr, method);
+      if (!IsSharedRegion(*region) && compilation_kind != CompilationKind::kOsr) {
+        RecordCodeUsage(self, method, code_ptr);
       }
-      if (compilation_kind == CompilationKind::kOsr) {
-        ScopedDebugDisallowReadBarriers sddrb(self);
-        osr_code_map_.Put(method, code_ptr);
-      } else if (method->StillNeedsClinitCheck()) {
-        ScopedDebugDisallowReadBarriers sddrb(self);
-        // This situation currently only occurs in the jit-zygote mode.
-        DCHECK(!garbage_collect_code_);
-        DCHECK(method->IsPreCompiled());
-        // The shared region can easily be queried. For the private region, we
-        // use a side map.
-        if (!IsSharedRegion(*region)) {
-          saved_compiled_methods_map_.Put(method, code_ptr);
-        }
-      } else {
-        Runtime::Current()->GetInstrumentation()->UpdateMethodsCode(
-            method, method_header->GetEntryPoint());
+    }
+    if (compilation_kind == CompilationKind::kOsr) {
+      ScopedDebugDisallowReadBarriers sddrb(self);
+      osr_code_map_.Put(method, code_ptr);
+    } else if (method->StillNeedsClinitCheck()) {
+      ScopedDebugDisallowReadBarriers sddrb(self);
+      // This situation currently only occurs in the jit-zygote mode.
+      DCHECK(!garbage_collect_code_);
+      DCHECK(method->IsPreCompiled());
+      // The shared region can easily be queried. For the private region, we
+      // use a side map.
+      if (!IsSharedRegion(*region)) {
+        saved_compiled_methods_map_.Put(method, code_ptr);
       }
+    } else {
+      entry_point_updates->emplace_back(method, method_header->GetEntryPoint());
     }
-    VLOG(jit)
-        << "JIT added (kind=" << compilation_kind << ") "
-        << ArtMethod::PrettyMethod(method) << "@" << method
-        << " ccache_size=" << PrettySize(CodeCacheSizeLocked()) << ": "
-        << " dcache_size=" << PrettySize(DataCacheSizeLocked()) << ": "
-        << reinterpret_cast<const void*>(method_header->GetEntryPoint()) << ","
-        << reinterpret_cast<const void*>(method_header->GetEntryPoint() +
-                                         method_header->GetCodeSize());
-  }
-
-  if (kIsDebugBuild) {
-    uintptr_t entry_point = reinterpret_cast<uintptr_t>(method_header->GetEntryPoint());
-    DCHECK_EQ(LookupMethodHeader(entry_point, method), method_header) << method->PrettyMethod();
-    DCHECK_EQ(LookupMethodHeader(entry_point + method_header->GetCodeSize() - 1, method),
-              method_header) << method->PrettyMethod();
   }
+  VLOG(jit)
+      << "JIT added (kind=" << compilation_kind << ") "
+      << ArtMethod::PrettyMethod(method) << "@" << method
+      << " ccache_size=" << PrettySize(CodeCacheSizeLocked()) << ": "
+      << " dcache_size=" << PrettySize(DataCacheSizeLocked()) << ": "
+      << reinterpret_cast<const void*>(method_header->GetEntryPoint()) << ","
+      << reinterpret_cast<const void*>(method_header->GetEntryPoint() +
+                                       method_header->GetCodeSize());
   return true;
 }
 
@@ -864,6 +1081,11 @@ bool JitCodeCache::RemoveMethodLocked(ArtMethod* method, bool release_memory) {
     if (osr_it != osr_code_map_.end()) {
       osr_code_map_.erase(osr_it);
     }
+
+    std::atomic<const void*>* slot = FindEntryPointSlotLocked(method);
+    if (slot != nullptr) {
+      slot->store(nullptr, std::memory_order_release);
+    }
   }
 
   return in_cache;
@@ -967,6 +1189,8 @@ bool JitCodeCache::Reserve(Thread* self,
 
   const uint8_t* code;
   const uint8_t* data;
+  bool hit = true;
+  bool evicted_cold_code = false;
   while (true) {
     bool at_max_capacity = false;
     {
@@ -981,7 +1205,16 @@ bool JitCodeCache::Reserve(Thread* self,
       break;
     }
     Free(self, region, code, data);
+    hit = false;
     if (at_max_capacity) {
+      if (!evicted_cold_code && EvictColdCode(self, code_size + data_size) != 0u) {
+        // Free the evicted code right away and try again.
+        evicted_cold_code = true;
+        ScopedThreadSuspension sts(self, ThreadState::kNative);
+        DoCollection(self);
+        continue;
+      }
+      Runtime::Current()->GetMetrics()->JitCodeCacheAllocationMisses()->Add(1u);
       VLOG(jit) << "JIT failed to allocate code of size "
                 << PrettySize(code_size)
                 << ", and data of size "
@@ -992,6 +1225,13 @@ bool JitCodeCache::Reserve(Thread* self,
     IncreaseCodeCacheCapacity(self);
   }
 
+  metrics::ArtMetrics* metrics = Runtime::Current()->GetMetrics();
+  if (hit) {
+    metrics->JitCodeCacheAllocationHits()->Add(1u);
+  } else {
+    metrics->JitCodeCacheAllocationMisses()->Add(1u);
+  }
+
   *reserved_code = ArrayRef<const uint8_t>(code, code_size);
   *reserved_data = ArrayRef<const uint8_t>(data, data_size);
 
@@ -1084,6 +1324,162 @@ bool JitCodeCache::IsAtMaxCapacity() const {
   return private_region_.GetCurrentCapacity() == private_region_.GetMaxCapacity();
 }
 
+size_t JitCodeCache::EvictColdCode(Thread* self, size_t bytes_needed) {
+  ScopedTrace trace(__FUNCTION__);
+  // Read barriers are allowed here, as looking up the AOT code of evicted methods reads
+  // their declaring class. This runs on a runnable thread, never during a heap GC.
+  MutexLock mu(self, *Locks::jit_lock_);
+  if (!garbage_collect_code_ || code_usage_.empty()) {
+    return 0u;
+  }
+
+  struct Candidate {
+    ArtMethod* method;
+    const void* code_ptr;
+    uint8_t usage;
+    size_t code_size;
+  };
+  std::vector<Candidate> candidates;
+  for (const auto& [code_ptr, method] : method_code_map_) {
+    auto usage_it = code_usage_.find(code_ptr);
+    // Keep code which ran since the last sample, or which was not sampled yet.
+    if (usage_it == code_usage_.end() || (usage_it->second & kRecentCodeUsage) != 0u) {
+      continue;
+    }
+    if (method->IsObsolete() ||
+        method->IsPreCompiled() ||
+        IsInZygoteExecSpace(code_ptr) ||
+        ContainsElement(zombie_code_, code_ptr) ||
+        ContainsElement(processed_zombie_code_, code_ptr)) {
+      continue;
+    }
+    // Only evict the code methods currently use; other code is already up for collection.
+    const OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
+    if (method->GetEntryPointFromQuickCompiledCode() != method_header->GetEntryPoint()) {
+      continue;
+    }
+    candidates.push_back(
+        Candidate{ method, code_ptr, usage_it->second, method_header->GetCodeSize() });
+  }
+  // Coldest first, and the largest first among equally cold code.
+  std::sort(candidates.begin(),
+            candidates.end(),
+            [](const Candidate& lhs, const Candidate& rhs) {
+              return lhs.usage != rhs.usage ? lhs.usage < rhs.usage
+                                            : lhs.code_size > rhs.code_size;
+            });
+
+  Runtime* runtime = Runtime::Current();
+  instrumentation::Instrumentation* instr = runtime->GetInstrumentation();
+  const PointerSize pointer_size = runtime->GetClassLinker()->GetImagePointerSize();
+  const uint16_t warmup_threshold = runtime->GetJITOptions()->GetWarmupThreshold();
+  const size_t bytes_to_evict =
+      std::max(bytes_needed, private_region_.GetCurrentCapacity() / kEvictionCapacityDivisor);
+  size_t evicted_bytes = 0u;
+  size_t evicted_methods = 0u;
+  for (const Candidate& candidate : candidates) {
+    if (evicted_bytes >= bytes_to_evict) {
+      break;
+    }
+    // Go back to the AOT code if there is any, otherwise to nterp or the interpreter.
+    instr->InitializeMethodsCode(candidate.method,
+                                 candidate.method->GetOatMethodQuickCode(pointer_size));
+    candidate.method->ResetCounter(warmup_threshold);
+    code_usage_.erase(candidate.code_ptr);
+    evicted_methods_.insert(candidate.method);
+    AddZombieCodeInternal(candidate.method, candidate.code_ptr);
+    evicted_bytes += candidate.code_size;
+    ++evicted_methods;
+  }
+  number_of_evictions_ += evicted_methods;
+  runtime->GetMetrics()->JitCodeCacheEvictions()->Add(evicted_methods);
+  VLOG(jit) << "JIT evicted " << evicted_methods << " methods with "
+            << PrettySize(evicted_bytes) << " of code";
+  return evicted_methods;
+}
+
+class JitSampleTask final : public Task {
+ public:
+  JitSampleTask() {}
+
+  void Run(Thread* self) override {
+    Runtime::Current()->GetJit()->GetCodeCache()->SampleCodeUsage(self);
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+};
+
+void JitCodeCache::RecordCodeUsage(Thread* self, ArtMethod* method, const void* code_ptr) {
+  // Usage only matters for eviction, which starts once the capacity cannot grow anymore.
+  if (!garbage_collect_code_ || !IsAtMaxCapacity()) {
+    return;
+  }
+  code_usage_.Overwrite(code_ptr, kRecentCodeUsage);
+  if (evicted_methods_.erase(method) != 0u) {
+    Runtime::Current()->GetMetrics()->JitCodeCacheEvictionRecompilations()->Add(1u);
+  }
+  if (++commits_since_usage_sample_ >= kCommitsPerUsageSample) {
+    JitThreadPool* pool = Runtime::Current()->GetJit()->GetThreadPool();
+    if (pool != nullptr && !sample_task_scheduled_) {
+      sample_task_scheduled_ = true;
+      commits_since_usage_sample_ = 0;
+      pool->AddTask(self, new JitSampleTask());
+    }
+  }
+}
+
+void JitCodeCache::SampleCodeUsage(Thread* self) {
+  ScopedTrace trace(__FUNCTION__);
+  {
+    ScopedDebugDisallowReadBarriers sddrb(self);
+    MutexLock mu(self, *Locks::jit_lock_);
+    sample_task_scheduled_ = false;
+    if (!garbage_collect_code_) {
+      return;
+    } else if (WaitForPotentialCollectionToComplete(self)) {
+      return;
+    } else if (gc_task_scheduled_) {
+      // The scheduled collection samples the usage with its own checkpoint.
+      return;
+    }
+    // Sampling uses the live bitmap, so it counts as a collection for other threads.
+    collection_in_progress_ = true;
+    CreateLiveBitmap();
+  }
+  ScopedObjectAccess soa(self);
+  MarkCompiledCodeOnThreadStacks(self);
+
+  ScopedDebugDisallowReadBarriers sddrb(self);
+  MutexLock mu(self, *Locks::jit_lock_);
+  UpdateCodeUsageLocked();
+  live_bitmap_.reset(nullptr);
+  // This also lets the JIT GC be scheduled again if it gave up while sampling was in progress.
+  NotifyCollectionDone(self);
+}
+
+void JitCodeCache::UpdateCodeUsageLocked() {
+  DCHECK(live_bitmap_ != nullptr);
+  commits_since_usage_sample_ = 0;
+  // Rebuild the usage from `method_code_map_`, which drops the entries of removed code.
+  SafeMap<const void*, uint8_t> code_usage;
+  for (const auto& [code_ptr, method] : method_code_map_) {
+    if (IsInZygoteExecSpace(code_ptr)) {
+      continue;
+    }
+    auto osr_it = osr_code_map_.find(method);
+    if (osr_it != osr_code_map_.end() && osr_it->second == code_ptr) {
+      continue;
+    }
+    auto it = code_usage_.find(code_ptr);
+    uint8_t usage = (it != code_usage_.end()) ? it->second : kRecentCodeUsage;
+    bool on_stack = GetLiveBitmap()->Test(FromCodeToAllocation(code_ptr));
+    code_usage.Put(code_ptr, (usage >> 1) | (on_stack ? kRecentCodeUsage : 0u));
+  }
+  code_usage_.swap(code_usage);
+}
+
 void JitCodeCache::IncreaseCodeCacheCapacity(Thread* self) {
   ScopedThreadSuspension sts(self, ThreadState::kSuspended);
   MutexLock mu(self, *Locks::jit_lock_);
@@ -1183,6 +1579,15 @@ void JitCodeCache::AddZombieCodeInternal(ArtMethod* method, const void* code_ptr
   } else {
     CHECK(!ContainsElement(zombie_code_, code_ptr));
     zombie_code_.insert(code_ptr);
+    // The method no longer runs this code, so callers going through its entry point table must
+    // not reach it either. Clearing the slot before the next collection marks the code on the
+    // thread stacks keeps the code alive for the callers that already loaded it.
+    std::atomic<const void*>* slot = FindEntryPointSlotLocked(method);
+    if (slot != nullptr) {
+      const void* entry_point = OatQuickMethodHeader::FromCodePointer(code_ptr)->GetEntryPoint();
+      slot->compare_exchange_strong(
+          entry_point, nullptr, std::memory_order_release, std::memory_order_relaxed);
+    }
   }
   // Arbitrary threshold of number of zombie code before doing a GC.
   static constexpr size_t kNumberOfZombieCodeThreshold = kIsDebugBuild ? 1 : 1000;
@@ -1234,6 +1639,31 @@ void JitCodeCache::MaybeUpdateInlineCache(ArtMethod* method,
   info->AddInvokeInfo(dex_pc, cls.Ptr());
 }
 
+void JitCodeCache::RecordDeoptimization(ArtMethod* method,
+                                        DeoptimizationKind kind,
+                                        Thread* self) {
+  ScopedDebugDisallowReadBarriers sddrb(self);
+  MutexLock mu(self, *Locks::jit_lock_);
+  auto it = profiling_infos_.find(method);
+  if (it == profiling_infos_.end()) {
+    return;
+  }
+  it->second->RecordDeoptimization(kind);
+}
+
+void JitCodeCache::MaybeUpdateBranchCache(ArtMethod* method, uint32_t dex_pc, Thread* self) {
+  ScopedDebugDisallowReadBarriers sddrb(self);
+  MutexLock mu(self, *Locks::jit_lock_);
+  auto it = profiling_infos_.find(method);
+  if (it == profiling_infos_.end()) {
+    return;
+  }
+  BranchCache* cache = it->second->GetBranchCache(dex_pc);
+  if (cache != nullptr) {
+    cache->RecordSpeculationFailure();
+  }
+}
+
 void JitCodeCache::DoCollection(Thread* self) {
   ScopedTrace trace(__FUNCTION__);
 
@@ -1247,11 +1677,7 @@ void JitCodeCache::DoCollection(Thread* self) {
     }
     collection_in_progress_ = true;
     number_of_collections_++;
-    live_bitmap_.reset(CodeCacheBitmap::Create(
-          "code-cache-bitmap",
-          reinterpret_cast<uintptr_t>(private_region_.GetExecPages()->Begin()),
-          reinterpret_cast<uintptr_t>(
-              private_region_.GetExecPages()->Begin() + private_region_.GetCurrentCapacity() / 2)));
+    CreateLiveBitmap();
     processed_zombie_code_.insert(zombie_code_.begin(), zombie_code_.end());
     zombie_code_.clear();
     processed_zombie_jni_code_.insert(zombie_jni_code_.begin(), zombie_jni_code_.end());
@@ -1274,16 +1700,29 @@ void JitCodeCache::DoCollection(Thread* self) {
 
       // Remove zombie code which hasn't been marked.
       RemoveUnmarkedCode(self);
-    }
 
-    MutexLock mu(self, *Locks::jit_lock_);
-    live_bitmap_.reset(nullptr);
-    NotifyCollectionDone(self);
+      ScopedDebugDisallowReadBarriers sddrb(self);
+      MutexLock mu(self, *Locks::jit_lock_);
+      // The marking tells which code is running, so it also serves as a usage sample.
+      if (IsAtMaxCapacity()) {
+        UpdateCodeUsageLocked();
+      }
+      live_bitmap_.reset(nullptr);
+      NotifyCollectionDone(self);
+    }
   }
 
   Runtime::Current()->GetJit()->AddTimingLogger(logger);
 }
 
+void JitCodeCache::CreateLiveBitmap() {
+  live_bitmap_.reset(CodeCacheBitmap::Create(
+        "code-cache-bitmap",
+        reinterpret_cast<uintptr_t>(private_region_.GetExecPages()->Begin()),
+        reinterpret_cast<uintptr_t>(
+            private_region_.GetExecPages()->Begin() + private_region_.GetCurrentCapacity() / 2)));
+}
+
 void JitCodeCache::NotifyCollectionDone(Thread* self) {
   collection_in_progress_ = false;
   gc_task_scheduled_ = false;
@@ -1379,21 +1818,25 @@ OatQuickMethodHeader* JitCodeCache::LookupOsrMethodHeader(ArtMethod* method) {
   return OatQuickMethodHeader::FromCodePointer(it->second);
 }
 
-ProfilingInfo* JitCodeCache::AddProfilingInfo(Thread* self,
-                                              ArtMethod* method,
-                                              const std::vector<uint32_t>& inline_cache_entries,
-                                              const std::vector<uint32_t>& branch_cache_entries) {
+ProfilingInfo* JitCodeCache::AddProfilingInfo(
+    Thread* self,
+    ArtMethod* method,
+    const std::vector<uint32_t>& inline_cache_entries,
+    const std::vector<uint32_t>& branch_cache_entries,
+    const std::vector<uint32_t>& allocation_site_entries) {
   DCHECK(CanAllocateProfilingInfo());
   ProfilingInfo* info = nullptr;
   {
     MutexLock mu(self, *Locks::jit_lock_);
-    info = AddProfilingInfoInternal(self, method, inline_cache_entries, branch_cache_entries);
+    info = AddProfilingInfoInternal(
+        self, method, inline_cache_entries, branch_cache_entries, allocation_site_entries);
   }
 
   if (info == nullptr) {
     IncreaseCodeCacheCapacity(self);
     MutexLock mu(self, *Locks::jit_lock_);
-    info = AddProfilingInfoInternal(self, method, inline_cache_entries, branch_cache_entries);
+    info = AddProfilingInfoInternal(
+        self, method, inline_cache_entries, branch_cache_entries, allocation_site_entries);
   }
   return info;
 }
@@ -1402,7 +1845,8 @@ ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(
     Thread* self,
     ArtMethod* method,
     const std::vector<uint32_t>& inline_cache_entries,
-    const std::vector<uint32_t>& branch_cache_entries) {
+    const std::vector<uint32_t>& branch_cache_entries,
+    const std::vector<uint32_t>& allocation_site_entries) {
   ScopedDebugDisallowReadBarriers sddrb(self);
   // Check whether some other thread has concurrently created it.
   auto it = profiling_infos_.find(method);
@@ -1410,22 +1854,34 @@ ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(
     return it->second;
   }
 
-  size_t profile_info_size =
-      ProfilingInfo::ComputeSize(inline_cache_entries.size(), branch_cache_entries.size());
+  size_t profile_info_size = ProfilingInfo::ComputeSize(inline_cache_entries.size(),
+                                                         branch_cache_entries.size(),
+                                                         allocation_site_entries.size());
 
   const uint8_t* data = private_region_.AllocateData(profile_info_size);
   if (data == nullptr) {
     return nullptr;
   }
   uint8_t* writable_data = private_region_.GetWritableDataAddress(data);
-  ProfilingInfo* info =
-      new (writable_data) ProfilingInfo(method, inline_cache_entries, branch_cache_entries);
+  ProfilingInfo* info = new (writable_data) ProfilingInfo(
+      method, inline_cache_entries, branch_cache_entries, allocation_site_entries);
 
   profiling_infos_.Put(method, info);
   histogram_profiling_info_memory_use_.AddValue(profile_info_size);
   return info;
 }
 
+void JitCodeCache::AddAllocationSiteSample(ArtMethod* method, uint32_t dex_pc, bool survived) {
+  auto it = profiling_infos_.find(method);
+  if (it == profiling_infos_.end()) {
+    return;
+  }
+  AllocationSiteCache* cache = it->second->GetAllocationSiteCache(dex_pc);
+  if (cache != nullptr) {
+    cache->AddSample(survived);
+  }
+}
+
 void* JitCodeCache::MoreCore(const void* mspace, intptr_t increment) {
   return shared_region_.OwnsSpace(mspace)
       ? shared_region_.MoreCore(mspace, increment)
@@ -1492,6 +1948,9 @@ void JitCodeCache::GetProfiledMethods(const std::set<std::string>& dex_base_loca
         const InlineCache& cache = info->GetInlineCaches()[i];
         ArtMethod* caller = info->GetMethod();
         bool is_missing_types = false;
+        // Index in `profile_classes` of each entry of the cache, if any.
+        size_t profile_class_indexes[InlineCache::kIndividualCacheSize];
+        std::fill_n(profile_class_indexes, InlineCache::kIndividualCacheSize, SIZE_MAX);
         for (size_t k = 0; k < InlineCache::kIndividualCacheSize; k++) {
           mirror::Class* cls = cache.classes_[k].Read();
           if (cls == nullptr) {
@@ -1529,6 +1988,7 @@ void JitCodeCache::GetProfiledMethods(const std::set<std::string>& dex_base_loca
           if (ContainsElement(dex_base_locations,
                               DexFileLoader::GetBaseLocation(class_dex_file->GetLocation()))) {
             // Only consider classes from the same apk (including multidex).
+            profile_class_indexes[k] = profile_classes.size();
             profile_classes.emplace_back(/*ProfileMethodInfo::ProfileClassReference*/
                 class_dex_file, type_index);
           } else {
@@ -1538,11 +1998,32 @@ void JitCodeCache::GetProfiledMethods(const std::set<std::string>& dex_base_loca
         if (!profile_classes.empty()) {
           inline_caches.emplace_back(/*ProfileMethodInfo::ProfileInlineCache*/
               cache.dex_pc_, is_missing_types, profile_classes);
+          if (!cache.classes_[InlineCache::kIndividualCacheSize - 1].IsNull()) {
+            // The call is megamorphic, also save its most frequent receivers.
+            size_t slots[InlineCache::kMaxHotReceivers];
+            size_t number_of_slots = cache.GetHotReceiverSlots(slots);
+            for (size_t k = 0; k < number_of_slots; ++k) {
+              if (profile_class_indexes[slots[k]] != SIZE_MAX) {
+                inline_caches.back().hot_classes.push_back(
+                    profile_classes[profile_class_indexes[slots[k]]]);
+              }
+            }
+          }
         }
       }
     }
     methods.emplace_back(/*ProfileMethodInfo*/
         MethodReference(dex_file, method->GetDexMethodIndex()), inline_caches);
+    if (info != nullptr) {
+      // Persist the pretenuring decisions so that AOT code allocates the same
+      // sites in the non-moving space.
+      for (size_t i = 0; i < info->GetNumberOfAllocationSiteCaches(); ++i) {
+        const AllocationSiteCache& cache = info->GetAllocationSiteCaches()[i];
+        if (cache.ShouldPretenure()) {
+          methods.back().pretenured_allocation_sites.push_back(cache.dex_pc_);
+        }
+      }
+    }
   }
 }
 
@@ -1719,8 +2200,12 @@ void JitCodeCache::InvalidateCompiledCodeFor(ArtMethod* method,
   // Clear the method counter if we are running jitted code since we might want to jit this again in
   // the future.
   if (method_entrypoint == header->GetEntryPoint()) {
-    // The entrypoint is the one to invalidate, so we just update it to the interpreter entry point.
-    Runtime::Current()->GetInstrumentation()->InitializeMethodsCode(method, /*aot_code=*/ nullptr);
+    // The entrypoint is the one to invalidate, so we just update it to the AOT code if any,
+    // otherwise to the interpreter entry point.
+    Runtime* runtime = Runtime::Current();
+    const void* aot_code =
+        method->GetOatMethodQuickCode(runtime->GetClassLinker()->GetImagePointerSize());
+    runtime->GetInstrumentation()->InitializeMethodsCode(method, aot_code);
   } else {
     Thread* self = Thread::Current();
     ScopedDebugDisallowReadBarriers sddrb(self);
@@ -1763,7 +2248,8 @@ void JitCodeCache::Dump(std::ostream& os) {
      << "Total number of JIT optimized compilations: " << number_of_optimized_compilations_ << "\n"
      << "Total number of JIT compilations for on stack replacement: "
         << number_of_osr_compilations_ << "\n"
-     << "Total number of JIT code cache collections: " << number_of_collections_ << std::endl;
+     << "Total number of JIT code cache collections: " << number_of_collections_ << "\n"
+     << "Total number of JIT code cache evictions: " << number_of_evictions_ << std::endl;
   histogram_stack_map_memory_use_.PrintMemoryUse(os);
   histogram_code_memory_use_.PrintMemoryUse(os);
   histogram_profiling_info_memory_use_.PrintMemoryUse(os);
@@ -1822,6 +2308,7 @@ void JitCodeCache::PostForkChildAction(bool is_system_server, bool is_zygote) {
   number_of_optimized_compilations_ = 0;
   number_of_osr_compilations_ = 0;
   number_of_collections_ = 0;
+  number_of_evictions_ = 0;
   histogram_stack_map_memory_use_.Reset();
   histogram_code_memory_use_.Reset();
   histogram_profiling_info_memory_use_.Reset();
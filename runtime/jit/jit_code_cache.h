@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_JIT_JIT_CODE_CACHE_H_
 #define ART_RUNTIME_JIT_JIT_CODE_CACHE_H_
 
+#include <atomic>
 #include <cstdint>
 #include <iosfwd>
 #include <memory>
@@ -40,6 +41,7 @@
 namespace art HIDDEN {
 
 class ArtMethod;
+class DexFile;
 template<class T> class Handle;
 class LinearAlloc;
 class InlineCache;
@@ -319,14 +321,27 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Copy the most frequent receivers of `ic`, most frequent first. See
+  // `InlineCache::GetHotReceiverSlots`.
+  void CopyHotReceiversInto(const InlineCache& ic,
+                            /*out*/StackHandleScope<InlineCache::kIndividualCacheSize>* classes)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Create a 'ProfileInfo' for 'method'.
   ProfilingInfo* AddProfilingInfo(Thread* self,
                                   ArtMethod* method,
                                   const std::vector<uint32_t>& inline_cache_entries,
-                                  const std::vector<uint32_t>& branch_cache_entries)
+                                  const std::vector<uint32_t>& branch_cache_entries,
+                                  const std::vector<uint32_t>& allocation_site_entries)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Record in the profiling info of `method` whether an object sampled at
+  // `dex_pc` survived a GC. Does nothing if `method` has no profiling info.
+  void AddAllocationSiteSample(ArtMethod* method, uint32_t dex_pc, bool survived)
+      REQUIRES(Locks::jit_lock_);
+
   bool OwnsSpace(const void* mspace) const NO_THREAD_SAFETY_ANALYSIS {
     return private_region_.OwnsSpace(mspace) || shared_region_.OwnsSpace(mspace);
   }
@@ -390,6 +405,18 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Return the slot of `method` in the entry point table of its dex file, creating the table if
+  // needed. The slot holds the JIT code of `method` while it is its entry point, and is null
+  // otherwise. JIT-compiled callers call the code in the slot, and go through the ArtMethod
+  // when it is null.
+  std::atomic<const void*>* GetEntryPointSlot(Thread* self, ArtMethod* method)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Remove the entry point tables of dex files that are being unloaded.
+  void RemoveEntryPointTables(Thread* self, ArrayRef<const DexFile* const> dex_files)
+      REQUIRES(!Locks::jit_lock_);
+
   EXPORT void PostForkChildAction(bool is_system_server, bool is_zygote);
 
   // Clear the entrypoints of JIT compiled methods that belong in the zygote space.
@@ -420,6 +447,16 @@ class JitCodeCache {
                               Thread* self)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Record in the profiling info of `method` that its optimized code deoptimized
+  // for `kind`. The compiler uses it to stop emitting failing speculations.
+  void RecordDeoptimization(ArtMethod* method, DeoptimizationKind kind, Thread* self)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Record that compiled code deoptimized because the branch at `dex_pc` of `method`
+  // took the side the compiler speculated it would not take.
+  void MaybeUpdateBranchCache(ArtMethod* method, uint32_t dex_pc, Thread* self)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // NO_THREAD_SAFETY_ANALYSIS because we may be called with the JIT lock held
   // or not. The implementation of this method handles the two cases.
   void AddZombieCode(ArtMethod* method, const void* code_ptr) NO_THREAD_SAFETY_ANALYSIS;
@@ -427,17 +464,64 @@ class JitCodeCache {
   EXPORT void DoCollection(Thread* self)
       REQUIRES(!Locks::jit_lock_);
 
+  // Sample which compiled code is running on thread stacks, to tell cold code from hot code
+  // when evicting.
+  EXPORT void SampleCodeUsage(Thread* self)
+      REQUIRES(!Locks::jit_lock_);
+
+  // Evict the coldest compiled code of the private region, until at least `bytes_needed` bytes
+  // of code are freed by the next collection. Methods whose code is evicted go back to the
+  // interpreter and warm up again. Returns the number of evicted methods.
+  EXPORT size_t EvictColdCode(Thread* self, size_t bytes_needed)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
  private:
+  struct PendingCommit;
+
   JitCodeCache();
 
+  // Install the compiled methods of `batch`, sharing the code cache write permission toggle,
+  // the synchronization of instruction pipelines and the entry point updates.
+  void CommitBatchLocked(Thread* self, ArrayRef<PendingCommit* const> batch)
+      REQUIRES(Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Install a method whose code was written. Entry point updates are appended to
+  // `entry_point_updates` instead of being done right away. Returns whether the method got
+  // installed.
+  bool InstallLocked(Thread* self,
+                     const PendingCommit& pending,
+                     /*inout*/ std::vector<std::pair<ArtMethod*, const void*>>* entry_point_updates)
+      REQUIRES(Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   void AddZombieCodeInternal(ArtMethod* method, const void* code_ptr)
       REQUIRES(Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Return the slot of `method` if its dex file has an entry point table, null otherwise.
+  std::atomic<const void*>* FindEntryPointSlotLocked(ArtMethod* method)
+      REQUIRES(Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Publish `entry_point` in the slot of `method`, if it has one and `entry_point` is private
+  // JIT code.
+  void PublishEntryPointLocked(ArtMethod* method, const void* entry_point)
+      REQUIRES(Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Age `code_usage_` with the code marked in the live bitmap. Shared by usage sampling and
+  // collections, so that a collection saves the checkpoint of the next sample.
+  void UpdateCodeUsageLocked()
+      REQUIRES(Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   ProfilingInfo* AddProfilingInfoInternal(Thread* self,
                                           ArtMethod* method,
                                           const std::vector<uint32_t>& inline_cache_entries,
-                                          const std::vector<uint32_t>& branch_cache_entries)
+                                          const std::vector<uint32_t>& branch_cache_entries,
+                                          const std::vector<uint32_t>& allocation_site_entries)
       REQUIRES(Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -483,6 +567,13 @@ class JitCodeCache {
   // Return whether the code cache's capacity is at its maximum.
   bool IsAtMaxCapacity() const REQUIRES(Locks::jit_lock_);
 
+  // Record that `code_ptr` was committed for `method` in the private region.
+  void RecordCodeUsage(Thread* self, ArtMethod* method, const void* code_ptr)
+      REQUIRES(Locks::jit_lock_);
+
+  // Allocate `live_bitmap_` for the current capacity of the private region.
+  void CreateLiveBitmap() REQUIRES(Locks::jit_lock_);
+
   void RemoveUnmarkedCode(Thread* self)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -533,6 +624,10 @@ class JitCodeCache {
   // Process's own region.
   JitMemoryRegion private_region_;
 
+  // Compiled methods waiting for a thread holding `Locks::jit_lock_` to install them.
+  Mutex pending_commits_lock_;
+  std::vector<PendingCommit*> pending_commits_ GUARDED_BY(pending_commits_lock_);
+
   // -------------- Global JIT maps --------------------------------------- //
 
   // Note: The methods held in these maps may be dead, so we must ensure that we do not use
@@ -556,6 +651,11 @@ class JitCodeCache {
   // Holds osr compiled code associated to the ArtMethod.
   SafeMap<ArtMethod*, const void*> osr_code_map_ GUARDED_BY(Locks::jit_lock_);
 
+  // Entry point tables of the dex files whose methods JIT-compiled code calls through them,
+  // indexed by dex method index. See `GetEntryPointSlot()`.
+  SafeMap<const DexFile*, std::unique_ptr<std::atomic<const void*>[]>> entry_point_tables_
+      GUARDED_BY(Locks::jit_lock_);
+
   // ProfilingInfo objects we have allocated.
   SafeMap<ArtMethod*, ProfilingInfo*> profiling_infos_ GUARDED_BY(Locks::jit_lock_);
 
@@ -587,6 +687,23 @@ class JitCodeCache {
   // Whether we can do garbage collection. Not 'const' as tests may override this.
   bool garbage_collect_code_ GUARDED_BY(Locks::jit_lock_);
 
+  // ---------------- JIT code eviction ------------------------------------ //
+
+  // Usage of the code in `method_code_map_`, tracked once the code cache reached its maximum
+  // capacity. Each sample shifts the usage right and sets the top bit if the code was on a
+  // thread stack, so that recent samples weigh the most. Code committed since the last sample
+  // starts with the top bit set.
+  SafeMap<const void*, uint8_t> code_usage_ GUARDED_BY(Locks::jit_lock_);
+
+  // Number of commits since the last usage sample.
+  size_t commits_since_usage_sample_ GUARDED_BY(Locks::jit_lock_);
+
+  // Whether a usage sampling task is already scheduled.
+  bool sample_task_scheduled_ GUARDED_BY(Locks::jit_lock_);
+
+  // Methods whose code got evicted and which have not been compiled again.
+  std::set<ArtMethod*> evicted_methods_ GUARDED_BY(Locks::jit_lock_);
+
   // ---------------- JIT statistics -------------------------------------- //
 
   // Number of baseline compilations done throughout the lifetime of the JIT.
@@ -601,6 +718,9 @@ class JitCodeCache {
   // Number of code cache collections done throughout the lifetime of the JIT.
   size_t number_of_collections_ GUARDED_BY(Locks::jit_lock_);
 
+  // Number of methods whose code got evicted throughout the lifetime of the JIT.
+  size_t number_of_evictions_ GUARDED_BY(Locks::jit_lock_);
+
   // Histograms for keeping track of stack map size statistics.
   Histogram<uint64_t> histogram_stack_map_memory_use_ GUARDED_BY(Locks::jit_lock_);
 
@@ -612,6 +732,7 @@ class JitCodeCache {
 
   friend class ScopedCodeCacheWrite;
   friend class MarkCodeClosure;
+  friend class JitCodeCacheTest;
 
   DISALLOW_COPY_AND_ASSIGN(JitCodeCache);
 };
@@ -0,0 +1,349 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_code_cache.h"
+
+#include <sched.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "art_method-inl.h"
+#include "base/arena_allocator.h"
+#include "base/arena_containers.h"
+#include "base/bit_memory_region.h"
+#include "class_linker.h"
+#include "common_runtime_test.h"
+#include "compilation_kind.h"
+#include "handle_scope-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/class_loader.h"
+#include "oat/oat_quick_method_header.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+#include "thread-current-inl.h"
+
+namespace art HIDDEN {
+namespace jit {
+
+class JitCodeCacheTest : public CommonRuntimeTest {
+ protected:
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    // Reset the callbacks so that the runtime doesn't think it's for AOT.
+    callbacks_ = nullptr;
+    CommonRuntimeTest::SetUpRuntimeOptions(options);
+    options->push_back(std::make_pair("-Xusejit:true", nullptr));
+  }
+
+  size_t NumberOfPendingCommits(JitCodeCache* code_cache) {
+    MutexLock mu(Thread::Current(), code_cache->pending_commits_lock_);
+    return code_cache->pending_commits_.size();
+  }
+
+  size_t NumberOfOptimizedCompilations(JitCodeCache* code_cache) {
+    MutexLock mu(Thread::Current(), *Locks::jit_lock_);
+    return code_cache->number_of_optimized_compilations_;
+  }
+
+  // A `CodeInfo` without stack maps, which only records the size of the code.
+  static std::vector<uint8_t> EncodeCodeInfo(uint32_t code_size, bool is_baseline = false) {
+    std::vector<uint8_t> code_info;
+    BitMemoryWriter<std::vector<uint8_t>> writer(&code_info);
+    // Flags (`CodeInfo::kIsBaseline` is 1 << 2), code size, frame size, core and FP spill
+    // masks, dex registers, bit tables.
+    uint32_t flags = is_baseline ? (1u << 2) : 0u;
+    writer.WriteInterleavedVarints(
+        std::array<uint32_t, 7>{ flags, code_size, 0u, 0u, 0u, 0u, 0u });
+    return code_info;
+  }
+
+  // Installs never executed code of `code_size` bytes for `method`. Returns the code pointer,
+  // or null if the code cache did not install it.
+  const void* CommitCode(Thread* self,
+                         JitCodeCache* code_cache,
+                         ArtMethod* method,
+                         uint32_t code_size,
+                         CompilationKind compilation_kind)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    std::vector<uint8_t> code(code_size, 0u);
+    std::vector<uint8_t> stack_map =
+        EncodeCodeInfo(code_size, compilation_kind == CompilationKind::kBaseline);
+    JitMemoryRegion* region = code_cache->GetCurrentRegion();
+    ArrayRef<const uint8_t> reserved_code;
+    ArrayRef<const uint8_t> reserved_data;
+    if (!code_cache->Reserve(self,
+                             region,
+                             code.size(),
+                             stack_map.size(),
+                             /*number_of_roots=*/ 0u,
+                             method,
+                             &reserved_code,
+                             &reserved_data)) {
+      return nullptr;
+    }
+    ArenaAllocator allocator(runtime_->GetArenaPool());
+    ArenaSet<ArtMethod*> cha_single_implementation_list(allocator.Adapter(kArenaAllocCHA));
+    if (!code_cache->Commit(self,
+                            region,
+                            method,
+                            reserved_code,
+                            ArrayRef<const uint8_t>(code),
+                            reserved_data,
+                            /*roots=*/ {},
+                            ArrayRef<const uint8_t>(stack_map),
+                            /*debug_info=*/ {},
+                            /*is_full_debug_info=*/ false,
+                            compilation_kind,
+                            cha_single_implementation_list)) {
+      code_cache->Free(self, region, reserved_code.data(), reserved_data.data());
+      return nullptr;
+    }
+    return reserved_code.data() + OatQuickMethodHeader::InstructionAlignedSize();
+  }
+};
+
+// Compilations which finish while another thread installs code are all installed by
+// the next thread to get the JIT lock, and each method gets the entry point of its own code.
+TEST_F(JitCodeCacheTest, CommitBatch) {
+  Thread* self = Thread::Current();
+  JitCodeCache* code_cache = runtime_->GetJitCodeCache();
+  ASSERT_TRUE(code_cache != nullptr);
+
+  jobject jclass_loader = LoadDex("StaticLeafMethods");
+  std::vector<ArtMethod*> methods;
+  {
+    ScopedObjectAccess soa(self);
+    StackHandleScope<2> hs(self);
+    Handle<mirror::ClassLoader> class_loader(
+        hs.NewHandle(soa.Decode<mirror::ClassLoader>(jclass_loader)));
+    Handle<mirror::Class> klass(
+        hs.NewHandle(class_linker_->FindClass(self, "LStaticLeafMethods;", class_loader)));
+    ASSERT_TRUE(klass != nullptr);
+    // Code of static methods is only installed as entry point once the class is visibly
+    // initialized.
+    ASSERT_TRUE(class_linker_->EnsureInitialized(self, klass, true, true));
+    {
+      ScopedThreadSuspension sts(self, ThreadState::kNative);
+      class_linker_->MakeInitializedClassesVisiblyInitialized(self, /*wait=*/ true);
+    }
+    for (ArtMethod& method : klass->GetDirectMethods(kRuntimePointerSize)) {
+      if (!method.IsConstructor()) {
+        methods.push_back(&method);
+      }
+    }
+  }
+  ASSERT_GE(methods.size(), 4u);
+  const size_t num_methods = methods.size();
+  const size_t compilations_before = NumberOfOptimizedCompilations(code_cache);
+
+  std::atomic<size_t> num_reserved = 0u;
+  std::atomic<size_t> num_committing = 0u;
+  std::atomic<bool> commit = false;
+  std::vector<const void*> code_ptrs(num_methods, nullptr);
+  std::unique_ptr<bool[]> success(new bool[num_methods]());
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i != num_methods; ++i) {
+    threads.emplace_back([&, i]() {
+      CHECK(runtime_->AttachCurrentThread("JitCodeCacheTest",
+                                          /*as_daemon=*/ false,
+                                          /*thread_group=*/ nullptr,
+                                          /*create_peer=*/ false));
+      Thread* thread = Thread::Current();
+      {
+        ScopedObjectAccess soa(thread);
+        // Code of a different size for each method, never executed.
+        std::vector<uint8_t> code(16u * (i + 1u), 0u);
+        std::vector<uint8_t> stack_map = EncodeCodeInfo(code.size());
+        JitMemoryRegion* region = code_cache->GetCurrentRegion();
+        ArrayRef<const uint8_t> reserved_code;
+        ArrayRef<const uint8_t> reserved_data;
+        bool reserved = code_cache->Reserve(thread,
+                                            region,
+                                            code.size(),
+                                            stack_map.size(),
+                                            /*number_of_roots=*/ 0u,
+                                            methods[i],
+                                            &reserved_code,
+                                            &reserved_data);
+        EXPECT_TRUE(reserved);
+        if (reserved) {
+          ++num_committing;
+        }
+        ++num_reserved;
+        {
+          ScopedThreadSuspension sts(thread, ThreadState::kNative);
+          while (!commit.load()) {
+            sched_yield();
+          }
+        }
+        if (reserved) {
+          code_ptrs[i] = reserved_code.data() + OatQuickMethodHeader::InstructionAlignedSize();
+          ArenaAllocator allocator(runtime_->GetArenaPool());
+          ArenaSet<ArtMethod*> cha_single_implementation_list(allocator.Adapter(kArenaAllocCHA));
+          success[i] = code_cache->Commit(thread,
+                                          region,
+                                          methods[i],
+                                          reserved_code,
+                                          ArrayRef<const uint8_t>(code),
+                                          reserved_data,
+                                          /*roots=*/ {},
+                                          ArrayRef<const uint8_t>(stack_map),
+                                          /*debug_info=*/ {},
+                                          /*is_full_debug_info=*/ false,
+                                          CompilationKind::kOptimized,
+                                          cha_single_implementation_list);
+        }
+      }
+      runtime_->DetachCurrentThread();
+    });
+  }
+
+  while (num_reserved.load() != num_methods) {
+    sched_yield();
+  }
+  {
+    // Hold the JIT lock until every thread queued its method, so that the thread which gets
+    // the lock next installs all of them in a single batch.
+    MutexLock mu(self, *Locks::jit_lock_);
+    commit.store(true);
+    while (NumberOfPendingCommits(code_cache) != num_committing.load()) {
+      sched_yield();
+    }
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(NumberOfPendingCommits(code_cache), 0u);
+  EXPECT_EQ(NumberOfOptimizedCompilations(code_cache), compilations_before + num_methods);
+  ScopedObjectAccess soa(self);
+  for (size_t i = 0; i != num_methods; ++i) {
+    ASSERT_TRUE(success[i]) << methods[i]->PrettyMethod();
+    const void* entry_point = methods[i]->GetEntryPointFromQuickCompiledCode();
+    const OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromCodePointer(code_ptrs[i]);
+    EXPECT_EQ(entry_point, method_header->GetEntryPoint()) << methods[i]->PrettyMethod();
+    EXPECT_EQ(method_header->GetCodeSize(), 16u * (i + 1u));
+    EXPECT_EQ(code_cache->LookupMethodHeader(reinterpret_cast<uintptr_t>(entry_point), methods[i]),
+              method_header);
+  }
+
+  // Restore the previous entry points, as the code above is not executable.
+  for (ArtMethod* method : methods) {
+    EXPECT_TRUE(code_cache->RemoveMethod(method, /*release_memory=*/ true));
+    EXPECT_FALSE(code_cache->ContainsPc(method->GetEntryPointFromQuickCompiledCode()));
+  }
+}
+
+// Baseline code which is ready after the optimized code of the same method, as can happen with
+// several JIT threads, does not replace the optimized code.
+TEST_F(JitCodeCacheTest, BaselineDoesNotReplaceOptimized) {
+  Thread* self = Thread::Current();
+  JitCodeCache* code_cache = runtime_->GetJitCodeCache();
+  ASSERT_TRUE(code_cache != nullptr);
+
+  jobject jclass_loader = LoadDex("StaticLeafMethods");
+  ScopedObjectAccess soa(self);
+  StackHandleScope<2> hs(self);
+  Handle<mirror::ClassLoader> class_loader(
+      hs.NewHandle(soa.Decode<mirror::ClassLoader>(jclass_loader)));
+  Handle<mirror::Class> klass(
+      hs.NewHandle(class_linker_->FindClass(self, "LStaticLeafMethods;", class_loader)));
+  ASSERT_TRUE(klass != nullptr);
+  ASSERT_TRUE(class_linker_->EnsureInitialized(self, klass, true, true));
+  {
+    ScopedThreadSuspension sts(self, ThreadState::kNative);
+    class_linker_->MakeInitializedClassesVisiblyInitialized(self, /*wait=*/ true);
+  }
+  ArtMethod* method = nullptr;
+  for (ArtMethod& m : klass->GetDirectMethods(kRuntimePointerSize)) {
+    if (!m.IsConstructor()) {
+      method = &m;
+      break;
+    }
+  }
+  ASSERT_TRUE(method != nullptr);
+
+  const void* optimized_code =
+      CommitCode(self, code_cache, method, /*code_size=*/ 32u, CompilationKind::kOptimized);
+  ASSERT_TRUE(optimized_code != nullptr);
+  const void* entry_point = OatQuickMethodHeader::FromCodePointer(optimized_code)->GetEntryPoint();
+  EXPECT_EQ(method->GetEntryPointFromQuickCompiledCode(), entry_point);
+
+  EXPECT_TRUE(
+      CommitCode(self, code_cache, method, /*code_size=*/ 48u, CompilationKind::kBaseline) ==
+      nullptr);
+  EXPECT_EQ(method->GetEntryPointFromQuickCompiledCode(), entry_point);
+
+  // Restore the previous entry point, as the code above is not executable.
+  EXPECT_TRUE(code_cache->RemoveMethod(method, /*release_memory=*/ true));
+}
+
+// Callers going through the entry point table of a dex file see the code installed for a
+// method once it is committed, and no longer see it once the method's code is removed.
+TEST_F(JitCodeCacheTest, EntryPointTable) {
+  Thread* self = Thread::Current();
+  JitCodeCache* code_cache = runtime_->GetJitCodeCache();
+  ASSERT_TRUE(code_cache != nullptr);
+
+  jobject jclass_loader = LoadDex("StaticLeafMethods");
+  ScopedObjectAccess soa(self);
+  StackHandleScope<2> hs(self);
+  Handle<mirror::ClassLoader> class_loader(
+      hs.NewHandle(soa.Decode<mirror::ClassLoader>(jclass_loader)));
+  Handle<mirror::Class> klass(
+      hs.NewHandle(class_linker_->FindClass(self, "LStaticLeafMethods;", class_loader)));
+  ASSERT_TRUE(klass != nullptr);
+  ASSERT_TRUE(class_linker_->EnsureInitialized(self, klass, true, true));
+  {
+    ScopedThreadSuspension sts(self, ThreadState::kNative);
+    class_linker_->MakeInitializedClassesVisiblyInitialized(self, /*wait=*/ true);
+  }
+  ArtMethod* method = nullptr;
+  for (ArtMethod& m : klass->GetDirectMethods(kRuntimePointerSize)) {
+    if (!m.IsConstructor()) {
+      method = &m;
+      break;
+    }
+  }
+  ASSERT_TRUE(method != nullptr);
+
+  std::atomic<const void*>* slot = code_cache->GetEntryPointSlot(self, method);
+  ASSERT_TRUE(slot != nullptr);
+  EXPECT_TRUE(slot->load() == nullptr);
+
+  const void* code =
+      CommitCode(self, code_cache, method, /*code_size=*/ 32u, CompilationKind::kOptimized);
+  ASSERT_TRUE(code != nullptr);
+  const void* entry_point = OatQuickMethodHeader::FromCodePointer(code)->GetEntryPoint();
+  EXPECT_EQ(method->GetEntryPointFromQuickCompiledCode(), entry_point);
+  EXPECT_EQ(slot->load(), entry_point);
+  EXPECT_EQ(code_cache->GetEntryPointSlot(self, method), slot);
+
+  // Restore the previous entry point, as the code above is not executable.
+  EXPECT_TRUE(code_cache->RemoveMethod(method, /*release_memory=*/ true));
+  EXPECT_TRUE(slot->load() == nullptr);
+
+  const DexFile* dex_file = method->GetDexFile();
+  code_cache->RemoveEntryPointTables(self, ArrayRef<const DexFile* const>(&dex_file, 1u));
+}
+
+}  // namespace jit
+}  // namespace art
@@ -353,11 +353,10 @@ void* JitMemoryRegion::MoreCore(const void* mspace, intptr_t increment) NO_THREA
   }
 }
 
-const uint8_t* JitMemoryRegion::CommitCode(ArrayRef<const uint8_t> reserved_code,
-                                           ArrayRef<const uint8_t> code,
-                                           const uint8_t* stack_map) {
+const uint8_t* JitMemoryRegion::WriteCode(ArrayRef<const uint8_t> reserved_code,
+                                          ArrayRef<const uint8_t> code,
+                                          const uint8_t* stack_map) {
   DCHECK(IsInExecSpace(reserved_code.data()));
-  ScopedCodeCacheWrite scc(*this);
 
   size_t alignment = GetInstructionSetCodeAlignment(kRuntimeISA);
   size_t header_size = OatQuickMethodHeader::InstructionAlignedSize();
@@ -415,6 +414,10 @@ const uint8_t* JitMemoryRegion::CommitCode(ArrayRef<const uint8_t> reserved_code
     return nullptr;
   }
 
+  return result;
+}
+
+void JitMemoryRegion::SyncCodeWrites() {
   // Ensure CPU instruction pipelines are flushed for all cores. This is necessary for
   // correctness as code may still be in instruction pipelines despite the i-cache flush. It is
   // not safe to assume that changing permissions with mprotect (RX->RWX->RX) will cause a TLB
@@ -425,8 +428,6 @@ const uint8_t* JitMemoryRegion::CommitCode(ArrayRef<const uint8_t> reserved_code
   // address this (see mbarrier(2)). The membarrier here will fail on prior kernels and on
   // platforms lacking the appropriate support.
   art::membarrier(art::MembarrierCommand::kPrivateExpeditedSyncCore);
-
-  return result;
 }
 
 static void FillRootTable(uint8_t* roots_data, const std::vector<Handle<mirror::Object>>& roots)
@@ -88,11 +88,16 @@ class JitMemoryRegion {
 
   // Emit header and code into the memory pointed by `reserved_code` (despite it being const).
   // Returns pointer to copied code (within reserved_code region; after OatQuickMethodHeader).
-  const uint8_t* CommitCode(ArrayRef<const uint8_t> reserved_code,
-                            ArrayRef<const uint8_t> code,
-                            const uint8_t* stack_map)
+  // The caller must make the region writable with a `ScopedCodeCacheWrite`, and call
+  // `SyncCodeWrites()` before the code can be executed. Both can be shared by several methods.
+  const uint8_t* WriteCode(ArrayRef<const uint8_t> reserved_code,
+                           ArrayRef<const uint8_t> code,
+                           const uint8_t* stack_map)
       REQUIRES(Locks::jit_lock_);
 
+  // Make code written by `WriteCode()` visible to the instruction pipelines of all cores.
+  static void SyncCodeWrites();
+
   // Emit roots and stack map into the memory pointed by `roots_data` (despite it being const).
   bool CommitData(ArrayRef<const uint8_t> reserved_data,
                   const std::vector<Handle<mirror::Object>>& roots,
@@ -48,6 +48,10 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
   jit_options->use_jit_compilation_ = options.GetOrDefault(RuntimeArgumentMap::UseJitCompilation);
   jit_options->use_profiled_jit_compilation_ =
       options.GetOrDefault(RuntimeArgumentMap::UseProfiledJitCompilation);
+  jit_options->use_profiled_app_jit_compilation_ =
+      options.GetOrDefault(RuntimeArgumentMap::UseProfiledAppJitCompilation);
+  jit_options->use_entry_point_table_ =
+      options.GetOrDefault(RuntimeArgumentMap::UseJitEntryPointTable);
 
   jit_options->code_cache_initial_capacity_ =
       options.GetOrDefault(RuntimeArgumentMap::JITCodeCacheInitialCapacity);
@@ -61,6 +65,7 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
       options.GetOrDefault(RuntimeArgumentMap::JITPoolThreadPthreadPriority);
   jit_options->zygote_thread_pool_pthread_priority_ =
       options.GetOrDefault(RuntimeArgumentMap::JITZygotePoolThreadPthreadPriority);
+  jit_options->thread_pool_size_ = options.GetOrDefault(RuntimeArgumentMap::JITPoolThreads);
 
   // Set default optimize threshold to aid with checking defaults.
   jit_options->optimize_threshold_ = kIsDebugBuild
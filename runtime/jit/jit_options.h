@@ -85,6 +85,11 @@ class JitOptions {
     return zygote_thread_pool_pthread_priority_;
   }
 
+  // Number of JIT compiler threads, or zero to size the pool by the number of cores.
+  size_t GetThreadPoolSize() const {
+    return thread_pool_size_;
+  }
+
   bool UseJitCompilation() const {
     return use_jit_compilation_;
   }
@@ -93,6 +98,18 @@ class JitOptions {
     return use_profiled_jit_compilation_;
   }
 
+  // Whether the methods that previous runs of an app recorded as hot in its profile are compiled
+  // when the app registers the profile, rather than when they get hot again.
+  bool UseProfiledAppJitCompilation() const {
+    return use_profiled_app_jit_compilation_;
+  }
+
+  // Whether JIT-compiled code calls the methods of the app through the entry point tables of
+  // their dex files rather than through their ArtMethod.
+  bool UseEntryPointTable() const {
+    return use_entry_point_table_;
+  }
+
   void SetUseJitCompilation(bool b) {
     use_jit_compilation_ = b;
   }
@@ -125,6 +142,8 @@ class JitOptions {
 
   bool use_jit_compilation_;
   bool use_profiled_jit_compilation_;
+  bool use_profiled_app_jit_compilation_;
+  bool use_entry_point_table_;
   bool use_baseline_compiler_;
   size_t code_cache_initial_capacity_;
   size_t code_cache_max_capacity_;
@@ -135,11 +154,14 @@ class JitOptions {
   bool dump_info_on_shutdown_;
   int thread_pool_pthread_priority_;
   int zygote_thread_pool_pthread_priority_;
+  size_t thread_pool_size_;
   ProfileSaverOptions profile_saver_options_;
 
   JitOptions()
       : use_jit_compilation_(false),
         use_profiled_jit_compilation_(false),
+        use_profiled_app_jit_compilation_(false),
+        use_entry_point_table_(false),
         use_baseline_compiler_(false),
         code_cache_initial_capacity_(0),
         code_cache_max_capacity_(0),
@@ -149,7 +171,8 @@ class JitOptions {
         invoke_transition_weight_(0),
         dump_info_on_shutdown_(false),
         thread_pool_pthread_priority_(kJitPoolThreadPthreadDefaultPriority),
-        zygote_thread_pool_pthread_priority_(kJitZygotePoolThreadPthreadDefaultPriority) {}
+        zygote_thread_pool_pthread_priority_(kJitZygotePoolThreadPthreadDefaultPriority),
+        thread_pool_size_(0) {}
 
   DISALLOW_COPY_AND_ASSIGN(JitOptions);
 };
@@ -999,6 +999,10 @@ void  ProfileSaver::Start(const ProfileSaverOptions& options,
     }
   }
 
+  // The profile of a previous run of the app tells which methods will get hot.
+  runtime->GetJit()->CompileHotMethodsFromAppProfile(
+      Thread::Current(), output_filename, code_paths_to_profile);
+
   MutexLock mu(Thread::Current(), *Locks::profiler_lock_);
   // Support getting profile samples for the boot class path. This will be used to generate the boot
   // image profile. The intention is to use this code to generate to boot image but not use it in
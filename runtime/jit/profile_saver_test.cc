@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 
+#include <set>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "common_runtime_test.h"
@@ -103,4 +106,30 @@ TEST_F(ProfileSaverTest, AnnotateSampleFlags) {
   ASSERT_EQ(Hotness::kFlagHot, actual);
 }
 
+TEST_F(ProfileSaverTest, GetHotMethodsFromAppProfile) {
+  std::unique_ptr<const DexFile> dex(OpenTestDexFile("MyClassNatives"));
+  ASSERT_GE(dex->NumMethodIds(), 7u);
+  std::vector<uint16_t> hot_methods = {1, 3, 5};
+  std::vector<uint16_t> startup_methods = {1, 2, 4};
+  std::vector<uint16_t> post_startup_methods = {0, 4, 6};
+  ProfileCompilationInfo saved_info;
+  ASSERT_TRUE(saved_info.AddMethodsForDex(
+      Hotness::kFlagHot, dex.get(), hot_methods.begin(), hot_methods.end()));
+  ASSERT_TRUE(saved_info.AddMethodsForDex(
+      Hotness::kFlagStartup, dex.get(), startup_methods.begin(), startup_methods.end()));
+  ASSERT_TRUE(saved_info.AddMethodsForDex(Hotness::kFlagPostStartup,
+                                          dex.get(),
+                                          post_startup_methods.begin(),
+                                          post_startup_methods.end()));
+  ScratchFile profile;
+  ASSERT_TRUE(saved_info.Save(profile.GetFd()));
+  ASSERT_EQ(0, profile.GetFile()->Flush());
+
+  // Load the profile the way the JIT does, and check that startup and post-startup methods are
+  // not compiled unless they are also hot.
+  ProfileCompilationInfo loaded_info;
+  ASSERT_TRUE(loaded_info.Load(profile.GetFilename(), /*clear_if_invalid=*/ false));
+  EXPECT_EQ(std::set<uint16_t>({1, 3, 5}), jit::Jit::GetHotMethods(loaded_info, *dex));
+}
+
 }  // namespace art
@@ -16,6 +16,8 @@
 
 #include "profiling_info.h"
 
+#include <algorithm>
+
 #include "art_method-inl.h"
 #include "dex/dex_instruction.h"
 #include "jit/jit.h"
@@ -27,12 +29,15 @@ namespace art HIDDEN {
 
 ProfilingInfo::ProfilingInfo(ArtMethod* method,
                              const std::vector<uint32_t>& inline_cache_entries,
-                             const std::vector<uint32_t>& branch_cache_entries)
+                             const std::vector<uint32_t>& branch_cache_entries,
+                             const std::vector<uint32_t>& allocation_site_entries)
       : baseline_hotness_count_(GetOptimizeThreshold()),
         method_(method),
         number_of_inline_caches_(inline_cache_entries.size()),
         number_of_branch_caches_(branch_cache_entries.size()),
-        current_inline_uses_(0) {
+        number_of_allocation_site_caches_(allocation_site_entries.size()),
+        current_inline_uses_(0),
+        deoptimization_counts_() {
   InlineCache* inline_caches = GetInlineCaches();
   memset(inline_caches, 0, number_of_inline_caches_ * sizeof(InlineCache));
   for (size_t i = 0; i < number_of_inline_caches_; ++i) {
@@ -44,6 +49,14 @@ ProfilingInfo::ProfilingInfo(ArtMethod* method,
   for (size_t i = 0; i < number_of_branch_caches_; ++i) {
     branch_caches[i].dex_pc_ = branch_cache_entries[i];
   }
+
+  AllocationSiteCache* allocation_site_caches = GetAllocationSiteCaches();
+  memset(allocation_site_caches,
+         0,
+         number_of_allocation_site_caches_ * sizeof(AllocationSiteCache));
+  for (size_t i = 0; i < number_of_allocation_site_caches_; ++i) {
+    allocation_site_caches[i].dex_pc_ = allocation_site_entries[i];
+  }
 }
 
 uint16_t ProfilingInfo::GetOptimizeThreshold() {
@@ -58,6 +71,7 @@ ProfilingInfo* ProfilingInfo::Create(Thread* self,
   DCHECK(!method->IsNative());
 
   std::vector<uint32_t> branch_cache_entries;
+  std::vector<uint32_t> allocation_site_entries;
   for (const DexInstructionPcPair& inst : method->DexInstructions()) {
     switch (inst->Opcode()) {
       case Instruction::IF_EQ:
@@ -75,6 +89,11 @@ ProfilingInfo* ProfilingInfo::Create(Thread* self,
         branch_cache_entries.push_back(inst.DexPc());
         break;
 
+      case Instruction::NEW_INSTANCE:
+      case Instruction::NEW_ARRAY:
+        allocation_site_entries.push_back(inst.DexPc());
+        break;
+
       default:
         break;
     }
@@ -85,7 +104,8 @@ ProfilingInfo* ProfilingInfo::Create(Thread* self,
 
   // Allocate the `ProfilingInfo` object int the JIT's data space.
   jit::JitCodeCache* code_cache = Runtime::Current()->GetJit()->GetCodeCache();
-  return code_cache->AddProfilingInfo(self, method, inline_cache_entries, branch_cache_entries);
+  return code_cache->AddProfilingInfo(
+      self, method, inline_cache_entries, branch_cache_entries, allocation_site_entries);
 }
 
 InlineCache* ProfilingInfo::GetInlineCache(uint32_t dex_pc) {
@@ -112,6 +132,17 @@ BranchCache* ProfilingInfo::GetBranchCache(uint32_t dex_pc) {
   return nullptr;
 }
 
+AllocationSiteCache* ProfilingInfo::GetAllocationSiteCache(uint32_t dex_pc) {
+  // Entries are created in dex pc order, see `ProfilingInfo::Create`.
+  AllocationSiteCache* caches = GetAllocationSiteCaches();
+  AllocationSiteCache* end = caches + number_of_allocation_site_caches_;
+  AllocationSiteCache* it = std::lower_bound(
+      caches, end, dex_pc, [](const AllocationSiteCache& cache, uint32_t pc) {
+        return cache.dex_pc_ < pc;
+      });
+  return (it != end && it->dex_pc_ == dex_pc) ? it : nullptr;
+}
+
 void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
   InlineCache* cache = GetInlineCache(dex_pc);
   if (cache == nullptr) {
@@ -122,6 +153,7 @@ void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
     mirror::Class* marked = ReadBarrier::IsMarked(existing);
     if (marked == cls) {
       // Receiver type is already in the cache, nothing else to do.
+      cache->counts_[i]++;
       return;
     } else if (marked == nullptr) {
       // Cache entry is empty, try to put `cls` in it.
@@ -137,12 +169,44 @@ void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
         --i;
       } else {
         // We successfully set `cls`, just return.
+        cache->counts_[i]++;
         return;
       }
     }
   }
   // Unsuccessfull - cache is full, making it megamorphic. We do not DCHECK it though,
   // as the garbage collector might clear the entries concurrently.
+  cache->misses_++;
+}
+
+size_t InlineCache::GetHotReceiverSlots(/*out*/ size_t slots[kMaxHotReceivers]) const {
+  uint64_t total = misses_;
+  for (uint32_t count : counts_) {
+    total += count;
+  }
+  if (total < kMinSamplesForHotReceivers) {
+    return 0u;
+  }
+  size_t number_of_slots = 0u;
+  for (size_t i = 0; i < kIndividualCacheSize; ++i) {
+    uint32_t count = counts_[i];
+    if (static_cast<uint64_t>(count) * 100u < total * kHotReceiverPercent) {
+      continue;
+    }
+    // Insert `i` so that `slots` stays sorted by decreasing count.
+    size_t pos = number_of_slots;
+    while (pos != 0u && counts_[slots[pos - 1u]] < count) {
+      if (pos < kMaxHotReceivers) {
+        slots[pos] = slots[pos - 1u];
+      }
+      --pos;
+    }
+    if (pos < kMaxHotReceivers) {
+      slots[pos] = i;
+      number_of_slots = std::min(number_of_slots + 1u, kMaxHotReceivers);
+    }
+  }
+  return number_of_slots;
 }
 
 ScopedProfilingInfoUse::ScopedProfilingInfoUse(jit::Jit* jit, ArtMethod* method, Thread* self)
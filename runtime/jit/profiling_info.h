@@ -21,6 +21,7 @@
 
 #include "base/macros.h"
 #include "base/value_object.h"
+#include "deoptimization_kind.h"
 #include "gc_root.h"
 #include "interpreter/mterp/nterp.h"
 #include "offsets.h"
@@ -42,15 +43,39 @@ class Class;
 
 // Structure to store the classes seen at runtime for a specific instruction.
 // Once the classes_ array is full, we consider the INVOKE to be megamorphic.
+// Baseline code on arm64 and x86-64 also counts how many times each class was
+// seen, and how many receivers did not fit in the cache. The compiler uses the
+// counts to inline the most frequent receivers of megamorphic calls.
 class InlineCache {
  public:
   // This is hard coded in the assembly stub art_quick_update_inline_cache.
   static constexpr uint8_t kIndividualCacheSize = 5;
 
+  // Maximum number of receivers of a megamorphic call that get inlined.
+  static constexpr size_t kMaxHotReceivers = 2;
+  // Number of receivers that need to be counted before we trust the counts.
+  static constexpr uint32_t kMinSamplesForHotReceivers = 64;
+  // Percentage of the receivers that a class needs to have to be inlined
+  // at a megamorphic call.
+  static constexpr uint32_t kHotReceiverPercent = 30;
+
   static constexpr MemberOffset ClassesOffset() {
     return MemberOffset(OFFSETOF_MEMBER(InlineCache, classes_));
   }
 
+  static constexpr MemberOffset CountsOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(InlineCache, counts_));
+  }
+
+  static constexpr MemberOffset MissesOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(InlineCache, misses_));
+  }
+
+  // Fill `slots` with the indexes in the cache of the most frequent receivers,
+  // most frequent first, and return how many there are. Only receivers making
+  // at least `kHotReceiverPercent` of all the counted receivers are returned.
+  size_t GetHotReceiverSlots(/*out*/ size_t slots[kMaxHotReceivers]) const;
+
   // Encode the list of `dex_pcs` to fit into an uint32_t.
   static uint32_t EncodeDexPc(ArtMethod* method,
                               const std::vector<uint32_t>& dex_pcs,
@@ -66,6 +91,11 @@ class InlineCache {
  private:
   uint32_t dex_pc_;
   GcRoot<mirror::Class> classes_[kIndividualCacheSize];
+  // Number of times the class at the same index in `classes_` was seen. Updated
+  // without synchronization, so the counts are only an approximation.
+  uint32_t counts_[kIndividualCacheSize];
+  // Number of times a class not in `classes_` was seen.
+  uint32_t misses_;
 
   friend class jit::JitCodeCache;
   friend class ProfilingInfo;
@@ -75,6 +105,10 @@ class InlineCache {
 
 class BranchCache {
  public:
+  // Number of times a branch needs to be executed before the compiler speculates
+  // that a side never taken will not be taken.
+  static constexpr uint32_t kMinExecutionsForSpeculation = 1000;
+
   static constexpr MemberOffset FalseOffset() {
     return MemberOffset(OFFSETOF_MEMBER(BranchCache, false_));
   }
@@ -95,6 +129,23 @@ class BranchCache {
     return false_;
   }
 
+  // Return whether the compiler can only compile the side of the branch that was
+  // taken, and deoptimize on the other side.
+  bool IsSpeculative() const {
+    return (true_ == 0u || false_ == 0u) && GetExecutionCount() >= kMinExecutionsForSpeculation;
+  }
+
+  // Called when compiled code deoptimized because the side never taken was
+  // taken. Count it so that the method is not compiled with the same speculation.
+  void RecordSpeculationFailure() {
+    if (true_ == 0u) {
+      true_ = 1u;
+    }
+    if (false_ == 0u) {
+      false_ = 1u;
+    }
+  }
+
  private:
   uint32_t dex_pc_;
   uint16_t false_;
@@ -105,6 +156,57 @@ class BranchCache {
   DISALLOW_COPY_AND_ASSIGN(BranchCache);
 };
 
+// Structure to store how many of the objects sampled at a NEW_INSTANCE or
+// NEW_ARRAY instruction survived the GC following their allocation. The
+// compiler uses it to allocate long-lived objects directly in the non-moving
+// space instead of copying them out of the young generation on every GC.
+class AllocationSiteCache {
+ public:
+  // Number of samples needed before the survival rate is trusted.
+  static constexpr uint16_t kMinSamplesForPretenuring = 16;
+  // Percentage of the sampled objects that need to survive for the site to be
+  // pretenured.
+  static constexpr uint32_t kPretenureSurvivalPercent = 90;
+
+  uint16_t GetSampled() const {
+    return sampled_;
+  }
+
+  uint16_t GetSurvived() const {
+    return survived_;
+  }
+
+  bool ShouldPretenure() const {
+    return sampled_ >= kMinSamplesForPretenuring &&
+        static_cast<uint32_t>(survived_) * 100u >=
+            static_cast<uint32_t>(sampled_) * kPretenureSurvivalPercent;
+  }
+
+  // Record whether an object sampled at this site survived a GC.
+  void AddSample(bool survived) {
+    if (sampled_ == std::numeric_limits<uint16_t>::max()) {
+      // Halve both counters so that the rate keeps following the behavior of
+      // the application.
+      sampled_ /= 2;
+      survived_ /= 2;
+    }
+    ++sampled_;
+    if (survived) {
+      ++survived_;
+    }
+  }
+
+ private:
+  uint32_t dex_pc_;
+  uint16_t sampled_;
+  uint16_t survived_;
+
+  friend class ProfilingInfo;
+  friend class jit::JitCodeCache;
+
+  DISALLOW_COPY_AND_ASSIGN(AllocationSiteCache);
+};
+
 /**
  * Profiling info for a method, created and filled by the interpreter once the
  * method is warm, and used by the compiler to drive optimizations.
@@ -130,6 +232,7 @@ class ProfilingInfo {
 
   InlineCache* GetInlineCache(uint32_t dex_pc);
   BranchCache* GetBranchCache(uint32_t dex_pc);
+  AllocationSiteCache* GetAllocationSiteCache(uint32_t dex_pc);
 
   InlineCache* GetInlineCaches() {
     return reinterpret_cast<InlineCache*>(
@@ -140,11 +243,24 @@ class ProfilingInfo {
         reinterpret_cast<uintptr_t>(this) + sizeof(ProfilingInfo) +
         number_of_inline_caches_ * sizeof(InlineCache));
   }
+  AllocationSiteCache* GetAllocationSiteCaches() {
+    return reinterpret_cast<AllocationSiteCache*>(
+        reinterpret_cast<uintptr_t>(this) + sizeof(ProfilingInfo) +
+        number_of_inline_caches_ * sizeof(InlineCache) +
+        number_of_branch_caches_ * sizeof(BranchCache));
+  }
 
-  static size_t ComputeSize(uint32_t number_of_inline_caches, uint32_t number_of_branch_caches) {
+  uint32_t GetNumberOfAllocationSiteCaches() const {
+    return number_of_allocation_site_caches_;
+  }
+
+  static size_t ComputeSize(uint32_t number_of_inline_caches,
+                            uint32_t number_of_branch_caches,
+                            uint32_t number_of_allocation_site_caches) {
     return sizeof(ProfilingInfo) +
         number_of_inline_caches * sizeof(InlineCache) +
-        number_of_branch_caches * sizeof(BranchCache);
+        number_of_branch_caches * sizeof(BranchCache) +
+        number_of_allocation_site_caches * sizeof(AllocationSiteCache);
   }
 
   // Increments the number of times this method is currently being inlined.
@@ -177,10 +293,33 @@ class ProfilingInfo {
 
   static uint16_t GetOptimizeThreshold();
 
+  // Record that optimized code of the method deoptimized for `kind`.
+  void RecordDeoptimization(DeoptimizationKind kind) {
+    uint8_t& count = deoptimization_counts_[static_cast<size_t>(kind)];
+    if (count != std::numeric_limits<uint8_t>::max()) {
+      ++count;
+    }
+  }
+
+  uint32_t GetNumberOfDeoptimizations(DeoptimizationKind kind) const {
+    return deoptimization_counts_[static_cast<size_t>(kind)];
+  }
+
+  // Return whether the compiler can still emit speculative code that deoptimizes
+  // for `kind`. A method that keeps deoptimizing gets compiled without it.
+  bool AllowsSpeculation(DeoptimizationKind kind) const {
+    return GetNumberOfDeoptimizations(kind) < kMaxDeoptimizationsPerKind;
+  }
+
  private:
+  // Number of deoptimizations of a kind after which the compiler stops emitting
+  // the speculation that causes it.
+  static constexpr uint8_t kMaxDeoptimizationsPerKind = 3;
+
   ProfilingInfo(ArtMethod* method,
                 const std::vector<uint32_t>& inline_cache_entries,
-                const std::vector<uint32_t>& branch_cache_entries);
+                const std::vector<uint32_t>& branch_cache_entries,
+                const std::vector<uint32_t>& allocation_site_entries);
 
   // Hotness count for methods compiled with the JIT baseline compiler. Once
   // a threshold is hit (currentily the maximum value of uint16_t), we will
@@ -198,13 +337,21 @@ class ProfilingInfo {
   // Number of branches we are profiling in the ArtMethod.
   const uint32_t number_of_branch_caches_;
 
+  // Number of allocations we are sampling in the ArtMethod.
+  const uint32_t number_of_allocation_site_caches_;
+
   // When the compiler inlines the method associated to this ProfilingInfo,
   // it updates this counter so that the GC does not try to clear the inline caches.
   uint16_t current_inline_uses_;
 
+  // Number of times optimized code of the method deoptimized, per kind.
+  uint8_t deoptimization_counts_[static_cast<size_t>(DeoptimizationKind::kLast) + 1];
+
   // Memory following the object:
   // - Dynamically allocated array of `InlineCache` of size `number_of_inline_caches_`.
   // - Dynamically allocated array of `BranchCache of size `number_of_branch_caches_`.
+  // - Dynamically allocated array of `AllocationSiteCache` of size
+  //   `number_of_allocation_site_caches_`.
   friend class jit::JitCodeCache;
 
   DISALLOW_COPY_AND_ASSIGN(ProfilingInfo);
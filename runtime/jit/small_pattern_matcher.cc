@@ -27,8 +27,40 @@ namespace jit {
 // code.
 
 static void EmptyMethod() {}
-static int32_t ReturnZero() { return 0; }
-static int32_t ReturnOne() { return 1; }
+
+template <typename T, T kValue>
+static T ReturnConstant() { return kValue; }
+
+// Range of constants for which we have a stub.
+static constexpr int32_t kMinConstant = -1;
+static constexpr int32_t kMaxConstant = 7;
+
+static constexpr int32_t (*kIntConstantStubs[])() = {
+  &ReturnConstant<int32_t, -1>,
+  &ReturnConstant<int32_t, 0>,
+  &ReturnConstant<int32_t, 1>,
+  &ReturnConstant<int32_t, 2>,
+  &ReturnConstant<int32_t, 3>,
+  &ReturnConstant<int32_t, 4>,
+  &ReturnConstant<int32_t, 5>,
+  &ReturnConstant<int32_t, 6>,
+  &ReturnConstant<int32_t, 7>,
+};
+static_assert(arraysize(kIntConstantStubs) == kMaxConstant - kMinConstant + 1);
+
+static constexpr int64_t (*kLongConstantStubs[])() = {
+  &ReturnConstant<int64_t, -1>,
+  &ReturnConstant<int64_t, 0>,
+  &ReturnConstant<int64_t, 1>,
+  &ReturnConstant<int64_t, 2>,
+  &ReturnConstant<int64_t, 3>,
+  &ReturnConstant<int64_t, 4>,
+  &ReturnConstant<int64_t, 5>,
+  &ReturnConstant<int64_t, 6>,
+  &ReturnConstant<int64_t, 7>,
+};
+static_assert(arraysize(kLongConstantStubs) == kMaxConstant - kMinConstant + 1);
+
 static int32_t ReturnFirstArgMethod([[maybe_unused]] ArtMethod* method, int32_t first_arg) {
   return first_arg;
 }
@@ -121,14 +153,43 @@ static void ConstructorSetFieldObjectAt([[maybe_unused]] ArtMethod* method,
     SWITCH_CASE(56, F, T) \
     SWITCH_CASE(60, F, T) \
     SWITCH_CASE(64, F, T) \
+    SWITCH_CASE(68, F, T) \
+    SWITCH_CASE(72, F, T) \
+    SWITCH_CASE(76, F, T) \
+    SWITCH_CASE(80, F, T) \
+    SWITCH_CASE(84, F, T) \
+    SWITCH_CASE(88, F, T) \
+    SWITCH_CASE(92, F, T) \
+    SWITCH_CASE(96, F, T) \
+    SWITCH_CASE(100, F, T) \
+    SWITCH_CASE(104, F, T) \
+    SWITCH_CASE(108, F, T) \
+    SWITCH_CASE(112, F, T) \
+    SWITCH_CASE(116, F, T) \
+    SWITCH_CASE(120, F, T) \
+    SWITCH_CASE(124, F, T) \
     default: return nullptr; \
   }
 
+// Largest offset handled by DO_SWITCH_OFFSET, relative to the first field.
+static constexpr uint32_t kMaxFieldOffset = 124;
+
+// Whether the calling convention of managed code passes and returns floating point values
+// like the C++ one.
+static constexpr bool kFloatingPointStubs =
+    kRuntimeISA == InstructionSet::kArm64 || kRuntimeISA == InstructionSet::kX86_64;
+
 #define DO_SWITCH(offset, O, P, K)                  \
   DCHECK_EQ(is_object, (K) == Primitive::kPrimNot); \
   switch (K) {                                      \
     case Primitive::kPrimBoolean:                   \
       DO_SWITCH_OFFSET(offset, P, uint8_t);         \
+    case Primitive::kPrimByte:                      \
+      DO_SWITCH_OFFSET(offset, P, int8_t);          \
+    case Primitive::kPrimChar:                      \
+      DO_SWITCH_OFFSET(offset, P, uint16_t);        \
+    case Primitive::kPrimShort:                     \
+      DO_SWITCH_OFFSET(offset, P, int16_t);         \
     case Primitive::kPrimInt:                       \
       DO_SWITCH_OFFSET(offset, P, int32_t);         \
     case Primitive::kPrimLong:                      \
@@ -136,13 +197,13 @@ static void ConstructorSetFieldObjectAt([[maybe_unused]] ArtMethod* method,
     case Primitive::kPrimNot:                       \
       DO_SWITCH_OFFSET(offset, O, mirror::Object*); \
     case Primitive::kPrimFloat:                     \
-      if (kRuntimeISA == InstructionSet::kArm64) {  \
+      if (kFloatingPointStubs) {                    \
         DO_SWITCH_OFFSET(offset, P, float);         \
       } else {                                      \
         return nullptr;                             \
       }                                             \
     case Primitive::kPrimDouble:                    \
-      if (kRuntimeISA == InstructionSet::kArm64) {  \
+      if (kFloatingPointStubs) {                    \
         DO_SWITCH_OFFSET(offset, P, double);        \
       } else {                                      \
         return nullptr;                             \
@@ -151,7 +212,64 @@ static void ConstructorSetFieldObjectAt([[maybe_unused]] ArtMethod* method,
       return nullptr;                               \
   }
 
-const void* SmallPatternMatcher::TryMatch(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_) {
+// Recognize:
+//   const{/4,/16,-wide/16} vX, #constant
+//   return{-object,-wide} vX
+static const void* TryMatchConstant(ArtMethod* method, const CodeItemDataAccessor& accessor)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  Primitive::Type return_type = method->GetReturnTypePrimitive();
+  if (return_type == Primitive::kPrimFloat || return_type == Primitive::kPrimDouble) {
+    // Too rare to bother.
+    return nullptr;
+  }
+  bool has_constant = false;
+  bool is_wide = false;
+  uint32_t register_index = 0u;
+  int32_t constant = 0;
+  for (DexInstructionPcPair pair : accessor) {
+    const Instruction& instruction = pair.Inst();
+    switch (pair->Opcode()) {
+      case Instruction::CONST_4: {
+        register_index = instruction.VRegA_11n();
+        constant = instruction.VRegB_11n();
+        has_constant = true;
+        break;
+      }
+      case Instruction::CONST_WIDE_16:
+        is_wide = true;
+        FALLTHROUGH_INTENDED;
+      case Instruction::CONST_16: {
+        register_index = instruction.VRegA_21s();
+        constant = instruction.VRegB_21s();
+        has_constant = true;
+        break;
+      }
+      case Instruction::RETURN:
+      case Instruction::RETURN_OBJECT:
+      case Instruction::RETURN_WIDE: {
+        if (!has_constant ||
+            register_index != instruction.VRegA_11x() ||
+            is_wide != (pair->Opcode() == Instruction::RETURN_WIDE) ||
+            constant < kMinConstant ||
+            constant > kMaxConstant) {
+          return nullptr;
+        }
+        return is_wide
+            ? reinterpret_cast<const void*>(kLongConstantStubs[constant - kMinConstant])
+            : reinterpret_cast<const void*>(kIntConstantStubs[constant - kMinConstant]);
+      }
+      default:
+        return nullptr;
+    }
+  }
+  return nullptr;
+}
+
+const void* SmallPatternMatcher::TryMatch(ArtMethod* method) {
+  return TryMatch(method, /* allow_delegation= */ true);
+}
+
+const void* SmallPatternMatcher::TryMatch(ArtMethod* method, bool allow_delegation) {
   CodeItemDataAccessor accessor(*method->GetDexFile(), method->GetCodeItem());
 
   ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
@@ -163,6 +281,10 @@ const void* SmallPatternMatcher::TryMatch(ArtMethod* method) REQUIRES_SHARED(Loc
       method->GetDeclaringClass()->GetSuperClass()->IsObjectClass();
 
   size_t insns_size = accessor.InsnsSizeInCodeUnits();
+  if (!method->IsConstructor() && (insns_size == 4u || insns_size == 5u)) {
+    // Only a call and a return fit in 4 or 5 code units.
+    return allow_delegation ? TryMatchDelegation(method, accessor) : nullptr;
+  }
   if (insns_size >= 4u) {
     if (!is_recognizable_constructor) {
       return nullptr;
@@ -230,69 +352,32 @@ const void* SmallPatternMatcher::TryMatch(ArtMethod* method) REQUIRES_SHARED(Loc
     return nullptr;
   }
 
-  // Recognize:
-  //   const vX, 0/1
-  //   return{-object} vX
   if (insns_size == 2u) {
-    if (method->GetReturnTypePrimitive() == Primitive::kPrimFloat) {
-      // Too rare to bother.
-      return nullptr;
-    }
-    int32_t register_index = -1;
-    int32_t constant = -1;
-    for (DexInstructionPcPair pair : accessor) {
-      const Instruction& instruction = pair.Inst();
-      switch (pair->Opcode()) {
-        case Instruction::CONST_4: {
-          register_index = instruction.VRegA_11n();
-          constant = instruction.VRegB_11n();
-          if (constant != 0 && constant != 1) {
-            return nullptr;
-          }
-          break;
-        }
-        case Instruction::CONST_16: {
-          register_index = instruction.VRegA_21s();
-          constant = instruction.VRegB_21s();
-          if (constant != 0 && constant != 1) {
-            return nullptr;
-          }
-          break;
-        }
-        case Instruction::RETURN:
-        case Instruction::RETURN_OBJECT: {
-          if (register_index == instruction.VRegA_11x()) {
-            if (constant == 0) {
-              return reinterpret_cast<void*>(&ReturnZero);
-            } else if (constant == 1) {
-              return reinterpret_cast<void*>(&ReturnOne);
-            }
-          }
-          return nullptr;
-        }
-        default:
-          return nullptr;
-      }
+    return TryMatchConstant(method, accessor);
+  }
+  if (insns_size == 3u) {
+    Instruction::Code opcode = accessor.begin().Inst().Opcode();
+    if (opcode == Instruction::CONST_16 || opcode == Instruction::CONST_WIDE_16) {
+      return TryMatchConstant(method, accessor);
     }
-    return nullptr;
   }
 
   // Recognize:
-  //   iget-{object,wide,boolean} vX, v0, field
-  //   return-{object} vX
+  //   iget{-object,-wide,-boolean,-byte,-char,-short} vX, v0, field
+  //   return{-object,-wide} vX
   // Or:
-  //   iput-{object,wide,boolean} v1, v0, field
+  //   iput{-object,-wide,-boolean,-byte,-char,-short} v1, v0, field
   //   return-void
   // Or:
-  //   sget-object vX, field
-  //   return-object vX
+  //   sget{-object,-wide,-boolean,-byte,-char,-short} vX, field
+  //   return{-object,-wide} vX
   // Or:
-  //   iput-{object,wide,boolean} v1, v0, field
+  //   iput{-object,-wide,-boolean,-byte,-char,-short} v1, v0, field
   //   invoke-direct v0, j.l.Object.<init>
   //   return-void
   // Or:
   //   invoke-direct v0, j.l.Object.<init>
-  //   iput-{object,wide,boolean} v1, v0, field
+  //   iput{-object,-wide,-boolean,-byte,-char,-short} v1, v0, field
   //   return-void
   if (insns_size == 3u || insns_size == 6u) {
     DCHECK_IMPLIES(insns_size == 6u, is_recognizable_constructor);
@@ -316,21 +401,39 @@ const void* SmallPatternMatcher::TryMatch(ArtMethod* method) REQUIRES_SHARED(Loc
           }
           break;
         case Instruction::SGET_OBJECT:
+          is_object = true;
+          FALLTHROUGH_INTENDED;
+        case Instruction::SGET:
+        case Instruction::SGET_WIDE:
+        case Instruction::SGET_BOOLEAN:
+        case Instruction::SGET_BYTE:
+        case Instruction::SGET_CHAR:
+        case Instruction::SGET_SHORT:
           is_static = true;
           FALLTHROUGH_INTENDED;
         case Instruction::IPUT_OBJECT:
         case Instruction::IGET_OBJECT:
-          is_object = true;
-          FALLTHROUGH_INTENDED;
         case Instruction::IPUT:
         case Instruction::IGET:
         case Instruction::IGET_BOOLEAN:
         case Instruction::IPUT_BOOLEAN:
+        case Instruction::IGET_BYTE:
+        case Instruction::IPUT_BYTE:
+        case Instruction::IGET_CHAR:
+        case Instruction::IPUT_CHAR:
+        case Instruction::IGET_SHORT:
+        case Instruction::IPUT_SHORT:
         case Instruction::IGET_WIDE:
         case Instruction::IPUT_WIDE: {
+          is_object = is_object ||
+                      pair->Opcode() == Instruction::IPUT_OBJECT ||
+                      pair->Opcode() == Instruction::IGET_OBJECT;
           is_put = (pair->Opcode() == Instruction::IPUT ||
                     pair->Opcode() == Instruction::IPUT_OBJECT ||
                     pair->Opcode() == Instruction::IPUT_BOOLEAN ||
+                    pair->Opcode() == Instruction::IPUT_BYTE ||
+                    pair->Opcode() == Instruction::IPUT_CHAR ||
+                    pair->Opcode() == Instruction::IPUT_SHORT ||
                     pair->Opcode() == Instruction::IPUT_WIDE);
           if (!is_static && obj_reg != instruction.VRegB_22c()) {
             // The field access is not on the first parameter.
@@ -378,11 +481,19 @@ const void* SmallPatternMatcher::TryMatch(ArtMethod* method) REQUIRES_SHARED(Loc
           } else {
             offset = offset - sizeof(mirror::Object);
           }
-          if (offset > 64) {
+          if (offset > kMaxFieldOffset) {
             return nullptr;
           }
           field_type = field->GetTypeAsPrimitiveType();
           is_final = field->IsFinal();
+          if (kRuntimeISA == InstructionSet::kX86_64 &&
+              gUseReadBarrier &&
+              (is_static || (is_object && !is_put))) {
+            // Reference loads, including the load of the declaring class by static field
+            // stubs, may take the read barrier slow path, which may clobber XMM registers
+            // that managed code expects to be preserved.
+            return nullptr;
+          }
           break;
         }
         case Instruction::RETURN_OBJECT:
@@ -418,5 +529,91 @@ const void* SmallPatternMatcher::TryMatch(ArtMethod* method) REQUIRES_SHARED(Loc
   return nullptr;
 }
 
+// Recognize a method forwarding all its parameters to another method of the same class that
+// we recognize:
+//   invoke-{direct,static} {v0, ..., vN}, method
+//   move-result{-object,-wide} vX
+//   return{-object,-wide} vX
+// Or:
+//   invoke-{direct,static} {v0, ..., vN}, method
+//   return-void
+// The stub of the callee is then also the stub of the caller, as stubs only look at the
+// declaring class of the `ArtMethod` they get.
+const void* SmallPatternMatcher::TryMatchDelegation(ArtMethod* method,
+                                                    const CodeItemDataAccessor& accessor) {
+  uint16_t number_of_vregs = accessor.RegistersSize();
+  uint16_t number_of_parameters = accessor.InsSize();
+  uint32_t first_param_reg = number_of_vregs - number_of_parameters;
+  ArtMethod* target_method = nullptr;
+  bool has_result = false;
+  uint32_t result_reg = 0u;
+  for (DexInstructionPcPair pair : accessor) {
+    const Instruction& instruction = pair.Inst();
+    switch (pair->Opcode()) {
+      case Instruction::INVOKE_DIRECT:
+      case Instruction::INVOKE_STATIC: {
+        bool is_static = (pair->Opcode() == Instruction::INVOKE_STATIC);
+        if (target_method != nullptr ||
+            is_static != method->IsStatic() ||
+            instruction.VRegA_35c() != number_of_parameters) {
+          return nullptr;
+        }
+        uint32_t args[Instruction::kMaxVarArgRegs];
+        instruction.GetVarArgs(args);
+        for (uint32_t i = 0; i < number_of_parameters; ++i) {
+          if (args[i] != first_param_reg + i) {
+            // The parameters are not forwarded as is.
+            return nullptr;
+          }
+        }
+        Thread* self = Thread::Current();
+        target_method = Runtime::Current()->GetClassLinker()->ResolveMethod<
+            ClassLinker::ResolveMode::kNoChecks>(self,
+                                                 instruction.VRegB_35c(),
+                                                 method,
+                                                 is_static ? kStatic : kDirect);
+        if (target_method == nullptr) {
+          self->ClearException();
+          return nullptr;
+        }
+        if (target_method->GetDeclaringClass() != method->GetDeclaringClass() ||
+            target_method->IsStatic() != is_static ||
+            target_method->IsConstructor() ||
+            target_method->IsNative()) {
+          return nullptr;
+        }
+        break;
+      }
+      case Instruction::MOVE_RESULT:
+      case Instruction::MOVE_RESULT_WIDE:
+      case Instruction::MOVE_RESULT_OBJECT: {
+        if (target_method == nullptr || has_result) {
+          return nullptr;
+        }
+        has_result = true;
+        result_reg = instruction.VRegA_11x();
+        break;
+      }
+      case Instruction::RETURN_VOID: {
+        if (target_method == nullptr || has_result) {
+          return nullptr;
+        }
+        return TryMatch(target_method, /* allow_delegation= */ false);
+      }
+      case Instruction::RETURN:
+      case Instruction::RETURN_WIDE:
+      case Instruction::RETURN_OBJECT: {
+        if (!has_result || result_reg != instruction.VRegA_11x()) {
+          return nullptr;
+        }
+        return TryMatch(target_method, /* allow_delegation= */ false);
+      }
+      default:
+        return nullptr;
+    }
+  }
+  return nullptr;
+}
+
 }  // namespace jit
 }  // namespace art
@@ -23,12 +23,22 @@
 namespace art HIDDEN {
 
 class ArtMethod;
+class CodeItemDataAccessor;
 
 namespace jit {
 
 class SmallPatternMatcher {
  public:
+  // Returns a stub shared by all methods with the same trivial body as `method`, or null if
+  // `method` is not recognized.
   static const void* TryMatch(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_);
+
+ private:
+  static const void* TryMatch(ArtMethod* method, bool allow_delegation)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  static const void* TryMatchDelegation(ArtMethod* method, const CodeItemDataAccessor& accessor)
+      REQUIRES_SHARED(Locks::mutator_lock_);
 };
 
 }  // namespace jit
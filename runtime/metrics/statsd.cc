@@ -195,6 +195,27 @@ constexpr std::optional<int32_t> EncodeDatumId(DatumId datum_id) {
     case DatumId::kTimeElapsedDelta:
       return std::make_optional(
           statsd::ART_DATUM_DELTA_REPORTED__KIND__ART_DATUM_DELTA_TIME_ELAPSED_MS);
+    // Reference processing metrics don't have atoms yet, they are only available through the
+    // other metrics backends.
+    case DatumId::kGcSoftReferenceCount:
+    case DatumId::kGcSoftReferenceProcessingTime:
+    case DatumId::kGcWeakReferenceCount:
+    case DatumId::kGcWeakReferenceProcessingTime:
+    case DatumId::kGcFinalizerReferenceCount:
+    case DatumId::kGcFinalizerReferenceProcessingTime:
+    case DatumId::kGcPhantomReferenceCount:
+    case DatumId::kGcPhantomReferenceProcessingTime:
+    // Neither do the JIT queue latencies.
+    case DatumId::kJitOsrQueueLatency:
+    case DatumId::kJitBaselineQueueLatency:
+    case DatumId::kJitOptimizedQueueLatency:
+    // Nor do the JIT code cache counters.
+    case DatumId::kJitCodeCacheAllocationHits:
+    case DatumId::kJitCodeCacheAllocationMisses:
+    case DatumId::kJitCodeCacheEvictions:
+    case DatumId::kJitCodeCacheEvictionRecompilations:
+    case DatumId::kJitCommitBatchSizeAvg:
+      return std::nullopt;
   }
 }
 
@@ -44,8 +44,9 @@ std::ostream& operator<<(std::ostream& stream, StubType stub_type);
 class EXPORT PACKED(4) OatHeader {
  public:
   static constexpr std::array<uint8_t, 4> kOatMagic { { 'o', 'a', 't', '\n' } };
-  // Last oat version changed reason: Implement `HLoadClass::LoadKind::kAppImageRelRo`.
-  static constexpr std::array<uint8_t, 4> kOatVersion{{'2', '4', '4', '\0'}};
+  // Last oat version changed reason: Add pretenured allocation entrypoints and the thread-local
+  // large object cache.
+  static constexpr std::array<uint8_t, 4> kOatVersion{{'2', '4', '5', '\0'}};
 
   static constexpr const char* kDex2OatCmdLineKey = "dex2oat-cmdline";
   static constexpr const char* kDebuggableKey = "debuggable";
@@ -230,6 +230,8 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .IntoKey(M::DumpRegionInfoBeforeGC)
       .Define("-XX:DumpRegionInfoAfterGC")
           .IntoKey(M::DumpRegionInfoAfterGC)
+      .Define("-XX:NumaAwareRegionAllocation")
+          .IntoKey(M::NumaAwareRegionAllocation)
       .Define("-XX:DumpJITInfoOnShutdown")
           .IntoKey(M::DumpJITInfoOnShutdown)
       .Define("-XX:IgnoreMaxFootprint")
@@ -271,6 +273,14 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
           .IntoKey(M::UseProfiledJitCompilation)
+      .Define("-Xuseprofiledappjit:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::UseProfiledAppJitCompilation)
+      .Define("-Xjitentrypointtable:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::UseJitEntryPointTable)
       .Define("-Xjitinitialsize:_")
           .WithType<MemoryKiB>()
           .IntoKey(M::JITCodeCacheInitialCapacity)
@@ -292,6 +302,9 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xjitzygotepthreadpriority:_")
           .WithType<int>()
           .IntoKey(M::JITZygotePoolThreadPthreadPriority)
+      .Define("-Xjitthreads:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::JITPoolThreads)
       .Define("-Xjitsaveprofilinginfo")
           .WithType<ProfileSaverOptions>()
           .AppendValues()
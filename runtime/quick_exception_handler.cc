@@ -744,6 +744,8 @@ void QuickExceptionHandler::DeoptimizeSingleFrame(DeoptimizationKind kind) {
   if (runtime->UseJitCompilation() && (kind != DeoptimizationKind::kDebugging)) {
     runtime->GetJit()->GetCodeCache()->InvalidateCompiledCodeFor(
         deopt_method, visitor.GetSingleFrameDeoptQuickMethodHeader());
+    // Let the next compilation of the method know that its speculation failed.
+    runtime->GetJit()->GetCodeCache()->RecordDeoptimization(deopt_method, kind, self_);
   } else {
     runtime->GetInstrumentation()->InitializeMethodsCode(
         deopt_method, /*aot_code=*/ nullptr);
@@ -792,6 +794,16 @@ void QuickExceptionHandler::DeoptimizeSingleFrame(DeoptimizationKind kind) {
     }
   }
 
+  // If the deoptimization is due to a branch speculated as never taken, update
+  // the branch profile of the method that contains the branch, which can be an
+  // inlined method.
+  if (kind == DeoptimizationKind::kBranchSpeculation) {
+    DCHECK(runtime->UseJitCompilation());
+    ShadowFrame* shadow_frame = visitor.GetBottomShadowFrame();
+    runtime->GetJit()->GetCodeCache()->MaybeUpdateBranchCache(
+        shadow_frame->GetMethod(), shadow_frame->GetDexPC(), self_);
+  }
+
   PrepareForLongJumpToInvokeStubOrInterpreterBridge();
 }
 
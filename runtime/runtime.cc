@@ -93,6 +93,7 @@
 #include "instrumentation.h"
 #include "intern_table-inl.h"
 #include "interpreter/interpreter.h"
+#include "jit/allocation_site_sampler.h"
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
 #include "jit/profile_saver.h"
@@ -902,6 +903,9 @@ void Runtime::SweepSystemWeaks(IsMarkedVisitor* visitor) {
     // TODO: Move this closer to CleanupClassLoaders, to avoid blocking weak accesses
     // from mutators. See b/32167580.
     GetJit()->GetCodeCache()->SweepRootTables(visitor);
+    if (GetJit()->GetAllocationSiteSampler() != nullptr) {
+      GetJit()->GetAllocationSiteSampler()->Sweep(visitor);
+    }
   }
 
   // All other generic system-weak holders.
@@ -1746,6 +1750,8 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   // Generational CC collection is currently only compatible with Baker read barriers.
   bool use_generational_cc = kUseBakerReadBarrier && xgc_option.generational_cc;
+  // Generational CMC collection requires the userfaultfd-based CMC collector.
+  bool use_generational_cmc = gUseUserfaultfd && xgc_option.generational_cmc;
 
   // Cache the apex versions.
   InitializeApexVersions();
@@ -1795,9 +1801,11 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                        xgc_option.measure_,
                        runtime_options.GetOrDefault(Opt::EnableHSpaceCompactForOOM),
                        use_generational_cc,
+                       use_generational_cmc,
                        runtime_options.GetOrDefault(Opt::HSpaceCompactForOOMMinIntervalsMs),
                        runtime_options.Exists(Opt::DumpRegionInfoBeforeGC),
-                       runtime_options.Exists(Opt::DumpRegionInfoAfterGC));
+                       runtime_options.Exists(Opt::DumpRegionInfoAfterGC),
+                       runtime_options.Exists(Opt::NumaAwareRegionAllocation));
 
   dump_gc_performance_on_shutdown_ = runtime_options.Exists(Opt::DumpGCPerformanceOnShutdown);
 
@@ -2785,6 +2793,9 @@ void Runtime::DisallowNewSystemWeaks() {
   heap_->DisallowNewAllocationRecords();
   if (GetJit() != nullptr) {
     GetJit()->GetCodeCache()->DisallowInlineCacheAccess();
+    if (GetJit()->GetAllocationSiteSampler() != nullptr) {
+      GetJit()->GetAllocationSiteSampler()->Disallow();
+    }
   }
 
   // All other generic system-weak holders.
@@ -2801,6 +2812,9 @@ void Runtime::AllowNewSystemWeaks() {
   heap_->AllowNewAllocationRecords();
   if (GetJit() != nullptr) {
     GetJit()->GetCodeCache()->AllowInlineCacheAccess();
+    if (GetJit()->GetAllocationSiteSampler() != nullptr) {
+      GetJit()->GetAllocationSiteSampler()->Allow();
+    }
   }
 
   // All other generic system-weak holders.
@@ -2819,6 +2833,9 @@ void Runtime::BroadcastForNewSystemWeaks(bool broadcast_for_checkpoint) {
   heap_->BroadcastForNewAllocationRecords();
   if (GetJit() != nullptr) {
     GetJit()->GetCodeCache()->BroadcastForInlineCacheAccess();
+    if (GetJit()->GetAllocationSiteSampler() != nullptr) {
+      GetJit()->GetAllocationSiteSampler()->Broadcast(broadcast_for_checkpoint);
+    }
   }
 
   // All other generic system-weak holders.
@@ -1484,6 +1484,14 @@ class EXPORT Thread {
     tlsPtr_.rosalloc_runs[index] = run;
   }
 
+  void* GetLargeObjectCache() const {
+    return tlsPtr_.large_object_cache;
+  }
+
+  void SetLargeObjectCache(void* cache) {
+    tlsPtr_.large_object_cache = cache;
+  }
+
   bool ProtectStack(bool fatal_on_error = true);
   bool UnprotectStack();
 
@@ -2148,7 +2156,8 @@ class EXPORT Thread {
                                top_reflective_handle_scope(nullptr),
                                method_trace_buffer(nullptr),
                                method_trace_buffer_index(0),
-                               thread_exit_flags(nullptr) {
+                               thread_exit_flags(nullptr),
+                               large_object_cache(nullptr) {
       std::fill(held_mutexes, held_mutexes + kLockLevelCount, nullptr);
     }
 
@@ -2328,6 +2337,9 @@ class EXPORT Thread {
 
     // Pointer to the first node of an intrusively doubly-linked list of ThreadExitFlags.
     ThreadExitFlag* thread_exit_flags GUARDED_BY(Locks::thread_list_lock_);
+
+    // Size-classed blocks reserved by this thread in the large-object space.
+    void* large_object_cache;
   } tlsPtr_;
 
   // Small thread-local cache to be used from the interpreter.
@@ -202,6 +202,8 @@ class AbstractThreadPool {
   uint64_t total_wait_time_;
   Barrier creation_barier_;
   size_t max_active_workers_ GUARDED_BY(task_queue_lock_);
+  // Number of threads created by CreateThreads, independently of max_active_workers_.
+  const size_t num_threads_;
   const bool create_peers_;
   const size_t worker_stack_size_;
 
@@ -192,6 +192,27 @@ class NoPeerTask : public Task {
   }
 };
 
+// Recreating the threads of a pool restores all of them, even if fewer were allowed to be active.
+TEST_F(ThreadPoolTest, RecreateThreads) {
+  Thread* self = Thread::Current();
+  std::unique_ptr<ThreadPool> thread_pool(
+      ThreadPool::Create("Thread pool test thread pool", num_threads));
+  thread_pool->SetMaxActiveWorkers(1);
+  thread_pool->DeleteThreads();
+  EXPECT_EQ(thread_pool->GetThreadCount(), 0u);
+  thread_pool->CreateThreads();
+  thread_pool->WaitForWorkersToBeCreated();
+  EXPECT_EQ(thread_pool->GetThreadCount(), static_cast<size_t>(num_threads));
+  AtomicInteger count(0);
+  static const int32_t num_tasks = num_threads * 4;
+  for (int32_t i = 0; i < num_tasks; ++i) {
+    thread_pool->AddTask(self, new CountTask(&count));
+  }
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, true, false);
+  EXPECT_EQ(num_tasks, count.load(std::memory_order_seq_cst));
+}
+
 // Tests for create_peer functionality.
 TEST_F(ThreadPoolTest, PeerTest) {
   Thread* self = Thread::Current();
@@ -18,6 +18,10 @@ public class Main {
   public float myFloatField = 42f;
   public double myDoubleField = 42d;
   public boolean myBooleanField = true;
+  public byte myByteField = -42;
+  public char myCharField = 'z';
+  public short myShortField = -4242;
+  public static long myStaticLongField = 42L;
 
   public float returnFloat() {
     return myFloatField;
@@ -31,6 +35,62 @@ public class Main {
     return myBooleanField;
   }
 
+  public byte returnByte() {
+    return myByteField;
+  }
+
+  public char returnChar() {
+    return myCharField;
+  }
+
+  public short returnShort() {
+    return myShortField;
+  }
+
+  public void setShort(short value) {
+    myShortField = value;
+  }
+
+  public static long returnStaticLong() {
+    return myStaticLongField;
+  }
+
+  public static int returnMinusOne() {
+    return -1;
+  }
+
+  public static long returnLongSeven() {
+    return 7L;
+  }
+
+  public Main returnThis() {
+    return this;
+  }
+
+  private char privateReturnChar() {
+    return myCharField;
+  }
+
+  public char delegateReturnChar() {
+    return privateReturnChar();
+  }
+
+  public static long delegateReturnStaticLong() {
+    return returnStaticLong();
+  }
+
+  public static void assertEquals(long a, long b) {
+    if (a != b) {
+      throw new Error("Expected " + a + ", got " + b);
+    }
+  }
+
+  public static void assertEquals(Object a, Object b) {
+    if (a != b) {
+      throw new Error("Expected " + a + ", got " + b);
+    }
+  }
+
   public static void assertEquals(float a, float b) {
     if (a != b) {
       throw new Error("Expected " + a + ", got " + b);
@@ -54,10 +114,31 @@ public class Main {
     ensureJitBaselineCompiled(Main.class, "returnFloat");
     ensureJitBaselineCompiled(Main.class, "returnDouble");
     ensureJitBaselineCompiled(Main.class, "returnBoolean");
+    ensureJitBaselineCompiled(Main.class, "returnByte");
+    ensureJitBaselineCompiled(Main.class, "returnChar");
+    ensureJitBaselineCompiled(Main.class, "returnShort");
+    ensureJitBaselineCompiled(Main.class, "setShort");
+    ensureJitBaselineCompiled(Main.class, "returnStaticLong");
+    ensureJitBaselineCompiled(Main.class, "returnMinusOne");
+    ensureJitBaselineCompiled(Main.class, "returnLongSeven");
+    ensureJitBaselineCompiled(Main.class, "returnThis");
+    ensureJitBaselineCompiled(Main.class, "delegateReturnChar");
+    ensureJitBaselineCompiled(Main.class, "delegateReturnStaticLong");
     Main m = new Main();
     assertEquals(m.myFloatField, m.returnFloat());
     assertEquals(m.myDoubleField, m.returnDouble());
     assertEquals(m.myBooleanField, m.returnBoolean());
+    assertEquals(m.myByteField, m.returnByte());
+    assertEquals(m.myCharField, m.returnChar());
+    assertEquals(m.myShortField, m.returnShort());
+    m.setShort((short) 4242);
+    assertEquals(4242, m.myShortField);
+    assertEquals(myStaticLongField, returnStaticLong());
+    assertEquals(-1, returnMinusOne());
+    assertEquals(7L, returnLongSeven());
+    assertEquals(m, m.returnThis());
+    assertEquals(m.myCharField, m.delegateReturnChar());
+    assertEquals(myStaticLongField, delegateReturnStaticLong());
   }
 
   public static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+    ensureJitBaselineCompiled(Main.class, "$noinline$speculate");
+    // Only take the first side of each branch, so that the optimized code speculates on all
+    // of them.
+    for (int i = 0; i < 2000; ++i) {
+      assertEquals(i + 4, $noinline$speculate(0, 0, 0, 0, i));
+    }
+    ensureJitCompiled(Main.class, "$noinline$speculate");
+    assertEquals(44, $noinline$speculate(0, 0, 0, 0, 40));
+
+    // Taking the other side of a branch deoptimizes. The recompiled code takes both sides of
+    // that branch, and still speculates on the others.
+    for (int branch = 0; branch < 3; ++branch) {
+      int deoptimizations = numberOfDeoptimizations();
+      assertEquals(53, $noinline$speculate(branch == 0 ? 1 : 0,
+                                           branch == 1 ? 1 : 0,
+                                           branch == 2 ? 1 : 0,
+                                           0,
+                                           40));
+      assertEquals(deoptimizations + 1, numberOfDeoptimizations());
+      ensureJitCompiled(Main.class, "$noinline$speculate");
+    }
+
+    // After three deoptimizations, the compiler stops speculating on the branches of the
+    // method, so taking the other side of the last branch does not deoptimize.
+    int deoptimizations = numberOfDeoptimizations();
+    assertEquals(53, $noinline$speculate(0, 0, 0, 1, 40));
+    assertEquals(deoptimizations, numberOfDeoptimizations());
+  }
+
+  /// CHECK-START: int Main.$noinline$speculate(int, int, int, int, int) dead_code_elimination$initial (after)
+  /// CHECK:     Deoptimize kind:branch speculation
+  /// CHECK:     Deoptimize kind:branch speculation
+  /// CHECK:     Deoptimize kind:branch speculation
+  /// CHECK:     Deoptimize kind:branch speculation
+  /// CHECK-NOT: Deoptimize
+
+  /// CHECK-START: int Main.$noinline$speculate(int, int, int, int, int) dead_code_elimination$initial (after)
+  /// CHECK-NOT: If
+  public static int $noinline$speculate(int a, int b, int c, int d, int value) {
+    if (a == 0) {
+      value += 1;
+    } else {
+      value += 10;
+    }
+    if (b == 0) {
+      value += 1;
+    } else {
+      value += 10;
+    }
+    if (c == 0) {
+      value += 1;
+    } else {
+      value += 10;
+    }
+    if (d == 0) {
+      value += 1;
+    } else {
+      value += 10;
+    }
+    return value;
+  }
+
+  public static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  public static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+  public static native void ensureJitCompiled(Class<?> cls, String methodName);
+  public static native int numberOfDeoptimizations();
+}
@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class Point {
+  int x;
+  int y;
+}
+
+class FinalPoint {
+  FinalPoint(int x) {
+    this.x = x;
+  }
+
+  final int x;
+}
+
+public class Main {
+  static Object sSink;
+
+  /// CHECK-START: int Main.$noinline$rareEscape(int, boolean) load_store_elimination (before)
+  /// CHECK:     NewInstance
+  /// CHECK:     If
+  /// CHECK-NOT: NewInstance
+
+  /// CHECK-START: int Main.$noinline$rareEscape(int, boolean) load_store_elimination (after)
+  /// CHECK:     If
+  /// CHECK:     NewInstance
+  /// CHECK-NOT: NewInstance
+
+  /// CHECK-START: int Main.$noinline$rareEscape(int, boolean) load_store_elimination (after)
+  /// CHECK-DAG: <<X:i\d+>>   ParameterValue
+  /// CHECK-DAG: <<C:i\d+>>   IntConstant 42
+  /// CHECK-DAG: <<New:l\d+>> NewInstance
+  /// CHECK-DAG:              InstanceFieldSet [<<New>>,<<X>>]
+  /// CHECK-DAG:              InstanceFieldSet [<<New>>,<<C>>]
+  /// CHECK-DAG:              StaticFieldSet [{{l\d+}},<<New>>]
+  /// CHECK-DAG: <<Add:i\d+>> Add [<<X>>,<<C>>]
+  /// CHECK-DAG:              Return [<<Add>>]
+
+  /// CHECK-START: int Main.$noinline$rareEscape(int, boolean) load_store_elimination (after)
+  /// CHECK-NOT: InstanceFieldGet
+  static int $noinline$rareEscape(int x, boolean escape) {
+    Point p = new Point();
+    p.x = x;
+    p.y = 42;
+    if (escape) {
+      sSink = p;
+      return -1;
+    }
+    return p.x + p.y;
+  }
+
+  /// CHECK-START: int Main.$noinline$escapeAfterUpdate(int, boolean) load_store_elimination (after)
+  /// CHECK-DAG: <<X:i\d+>>   ParameterValue
+  /// CHECK-DAG: <<C:i\d+>>   IntConstant 1
+  /// CHECK-DAG: <<New:l\d+>> NewInstance
+  /// CHECK-DAG: <<Inc:i\d+>> Add [<<X>>,<<C>>]
+  /// CHECK-DAG:              InstanceFieldSet [<<New>>,<<Inc>>]
+  /// CHECK-DAG:              Return [<<X>>]
+
+  /// CHECK-START: int Main.$noinline$escapeAfterUpdate(int, boolean) load_store_elimination (after)
+  /// CHECK:     NewInstance
+  /// CHECK-NOT: NewInstance
+
+  /// CHECK-START: int Main.$noinline$escapeAfterUpdate(int, boolean) load_store_elimination (after)
+  /// CHECK-NOT: InstanceFieldGet
+  static int $noinline$escapeAfterUpdate(int x, boolean escape) {
+    Point p = new Point();
+    p.x = x;
+    if (escape) {
+      // The materialized object gets the value stored on the escaping path.
+      p.x++;
+      sSink = p;
+      return 0;
+    }
+    return p.x;
+  }
+
+  // The escape is a call, whose environment the materialized allocation takes.
+
+  /// CHECK-START: int Main.$noinline$callEscape(int, boolean) load_store_elimination (after)
+  /// CHECK:     If
+  /// CHECK:     NewInstance
+  /// CHECK:     InvokeStaticOrDirect method_name:Main.$noinline$consume
+  /// CHECK-NOT: NewInstance
+
+  /// CHECK-START: int Main.$noinline$callEscape(int, boolean) load_store_elimination (after)
+  /// CHECK-NOT: InstanceFieldGet
+  static int $noinline$callEscape(int x, boolean escape) {
+    Point p = new Point();
+    p.x = x;
+    if (escape) {
+      $noinline$consume(p);
+      return -1;
+    }
+    return p.x;
+  }
+
+  /// CHECK-START: int Main.$noinline$escapeInLoop(int) load_store_elimination (after)
+  /// CHECK:     If
+  /// CHECK:     If
+  /// CHECK:     NewInstance
+  /// CHECK-NOT: NewInstance
+
+  /// CHECK-START: int Main.$noinline$escapeInLoop(int) load_store_elimination (after)
+  /// CHECK-NOT: InstanceFieldGet
+  static int $noinline$escapeInLoop(int n) {
+    int sum = 0;
+    for (int i = 0; i < n; ++i) {
+      Point p = new Point();
+      p.x = i;
+      p.y = sum;
+      sum += p.x - p.y + 1;
+      if (i == 42) {
+        sSink = p;
+      }
+    }
+    return sum;
+  }
+
+  /// CHECK-START: int Main.$noinline$finalFieldEscape(int, boolean) load_store_elimination (after)
+  /// CHECK:     If
+  /// CHECK:     NewInstance
+  /// CHECK:     InstanceFieldSet
+  /// CHECK:     ConstructorFence
+  /// CHECK:     StaticFieldSet
+
+  /// CHECK-START: int Main.$noinline$finalFieldEscape(int, boolean) load_store_elimination (after)
+  /// CHECK:     NewInstance
+  /// CHECK-NOT: NewInstance
+  static int $noinline$finalFieldEscape(int x, boolean escape) {
+    FinalPoint p = new FinalPoint(x);
+    if (escape) {
+      sSink = p;
+    }
+    return 0;
+  }
+
+  // The field is read after the escape, so the allocation stays where it is.
+
+  /// CHECK-START: int Main.$noinline$accessAfterEscape(int, boolean) load_store_elimination (after)
+  /// CHECK:     NewInstance
+  /// CHECK:     If
+  /// CHECK:     InstanceFieldGet
+
+  /// CHECK-START: int Main.$noinline$accessAfterEscape(int, boolean) load_store_elimination (after)
+  /// CHECK:     NewInstance
+  /// CHECK-NOT: NewInstance
+  static int $noinline$accessAfterEscape(int x, boolean escape) {
+    Point p = new Point();
+    p.x = x;
+    if (escape) {
+      $noinline$update(p);
+    }
+    return p.x;
+  }
+
+  // The allocation escapes on every path, so it stays where it is.
+
+  /// CHECK-START: int Main.$noinline$escapeOnAllPaths(int, boolean) load_store_elimination (after)
+  /// CHECK:     NewInstance
+  /// CHECK:     If
+  /// CHECK-NOT: NewInstance
+  static int $noinline$escapeOnAllPaths(int x, boolean escape) {
+    Point p = new Point();
+    p.x = x;
+    if (escape) {
+      sSink = p;
+    } else {
+      $noinline$update(p);
+    }
+    return 0;
+  }
+
+  // Without heap stores, load-store elimination bails out before removing anything, so the
+  // allocation is not copied on the escaping path either.
+
+  /// CHECK-START: int Main.$noinline$escapeWithoutStores(boolean) load_store_elimination (after)
+  /// CHECK:     NewInstance
+  /// CHECK:     If
+  /// CHECK-NOT: NewInstance
+  static int $noinline$escapeWithoutStores(boolean escape) {
+    Object o = new Object();
+    if (escape) {
+      $noinline$consume(o);
+    }
+    return 0;
+  }
+
+  static void $noinline$update(Point p) {
+    p.x = 100;
+  }
+
+  static void $noinline$consume(Object o) {
+    sSink = o;
+  }
+
+  public static void main(String[] args) {
+    assertEquals(52, $noinline$rareEscape(10, false));
+    assertEquals(null, sSink);
+    assertEquals(-1, $noinline$rareEscape(10, true));
+    assertEquals(10, ((Point) sSink).x);
+    assertEquals(42, ((Point) sSink).y);
+
+    sSink = null;
+    assertEquals(7, $noinline$escapeAfterUpdate(7, false));
+    assertEquals(null, sSink);
+    assertEquals(0, $noinline$escapeAfterUpdate(7, true));
+    assertEquals(8, ((Point) sSink).x);
+
+    sSink = null;
+    assertEquals(6, $noinline$callEscape(6, false));
+    assertEquals(null, sSink);
+    assertEquals(-1, $noinline$callEscape(6, true));
+    assertEquals(6, ((Point) sSink).x);
+
+    sSink = null;
+    assertEquals(10, $noinline$escapeInLoop(10));
+    assertEquals(null, sSink);
+    assertEquals(100, $noinline$escapeInLoop(100));
+    assertEquals(42, ((Point) sSink).x);
+    assertEquals(42, ((Point) sSink).y);
+
+    sSink = null;
+    assertEquals(0, $noinline$finalFieldEscape(3, false));
+    assertEquals(null, sSink);
+    assertEquals(0, $noinline$finalFieldEscape(3, true));
+    assertEquals(3, ((FinalPoint) sSink).x);
+
+    assertEquals(5, $noinline$accessAfterEscape(5, false));
+    assertEquals(100, $noinline$accessAfterEscape(5, true));
+
+    sSink = null;
+    assertEquals(0, $noinline$escapeOnAllPaths(4, true));
+    assertEquals(4, ((Point) sSink).x);
+
+    sSink = null;
+    assertEquals(0, $noinline$escapeWithoutStores(false));
+    assertEquals(null, sSink);
+    assertEquals(0, $noinline$escapeWithoutStores(true));
+    if (sSink == null) {
+      throw new Error("Expected the object to escape");
+    }
+  }
+
+  static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  static void assertEquals(Object expected, Object actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+}
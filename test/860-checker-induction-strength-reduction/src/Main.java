@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+
+  /// CHECK-START: int Main.$noinline$sumStrided(int[], int) induction_var_strength_reduction (before)
+  /// CHECK-DAG: <<C10:i\d+>> IntConstant 10                           loop:none
+  /// CHECK-DAG:              Mul [<<Phi:i\d+>>,<<C10>>]               loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: <<Phi>>      Phi                                      loop:<<Loop>>      outer_loop:none
+
+  /// CHECK-START: int Main.$noinline$sumStrided(int[], int) induction_var_strength_reduction (after)
+  /// CHECK-DAG: <<C0:i\d+>>  IntConstant 0                            loop:none
+  /// CHECK-DAG: <<C10:i\d+>> IntConstant 10                           loop:none
+  /// CHECK-DAG: <<Add:i\d+>> Add [<<Phi:i\d+>>,<<C10>>]               loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: <<Phi>>      Phi [<<C0>>,<<Add>>]                     loop:<<Loop>>      outer_loop:none
+
+  /// CHECK-START: int Main.$noinline$sumStrided(int[], int) induction_var_strength_reduction (after)
+  /// CHECK-NOT: Mul
+  static int $noinline$sumStrided(int[] a, int n) {
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+      sum += a[i * 10];
+    }
+    return sum;
+  }
+
+  // The multiplication by 3 is simplified into a shift and an addition first.
+
+  /// CHECK-START: int Main.$noinline$sumShiftAndAdd(int[], int) induction_var_strength_reduction (before)
+  /// CHECK-DAG: <<Shl:i\d+>> Shl [<<Phi:i\d+>>,{{i\d+}}]              loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: <<Phi>>      Phi                                      loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:              Add [<<Phi>>,<<Shl>>]                    loop:<<Loop>>      outer_loop:none
+
+  /// CHECK-START: int Main.$noinline$sumShiftAndAdd(int[], int) induction_var_strength_reduction (after)
+  /// CHECK-DAG: <<C3:i\d+>>  IntConstant 3                            loop:none
+  /// CHECK-DAG: <<Add:i\d+>> Add [<<Phi:i\d+>>,<<C3>>]                loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: <<Phi>>      Phi [{{i\d+}},<<Add>>]                   loop:<<Loop>>      outer_loop:none
+
+  /// CHECK-START: int Main.$noinline$sumShiftAndAdd(int[], int) induction_var_strength_reduction (after)
+  /// CHECK-NOT: Shl
+  static int $noinline$sumShiftAndAdd(int[] a, int n) {
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+      sum += a[i * 3];
+    }
+    return sum;
+  }
+
+  // With a known trip count, the loop test is rewritten in terms of the reduced
+  // induction, after which the basic induction is no longer needed.
+
+  /// CHECK-START: int Main.$noinline$sumStridedConstant(int[]) induction_var_strength_reduction (before)
+  /// CHECK-DAG: <<C1001:i\d+>> IntConstant 1001                       loop:none
+  /// CHECK-DAG:                {{(Greater|Less)Than\w*}} [<<Phi:i\d+>>,<<C1001>>] loop:<<Loop:B\d+>>
+  /// CHECK-DAG: <<Phi>>        Phi                                    loop:<<Loop>>      outer_loop:none
+
+  /// CHECK-START: int Main.$noinline$sumStridedConstant(int[]) induction_var_strength_reduction (after)
+  /// CHECK-DAG: <<C5:i\d+>>    IntConstant 5                          loop:none
+  /// CHECK-DAG: <<Last:i\d+>>  IntConstant 5005                       loop:none
+  /// CHECK-DAG: <<Add:i\d+>>   Add [<<Phi:i\d+>>,<<C5>>]              loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG:                {{(Not)?Equal}} [<<Phi>>,<<Last>>]     loop:<<Loop>>      outer_loop:none
+
+  /// CHECK-START: int Main.$noinline$sumStridedConstant(int[]) induction_var_strength_reduction (after)
+  /// CHECK-NOT: Mul
+  /// CHECK-NOT: {{(Greater|Less)Than}}
+  static int $noinline$sumStridedConstant(int[] a) {
+    int sum = 0;
+    for (int i = 0; i < 1001; i++) {
+      sum += a[i * 5];
+    }
+    return sum;
+  }
+
+  public static void main(String[] args) {
+    int[] a = new int[5005];
+    for (int i = 0; i < a.length; i++) {
+      a[i] = i;
+    }
+
+    assertEquals(0, $noinline$sumStrided(a, 0));
+    assertEquals(450, $noinline$sumStrided(a, 10));
+    assertEquals(3, $noinline$sumShiftAndAdd(a, 2));
+    assertEquals(135, $noinline$sumShiftAndAdd(a, 10));
+    assertEquals(2502500, $noinline$sumStridedConstant(a));
+
+    try {
+      $noinline$sumStrided(a, 502);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+  }
+
+  static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+}
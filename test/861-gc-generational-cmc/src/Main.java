@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.ref.WeakReference;
+
+public class Main {
+  static class Node {
+    Node(int value) {
+      this.value = value;
+    }
+
+    final int value;
+    Node next;
+    Object young;
+  }
+
+  static final int NODE_COUNT = 10000;
+  static final int ROUNDS = 40;
+
+  static Object sSink;
+
+  public static void main(String[] args) {
+    // Build a list that gets promoted to the old generation by a full-heap cycle.
+    Node head = null;
+    for (int i = NODE_COUNT - 1; i >= 0; i--) {
+      Node node = new Node(i);
+      node.next = head;
+      head = node;
+    }
+    Runtime.getRuntime().gc();
+
+    for (int round = 0; round < ROUNDS; round++) {
+      // Store young objects in the old nodes. Only the card table keeps them
+      // reachable during young-gen cycles.
+      int i = 0;
+      for (Node node = head; node != null; node = node.next, i++) {
+        if (i % 7 == round % 7) {
+          node.young = new Node(round * NODE_COUNT + node.value);
+        }
+      }
+      // Allocate enough garbage to trigger young-gen cycles.
+      WeakReference<Object> weak = null;
+      for (int j = 0; j < 100000; j++) {
+        Object garbage = new int[16];
+        if (j == 0) {
+          weak = new WeakReference<>(garbage);
+        }
+        sSink = garbage;
+      }
+      sSink = null;
+      if (round % 10 == 9) {
+        Runtime.getRuntime().gc();
+        if (weak.get() != null) {
+          System.out.println("weak reference not cleared in round " + round);
+        }
+      }
+      check(head, round);
+    }
+    System.out.println("passed");
+  }
+
+  static void check(Node head, int round) {
+    int i = 0;
+    for (Node node = head; node != null; node = node.next, i++) {
+      if (node.value != i) {
+        throw new Error("Unexpected value " + node.value + " at " + i);
+      }
+      if (node.young == null) {
+        // Only possible for the nodes not written to yet.
+        if (round >= 6) {
+          throw new Error("Missing young object at " + i);
+        }
+        continue;
+      }
+      int youngValue = ((Node) node.young).value;
+      if (youngValue % NODE_COUNT != i || youngValue / NODE_COUNT > round) {
+        throw new Error("Unexpected young value " + youngValue + " at " + i);
+      }
+    }
+    if (i != NODE_COUNT) {
+      throw new Error("Unexpected length " + i);
+    }
+  }
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  static class Node {
+    Node(int value, Node next) {
+      this.value = value;
+      this.next = next;
+      this.payload = new int[value % 64];
+      for (int i = 0; i < payload.length; i++) {
+        payload[i] = value + i;
+      }
+    }
+
+    final int value;
+    final Node next;
+    final int[] payload;
+  }
+
+  static final int NODE_COUNT = 100000;
+
+  public static void main(String[] args) {
+    // Interleave live and dead objects over many pages, so that every page of
+    // the moving space needs to be compacted.
+    Node head = null;
+    Object[] garbage = new Object[NODE_COUNT];
+    for (int i = 0; i < NODE_COUNT; i++) {
+      head = new Node(i, head);
+      garbage[i] = new Node(i, null);
+    }
+    garbage = null;
+
+    for (int round = 0; round < 5; round++) {
+      Runtime.getRuntime().gc();
+      check(head);
+      // Allocate more garbage for the next round.
+      garbage = new Object[NODE_COUNT / 2];
+      for (int i = 0; i < garbage.length; i++) {
+        garbage[i] = new Node(i, null);
+      }
+      garbage = null;
+    }
+    System.out.println("passed");
+  }
+
+  static void check(Node head) {
+    int expected = NODE_COUNT - 1;
+    for (Node node = head; node != null; node = node.next, expected--) {
+      if (node.value != expected) {
+        throw new Error("Unexpected value " + node.value + ", expected " + expected);
+      }
+      if (node.payload.length != node.value % 64) {
+        throw new Error("Unexpected payload length " + node.payload.length);
+      }
+      for (int i = 0; i < node.payload.length; i++) {
+        if (node.payload[i] != node.value + i) {
+          throw new Error("Unexpected payload at " + node.value);
+        }
+      }
+    }
+    if (expected != -1) {
+      throw new Error("Unexpected list length");
+    }
+  }
+}
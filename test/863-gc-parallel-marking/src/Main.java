@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.ref.WeakReference;
+
+public class Main {
+  static class Tree {
+    Tree(int depth, int value) {
+      this.value = value;
+      if (depth > 0) {
+        left = new Tree(depth - 1, 2 * value);
+        right = new Tree(depth - 1, 2 * value + 1);
+      }
+    }
+
+    final int value;
+    Tree left;
+    Tree right;
+  }
+
+  static final int DEPTH = 16;
+  static final int THREAD_COUNT = 4;
+
+  public static void main(String[] args) throws Exception {
+    // A wide graph gives all the markers work to steal from each other.
+    Tree tree = new Tree(DEPTH, 1);
+    WeakReference<Tree> weak = new WeakReference<>(new Tree(4, 1));
+
+    // Mutators allocate and modify the graph while the GC marks it.
+    Thread[] threads = new Thread[THREAD_COUNT];
+    for (int i = 0; i < THREAD_COUNT; i++) {
+      final int index = i;
+      threads[i] = new Thread(() -> {
+        Tree own = new Tree(10, 1);
+        for (int round = 0; round < 20; round++) {
+          own.left = new Tree(9, 2);
+          check(own, 10, 1);
+          for (int j = 0; j < 10000; j++) {
+            new Tree(2, index);
+          }
+        }
+      });
+      threads[i].start();
+    }
+    for (int round = 0; round < 10; round++) {
+      Runtime.getRuntime().gc();
+      check(tree, DEPTH, 1);
+    }
+    for (Thread thread : threads) {
+      thread.join();
+    }
+    if (weak.get() != null) {
+      System.out.println("weak reference not cleared");
+    }
+    System.out.println("passed");
+  }
+
+  static void check(Tree tree, int depth, int value) {
+    if (tree.value != value) {
+      throw new Error("Unexpected value " + tree.value + ", expected " + value);
+    }
+    if (depth > 0) {
+      check(tree.left, depth - 1, 2 * value);
+      check(tree.right, depth - 1, 2 * value + 1);
+    } else if (tree.left != null || tree.right != null) {
+      throw new Error("Unexpected subtree at " + value);
+    }
+  }
+}
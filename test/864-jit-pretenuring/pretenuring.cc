@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gc/heap.h"
+#include "gc/space/malloc_space.h"
+#include "jit/jit.h"
+#include "jni.h"
+#include "mirror/object-inl.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+namespace {
+
+// Whether the JIT samples allocation sites and compiles optimized code that can pretenure them.
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_canPretenure(JNIEnv*, jclass) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  return (jit != nullptr &&
+          jit->GetAllocationSiteSampler() != nullptr &&
+          !jit->GetJitCompiler()->IsBaselineCompiler()) ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_isInNonMovingSpace(JNIEnv* env,
+                                                                   jclass,
+                                                                   jobject object) {
+  ScopedObjectAccess soa(env);
+  gc::space::MallocSpace* space = Runtime::Current()->GetHeap()->GetNonMovingSpace();
+  return space->Contains(soa.Decode<mirror::Object>(object).Ptr()) ? JNI_TRUE : JNI_FALSE;
+}
+
+}  // namespace
+}  // namespace art
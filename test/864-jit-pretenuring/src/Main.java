@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  // Arrays below the large object threshold, so that they are allocated by the
+  // allocation site rather than in the large object space.
+  static final int ARRAY_LENGTH = 2048;
+  static final int KEPT_COUNT = 1024;
+  static final int ROUNDS = 40;
+
+  static Object[] kept = new Object[KEPT_COUNT];
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    if (!canPretenure()) {
+      // No JIT, or a collector that does not copy survivors.
+      System.out.println("passed");
+      return;
+    }
+
+    // Baseline code samples the allocations that reach the runtime. All of them
+    // are still referenced by `kept` at the next collection, so they survive.
+    ensureJitBaselineCompiled(Main.class, "$noinline$fill");
+    for (int round = 0; round < ROUNDS; ++round) {
+      $noinline$fill(kept, round);
+      Runtime.getRuntime().gc();
+      check(kept, round);
+    }
+
+    // Optimized code allocates through the pretenured entrypoint.
+    ensureJitCompiled(Main.class, "$noinline$fill");
+    $noinline$fill(kept, ROUNDS);
+    for (int i = 0; i < KEPT_COUNT; ++i) {
+      if (!isInNonMovingSpace(kept[i])) {
+        throw new Error("Expected a pretenured array at index " + i);
+      }
+    }
+    Runtime.getRuntime().gc();
+    check(kept, ROUNDS);
+
+    System.out.println("passed");
+  }
+
+  static void $noinline$fill(Object[] array, int value) {
+    for (int i = 0; i < array.length; ++i) {
+      int[] payload = new int[ARRAY_LENGTH];
+      payload[0] = value;
+      payload[ARRAY_LENGTH - 1] = i;
+      array[i] = payload;
+    }
+  }
+
+  static void check(Object[] array, int value) {
+    for (int i = 0; i < array.length; ++i) {
+      int[] payload = (int[]) array[i];
+      if (payload.length != ARRAY_LENGTH ||
+          payload[0] != value ||
+          payload[ARRAY_LENGTH - 1] != i) {
+        throw new Error("Unexpected payload at index " + i);
+      }
+    }
+  }
+
+  private static native boolean canPretenure();
+  private static native boolean isInNonMovingSpace(Object object);
+  private static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+}
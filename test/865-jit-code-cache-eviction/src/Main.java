@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    if (!hasJit()) {
+      return;
+    }
+
+    ensureJitCompiled(Main.class, "$noinline$cold");
+    ensureJitCompiled(Main.class, "$noinline$hot");
+    assertTrue(hasJitCompiledEntrypoint(Main.class, "$noinline$cold"));
+    assertTrue(hasJitCompiledEntrypoint(Main.class, "$noinline$hot"));
+
+    // The code of `$noinline$hot` is on the stack when the eviction samples the code usage,
+    // the code of `$noinline$cold` is not.
+    assertTrue($noinline$hot() > 0);
+    assertFalse(hasJitCompiledEntrypoint(Main.class, "$noinline$cold"));
+    assertTrue(hasJitCompiledEntrypoint(Main.class, "$noinline$hot"));
+
+    // The evicted method still runs, and can be compiled again.
+    assertEquals(42, $noinline$cold(41));
+    ensureJitCompiled(Main.class, "$noinline$cold");
+    assertTrue(hasJitCompiledEntrypoint(Main.class, "$noinline$cold"));
+    assertEquals(42, $noinline$cold(41));
+  }
+
+  public static int $noinline$cold(int x) {
+    return x + 1;
+  }
+
+  public static int $noinline$hot() {
+    return evictColdJitCode();
+  }
+
+  public static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  public static void assertTrue(boolean value) {
+    if (!value) {
+      throw new Error("Expected true");
+    }
+  }
+
+  public static void assertFalse(boolean value) {
+    if (value) {
+      throw new Error("Expected false");
+    }
+  }
+
+  private static native boolean hasJit();
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+  private static native boolean hasJitCompiledEntrypoint(Class<?> cls, String methodName);
+  private static native int evictColdJitCode();
+}
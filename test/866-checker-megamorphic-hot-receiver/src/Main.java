@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+
+  // Baseline code only counts the receivers of inline caches on arm64 and x86-64.
+
+  /// CHECK-START-{ARM64,X86_64}: int Main.$noinline$megamorphicCall(Super) inliner (before)
+  /// CHECK:       InvokeVirtual method_name:Super.getValue
+
+  /// CHECK-START-{ARM64,X86_64}: int Main.$noinline$megamorphicCall(Super) inliner (after)
+  /// CHECK-DAG:   <<Hot:i\d+>>    IntConstant 42
+  /// CHECK-DAG:   <<Call:i\d+>>   InvokeVirtual method_name:Super.getValue
+  /// CHECK-DAG:   <<Phi:i\d+>>    Phi [{{i\d+}},{{i\d+}}]
+  /// CHECK-DAG:                   Return [<<Phi>>]
+
+  /// CHECK-START-{ARM64,X86_64}: int Main.$noinline$megamorphicCall(Super) inliner (after)
+  /// CHECK-NOT:   Deoptimize
+
+  public static int $noinline$megamorphicCall(Super s) {
+    return s.getValue();
+  }
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    Super[] others = { new SubB(), new SubC(), new SubD(), new SubE(), new SubF() };
+    Super hot = new SubA();
+
+    ensureJitBaselineCompiled(Main.class, "$noinline$megamorphicCall");
+    // Fill the inline cache with the hot receiver first, then make the call megamorphic.
+    check(42, $noinline$megamorphicCall(hot));
+    for (int i = 0; i < others.length; ++i) {
+      check(i + 1, $noinline$megamorphicCall(others[i]));
+    }
+    // Most of the receivers are `SubA`.
+    for (int i = 0; i < 100000; ++i) {
+      check(42, $noinline$megamorphicCall(hot));
+      if ((i % 10) == 0) {
+        Super other = others[(i / 10) % others.length];
+        check(other.getValue(), $noinline$megamorphicCall(other));
+      }
+    }
+
+    ensureJitCompiled(Main.class, "$noinline$megamorphicCall");
+    // Both the inlined receiver and the others go through the optimized code.
+    check(42, $noinline$megamorphicCall(hot));
+    for (int i = 0; i < others.length; ++i) {
+      check(i + 1, $noinline$megamorphicCall(others[i]));
+    }
+  }
+
+  static void check(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  private static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+}
+
+abstract class Super {
+  abstract int getValue();
+}
+
+class SubA extends Super {
+  int getValue() { return 42; }
+}
+
+class SubB extends Super {
+  int getValue() { return 1; }
+}
+
+class SubC extends Super {
+  int getValue() { return 2; }
+}
+
+class SubD extends Super {
+  int getValue() { return 3; }
+}
+
+class SubE extends Super {
+  int getValue() { return 4; }
+}
+
+class SubF extends Super {
+  int getValue() { return 5; }
+}
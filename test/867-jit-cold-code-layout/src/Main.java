@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  static class Box {
+    Box(int value) {
+      this.value = value;
+    }
+
+    int value;
+  }
+
+  static final int COLD = 1000;
+  static final int THROW_LINE = 40;
+
+  public static int $noinline$withCatch(int x) {
+    try {
+      return $noinline$coldThrow(x);
+    } catch (IllegalStateException e) {
+      return -1;
+    }
+  }
+
+  public static int $noinline$coldThrow(int x) {
+    if (x == COLD) {
+      // Keep this statement on line THROW_LINE.
+      throw new IllegalStateException("cold");
+    }
+    return x + 1;
+  }
+
+  public static int $noinline$coldGc(Box box, int x) {
+    int result = x;
+    if (x == COLD) {
+      Box other = new Box(2);
+      Runtime.getRuntime().gc();
+      result += other.value;
+    }
+    // `box` is live across the GC above, and may have moved.
+    return result + box.value;
+  }
+
+  public static int $noinline$coldLoopExit(int[] array, int x) {
+    int sum = 0;
+    for (int i = 0; i < array.length; ++i) {
+      if (array[i] == x) {
+        // Never taken during the warm-up.
+        sum = -sum;
+        break;
+      }
+      sum += array[i];
+    }
+    return sum;
+  }
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    String[] methods = {
+        "$noinline$withCatch", "$noinline$coldThrow", "$noinline$coldGc", "$noinline$coldLoopExit"
+    };
+    for (String method : methods) {
+      ensureJitBaselineCompiled(Main.class, method);
+    }
+    Box box = new Box(1);
+    int[] array = { 1, 2, 3, 4 };
+    for (int i = 0; i < 10000; ++i) {
+      expectEquals(i % 100 + 1, $noinline$withCatch(i % 100));
+      expectEquals(i % 100 + 1, $noinline$coldGc(box, i % 100));
+      expectEquals(10, $noinline$coldLoopExit(array, 0));
+    }
+    for (String method : methods) {
+      ensureJitCompiled(Main.class, method);
+      if (!hasJitCompiledCode(Main.class, method)) {
+        throw new Error("Expected " + method + " to be JIT compiled");
+      }
+    }
+
+    // The hot paths.
+    expectEquals(6, $noinline$withCatch(5));
+    expectEquals(6, $noinline$coldGc(box, 5));
+    expectEquals(10, $noinline$coldLoopExit(array, 5));
+
+    // The cold paths.
+    expectEquals(-1, $noinline$withCatch(COLD));
+    try {
+      $noinline$coldThrow(COLD);
+      throw new Error("Expected IllegalStateException");
+    } catch (IllegalStateException e) {
+      StackTraceElement[] trace = e.getStackTrace();
+      expectEquals("$noinline$coldThrow", trace[0].getMethodName());
+      expectEquals(THROW_LINE, trace[0].getLineNumber());
+      expectEquals("main", trace[1].getMethodName());
+    }
+    expectEquals(COLD + 2 + 1, $noinline$coldGc(box, COLD));
+    expectEquals(-3, $noinline$coldLoopExit(array, 3));
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(String expected, String result) {
+    if (!expected.equals(result)) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  public static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+  public static native void ensureJitCompiled(Class<?> cls, String methodName);
+  public static native boolean hasJitCompiledCode(Class<?> cls, String methodName);
+}
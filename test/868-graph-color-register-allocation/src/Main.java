@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  static final int N = 24;
+
+  // More values than registers are live across a loop which does not use them.
+  static int $noinline$liveAcrossLoop(int[] a, int n) {
+    int v0 = a[0];
+    int v1 = a[1];
+    int v2 = a[2];
+    int v3 = a[3];
+    int v4 = a[4];
+    int v5 = a[5];
+    int v6 = a[6];
+    int v7 = a[7];
+    int v8 = a[8];
+    int v9 = a[9];
+    int v10 = a[10];
+    int v11 = a[11];
+    int v12 = a[12];
+    int v13 = a[13];
+    int v14 = a[14];
+    int v15 = a[15];
+    int v16 = a[16];
+    int v17 = a[17];
+    int v18 = a[18];
+    int v19 = a[19];
+    int v20 = a[20];
+    int v21 = a[21];
+    int v22 = a[22];
+    int v23 = a[23];
+    int count = 0;
+    for (int i = 0; i < n; ++i) {
+      count += i;
+    }
+    return count +
+        v0 + v1 + v2 + v3 + v4 + v5 + v6 + v7 + v8 + v9 + v10 + v11 + v12 + v13 + v14 + v15 +
+        v16 + v17 + v18 + v19 + v20 + v21 + v22 + v23;
+  }
+
+  // The values are live across calls, which clobber the caller-save registers.
+  static int $noinline$liveAcrossCalls(int[] a, int n) {
+    int v0 = a[0];
+    int v1 = a[1];
+    int v2 = a[2];
+    int v3 = a[3];
+    int v4 = a[4];
+    int v5 = a[5];
+    int v6 = a[6];
+    int v7 = a[7];
+    int v8 = a[8];
+    int v9 = a[9];
+    int v10 = a[10];
+    int v11 = a[11];
+    int v12 = a[12];
+    int v13 = a[13];
+    int v14 = a[14];
+    int v15 = a[15];
+    int v16 = a[16];
+    int v17 = a[17];
+    int v18 = a[18];
+    int v19 = a[19];
+    int v20 = a[20];
+    int v21 = a[21];
+    int v22 = a[22];
+    int v23 = a[23];
+    int count = 0;
+    for (int i = 0; i < n; ++i) {
+      count += $noinline$identity(i);
+    }
+    return count +
+        v0 + v1 + v2 + v3 + v4 + v5 + v6 + v7 + v8 + v9 + v10 + v11 + v12 + v13 + v14 + v15 +
+        v16 + v17 + v18 + v19 + v20 + v21 + v22 + v23;
+  }
+
+  // The values are used on every iteration.
+  static int $noinline$usedInLoop(int[] a, int n) {
+    int v0 = a[0];
+    int v1 = a[1];
+    int v2 = a[2];
+    int v3 = a[3];
+    int v4 = a[4];
+    int v5 = a[5];
+    int v6 = a[6];
+    int v7 = a[7];
+    int v8 = a[8];
+    int v9 = a[9];
+    int v10 = a[10];
+    int v11 = a[11];
+    int v12 = a[12];
+    int v13 = a[13];
+    int v14 = a[14];
+    int v15 = a[15];
+    int v16 = a[16];
+    int v17 = a[17];
+    int v18 = a[18];
+    int v19 = a[19];
+    int v20 = a[20];
+    int v21 = a[21];
+    int v22 = a[22];
+    int v23 = a[23];
+    int sum = 0;
+    for (int i = 0; i < n; ++i) {
+      sum += i +
+          v0 + v1 + v2 + v3 + v4 + v5 + v6 + v7 + v8 + v9 + v10 + v11 + v12 + v13 + v14 + v15 +
+          v16 + v17 + v18 + v19 + v20 + v21 + v22 + v23;
+    }
+    return sum;
+  }
+
+  // Register pairs on 32-bit targets.
+  static long $noinline$longsAcrossCalls(long[] a, int n) {
+    long v0 = a[0];
+    long v1 = a[1];
+    long v2 = a[2];
+    long v3 = a[3];
+    long v4 = a[4];
+    long v5 = a[5];
+    long v6 = a[6];
+    long v7 = a[7];
+    long v8 = a[8];
+    long v9 = a[9];
+    long v10 = a[10];
+    long v11 = a[11];
+    long v12 = a[12];
+    long v13 = a[13];
+    long v14 = a[14];
+    long v15 = a[15];
+    long v16 = a[16];
+    long v17 = a[17];
+    long v18 = a[18];
+    long v19 = a[19];
+    long v20 = a[20];
+    long v21 = a[21];
+    long v22 = a[22];
+    long v23 = a[23];
+    long count = 0;
+    for (int i = 0; i < n; ++i) {
+      count += $noinline$identity(i);
+    }
+    return count +
+        v0 + v1 + v2 + v3 + v4 + v5 + v6 + v7 + v8 + v9 + v10 + v11 + v12 + v13 + v14 + v15 +
+        v16 + v17 + v18 + v19 + v20 + v21 + v22 + v23;
+  }
+
+  static double $noinline$doublesAcrossCalls(double[] a, int n) {
+    double v0 = a[0];
+    double v1 = a[1];
+    double v2 = a[2];
+    double v3 = a[3];
+    double v4 = a[4];
+    double v5 = a[5];
+    double v6 = a[6];
+    double v7 = a[7];
+    double v8 = a[8];
+    double v9 = a[9];
+    double v10 = a[10];
+    double v11 = a[11];
+    double v12 = a[12];
+    double v13 = a[13];
+    double v14 = a[14];
+    double v15 = a[15];
+    double v16 = a[16];
+    double v17 = a[17];
+    double v18 = a[18];
+    double v19 = a[19];
+    double v20 = a[20];
+    double v21 = a[21];
+    double v22 = a[22];
+    double v23 = a[23];
+    double count = 0;
+    for (int i = 0; i < n; ++i) {
+      count += $noinline$identity(i);
+    }
+    return count +
+        v0 + v1 + v2 + v3 + v4 + v5 + v6 + v7 + v8 + v9 + v10 + v11 + v12 + v13 + v14 + v15 +
+        v16 + v17 + v18 + v19 + v20 + v21 + v22 + v23;
+  }
+
+  static int $noinline$identity(int i) {
+    return i;
+  }
+
+  public static void main(String[] args) {
+    int[] ints = new int[N];
+    long[] longs = new long[N];
+    double[] doubles = new double[N];
+    int sum = 0;
+    for (int i = 0; i < N; ++i) {
+      ints[i] = i * 3 + 1;
+      longs[i] = (1L << 33) + i;
+      doubles[i] = i * 0.5;
+      sum += ints[i];
+    }
+    long longSum = N * (1L << 33) + N * (N - 1) / 2;
+    double doubleSum = N * (N - 1) / 4.0;
+
+    for (int n : new int[] { 0, 1, 10, 100 }) {
+      int count = n * (n - 1) / 2;
+      assertEquals(sum + count, $noinline$liveAcrossLoop(ints, n));
+      assertEquals(sum + count, $noinline$liveAcrossCalls(ints, n));
+      assertEquals(n * sum + count, $noinline$usedInLoop(ints, n));
+      assertEquals(longSum + count, $noinline$longsAcrossCalls(longs, n));
+      assertEquals(doubleSum + count, $noinline$doublesAcrossCalls(doubles, n));
+    }
+    System.out.println("passed");
+  }
+
+  static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  static void assertEquals(long expected, long actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  static void assertEquals(double expected, double actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+}
@@ -0,0 +1,28 @@
+#!/bin/bash
+#
+# Copyright 2026 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+def has_avx2():
+  with open("/proc/cpuinfo") as cpuinfo:
+    return any(line.startswith("flags") and "avx2" in line.split() for line in cpuinfo)
+
+
+def run(ctx, args):
+  # Only compile for AVX2 where the code can also run.
+  if args.host and has_avx2():
+    ctx.default_run(args, Xcompiler_option=["--instruction-set-features=avx2"])
+  else:
+    ctx.default_run(args)
@@ -0,0 +1,313 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Tests for the 256-bit vectorization of loops on x86-64 with AVX2.
+ */
+public class Main {
+
+  // Not a multiple of any vector length, so that the cleanup loops run too.
+  static final int N = 1003;
+  static final int K = 20;
+
+  //
+  // Loops.
+  //
+
+  /// CHECK-START-X86_64: void Main.$noinline$addInt(int[], int) loop_optimization (after)
+  /// CHECK-IF: hasIsaFeature('avx2')
+  //
+  ///     CHECK-DAG: <<Cons:i\d+>>   IntConstant 8                        loop:none
+  ///     CHECK-DAG: <<Repl:d\d+>>   VecReplicateScalar [{{i\d+}}]        loop:none
+  ///     CHECK-DAG: <<Phi:i\d+>>    Phi                                  loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Load:d\d+>>   VecLoad [{{l\d+}},<<I:i\d+>>]        loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Add:d\d+>>    VecAdd [<<Load>>,<<Repl>>]           loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 VecStore [{{l\d+}},<<I>>,<<Add>>]    loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 Add [<<I>>,<<Cons>>]                 loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-FI:
+  private static void $noinline$addInt(int[] a, int x) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] += x;
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.$noinline$addByte(byte[], byte) loop_optimization (after)
+  /// CHECK-IF: hasIsaFeature('avx2')
+  //
+  ///     CHECK-DAG: <<Cons:i\d+>>   IntConstant 32                       loop:none
+  ///     CHECK-DAG: <<Repl:d\d+>>   VecReplicateScalar [{{b\d+}}]        loop:none
+  ///     CHECK-DAG: <<Load:d\d+>>   VecLoad [{{l\d+}},<<I:i\d+>>]        loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Add:d\d+>>    VecAdd [<<Load>>,<<Repl>>]           loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 VecStore [{{l\d+}},<<I>>,<<Add>>]    loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 Add [<<I>>,<<Cons>>]                 loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-FI:
+  private static void $noinline$addByte(byte[] a, byte x) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] += x;
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.$noinline$mulDouble(double[], double) loop_optimization (after)
+  /// CHECK-IF: hasIsaFeature('avx2')
+  //
+  ///     CHECK-DAG: <<Cons:i\d+>>   IntConstant 4                        loop:none
+  ///     CHECK-DAG: <<Repl:d\d+>>   VecReplicateScalar [{{d\d+}}]        loop:none
+  ///     CHECK-DAG: <<Load:d\d+>>   VecLoad [{{l\d+}},<<I:i\d+>>]        loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Mul:d\d+>>    VecMul [<<Load>>,<<Repl>>]           loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 VecStore [{{l\d+}},<<I>>,<<Mul>>]    loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 Add [<<I>>,<<Cons>>]                 loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-FI:
+  private static void $noinline$mulDouble(double[] a, double x) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] *= x;
+    }
+  }
+
+  //
+  // Reductions.
+  //
+
+  /// CHECK-START-X86_64: int Main.$noinline$sumInt(int[]) loop_optimization (after)
+  /// CHECK-IF: hasIsaFeature('avx2')
+  //
+  ///     CHECK-DAG: <<Cons:i\d+>>   IntConstant 8                        loop:none
+  ///     CHECK-DAG: <<Set:d\d+>>    VecSetScalars [{{i\d+}}]             loop:none
+  ///     CHECK-DAG: <<Phi:d\d+>>    Phi [<<Set>>,{{d\d+}}]               loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Load:d\d+>>   VecLoad [{{l\d+}},<<I:i\d+>>]        loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 VecAdd [<<Phi>>,<<Load>>]            loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 Add [<<I>>,<<Cons>>]                 loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Red:d\d+>>    VecReduce [<<Phi>>]                  loop:none
+  ///     CHECK-DAG: <<Extr:i\d+>>   VecExtractScalar [<<Red>>]           loop:none
+  //
+  /// CHECK-FI:
+  private static int $noinline$sumInt(int[] a) {
+    int sum = 0;
+    for (int i = 0; i < a.length; i++) {
+      sum += a[i];
+    }
+    return sum;
+  }
+
+  /// CHECK-START-X86_64: long Main.$noinline$sumLong(long[]) loop_optimization (after)
+  /// CHECK-IF: hasIsaFeature('avx2')
+  //
+  ///     CHECK-DAG: <<Cons:i\d+>>   IntConstant 4                        loop:none
+  ///     CHECK-DAG: <<Set:d\d+>>    VecSetScalars [{{j\d+}}]             loop:none
+  ///     CHECK-DAG: <<Phi:d\d+>>    Phi [<<Set>>,{{d\d+}}]               loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Load:d\d+>>   VecLoad [{{l\d+}},<<I:i\d+>>]        loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 VecAdd [<<Phi>>,<<Load>>]            loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 Add [<<I>>,<<Cons>>]                 loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Red:d\d+>>    VecReduce [<<Phi>>]                  loop:none
+  ///     CHECK-DAG: <<Extr:j\d+>>   VecExtractScalar [<<Red>>]           loop:none
+  //
+  /// CHECK-FI:
+  private static long $noinline$sumLong(long[] a) {
+    long sum = 0;
+    for (int i = 0; i < a.length; i++) {
+      sum += a[i];
+    }
+    return sum;
+  }
+
+  /// CHECK-START-X86_64: int Main.$noinline$maxInt(int[]) loop_optimization (after)
+  /// CHECK-IF: hasIsaFeature('avx2')
+  //
+  ///     CHECK-DAG: <<Cons:i\d+>>   IntConstant 8                        loop:none
+  ///     CHECK-DAG: <<Phi:d\d+>>    Phi                                  loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Load:d\d+>>   VecLoad [{{l\d+}},<<I:i\d+>>]        loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 VecMax [<<Phi>>,<<Load>>]            loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 Add [<<I>>,<<Cons>>]                 loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Red:d\d+>>    VecReduce [<<Phi>>]                  loop:none
+  //
+  /// CHECK-FI:
+  private static int $noinline$maxInt(int[] a) {
+    int max = Integer.MIN_VALUE;
+    for (int i = 0; i < a.length; i++) {
+      max = Math.max(max, a[i]);
+    }
+    return max;
+  }
+
+  //
+  // Spills and calls.
+  //
+
+  // More loop invariant vectors are live in the loop than there are YMM registers, so some
+  // of them are spilled and reloaded with all 256 bits.
+  /// CHECK-START-X86_64: void Main.$noinline$manyInvariants(int[], int[], int[]) loop_optimization (after)
+  /// CHECK-IF: hasIsaFeature('avx2')
+  //
+  ///     CHECK-DAG: <<Cons:i\d+>>   IntConstant 8                        loop:none
+  ///     CHECK-DAG:                 VecReplicateScalar                   loop:none
+  ///     CHECK-DAG: <<Load:d\d+>>   VecLoad [{{l\d+}},<<I:i\d+>>]        loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG:                 VecAdd [<<Load>>,{{d\d+}}]           loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 VecMul                               loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 VecStore [{{l\d+}},<<I>>,{{d\d+}}]   loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 Add [<<I>>,<<Cons>>]                 loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-FI:
+  private static void $noinline$manyInvariants(int[] a, int[] b, int[] k) {
+    int k0 = k[0];
+    int k1 = k[1];
+    int k2 = k[2];
+    int k3 = k[3];
+    int k4 = k[4];
+    int k5 = k[5];
+    int k6 = k[6];
+    int k7 = k[7];
+    int k8 = k[8];
+    int k9 = k[9];
+    int k10 = k[10];
+    int k11 = k[11];
+    int k12 = k[12];
+    int k13 = k[13];
+    int k14 = k[14];
+    int k15 = k[15];
+    int k16 = k[16];
+    int k17 = k[17];
+    int k18 = k[18];
+    int k19 = k[19];
+    for (int i = 0; i < a.length; i++) {
+      a[i] = ((((((((((b[i] + k0) * k1 + k2) * k3 + k4) * k5 + k6) * k7 + k8) * k9 + k10)
+          * k11 + k12) * k13 + k14) * k15 + k16) * k17 + k18) * k19;
+    }
+  }
+
+  // Calls out of a method using the YMM registers, first into the runtime to allocate and then
+  // into SSE code.
+  /// CHECK-START-X86_64: int Main.$noinline$sumThenCall(int[], double) loop_optimization (after)
+  /// CHECK-IF: hasIsaFeature('avx2')
+  //
+  ///     CHECK-DAG: <<Cons:i\d+>>   IntConstant 8                        loop:none
+  ///     CHECK-DAG:                 VecAdd                               loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG:                 Add [{{i\d+}},<<Cons>>]              loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                 VecReduce                            loop:none
+  ///     CHECK-DAG:                 InvokeStaticOrDirect                 loop:none
+  //
+  /// CHECK-FI:
+  private static int $noinline$sumThenCall(int[] a, double d) {
+    int[] copy = new int[a.length];
+    int sum = 0;
+    for (int i = 0; i < a.length; i++) {
+      copy[i] = a[i] + 1;
+      sum += a[i];
+    }
+    return sum + copy[a.length - 1] + (int) $noinline$scalarDouble(d);
+  }
+
+  private static double $noinline$scalarDouble(double d) {
+    return Math.sqrt(d) * d + 0.5;
+  }
+
+  //
+  // Reference implementations, which are not vectorized because of the calls and inner loops.
+  //
+
+  private static int $noinline$expectedInvariants(int v, int[] k) {
+    v += k[0];
+    for (int j = 1; j < K; j += 2) {
+      v = v * k[j];
+      if (j + 1 < K) {
+        v += k[j + 1];
+      }
+    }
+    return v;
+  }
+
+  //
+  // Test driver.
+  //
+
+  public static void main(String[] args) {
+    int[] ints = new int[N];
+    byte[] bytes = new byte[N];
+    long[] longs = new long[N];
+    double[] doubles = new double[N];
+    for (int i = 0; i < N; i++) {
+      ints[i] = i * 37 - 5000;
+      bytes[i] = (byte) i;
+      longs[i] = (long) i << 33;
+      doubles[i] = i;
+    }
+
+    $noinline$addInt(ints, 11);
+    for (int i = 0; i < N; i++) {
+      expectEquals(i * 37 - 5000 + 11, ints[i]);
+    }
+    $noinline$addByte(bytes, (byte) 100);
+    for (int i = 0; i < N; i++) {
+      expectEquals((byte) (i + 100), bytes[i]);
+    }
+    $noinline$mulDouble(doubles, 0.5);
+    for (int i = 0; i < N; i++) {
+      expectEquals(i * 0.5, doubles[i]);
+    }
+
+    // Repeat the reductions so that their loops also get to suspend checks with live vectors.
+    int intSum = 0;
+    long longSum = 0;
+    for (int i = 0; i < N; i++) {
+      intSum += ints[i];
+      longSum += longs[i];
+    }
+    for (int r = 0; r < 1000; r++) {
+      expectEquals(intSum, $noinline$sumInt(ints));
+      expectEquals(longSum, $noinline$sumLong(longs));
+    }
+    expectEquals(ints[N - 1], $noinline$maxInt(ints));
+    ints[N / 2] = Integer.MAX_VALUE;
+    expectEquals(Integer.MAX_VALUE, $noinline$maxInt(ints));
+    ints[N / 2] = N / 2 * 37 - 5000 + 11;
+
+    int[] k = new int[K];
+    for (int j = 0; j < K; j++) {
+      k[j] = j * 3 - 7;
+    }
+    int[] result = new int[N];
+    $noinline$manyInvariants(result, ints, k);
+    for (int i = 0; i < N; i++) {
+      expectEquals($noinline$expectedInvariants(ints[i], k), result[i]);
+    }
+
+    int expectedSum = intSum + ints[N - 1] + 1 + (int) $noinline$scalarDouble(16.0);
+    for (int r = 0; r < 1000; r++) {
+      expectEquals(expectedSum, $noinline$sumThenCall(ints, 16.0));
+    }
+
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(long expected, long result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(double expected, double result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
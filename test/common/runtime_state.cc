@@ -619,4 +619,27 @@ extern "C" JNIEXPORT jboolean Java_Main_removeJitCompiledMethod(JNIEnv* env,
   return removed ? JNI_TRUE : JNI_FALSE;
 }
 
+// Samples which JIT code is on thread stacks, then evicts all the code which was not. Returns
+// the number of evicted methods.
+extern "C" JNIEXPORT jint JNICALL Java_Main_evictColdJitCode(JNIEnv*, jclass) {
+  jit::Jit* jit = GetJitIfEnabled();
+  if (jit == nullptr) {
+    return 0;
+  }
+  Thread* self = Thread::Current();
+  jit->WaitForCompilationToFinish(self);
+  jit::JitCodeCache* code_cache = jit->GetCodeCache();
+  // `ensureJitCompiled` disables the code cache GC, which eviction relies on.
+  code_cache->SetGarbageCollectCode(true);
+  code_cache->SampleCodeUsage(self);
+  size_t evicted_methods;
+  {
+    ScopedObjectAccess soa(self);
+    evicted_methods = code_cache->EvictColdCode(self, std::numeric_limits<size_t>::max());
+  }
+  // Restore the setting of `ensureJitCompiled`, so that the code compiled by the test stays.
+  code_cache->SetGarbageCollectCode(false);
+  return static_cast<jint>(evicted_methods);
+}
+
 }  // namespace art